@@ -0,0 +1,97 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CCDBNodeCache.h
+/// \brief  Cache of CCDB object images shared by all processes of a node
+///
+
+#ifndef ALICEO2_CCDBNODECACHE_H
+#define ALICEO2_CCDBNODECACHE_H
+
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include "MemoryResources/MemoryResources.h"
+
+namespace o2
+{
+namespace ccdb
+{
+
+/// Content addressed cache of CCDB object images in a local directory, shared by all processes of a node.
+/// Pointing it to a tmpfs (e.g. /dev/shm/...) keeps the cache in shared memory.
+///
+/// Images are stored under their ETag together with the headers of the server reply, a separate index
+/// records for every query (path + metadata) the ETag of the last image received for it. The index is
+/// only a hint: the cached image is used only if the server confirms with a 304 reply to the request
+/// carrying this ETag in If-None-Match that it is still the valid one, so the object is never downloaded twice.
+///
+/// Files are published atomically (written to a temporary file and renamed), the least recently used
+/// images are evicted when the total size exceeds the budget. Entries open in other processes survive
+/// the eviction, since the removal of a file does not affect its open descriptors.
+class CCDBNodeCache
+{
+ public:
+  /// An image found in the cache. The file is kept open, so that it can be read even if evicted meanwhile.
+  class Entry
+  {
+   public:
+    std::string const& getETag() const { return mETag; }
+    /// copy the image to dest, add the stored headers to headers
+    bool read(o2::pmr::vector<char>& dest, std::map<std::string, std::string>& headers);
+
+   private:
+    friend class CCDBNodeCache;
+    std::string mETag{};
+    std::ifstream mFile{};
+    size_t mSize = 0;
+    std::map<std::string, std::string> mHeaders{};
+  };
+
+  static constexpr size_t DefaultMaxSizeMB = 4096;
+
+  CCDBNodeCache(std::string const& dir, size_t maxSize);
+
+  std::string const& getDir() const { return mDir; }
+  size_t getMaxSize() const { return mMaxSize; }
+
+  /// image last received for this query, if still in the cache
+  std::optional<Entry> find(std::string const& path, std::map<std::string, std::string> const& metadata) const;
+
+  /// store the image received from the server for this query, the headers must contain its ETag
+  void publish(std::string const& path, std::map<std::string, std::string> const& metadata,
+               const char* data, size_t size, std::map<std::string, std::string> const& headers) const;
+
+  /// Complete a request to the server issued with the ETag of entry (if any) in If-None-Match: on 304 reply the image
+  /// is read from the cache, a new image is published. Returns true if dest was filled from the cache.
+  bool complete(std::optional<Entry>& entry, std::string const& path, std::map<std::string, std::string> const& metadata,
+                o2::pmr::vector<char>& dest, std::map<std::string, std::string>& headers) const;
+
+  /// evict the least recently used images until the total size is within the budget
+  void evict() const;
+
+ private:
+  std::string getIndexFile(std::string const& path, std::map<std::string, std::string> const& metadata) const;
+  std::string getImageFile(std::string const& etag) const;
+  // write content to a temporary file and rename it to fileName
+  bool writeAtomically(std::string const& fileName, std::string const& header, const char* data, size_t size) const;
+
+  std::string mDir{};
+  size_t mMaxSize = 0;
+};
+
+} // namespace ccdb
+} // namespace o2
+
+#endif
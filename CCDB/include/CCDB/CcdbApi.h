@@ -30,7 +30,9 @@
 
 #if !defined(__CINT__) && !defined(__MAKECINT__) && !defined(__ROOTCLING__) && !defined(__CLING__)
 #include "MemoryResources/MemoryResources.h"
+#include "CCDB/CCDBNodeCache.h"
 #include <TJAlienCredentials.h>
+#include <optional>
 #else
 class TJAlienCredentials;
 #endif
@@ -44,6 +46,7 @@ namespace ccdb
 {
 
 class CCDBQuery;
+class CCDBNodeCache;
 
 /**
  * Interface to the CCDB.
@@ -347,6 +350,26 @@ class CcdbApi //: public DatabaseInterface
                         const std::string& createdNotAfter, const std::string& createdNotBefore, bool considerSnapshot = true) const;
   void navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL* curl_handle, std::string const& url, std::map<string, string>* headers) const;
 
+  /// Arguments of a single loadFileToMemory call, to be served by vectoredLoadFileToMemory
+  struct RequestContext {
+    o2::pmr::vector<char>& dest;
+    std::string path;
+    std::map<std::string, std::string> metadata;
+    long timestamp = -1;
+    std::map<std::string, std::string>& headers;
+    std::string etag{};
+    std::string createdNotAfter{};
+    std::string createdNotBefore{};
+    bool considerSnapshot = true;
+  };
+
+  /**
+   * Equivalent of calling loadFileToMemory for every request, but the requests to the server are issued concurrently,
+   * reusing the (kept alive) connections of previous calls from the same thread. Every request is complete on return.
+   * Requests involving a local snapshot (snapshot backend or ALICEO2_CCDB_LOCALCACHE) are served one by one.
+   */
+  void vectoredLoadFileToMemory(std::vector<RequestContext>& requests) const;
+
   // the failure to load the file to memory is signaled by 0 size and non-0 capacity
   static bool isMemoryFileInvalid(const o2::pmr::vector<char>& v) { return v.size() == 0 && v.capacity() > 0; }
   template <typename T>
@@ -366,6 +389,12 @@ class CcdbApi //: public DatabaseInterface
   // report what file is read and for which purpose
   void logReading(const std::string& path, long ts, const std::map<std::string, std::string>* headers, const std::string& comment) const;
 
+#if !defined(__CINT__) && !defined(__MAKECINT__) && !defined(__ROOTCLING__) && !defined(__CLING__)
+  // image of the node cache to validate with the server instead of downloading the object, if usable for this request
+  std::optional<CCDBNodeCache::Entry> findInNodeCache(std::string const& path, std::map<std::string, std::string> const& metadata,
+                                                      std::map<std::string, std::string> const* headers, std::string const& etag) const;
+#endif
+
   /**
    * Initialize in local mode; Objects will be retrieved from snapshot
    *
@@ -465,6 +494,9 @@ class CcdbApi //: public DatabaseInterface
   /// given by tinfo if that is possible. Returns nullptr if something fails...
   void* navigateURLsAndRetrieveContent(CURL*, std::string const& url, std::type_info const& tinfo, std::map<std::string, std::string>* headers) const;
 
+  /// Content locations of a redirection response in the order they should be tried: "Location" first, then the "Content-Location"s
+  std::vector<std::string> getRedirectLocations(std::multimap<std::string, std::string> const& headerData) const;
+
   // helper that interprets a content chunk as TMemFile and extracts the object therefrom
   static void* interpretAsTMemFileAndExtract(char* contentptr, size_t contentsize, std::type_info const& tinfo);
 
@@ -528,6 +560,7 @@ class CcdbApi //: public DatabaseInterface
   mutable TGrid* mAlienInstance = nullptr;                       // a cached connection to TGrid (needed for Alien locations)
   bool mNeedAlienToken = true;                                   // On EPN and FLP we use a local cache and don't need the alien token
   static std::unique_ptr<TJAlienCredentials> mJAlienCredentials; // access JAliEn credentials
+  std::shared_ptr<CCDBNodeCache> mNodeCache;                     //! images shared by the processes of the node, see ALICEO2_CCDB_NODECACHE
 
   ClassDefNV(CcdbApi, 1);
 };
@@ -0,0 +1,223 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CCDBNodeCache.cxx
+/// \brief  Cache of CCDB object images shared by all processes of a node
+///
+
+#include "CCDB/CCDBNodeCache.h"
+#include "CommonUtils/StringUtils.h"
+#include <fairlogger/Logger.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <functional>
+#include <tuple>
+#include <vector>
+
+namespace o2::ccdb
+{
+
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr const char* ImageMagic = "CCDBNODECACHE1";
+
+// keep only characters which are safe in the file name
+std::string sanitize(std::string const& str)
+{
+  std::string res{str};
+  std::replace_if(
+    res.begin(), res.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_'; }, '_');
+  return res;
+}
+} // namespace
+
+CCDBNodeCache::CCDBNodeCache(std::string const& dir, size_t maxSize) : mDir(dir), mMaxSize(maxSize)
+{
+  std::error_code ec;
+  fs::create_directories(mDir + "/images", ec);
+  fs::create_directories(mDir + "/index", ec);
+  if (ec) {
+    LOGP(warn, "Failed to create CCDB node cache directory {}: {}", mDir, ec.message());
+  }
+}
+
+std::string CCDBNodeCache::getIndexFile(std::string const& path, std::map<std::string, std::string> const& metadata) const
+{
+  if (metadata.empty()) {
+    return mDir + "/index/" + path + "/default";
+  }
+  std::string meta;
+  for (auto& [key, value] : metadata) {
+    meta += key + '=' + value + '/';
+  }
+  return fmt::format("{}/index/{}/meta_{:x}", mDir, path, std::hash<std::string>{}(meta));
+}
+
+std::string CCDBNodeCache::getImageFile(std::string const& etag) const
+{
+  return mDir + "/images/" + sanitize(etag);
+}
+
+bool CCDBNodeCache::writeAtomically(std::string const& fileName, std::string const& header, const char* data, size_t size) const
+{
+  fs::path target(fileName);
+  std::error_code ec;
+  fs::create_directories(target.parent_path(), ec);
+  // the temporary file is hidden from the eviction and from the readers until it is complete
+  auto tmpName = (target.parent_path() / ("." + target.filename().string() + "." + o2::utils::Str::getRandomString(8))).string();
+  {
+    std::ofstream out(tmpName, std::ios::out | std::ios::binary);
+    out.write(header.data(), header.size());
+    if (size) {
+      out.write(data, size);
+    }
+    if (!out.good()) {
+      LOGP(warn, "Failed to write {} to the CCDB node cache", fileName);
+      out.close();
+      fs::remove(tmpName, ec);
+      return false;
+    }
+  }
+  fs::rename(tmpName, target, ec); // atomic replacement of the previous version, if any
+  if (ec) {
+    LOGP(warn, "Failed to publish {} to the CCDB node cache: {}", fileName, ec.message());
+    fs::remove(tmpName, ec);
+    return false;
+  }
+  return true;
+}
+
+std::optional<CCDBNodeCache::Entry> CCDBNodeCache::find(std::string const& path, std::map<std::string, std::string> const& metadata) const
+{
+  std::string etag;
+  {
+    std::ifstream index(getIndexFile(path, metadata));
+    if (!index.good() || !std::getline(index, etag) || etag.empty()) {
+      return std::nullopt;
+    }
+  }
+  std::optional<Entry> entry{std::in_place};
+  entry->mETag = etag;
+  auto imageFile = getImageFile(etag);
+  entry->mFile.open(imageFile, std::ios::in | std::ios::binary);
+  std::string line;
+  size_t nHeaders = 0;
+  if (!entry->mFile.good() || !std::getline(entry->mFile, line) || line != ImageMagic || !(entry->mFile >> nHeaders >> entry->mSize) || !std::getline(entry->mFile, line)) {
+    return std::nullopt; // evicted or corrupted
+  }
+  for (size_t i = 0; i < nHeaders && std::getline(entry->mFile, line); i++) {
+    auto sep = line.find(": ");
+    if (sep != std::string::npos) {
+      entry->mHeaders[line.substr(0, sep)] = line.substr(sep + 2);
+    }
+  }
+  auto storedETag = entry->mHeaders.find("ETag");
+  if (!entry->mFile.good() || storedETag == entry->mHeaders.end() || storedETag->second != etag) {
+    return std::nullopt;
+  }
+  std::error_code ec;
+  fs::last_write_time(imageFile, fs::file_time_type::clock::now(), ec); // the modification time orders the eviction
+  return entry;
+}
+
+bool CCDBNodeCache::Entry::read(o2::pmr::vector<char>& dest, std::map<std::string, std::string>& headers)
+{
+  dest.resize(mSize);
+  if (!mFile.read(dest.data(), mSize)) {
+    LOGP(warn, "Failed to read image of {} from the CCDB node cache", mETag);
+    dest.clear();
+    return false;
+  }
+  for (auto& [key, value] : mHeaders) {
+    headers.emplace(key, value); // the headers of the 304 reply take precedence
+  }
+  return true;
+}
+
+void CCDBNodeCache::publish(std::string const& path, std::map<std::string, std::string> const& metadata,
+                            const char* data, size_t size, std::map<std::string, std::string> const& headers) const
+{
+  auto etagIt = headers.find("ETag");
+  if (etagIt == headers.end() || etagIt->second.empty() || etagIt->second.find('\n') != std::string::npos) {
+    return;
+  }
+  auto const& etag = etagIt->second;
+  auto imageFile = getImageFile(etag);
+  std::error_code ec;
+  if (!fs::exists(imageFile, ec)) { // otherwise published meanwhile by another process
+    size_t nHeaders = 0;
+    std::string header;
+    for (auto& [key, value] : headers) {
+      if (key != "Error" && value.find('\n') == std::string::npos) {
+        header += key + ": " + value + '\n';
+        nHeaders++;
+      }
+    }
+    header = fmt::format("{}\n{} {}\n{}", ImageMagic, nHeaders, size, header);
+    if (!writeAtomically(imageFile, header, data, size)) {
+      return;
+    }
+    LOGP(debug, "Published {} of {} bytes for {} to the CCDB node cache", etag, size, path);
+  }
+  writeAtomically(getIndexFile(path, metadata), etag + '\n', nullptr, 0);
+  evict();
+}
+
+bool CCDBNodeCache::complete(std::optional<Entry>& entry, std::string const& path, std::map<std::string, std::string> const& metadata,
+                             o2::pmr::vector<char>& dest, std::map<std::string, std::string>& headers) const
+{
+  if (headers.count("Error")) {
+    return false;
+  }
+  if (dest.empty()) {
+    // the server confirmed that the cached image is still valid
+    return entry && entry->read(dest, headers);
+  }
+  publish(path, metadata, dest.data(), dest.size(), headers);
+  return false;
+}
+
+void CCDBNodeCache::evict() const
+{
+  std::vector<std::tuple<fs::file_time_type, size_t, fs::path>> images;
+  size_t totalSize = 0;
+  std::error_code ec;
+  for (auto const& file : fs::directory_iterator(mDir + "/images", ec)) {
+    if (file.path().filename().string()[0] == '.') {
+      continue; // being written
+    }
+    auto size = file.file_size(ec);
+    auto time = file.last_write_time(ec);
+    if (!ec) {
+      images.emplace_back(time, size, file.path());
+      totalSize += size;
+    }
+  }
+  if (totalSize <= mMaxSize) {
+    return;
+  }
+  std::sort(images.begin(), images.end());
+  for (auto const& [time, size, file] : images) {
+    if (totalSize <= mMaxSize) {
+      break;
+    }
+    if (fs::remove(file, ec)) { // may be removed concurrently by another process
+      LOGP(debug, "Evicted {} of {} bytes from the CCDB node cache", file.filename().string(), size);
+    }
+    totalSize -= size;
+  }
+}
+
+} // namespace o2::ccdb
@@ -43,6 +43,7 @@
 #include <boost/interprocess/sync/named_semaphore.hpp>
 #include <regex>
 #include <cstdio>
+#include <deque>
 
 namespace o2::ccdb
 {
@@ -119,6 +120,17 @@ void CcdbApi::init(std::string const& host)
     snapshotReport += ')';
   }
 
+  // The environment option ALICEO2_CCDB_NODECACHE=<dir> enables the cache of the object images shared by all processes
+  // of the node (put it on a tmpfs to have it in shared memory). The objects are still validated by the server, but
+  // are not downloaded again if the image is in the cache. ALICEO2_CCDB_NODECACHE_SIZE sets its size budget in MB.
+  const char* nodecachedir = getenv("ALICEO2_CCDB_NODECACHE");
+  if (nodecachedir && nodecachedir[0] != 0 && !mInSnapshotMode) {
+    const char* nodecachesize = getenv("ALICEO2_CCDB_NODECACHE_SIZE");
+    size_t maxSize = (nodecachesize ? std::stoul(nodecachesize) : CCDBNodeCache::DefaultMaxSizeMB) << 20;
+    mNodeCache = std::make_shared<CCDBNodeCache>(nodecachedir, maxSize);
+    snapshotReport += fmt::format("(node cache dir={}, {} MB)", nodecachedir, maxSize >> 20);
+  }
+
   mNeedAlienToken = host != "http://o2-ccdb.internal" && host != "http://localhost:8084" && host != "http://127.0.0.1:8084";
 
   LOGP(info, "Init CcdApi with UserAgentID: {}, Host: {}{}", mUniqueAgentID, host,
@@ -480,6 +492,45 @@ size_t header_map_callback(char* buffer, size_t size, size_t nitems, void* userd
   }
   return size * nitems;
 }
+
+// appends the received data to the o2::pmr::vector<char> passed as userdata
+size_t pmr_vector_write_callback(void* contents, size_t size, size_t nmemb, void* chunkptr)
+{
+  o2::pmr::vector<char>& chunk = *static_cast<o2::pmr::vector<char>*>(chunkptr);
+  size_t realsize = size * nmemb;
+  try {
+    chunk.reserve(chunk.size() + realsize);
+    char* contC = (char*)contents;
+    chunk.insert(chunk.end(), contC, contC + realsize);
+  } catch (std::exception e) {
+    LOGP(info, "failed to expand by {} bytes chunk provided to CURL: {}", realsize, e.what());
+    realsize = 0;
+  }
+  return realsize;
+}
+
+// multi handle of the batched retrievals, created on first use. It owns the connection cache, hence
+// it is kept for the lifetime of the thread so that the connections (and TLS sessions) are reused
+struct CurlMultiHandle {
+  static constexpr long MaxHostConnections = 16; // limit the number of parallel connections to the same server
+  CURLM* handle = nullptr;
+
+  CURLM* get()
+  {
+    if (!handle) {
+      handle = curl_multi_init();
+      curl_multi_setopt(handle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+      curl_multi_setopt(handle, CURLMOPT_MAX_HOST_CONNECTIONS, MaxHostConnections);
+    }
+    return handle;
+  }
+  ~CurlMultiHandle()
+  {
+    if (handle) {
+      curl_multi_cleanup(handle);
+    }
+  }
+};
 } // namespace
 
 void CcdbApi::initHeadersForRetrieve(CURL* curlHandle, long timestamp, std::map<std::string, std::string>* headers, std::string const& etag,
@@ -798,6 +849,34 @@ void* CcdbApi::interpretAsTMemFileAndExtract(char* contentptr, size_t contentsiz
   return result;
 }
 
+std::vector<std::string> CcdbApi::getRedirectLocations(std::multimap<std::string, std::string> const& headerData) const
+{
+  // 1st: The "Location" field
+  // 2nd: Possible "Content-Location" fields - Location field
+  // some locations are relative to the main server so we need to fix/complement them
+  auto complement_Location = [this](std::string const& loc) {
+    if (loc[0] == '/') {
+      // if it's just a path (noticed by trailing '/' we prepend the server url
+      return getURL() + loc;
+    }
+    return loc;
+  };
+
+  std::vector<std::string> locs;
+  auto iter = headerData.find("Location");
+  if (iter != headerData.end()) {
+    locs.push_back(complement_Location(iter->second));
+  }
+  // add alternative locations (not yet included)
+  auto range = headerData.equal_range("Content-Location");
+  for (auto it = range.first; it != range.second; ++it) {
+    if (std::find(locs.begin(), locs.end(), it->second) == locs.end()) {
+      locs.push_back(complement_Location(it->second));
+    }
+  }
+  return locs;
+}
+
 // navigate sequence of URLs until TFile content is found; object is extracted and returned
 void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string const& url, std::type_info const& tinfo, std::map<string, string>* headers) const
 {
@@ -849,33 +928,7 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
     // this is a more general redirection
     else if (300 <= response_code && response_code < 400) {
       // we try content locations in order of appearance until one succeeds
-      // 1st: The "Location" field
-      // 2nd: Possible "Content-Location" fields - Location field
-
-      // some locations are relative to the main server so we need to fix/complement them
-      auto complement_Location = [this](std::string const& loc) {
-        if (loc[0] == '/') {
-          // if it's just a path (noticed by trailing '/' we prepend the server url
-          return getURL() + loc;
-        }
-        return loc;
-      };
-
-      std::vector<std::string> locs;
-      auto iter = headerData.find("Location");
-      if (iter != headerData.end()) {
-        locs.push_back(complement_Location(iter->second));
-      }
-      // add alternative locations (not yet included)
-      auto iter2 = headerData.find("Content-Location");
-      if (iter2 != headerData.end()) {
-        auto range = headerData.equal_range("Content-Location");
-        for (auto it = range.first; it != range.second; ++it) {
-          if (std::find(locs.begin(), locs.end(), it->second) == locs.end()) {
-            locs.push_back(complement_Location(it->second));
-          }
-        }
-      }
+      auto locs = getRedirectLocations(headerData);
       for (auto& l : locs) {
         if (l.size() > 0) {
           LOG(debug) << "Trying content location " << l;
@@ -960,6 +1013,12 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
 
   // normal mode follows
 
+  if (mNodeCache && headers && !mInSnapshotMode) { // the node cache works on the object images
+    o2::pmr::vector<char> buff;
+    loadFileToMemory(buff, path, metadata, timestamp, headers, etag, createdNotAfter, createdNotBefore, false);
+    return buff.empty() ? nullptr : interpretAsTMemFileAndExtract(buff.data(), buff.size(), tinfo);
+  }
+
   CURL* curl_handle = curl_easy_init();
   string fullUrl = getFullUrlForRetrieval(curl_handle, path, metadata, timestamp); // todo check if function still works correctly in case mInSnapshotMode
   // if we are in snapshot mode we can simply open the file; extract the object and return
@@ -1388,6 +1447,7 @@ void CcdbApi::loadFileToMemory(o2::pmr::vector<char>& dest, std::string const& p
   // this would mean that the object was is already fetched and in this mode we don't to validity checks!
   bool createSnapshot = considerSnapshot && !mSnapshotCachePath.empty(); // create snaphot if absent
   int fromSnapshot = 0;
+  bool fromNodeCache = false;
   boost::interprocess::named_semaphore* sem = nullptr;
   std::string semhashedstring{}, snapshotpath{}, logfile{};
   std::unique_ptr<std::fstream> logStream;
@@ -1433,7 +1493,9 @@ void CcdbApi::loadFileToMemory(o2::pmr::vector<char>& dest, std::string const& p
     CURL* curl_handle = curl_easy_init();
     string fullUrl = getFullUrlForRetrieval(curl_handle, path, metadata, timestamp);
 
-    initHeadersForRetrieve(curl_handle, timestamp, headers, etag, createdNotAfter, createdNotBefore);
+    // if the node cache has an image for this query, ask the server whether it is still valid
+    auto nodeCacheEntry = findInNodeCache(path, metadata, headers, etag);
+    initHeadersForRetrieve(curl_handle, timestamp, headers, nodeCacheEntry ? nodeCacheEntry->getETag() : etag, createdNotAfter, createdNotBefore);
 
     navigateURLsAndLoadFileToMemory(dest, curl_handle, fullUrl, headers);
 
@@ -1442,6 +1504,7 @@ void CcdbApi::loadFileToMemory(o2::pmr::vector<char>& dest, std::string const& p
       loadFileToMemory(dest, fullUrl, headers); // headers loaded from the file in case of the snapshot reading only
     }
     curl_easy_cleanup(curl_handle);
+    fromNodeCache = mNodeCache && headers && mNodeCache->complete(nodeCacheEntry, path, metadata, dest, *headers);
   }
 
   if (dest.empty()) {
@@ -1449,7 +1512,7 @@ void CcdbApi::loadFileToMemory(o2::pmr::vector<char>& dest, std::string const& p
     return; // nothing was fetched: either cached value is good or error was produced
   }
   // !considerSnapshot means that the call was made by retrieve for snapshoting reasons
-  logReading(path, timestamp, headers, fmt::format("{}{}", considerSnapshot ? "load to memory" : "retrieve", fromSnapshot ? " from snapshot" : ""));
+  logReading(path, timestamp, headers, fmt::format("{}{}", considerSnapshot ? "load to memory" : "retrieve", fromSnapshot ? " from snapshot" : (fromNodeCache ? " from node cache" : "")));
 
   // are we asked to create a snapshot ?
   if (createSnapshot && fromSnapshot != 2 && !(mInSnapshotMode && mSnapshotTopPath == mSnapshotCachePath)) { // store in the snapshot only if the object was not read from the snapshot
@@ -1503,23 +1566,10 @@ void CcdbApi::navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL*
     chunk.reserve(1);
     errorflag = true;
   };
-  auto writeCallBack = [](void* contents, size_t size, size_t nmemb, void* chunkptr) {
-    o2::pmr::vector<char>& chunk = *static_cast<o2::pmr::vector<char>*>(chunkptr);
-    size_t realsize = size * nmemb;
-    try {
-      chunk.reserve(chunk.size() + realsize);
-      char* contC = (char*)contents;
-      chunk.insert(chunk.end(), contC, contC + realsize);
-    } catch (std::exception e) {
-      LOGP(info, "failed to expand by {} bytes chunk provided to CURL: {}", realsize, e.what());
-      realsize = 0;
-    }
-    return realsize;
-  };
 
   // specify URL to get
   curl_easy_setopt(curl_handle, CURLOPT_URL, url.c_str());
-  initCurlOptionsForRetrieve(curl_handle, (void*)&dest, writeCallBack, false);
+  initCurlOptionsForRetrieve(curl_handle, (void*)&dest, pmr_vector_write_callback, false);
   curl_easy_setopt(curl_handle, CURLOPT_HEADERFUNCTION, header_map_callback<decltype(headerData)>);
   headerData.clear();
   curl_easy_setopt(curl_handle, CURLOPT_HEADERDATA, (void*)&headerData);
@@ -1541,32 +1591,7 @@ void CcdbApi::navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL*
     // this is a more general redirection
     else if (300 <= response_code && response_code < 400) {
       // we try content locations in order of appearance until one succeeds
-      // 1st: The "Location" field
-      // 2nd: Possible "Content-Location" fields - Location field
-      // some locations are relative to the main server so we need to fix/complement them
-      auto complement_Location = [this](std::string const& loc) {
-        if (loc[0] == '/') {
-          // if it's just a path (noticed by trailing '/' we prepend the server url
-          return getURL() + loc;
-        }
-        return loc;
-      };
-
-      std::vector<std::string> locs;
-      auto iter = headerData.find("Location");
-      if (iter != headerData.end()) {
-        locs.push_back(complement_Location(iter->second));
-      }
-      // add alternative locations (not yet included)
-      auto iter2 = headerData.find("Content-Location");
-      if (iter2 != headerData.end()) {
-        auto range = headerData.equal_range("Content-Location");
-        for (auto it = range.first; it != range.second; ++it) {
-          if (std::find(locs.begin(), locs.end(), it->second) == locs.end()) {
-            locs.push_back(complement_Location(it->second));
-          }
-        }
-      }
+      auto locs = getRedirectLocations(headerData);
       for (auto& l : locs) {
         if (l.size() > 0) {
           LOG(debug) << "Trying content location " << l;
@@ -1594,6 +1619,167 @@ void CcdbApi::navigateURLsAndLoadFileToMemory(o2::pmr::vector<char>& dest, CURL*
   return;
 }
 
+std::optional<CCDBNodeCache::Entry> CcdbApi::findInNodeCache(std::string const& path, std::map<std::string, std::string> const& metadata,
+                                                              std::map<std::string, std::string> const* headers, std::string const& etag) const
+{
+  // the image can be served only if the caller does not have its own copy and collects the headers
+  if (!mNodeCache || !headers || !etag.empty()) {
+    return std::nullopt;
+  }
+  return mNodeCache->find(path, metadata);
+}
+
+void CcdbApi::vectoredLoadFileToMemory(std::vector<RequestContext>& requests) const
+{
+  static thread_local CurlMultiHandle multiHandle;
+
+  struct Transfer {
+    RequestContext* request = nullptr;
+    CURL* handle = nullptr;
+    std::string url{};
+    std::multimap<std::string, std::string> headerData{};
+    std::deque<std::string> locations{}; // content locations still to try, in the order of navigateURLsAndLoadFileToMemory
+    bool active = false;                 // handle is attached to the multi handle
+    std::optional<CCDBNodeCache::Entry> nodeCacheEntry{};
+  };
+  std::vector<Transfer> transfers;
+  transfers.reserve(requests.size()); // curl keeps pointers to the elements
+  CURLM* multi = multiHandle.get();
+  int nActive = 0;
+
+  auto submit = [this, multi, &nActive](Transfer& tr, std::string const& url) {
+    tr.url = url;
+    tr.headerData.clear();
+    curl_easy_setopt(tr.handle, CURLOPT_URL, tr.url.c_str());
+    initCurlOptionsForRetrieve(tr.handle, (void*)&tr.request->dest, pmr_vector_write_callback, false);
+    curl_easy_setopt(tr.handle, CURLOPT_HEADERFUNCTION, header_map_callback<decltype(tr.headerData)>);
+    curl_easy_setopt(tr.handle, CURLOPT_HEADERDATA, (void*)&tr.headerData);
+    curlSetSSLOptions(tr.handle);
+    curl_multi_add_handle(multi, tr.handle);
+    tr.active = true;
+    nActive++;
+  };
+
+  // try the pending content locations until one provides the content, returns true if a transfer was submitted
+  auto proceed = [this, &submit](Transfer& tr) {
+    while (tr.request->dest.empty() && !tr.locations.empty()) {
+      auto url = std::move(tr.locations.front());
+      tr.locations.pop_front();
+      if (url.empty()) {
+        continue;
+      }
+      LOG(debug) << "Trying content location " << url;
+      if (url.find("alien:/", 0) != std::string::npos) { // something curl cannot handle
+        loadFileToMemory(tr.request->dest, url, nullptr);
+        continue;
+      }
+      submit(tr, url);
+      return true;
+    }
+    return false;
+  };
+
+  auto signalError = [](Transfer& tr) {
+    tr.request->dest.clear();
+    tr.request->dest.reserve(1);
+    // indicate that an error occurred ---> used by caching layers (such as CCDBManager)
+    tr.request->headers["Error"] = "An error occurred during retrieval";
+  };
+
+  auto processResponse = [this, &signalError](Transfer& tr, CURLcode res) {
+    auto& headers = tr.request->headers;
+    bool errorflag = false;
+    long response_code = -1;
+    if (res == CURLE_OK && curl_easy_getinfo(tr.handle, CURLINFO_RESPONSE_CODE, &response_code) == CURLE_OK) {
+      for (auto& p : tr.headerData) {
+        headers[p.first] = p.second;
+      }
+      if (200 <= response_code && response_code < 300) {
+        // good response and the content is directly provided and should have been dumped into dest
+      } else if (response_code == 304) {
+        LOGP(debug, "Object exists but I am not serving it since it's already in your possession");
+      } else if (300 <= response_code && response_code < 400) {
+        // locations of the redirection are tried before the remaining ones of the enclosing redirections
+        auto locs = getRedirectLocations(tr.headerData);
+        tr.locations.insert(tr.locations.begin(), locs.begin(), locs.end());
+      } else if (response_code == 404) {
+        LOG(error) << "Requested resource does not exist: " << tr.url;
+        errorflag = true;
+      } else {
+        LOG(error) << "Error in fetching object " << tr.url << ", curl response code:" << response_code;
+        errorflag = true;
+      }
+    } else {
+      LOGP(alarm, "Curl request to {} failed with result {}, response code: {}", tr.url, int(res), response_code);
+      errorflag = true;
+    }
+    if (errorflag) {
+      signalError(tr);
+    }
+  };
+
+  for (auto& req : requests) {
+    if (mInSnapshotMode || !mSnapshotCachePath.empty()) {
+      // reading or creating the snapshot is protected by an inter-process semaphore, keep it serial
+      loadFileToMemory(req.dest, req.path, req.metadata, req.timestamp, &req.headers, req.etag, req.createdNotAfter, req.createdNotBefore, req.considerSnapshot);
+      continue;
+    }
+    LOGP(debug, "vectoredLoadFileToMemory {} ETag=[{}]", req.path, req.etag);
+    auto& tr = transfers.emplace_back();
+    tr.request = &req;
+    tr.handle = curl_easy_init();
+    tr.nodeCacheEntry = findInNodeCache(req.path, req.metadata, &req.headers, req.etag);
+    initHeadersForRetrieve(tr.handle, req.timestamp, &req.headers, tr.nodeCacheEntry ? tr.nodeCacheEntry->getETag() : req.etag, req.createdNotAfter, req.createdNotBefore);
+    curl_easy_setopt(tr.handle, CURLOPT_PRIVATE, (void*)&tr);
+    curl_easy_setopt(tr.handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(tr.handle, CURLOPT_PIPEWAIT, 1L); // prefer multiplexing over an existing HTTP/2 connection to opening a new one
+    submit(tr, getFullUrlForRetrieval(tr.handle, req.path, req.metadata, req.timestamp));
+  }
+
+  while (nActive > 0) {
+    int running = 0;
+    if (auto mc = curl_multi_perform(multi, &running); mc != CURLM_OK) {
+      LOGP(alarm, "curl_multi_perform failed: {}", curl_multi_strerror(mc));
+      break;
+    }
+    CURLMsg* msg = nullptr;
+    int nQueued = 0;
+    while ((msg = curl_multi_info_read(multi, &nQueued))) {
+      if (msg->msg != CURLMSG_DONE) {
+        continue;
+      }
+      Transfer* tr = nullptr;
+      curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**)&tr);
+      auto res = msg->data.result; // msg is invalidated by the removal of the handle
+      curl_multi_remove_handle(multi, tr->handle);
+      tr->active = false;
+      nActive--;
+      processResponse(*tr, res);
+      proceed(*tr);
+    }
+    if (nActive > 0 && running > 0) {
+      curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+    }
+  }
+
+  for (auto& tr : transfers) {
+    if (tr.active) { // the loop above was aborted
+      curl_multi_remove_handle(multi, tr.handle);
+      signalError(tr);
+    }
+    auto& req = *tr.request;
+    for (size_t hostIndex = 1; hostIndex < hostsPool.size() && isMemoryFileInvalid(req.dest); hostIndex++) {
+      auto fullUrl = getFullUrlForRetrieval(tr.handle, req.path, req.metadata, req.timestamp, hostIndex);
+      loadFileToMemory(req.dest, fullUrl, &req.headers); // headers loaded from the file in case of the snapshot reading only
+    }
+    curl_easy_cleanup(tr.handle);
+    bool fromNodeCache = mNodeCache && mNodeCache->complete(tr.nodeCacheEntry, req.path, req.metadata, req.dest, req.headers);
+    if (!req.dest.empty()) {
+      logReading(req.path, req.timestamp, &req.headers, fmt::format("{}{}", req.considerSnapshot ? "load to memory" : "retrieve", fromNodeCache ? " from node cache" : ""));
+    }
+  }
+}
+
 void CcdbApi::loadFileToMemory(o2::pmr::vector<char>& dest, const std::string& path, std::map<std::string, std::string>* localHeaders) const
 {
   // Read file to memory as vector. For special case of the locally cached file retriev metadata stored directly in the file
@@ -0,0 +1,136 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCCDBNodeCache.cxx
+/// \brief  publication, lookup and eviction of the node-wide CCDB image cache
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CCDBNodeCache.h"
+#include <boost/test/unit_test.hpp>
+#include <filesystem>
+#include <string>
+#include <unistd.h>
+
+using namespace o2::ccdb;
+
+namespace
+{
+struct Fixture {
+  Fixture() : dir(std::filesystem::temp_directory_path() / ("ccdbNodeCache_" + std::to_string(getpid()))) {}
+  ~Fixture() { std::filesystem::remove_all(dir); }
+  std::filesystem::path dir;
+};
+
+std::map<std::string, std::string> makeHeaders(std::string const& etag)
+{
+  return {{"ETag", etag}, {"Valid-From", "1000"}, {"Valid-Until", "2000"}};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(publish_find_test)
+{
+  Fixture f;
+  CCDBNodeCache cache(f.dir.string(), 1 << 20);
+  std::map<std::string, std::string> metadata{{"runNumber", "123"}};
+  std::string image(1000, 'a');
+
+  BOOST_CHECK(!cache.find("Test/Object", metadata));
+  cache.publish("Test/Object", metadata, image.data(), image.size(), makeHeaders("\"etag-1\""));
+  // the query is part of the key
+  BOOST_CHECK(!cache.find("Test/Object", {}));
+  BOOST_CHECK(!cache.find("Test/Other", metadata));
+
+  // a second cache on the same directory stands for another process
+  CCDBNodeCache other(f.dir.string(), 1 << 20);
+  auto entry = other.find("Test/Object", metadata);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK_EQUAL(entry->getETag(), "\"etag-1\"");
+  o2::pmr::vector<char> dest;
+  std::map<std::string, std::string> headers{{"Valid-Until", "3000"}};
+  BOOST_REQUIRE(entry->read(dest, headers));
+  BOOST_CHECK_EQUAL(std::string(dest.begin(), dest.end()), image);
+  BOOST_CHECK_EQUAL(headers["ETag"], "\"etag-1\"");
+  BOOST_CHECK_EQUAL(headers["Valid-From"], "1000");
+  BOOST_CHECK_EQUAL(headers["Valid-Until"], "3000"); // headers of the reply are not overridden
+
+  // a newer image of the same query replaces the hint
+  std::string image2(500, 'b');
+  cache.publish("Test/Object", metadata, image2.data(), image2.size(), makeHeaders("\"etag-2\""));
+  entry = other.find("Test/Object", metadata);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK_EQUAL(entry->getETag(), "\"etag-2\"");
+}
+
+BOOST_AUTO_TEST_CASE(complete_test)
+{
+  Fixture f;
+  CCDBNodeCache cache(f.dir.string(), 1 << 20);
+  std::string image(1000, 'a');
+  std::optional<CCDBNodeCache::Entry> entry;
+
+  // new object received from the server is published
+  o2::pmr::vector<char> dest(image.begin(), image.end());
+  auto headers = makeHeaders("\"etag-1\"");
+  BOOST_CHECK(!cache.complete(entry, "Test/Object", {}, dest, headers));
+  entry = cache.find("Test/Object", {});
+  BOOST_REQUIRE(entry);
+
+  // 304 reply to the request with the ETag of the entry: image is served from the cache
+  o2::pmr::vector<char> dest304;
+  std::map<std::string, std::string> headers304;
+  BOOST_CHECK(cache.complete(entry, "Test/Object", {}, dest304, headers304));
+  BOOST_CHECK(dest304 == dest);
+  BOOST_CHECK_EQUAL(headers304["ETag"], "\"etag-1\"");
+
+  // failed request is neither served nor published
+  o2::pmr::vector<char> destError;
+  std::map<std::string, std::string> headersError{{"Error", "An error occurred during retrieval"}};
+  entry = cache.find("Test/Object", {});
+  BOOST_CHECK(!cache.complete(entry, "Test/Object", {}, destError, headersError));
+  BOOST_CHECK(destError.empty());
+}
+
+BOOST_AUTO_TEST_CASE(eviction_test)
+{
+  Fixture f;
+  constexpr size_t ImageSize = 1000;
+  CCDBNodeCache cache(f.dir.string(), 3 * ImageSize + 500); // headers of the images are accounted too
+  std::string image(ImageSize, 'a');
+  auto publish = [&](int i) {
+    cache.publish("Test/Object" + std::to_string(i), {}, image.data(), image.size(), makeHeaders("\"etag-" + std::to_string(i) + "\""));
+  };
+  publish(0);
+  publish(1);
+  publish(2);
+  // an entry kept open survives the eviction
+  auto open = cache.find("Test/Object1", {});
+  BOOST_REQUIRE(open);
+  // make the modification times distinct so that the LRU order does not depend on the file system time resolution
+  auto now = std::filesystem::file_time_type::clock::now();
+  for (int i = 0; i < 3; i++) {
+    std::filesystem::last_write_time(f.dir / "images" / ("_etag-" + std::to_string(i) + "_"), now - std::chrono::seconds(i == 1 ? 100 : 10 - i));
+  }
+  publish(3); // 1 is the least recently used one
+
+  BOOST_CHECK(!cache.find("Test/Object1", {}));
+  BOOST_CHECK(cache.find("Test/Object0", {}));
+  BOOST_CHECK(cache.find("Test/Object2", {}));
+  BOOST_CHECK(cache.find("Test/Object3", {}));
+  o2::pmr::vector<char> dest;
+  std::map<std::string, std::string> headers;
+  BOOST_CHECK(open->read(dest, headers));
+  BOOST_CHECK_EQUAL(dest.size(), ImageSize);
+}
@@ -0,0 +1,292 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCcdbApiVectored.cxx
+/// \brief  concurrent retrieval with CcdbApi::vectoredLoadFileToMemory against a local stand-in of the CCDB server
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CcdbApi.h"
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace o2::ccdb;
+
+namespace
+{
+/// Minimal HTTP/1.1 server with keep-alive, serving
+/// /Test/Object<i>/... : 200 with ETag "etag-<i>", or 304 if the request carries this ETag in If-None-Match
+/// /Test/Moved/...     : 303 with a Location relative to the server pointing to Object0
+/// anything else      : 404
+class StandInServer
+{
+ public:
+  StandInServer()
+  {
+    mListenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(mListenSocket, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0; // any free port
+    bind(mListenSocket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(mListenSocket, reinterpret_cast<sockaddr*>(&addr), &len);
+    mPort = ntohs(addr.sin_port);
+    listen(mListenSocket, 64);
+    mAcceptThread = std::thread([this]() { acceptLoop(); });
+  }
+
+  ~StandInServer()
+  {
+    shutdown(mListenSocket, SHUT_RDWR);
+    close(mListenSocket);
+    mAcceptThread.join();
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto& [sock, thread] : mConnections) {
+      shutdown(sock, SHUT_RDWR);
+      thread.join();
+      close(sock);
+    }
+  }
+
+  std::string getURL() const { return "http://127.0.0.1:" + std::to_string(mPort); }
+  int getNConnections() const { return mNConnections; }
+  int getNRequests() const { return mNRequests; }
+  int getNNotModified() const { return mNNotModified; }
+
+  static std::string getContent(int i) { return "content of object " + std::to_string(i) + std::string(1000 * (i + 1), 'x'); }
+  static std::string getETag(int i) { return "\"etag-" + std::to_string(i) + "\""; }
+
+ private:
+  void acceptLoop()
+  {
+    while (true) {
+      int sock = accept(mListenSocket, nullptr, nullptr);
+      if (sock < 0) {
+        return;
+      }
+      mNConnections++;
+      std::lock_guard<std::mutex> lock(mMutex);
+      mConnections.emplace_back(sock, std::thread([this, sock]() { serve(sock); }));
+    }
+  }
+
+  void serve(int sock)
+  {
+    std::string buffer;
+    char chunk[4096];
+    while (true) {
+      auto end = buffer.find("\r\n\r\n");
+      if (end == std::string::npos) {
+        auto n = recv(sock, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+          return;
+        }
+        buffer.append(chunk, n);
+        continue;
+      }
+      std::string request = buffer.substr(0, end);
+      buffer.erase(0, end + 4);
+      mNRequests++;
+      std::string reply = respond(request);
+      send(sock, reply.data(), reply.size(), MSG_NOSIGNAL);
+    }
+  }
+
+  std::string respond(std::string const& request)
+  {
+    std::istringstream lines(request);
+    std::string method, target, line;
+    lines >> method >> target;
+    std::vector<std::string> noneMatch;
+    while (std::getline(lines, line)) {
+      if (line.rfind("If-None-Match: ", 0) == 0) {
+        noneMatch.push_back(line.substr(15, line.find_last_not_of("\r") - 14));
+      }
+    }
+    std::string status = "404 Not Found", headers, body;
+    int id = -1;
+    if (target.rfind("/Test/Moved/", 0) == 0) {
+      status = "303 See Other";
+      headers = "Location: /Test/Object0/redirected/\r\n";
+    } else if (std::sscanf(target.c_str(), "/Test/Object%d/", &id) == 1) {
+      if (std::find(noneMatch.begin(), noneMatch.end(), getETag(id)) != noneMatch.end()) {
+        status = "304 Not Modified";
+        mNNotModified++;
+      } else {
+        status = "200 OK";
+        body = getContent(id);
+      }
+      headers = "ETag: " + getETag(id) + "\r\nValid-From: 1000\r\n";
+    }
+    return "HTTP/1.1 " + status + "\r\n" + headers + "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+  }
+
+  int mListenSocket = -1;
+  int mPort = 0;
+  std::atomic<int> mNConnections{0};
+  std::atomic<int> mNRequests{0};
+  std::atomic<int> mNNotModified{0};
+  std::thread mAcceptThread;
+  std::mutex mMutex;
+  std::vector<std::pair<int, std::thread>> mConnections;
+};
+
+struct Fixture {
+  Fixture()
+  {
+    unsetenv("ALICEO2_CCDB_LOCALCACHE"); // the snapshot cache would serialize the requests
+    api.init(server.getURL());
+  }
+  StandInServer server;
+  CcdbApi api;
+};
+
+struct Result {
+  o2::pmr::vector<char> dest;
+  std::map<std::string, std::string> headers;
+};
+
+void fetchAll(CcdbApi const& api, std::vector<std::string> const& paths, std::vector<Result>& results, std::vector<std::string> const& etags = {})
+{
+  results.resize(paths.size());
+  std::vector<CcdbApi::RequestContext> requests;
+  for (size_t i = 0; i < paths.size(); i++) {
+    requests.push_back({results[i].dest, paths[i], {}, 1234, results[i].headers, etags.empty() ? "" : etags[i]});
+  }
+  api.vectoredLoadFileToMemory(requests);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(vectored_vs_serial_test)
+{
+  Fixture f;
+  constexpr int NObjects = 20;
+  std::vector<std::string> paths;
+  for (int i = 0; i < NObjects; i++) {
+    paths.push_back("Test/Object" + std::to_string(i));
+  }
+  std::vector<Result> results;
+  fetchAll(f.api, paths, results);
+
+  for (int i = 0; i < NObjects; i++) {
+    Result serial;
+    f.api.loadFileToMemory(serial.dest, paths[i], {}, 1234, &serial.headers, "", "", "");
+    auto expected = StandInServer::getContent(i);
+    BOOST_CHECK_EQUAL(std::string(results[i].dest.begin(), results[i].dest.end()), expected);
+    BOOST_CHECK(results[i].dest == serial.dest);
+    BOOST_CHECK_EQUAL(results[i].headers["ETag"], StandInServer::getETag(i));
+    BOOST_CHECK(results[i].headers == serial.headers);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(vectored_etag_redirect_error_test)
+{
+  Fixture f;
+  std::vector<Result> results;
+  fetchAll(f.api, {"Test/Object1", "Test/Moved", "Test/Missing", "Test/Object2"}, results, {StandInServer::getETag(1), "", "", ""});
+
+  // object is up to date: nothing is transferred and no error is signaled
+  BOOST_CHECK(results[0].dest.empty());
+  BOOST_CHECK(!CcdbApi::isMemoryFileInvalid(results[0].dest));
+  BOOST_CHECK_EQUAL(results[0].headers.count("Error"), 0);
+  // redirection relative to the server is followed
+  BOOST_CHECK_EQUAL(std::string(results[1].dest.begin(), results[1].dest.end()), StandInServer::getContent(0));
+  BOOST_CHECK_EQUAL(results[1].headers["ETag"], StandInServer::getETag(0));
+  // missing object is signaled as for loadFileToMemory
+  BOOST_CHECK(CcdbApi::isMemoryFileInvalid(results[2].dest));
+  BOOST_CHECK_EQUAL(results[2].headers.count("Error"), 1);
+  // and does not affect the other requests
+  BOOST_CHECK_EQUAL(std::string(results[3].dest.begin(), results[3].dest.end()), StandInServer::getContent(2));
+}
+
+BOOST_AUTO_TEST_CASE(vectored_connection_reuse_test)
+{
+  Fixture f;
+  std::vector<std::string> paths;
+  for (int i = 0; i < 8; i++) {
+    paths.push_back("Test/Object" + std::to_string(i));
+  }
+  std::vector<Result> results;
+  fetchAll(f.api, paths, results);
+  int nConnections = f.server.getNConnections();
+  BOOST_CHECK(nConnections > 0);
+
+  for (int iter = 0; iter < 3; iter++) {
+    std::vector<Result> again;
+    fetchAll(f.api, paths, again);
+    for (size_t i = 0; i < paths.size(); i++) {
+      BOOST_CHECK(again[i].dest == results[i].dest);
+    }
+  }
+  // connections of the first batch are kept alive and reused
+  BOOST_CHECK_EQUAL(f.server.getNConnections(), nConnections);
+  BOOST_CHECK_EQUAL(f.server.getNRequests(), 4 * 8);
+}
+
+BOOST_AUTO_TEST_CASE(node_cache_test)
+{
+  auto cacheDir = std::filesystem::temp_directory_path() / ("ccdbNodeCacheApi_" + std::to_string(getpid()));
+  setenv("ALICEO2_CCDB_NODECACHE", cacheDir.c_str(), 1);
+  StandInServer server;
+  std::vector<std::string> paths{"Test/Object0", "Test/Object1", "Test/Moved"};
+
+  // the first process downloads the objects and publishes them to the node cache
+  CcdbApi first;
+  first.init(server.getURL());
+  std::vector<Result> results;
+  fetchAll(first, paths, results);
+  BOOST_CHECK_EQUAL(server.getNNotModified(), 0);
+
+  // other processes only get them validated by the server
+  CcdbApi second;
+  second.init(server.getURL());
+  std::vector<Result> cached;
+  fetchAll(second, paths, cached);
+  BOOST_CHECK_EQUAL(server.getNNotModified(), 3);
+  Result serial;
+  second.loadFileToMemory(serial.dest, paths[1], {}, 1234, &serial.headers, "", "", "");
+  BOOST_CHECK_EQUAL(server.getNNotModified(), 4);
+  BOOST_CHECK(serial.dest == results[1].dest);
+  for (size_t i = 0; i < paths.size(); i++) {
+    BOOST_CHECK(cached[i].dest == results[i].dest);
+    BOOST_CHECK_EQUAL(cached[i].headers["ETag"], results[i].headers["ETag"]);
+    BOOST_CHECK_EQUAL(cached[i].headers["Valid-From"], "1000");
+  }
+
+  // the process which already has the object gets an empty reply as without node cache
+  std::vector<Result> again;
+  fetchAll(second, {paths[0]}, again, {results[0].headers["ETag"]});
+  BOOST_CHECK(again[0].dest.empty());
+  BOOST_CHECK_EQUAL(again[0].headers.count("Error"), 0);
+
+  unsetenv("ALICEO2_CCDB_NODECACHE");
+  std::filesystem::remove_all(cacheDir);
+}
@@ -94,11 +94,16 @@ inline size_t calculatePaddedSize(size_t nElems) noexcept
 
 ///>>======================== Auxiliary classes =======================>>
 
+/// number of interleaved rANS states used for the blocks flagged by ANSHeader::isInterleaved
+constexpr size_t ANSInterleavedStreams = 8;
+
 struct ANSHeader {
   uint8_t majorVersion;
   uint8_t minorVersion;
 
   void clear() { majorVersion = minorVersion = 0; }
+  /// since v1.0 the entropy coded blocks use ANSInterleavedStreams rANS states instead of 2
+  bool isInterleaved() const { return majorVersion >= 1; }
   ClassDefNV(ANSHeader, 1);
 };
 
@@ -332,6 +337,16 @@ struct Block {
   ClassDefNV(Block, 1);
 }; // namespace ctf
 
+/// standalone image of a single block, filled outside of the container so that several blocks can be
+/// encoded concurrently. It is added to the container by EncodedBlocks::storeBlock, in the order of slots.
+template <typename W = uint32_t>
+struct PreparedBlock {
+  Metadata metadata{};
+  std::vector<W> dict{};
+  std::vector<W> data{};
+  std::vector<W> literals{};
+};
+
 ///<<======================== Auxiliary classes =======================<<
 
 template <typename H, int N, typename W = uint32_t>
@@ -339,6 +354,7 @@ class EncodedBlocks
 {
  public:
   typedef EncodedBlocks<H, N, W> base;
+  typedef PreparedBlock<W> preparedBlock_t;
 
   void setHeader(const H& h) { mHeader = h; }
   const H& getHeader() const { return mHeader; }
@@ -444,6 +460,21 @@ class EncodedBlocks
   template <typename input_IT, typename buffer_T>
   o2::ctf::CTFIOSize encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f);
 
+  /// encode vector src to a standalone block image, does not access the container and can be called concurrently
+  template <typename VE>
+  static inline PreparedBlock<W> prepareBlock(const VE& src, const ANSHeader& ansHeader, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt = nullptr, float memfc = 1.f)
+  {
+    return prepareBlock(std::begin(src), std::end(src), ansHeader, symbolTablePrecision, opt, encoderExt, memfc);
+  }
+
+  /// encode range [srcBegin, srcEnd) to a standalone block image, does not access the container and can be called concurrently
+  template <typename input_IT>
+  static PreparedBlock<W> prepareBlock(const input_IT srcBegin, const input_IT srcEnd, const ANSHeader& ansHeader, uint8_t symbolTablePrecision, Metadata::OptStore opt, const void* encoderExt = nullptr, float memfc = 1.f);
+
+  /// copy block image produced by prepareBlock to provided slot
+  template <typename buffer_T>
+  o2::ctf::CTFIOSize storeBlock(const PreparedBlock<W>& block, int slot, buffer_T* buffer = nullptr);
+
   /// decode block at provided slot to destination vector (will be resized as needed)
   template <class container_T, class container_IT = typename container_T::iterator>
   o2::ctf::CTFIOSize decode(container_T& dest, int slot, const void* decoderExt = nullptr) const;
@@ -495,6 +526,15 @@ class EncodedBlocks
   template <typename D>
   static bool readTreeBranch(TTree& tree, const std::string& brname, D& dt, int ev = 0);
 
+  /// encode range [srcBegin, srcEnd) to the storage provided by the sink and return the block metadata, used by encode,
+  /// which writes directly to the slot of the container, and by prepareBlock, which fills a standalone image.
+  /// The sink must provide: reserve(nWords) to make room for nWords more words, storeDict(nWords, dict),
+  /// createData(nWordsEstimate, capacity) returning the start of the data and its capacity in words,
+  /// setNData(nWords) once the data are encoded, storeLiterals(nWords, literals) and storeData(nWords, data)
+  template <typename input_IT, typename sink_T>
+  static Metadata encodeToSink(const input_IT srcBegin, const input_IT srcEnd, bool interleaved, uint8_t symbolTablePrecision, Metadata::OptStore opt,
+                               sink_T& sink, const void* encoderExt, float memfc);
+
   ClassDefNV(EncodedBlocks, 2);
 };
 
@@ -805,7 +845,11 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::decode(D_IT dest,
         // to D-word array
         literals = std::vector<dest_t>{reinterpret_cast<const dest_t*>(block.getLiterals()), reinterpret_cast<const dest_t*>(block.getLiterals()) + md.nLiterals};
       }
-      decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      if (mANSHeader.isInterleaved()) {
+        decoder->template process<ANSInterleavedStreams>(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      } else {
+        decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      }
     } else { // data was stored as is
       using destPtr_t = typename std::iterator_traits<D_IT>::pointer;
       destPtr_t srcBegin = reinterpret_cast<destPtr_t>(block.payload);
@@ -829,7 +873,102 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
                                                   const void* encoderExt,       // optional external encoder
                                                   float memfc)                  // memory allocation margin factor
 {
+  // fill a new block
+  assert(slot == mRegistry.nFilledBlocks);
+  mRegistry.nFilledBlocks++;
+
+  // the message is encoded directly into the block buffer
+  struct SlotSink {
+    Block<W>* thisBlock;
+    Metadata* thisMetadata;
+    buffer_T* buffer;
+    int slot;
+
+    // resize underlying buffer of block if necessary and update all pointers.
+    void reserve(size_t additionalElements)
+    {
+      auto* const blockHead = get(thisBlock->registry->head);                         // extract pointer from the block, as "this" might be invalid
+      const size_t additionalSize = blockHead->estimateBlockSize(additionalElements); // size in bytes!!!
+      if (additionalSize >= thisBlock->registry->getFreeSize()) {
+        LOG(debug) << "Slot " << slot << ": free size: " << thisBlock->registry->getFreeSize() << ", need " << additionalSize << " for " << additionalElements << " words";
+        if (buffer) {
+          blockHead->expand(*buffer, blockHead->size() + (additionalSize - blockHead->getFreeSize()));
+          thisMetadata = &(get(buffer->data())->mMetadata[slot]);
+          thisBlock = &(get(buffer->data())->mBlocks[slot]); // in case of resizing this and any this.xxx becomes invalid
+        } else {
+          throw std::runtime_error("no room for encoded block in provided container");
+        }
+      }
+    }
+    void storeDict(size_t nWords, const W* dict)
+    {
+      thisBlock->storeDict(nWords, dict);
+      LOGP(debug, "StoreDict {} bytes, offs: {}:{}", nWords * sizeof(W), thisBlock->getOffsDict(), thisBlock->getOffsDict() + nWords * sizeof(W));
+    }
+    W* createData(size_t, size_t& capacity)
+    {
+      capacity = thisBlock->registry->getFreeSize() / sizeof(W); // note: "this" might be not valid after reserve call!!!
+      return thisBlock->getCreateData();
+    }
+    void setNData(size_t nWords)
+    {
+      // update the size claimed by encode message directly inside the block
+      thisBlock->setNData(nWords);
+      thisBlock->realignBlock();
+      LOGP(debug, "StoreData {} bytes, offs: {}:{}", nWords * sizeof(W), thisBlock->getOffsData(), thisBlock->getOffsData() + nWords * sizeof(W));
+    }
+    void storeLiterals(size_t nWords, const W* literals)
+    {
+      thisBlock->storeLiterals(nWords, literals);
+      LOGP(debug, "StoreLiterals {} bytes, offs: {}:{}", nWords * sizeof(W), thisBlock->getOffsLiterals(), thisBlock->getOffsLiterals() + nWords * sizeof(W));
+    }
+    void storeData(size_t nWords, const W* data) { thisBlock->storeData(nWords, data); }
+  } sink{&mBlocks[slot], &mMetadata[slot], buffer, slot};
+
+  const bool interleaved = mANSHeader.isInterleaved(); // must be queried before "this" can be invalidated by the sink
+  const auto md = encodeToSink(srcBegin, srcEnd, interleaved, symbolTablePrecision, opt, sink, encoderExt, memfc);
+  *sink.thisMetadata = md;
+  if (md.messageLength == 0) {
+    return {};
+  }
+  return {0, md.getUncompressedSize(), md.getCompressedSize()};
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename input_IT>
+PreparedBlock<W> EncodedBlocks<H, N, W>::prepareBlock(const input_IT srcBegin, const input_IT srcEnd, const ANSHeader& ansHeader, uint8_t symbolTablePrecision,
+                                                      Metadata::OptStore opt, const void* encoderExt, float memfc)
+{
+  // the message is encoded to the vectors of the image, which are sized as the block of the container would be
+  struct ImageSink {
+    PreparedBlock<W>& block;
+
+    void reserve(size_t) {}
+    void storeDict(size_t nWords, const W* dict) { block.dict.assign(dict, dict + nWords); }
+    W* createData(size_t nWords, size_t& capacity)
+    {
+      block.data.resize(nWords);
+      capacity = nWords;
+      return block.data.data();
+    }
+    void setNData(size_t nWords) { block.data.resize(nWords); }
+    void storeLiterals(size_t nWords, const W* literals) { block.literals.assign(literals, literals + nWords); }
+    void storeData(size_t nWords, const W* data) { block.data.assign(data, data + nWords); }
+  };
+
+  PreparedBlock<W> block;
+  ImageSink sink{block};
+  block.metadata = encodeToSink(srcBegin, srcEnd, ansHeader.isInterleaved(), symbolTablePrecision, opt, sink, encoderExt, memfc);
+  return block;
+}
 
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename input_IT, typename sink_T>
+Metadata EncodedBlocks<H, N, W>::encodeToSink(const input_IT srcBegin, const input_IT srcEnd, bool interleaved, uint8_t symbolTablePrecision, Metadata::OptStore opt,
+                                              sink_T& sink, const void* encoderExt, float memfc)
+{
   using storageBuffer_t = W;
   using input_t = typename std::iterator_traits<input_IT>::value_type;
   using ransEncoder_t = typename rans::LiteralEncoder64<input_t>;
@@ -840,10 +979,6 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
   static_assert(std::is_same_v<storageBuffer_t, ransStream_t>);
   static_assert(std::is_same_v<storageBuffer_t, typename rans::count_t>);
 
-  // fill a new block
-  assert(slot == mRegistry.nFilledBlocks);
-  mRegistry.nFilledBlocks++;
-
   const size_t messageLength = std::distance(srcBegin, srcEnd);
   // cover three cases:
   // * empty source message: no entropy coding
@@ -852,29 +987,9 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
 
   // case 1: empty source message
   if (messageLength == 0) {
-    mMetadata[slot] = Metadata{0, 0, sizeof(input_t), sizeof(ransState_t), sizeof(ransStream_t), symbolTablePrecision, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
-    return {};
+    return Metadata{0, 0, sizeof(input_t), sizeof(ransState_t), sizeof(ransStream_t), symbolTablePrecision, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
   }
 
-  auto* thisBlock = &mBlocks[slot];
-  auto* thisMetadata = &mMetadata[slot];
-
-  // resize underlying buffer of block if necessary and update all pointers.
-  auto expandStorage = [&](int additionalElements) {
-    auto* const blockHead = get(thisBlock->registry->head);                         // extract pointer from the block, as "this" might be invalid
-    const size_t additionalSize = blockHead->estimateBlockSize(additionalElements); // size in bytes!!!
-    if (additionalSize >= thisBlock->registry->getFreeSize()) {
-      LOG(debug) << "Slot " << slot << ": free size: " << thisBlock->registry->getFreeSize() << ", need " << additionalSize << " for " << additionalElements << " words";
-      if (buffer) {
-        blockHead->expand(*buffer, blockHead->size() + (additionalSize - blockHead->getFreeSize()));
-        thisMetadata = &(get(buffer->data())->mMetadata[slot]);
-        thisBlock = &(get(buffer->data())->mBlocks[slot]); // in case of resizing this and any this.xxx becomes invalid
-      } else {
-        throw std::runtime_error("no room for encoded block in provided container");
-      }
-    }
-  };
-
   // case 3: message where entropy coding should be applied
   if (opt == Metadata::OptStore::EENCODE) {
     // build symbol statistics
@@ -896,24 +1011,21 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
     int dataSize = rans::calculateMaxBufferSize(messageLength, encoder->getAlphabetRangeBits(), sizeof(input_t)); // size in bytes
     // preliminary expansion of storage based on dict size + estimated size of encode buffer
     dataSize = SizeEstMarginAbs + int(SizeEstMarginRel * (dataSize / sizeof(storageBuffer_t))) + (sizeof(input_t) < sizeof(storageBuffer_t)); // size in words of output stream
-    expandStorage(frequencyTable.size() + dataSize);
+    sink.reserve(frequencyTable.size() + dataSize);
     // store dictionary first
     if (!frequencyTable.empty()) {
-      thisBlock->storeDict(frequencyTable.size(), frequencyTable.data());
-      LOGP(debug, "StoreDict {} bytes, offs: {}:{}", frequencyTable.size() * sizeof(W), thisBlock->getOffsDict(), thisBlock->getOffsDict() + frequencyTable.size() * sizeof(W));
+      sink.storeDict(frequencyTable.size(), frequencyTable.data());
     }
     // vector of incompressible literal symbols
     std::vector<input_t> literals;
-    // directly encode source message into block buffer.
-    storageBuffer_t* const blockBufferBegin = thisBlock->getCreateData();
-    const size_t maxBufferSize = thisBlock->registry->getFreeSize(); // note: "this" might be not valid after expandStorage call!!!
-    const auto encodedMessageEnd = encoder->process(srcBegin, srcEnd, blockBufferBegin, literals);
-    rans::utils::checkBounds(encodedMessageEnd, blockBufferBegin + maxBufferSize / sizeof(W));
-    dataSize = encodedMessageEnd - thisBlock->getDataPointer();
-    thisBlock->setNData(dataSize);
-    thisBlock->realignBlock();
-    LOGP(debug, "StoreData {} bytes, offs: {}:{}", dataSize * sizeof(W), thisBlock->getOffsData(), thisBlock->getOffsData() + dataSize * sizeof(W));
-    // update the size claimed by encode message directly inside the block
+    // directly encode source message into the data buffer of the sink
+    size_t maxDataSize = 0;
+    storageBuffer_t* const dataBegin = sink.createData(dataSize, maxDataSize);
+    const auto encodedMessageEnd = interleaved ? encoder->template process<ANSInterleavedStreams>(srcBegin, srcEnd, dataBegin, literals)
+                                               : encoder->process(srcBegin, srcEnd, dataBegin, literals);
+    rans::utils::checkBounds(encodedMessageEnd, dataBegin + maxDataSize);
+    dataSize = encodedMessageEnd - dataBegin;
+    sink.setNData(dataSize);
 
     // store incompressible symbols if any
     const size_t nLiteralSymbols = literals.size();
@@ -925,42 +1037,75 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
         literals.resize(nLiteralSymbolsPadded, {});
 
         const size_t nLiteralStorageElems = calculateNDestTElements<input_t, storageBuffer_t>(nSymbols);
-        expandStorage(nLiteralStorageElems);
-        thisBlock->storeLiterals(nLiteralStorageElems, reinterpret_cast<const storageBuffer_t*>(literals.data()));
-        LOGP(debug, "StoreLiterals {} bytes, offs: {}:{}", nLiteralStorageElems * sizeof(W), thisBlock->getOffsLiterals(), thisBlock->getOffsLiterals() + nLiteralStorageElems * sizeof(W));
+        sink.reserve(nLiteralStorageElems);
+        sink.storeLiterals(nLiteralStorageElems, reinterpret_cast<const storageBuffer_t*>(literals.data()));
         return nLiteralStorageElems;
       }
       return size_t(0);
     }();
 
-    *thisMetadata = Metadata{messageLength,
-                             nLiteralSymbols,
-                             sizeof(input_t),
-                             sizeof(ransState_t),
-                             sizeof(ransStream_t),
-                             static_cast<uint8_t>(encoder->getSymbolTablePrecision()),
-                             opt,
-                             encoder->getMinSymbol(),
-                             encoder->getMaxSymbol(),
-                             static_cast<int32_t>(frequencyTable.size()),
-                             dataSize,
-                             static_cast<int32_t>(nLiteralWords)};
-  } else { // store original data w/o EEncoding
-    // FIXME(milettri): we should be able to do without an intermediate vector;
-    //  provided iterator is not necessarily pointer, need to use intermediate vector!!!
-
-    // introduce padding in case literals don't align;
-    const size_t nSourceElemsPadded = calculatePaddedSize<input_t, storageBuffer_t>(messageLength);
-    std::vector<input_t> tmp(nSourceElemsPadded, {});
-    std::copy(srcBegin, srcEnd, std::begin(tmp));
-
-    const size_t nBufferElems = calculateNDestTElements<input_t, storageBuffer_t>(messageLength);
-    expandStorage(nBufferElems);
-    thisBlock->storeData(nBufferElems, reinterpret_cast<const storageBuffer_t*>(tmp.data()));
-
-    *thisMetadata = Metadata{messageLength, 0, sizeof(input_t), sizeof(ransState_t), sizeof(storageBuffer_t), symbolTablePrecision, opt, 0, 0, 0, static_cast<int>(nBufferElems), 0};
+    return Metadata{messageLength,
+                    nLiteralSymbols,
+                    sizeof(input_t),
+                    sizeof(ransState_t),
+                    sizeof(ransStream_t),
+                    static_cast<uint8_t>(encoder->getSymbolTablePrecision()),
+                    opt,
+                    encoder->getMinSymbol(),
+                    encoder->getMaxSymbol(),
+                    static_cast<int32_t>(frequencyTable.size()),
+                    dataSize,
+                    static_cast<int32_t>(nLiteralWords)};
   }
-  return {0, thisMetadata->getUncompressedSize(), thisMetadata->getCompressedSize()};
+  // case 2: store original data w/o EEncoding
+  // FIXME(milettri): we should be able to do without an intermediate vector;
+  //  provided iterator is not necessarily pointer, need to use intermediate vector!!!
+
+  // introduce padding in case literals don't align;
+  const size_t nSourceElemsPadded = calculatePaddedSize<input_t, storageBuffer_t>(messageLength);
+  std::vector<input_t> tmp(nSourceElemsPadded, {});
+  std::copy(srcBegin, srcEnd, std::begin(tmp));
+
+  const size_t nBufferElems = calculateNDestTElements<input_t, storageBuffer_t>(messageLength);
+  sink.reserve(nBufferElems);
+  sink.storeData(nBufferElems, reinterpret_cast<const storageBuffer_t*>(tmp.data()));
+
+  return Metadata{messageLength, 0, sizeof(input_t), sizeof(ransState_t), sizeof(storageBuffer_t), symbolTablePrecision, opt, 0, 0, 0, static_cast<int>(nBufferElems), 0};
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename buffer_T>
+o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::storeBlock(const PreparedBlock<W>& block, int slot, buffer_T* buffer)
+{
+  assert(slot == mRegistry.nFilledBlocks);
+  mRegistry.nFilledBlocks++;
+
+  const auto& md = block.metadata;
+  if (md.opt == Metadata::OptStore::NODATA) {
+    mMetadata[slot] = md;
+    return {};
+  }
+
+  // the size is known, expand the storage at most once
+  auto* thisBlock = &mBlocks[slot];
+  auto* thisMetadata = &mMetadata[slot];
+  const size_t nStored = block.dict.size() + block.data.size() + block.literals.size();
+  const size_t requiredSize = estimateBlockSize(nStored); // size in bytes!!!
+  if (requiredSize >= getFreeSize()) {
+    LOG(debug) << "Slot " << slot << ": free size: " << getFreeSize() << ", need " << requiredSize << " for " << nStored << " words";
+    if (buffer) {
+      expand(*buffer, size() + (requiredSize - getFreeSize()));
+      thisMetadata = &(get(buffer->data())->mMetadata[slot]);
+      thisBlock = &(get(buffer->data())->mBlocks[slot]); // in case of resizing this and any this.xxx becomes invalid
+    } else {
+      throw std::runtime_error("no room for encoded block in provided container");
+    }
+  }
+  thisBlock->store(block.dict.size(), block.data.size(), block.literals.size(),
+                   block.dict.empty() ? nullptr : block.dict.data(), block.data.empty() ? nullptr : block.data.data(), block.literals.data());
+  *thisMetadata = md;
+  return {0, md.getUncompressedSize(), md.getCompressedSize()};
 }
 
 /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
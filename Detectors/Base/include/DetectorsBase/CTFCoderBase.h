@@ -16,6 +16,8 @@
 #ifndef _ALICEO2_CTFCODER_BASE_H_
 #define _ALICEO2_CTFCODER_BASE_H_
 
+#include <array>
+#include <functional>
 #include <memory>
 #include <TFile.h>
 #include <TTree.h>
@@ -25,6 +27,7 @@
 #include "DetectorsCommonDataFormats/CTFDictHeader.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "DetectorsCommonDataFormats/CTFIOSize.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "rANS/rans.h"
 #include <filesystem>
 #include "Framework/InitContext.h"
@@ -104,6 +107,9 @@ class CTFCoderBase
   void setVerbosity(int v) { mVerbosity = v; }
   int getVerbosity() const { return mVerbosity; }
 
+  void setNThreads(int n) { mNThreads = n > 1 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
   const CTFDictHeader& getExtDictHeader() const { return mExtHeader; }
 
   template <typename T>
@@ -129,6 +135,19 @@ class CTFCoderBase
   std::string getPrefix() const { return o2::utils::Str::concat_string(mDet.getName(), "_CTF: "); }
 
   void checkDictVersion(const CTFDictHeader& h) const;
+
+  /// run task(i) for i in [0, nTasks) on up to mNThreads threads, the first exception thrown by a task is rethrown
+  void runConcurrently(int nTasks, const std::function<void(int)>& task) const;
+
+  /// entropy-encode the blocks concurrently, tasks[slot] provides the image of the block at slot. The images are stored
+  /// to the CTF in the buffer in the order of slots
+  template <typename CTF, typename BUF>
+  o2::ctf::CTFIOSize encodeBlocks(BUF& buffer, const std::array<std::function<typename CTF::preparedBlock_t()>, CTF::getNBlocks()>& tasks) const;
+
+  /// decode the blocks concurrently, tasks[slot] decodes the block at slot. Slots w/o task are skipped
+  template <typename CTF>
+  o2::ctf::CTFIOSize decodeBlocks(const std::array<std::function<o2::ctf::CTFIOSize()>, CTF::getNBlocks()>& tasks) const;
+
   std::vector<std::shared_ptr<void>> mCoders; // encoders/decoders
   DetID mDet;
   CTFDictHeader mExtHeader;      // external dictionary header
@@ -138,6 +157,7 @@ class CTFCoderBase
   OpType mOpType; // Encoder or Decoder
   size_t mIRFrameSelMarginBwd = 0; // margin in BC to add to the IRFrame lower boundary when selection is requested
   size_t mIRFrameSelMarginFwd = 0; // margin in BC to add to the IRFrame upper boundary when selection is requested
+  int mNThreads = 1;               // number of threads for concurrent encoding/decoding of the blocks
   int mVerbosity = 0;
 };
 
@@ -232,6 +252,9 @@ void CTFCoderBase::init(o2::framework::InitContext& ic)
   if (ic.options().hasOption("mem-factor")) {
     setMemMarginFactor(ic.options().get<float>("mem-factor"));
   }
+  if (ic.options().hasOption("ans-threads")) {
+    setNThreads(ic.options().get<int>("ans-threads"));
+  }
   if (ic.options().hasOption("irframe-margin-bwd")) {
     mIRFrameSelMarginBwd = ic.options().get<uint32_t>("irframe-margin-bwd");
   }
@@ -263,6 +286,44 @@ size_t CTFCoderBase::finaliseCTFOutput(BUF& buffer)
   return eeb->size();
 }
 
+///________________________________
+template <typename CTF, typename BUF>
+o2::ctf::CTFIOSize CTFCoderBase::encodeBlocks(BUF& buffer, const std::array<std::function<typename CTF::preparedBlock_t()>, CTF::getNBlocks()>& tasks) const
+{
+  constexpr int NBlocks = CTF::getNBlocks();
+  o2::ctf::CTFIOSize iosize;
+  if (mNThreads < 2) { // store every block as soon as it is ready, no need to keep all images in memory
+    for (int slot = 0; slot < NBlocks; slot++) {
+      iosize += CTF::get(buffer.data())->storeBlock(tasks[slot](), slot, &buffer);
+    }
+    return iosize;
+  }
+  std::array<typename CTF::preparedBlock_t, NBlocks> blocks;
+  runConcurrently(NBlocks, [&tasks, &blocks](int slot) { blocks[slot] = tasks[slot](); });
+  for (int slot = 0; slot < NBlocks; slot++) {
+    // at every storage the buffer might be autoexpanded, so we don't work with fixed pointer
+    iosize += CTF::get(buffer.data())->storeBlock(blocks[slot], slot, &buffer);
+  }
+  return iosize;
+}
+
+///________________________________
+template <typename CTF>
+o2::ctf::CTFIOSize CTFCoderBase::decodeBlocks(const std::array<std::function<o2::ctf::CTFIOSize()>, CTF::getNBlocks()>& tasks) const
+{
+  std::array<o2::ctf::CTFIOSize, CTF::getNBlocks()> sizes{};
+  runConcurrently(CTF::getNBlocks(), [&tasks, &sizes](int slot) {
+    if (tasks[slot]) {
+      sizes[slot] = tasks[slot]();
+    }
+  });
+  o2::ctf::CTFIOSize iosize;
+  for (const auto& sz : sizes) {
+    iosize += sz;
+  }
+  return iosize;
+}
+
 ///________________________________
 template <typename CTF>
 bool CTFCoderBase::finaliseCCDB(o2::framework::ConcreteDataMatcher& matcher, void* obj)
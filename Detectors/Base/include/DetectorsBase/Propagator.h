@@ -27,6 +27,10 @@
 #ifndef GPUCA_GPUCODE
 #include <string>
 #endif
+#if !defined(GPUCA_STANDALONE) && !defined(GPUCA_GPUCODE)
+#include <vector>
+#include <gsl/span>
+#endif
 
 namespace o2
 {
@@ -71,6 +75,7 @@ class PropagatorImpl
 
   static constexpr float MAX_SIN_PHI = 0.85f;
   static constexpr float MAX_STEP = 2.0f;
+  static constexpr int BATCH_SIZE = 32; ///< number of tracks propagated together by the batch methods
 
   GPUd() bool PropagateToXBxByBz(TrackParCov_t& track, value_type x,
                                  value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
@@ -115,6 +120,19 @@ class PropagatorImpl
                                    gpu::gpustd::array<value_type, 2>* dca = nullptr, track::TrackLTIntegral* tofInfo = nullptr,
                                    int signCorr = 0, value_type maxD = 999.f) const;
 
+#if !defined(GPUCA_STANDALONE) && !defined(GPUCA_GPUCODE)
+  // Batch versions of PropagateToXBxByBz and propagateToX, bringing all tracks to the same X.
+  // The result for each track is the same as with the single track method, its success flag is stored in ok.
+  // If not empty, tofInfo must have the same size as tracks. Return the number of successfully propagated tracks.
+  int PropagateToXBxByBz(gsl::span<TrackParCov_t> tracks, value_type x, std::vector<bool>& ok,
+                         value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                         gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0) const;
+
+  int propagateToX(gsl::span<TrackParCov_t> tracks, value_type x, value_type bZ, std::vector<bool>& ok,
+                   value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                   gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0) const;
+#endif
+
   PropagatorImpl(PropagatorImpl const&) = delete;
   PropagatorImpl(PropagatorImpl&&) = delete;
   PropagatorImpl& operator=(PropagatorImpl const&) = delete;
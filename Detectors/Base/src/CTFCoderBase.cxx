@@ -17,6 +17,11 @@
 #include "Framework/ControlService.h"
 #include "Framework/ProcessingContext.h"
 #include "Framework/InputRecord.h"
+#include <exception>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::ctf;
 using namespace o2::framework;
@@ -51,3 +56,23 @@ void CTFCoderBase::updateTimeDependentParams(ProcessingContext& pc)
     pc.inputs().get<std::vector<char>*>("ctfdict"); // just to trigger the finaliseCCDB
   }
 }
+
+void CTFCoderBase::runConcurrently(int nTasks, const std::function<void(int)>& task) const
+{
+  std::vector<std::exception_ptr> errors(nTasks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int i = 0; i < nTasks; i++) {
+    try {
+      task(i);
+    } catch (...) { // exceptions must not escape the parallel region
+      errors[i] = std::current_exception();
+    }
+  }
+  for (const auto& err : errors) {
+    if (err) {
+      std::rethrow_exception(err);
+    }
+  }
+}
@@ -0,0 +1,456 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PropagatorBatch.cxx
+/// \brief Propagation of batches of tracks to the same X
+/// Kept apart from Propagator.cxx, which is also compiled for the GPU, so that this file can be
+/// compiled with the options allowing the vectorisation of the track loops (see CMakeLists.txt)
+
+#include "DetectorsBase/Propagator.h"
+#include "GPUCommonMath.h"
+#include "MathUtils/Utils.h"
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+
+using namespace o2::base;
+using namespace o2::gpu;
+
+// the transport loop is also compiled for AVX2, the version to use is chosen at run time
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define O2_PROPAGATOR_BATCH_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define O2_PROPAGATOR_BATCH_CLONES
+#endif
+
+namespace o2::base
+{
+namespace
+{
+/// Block of tracks in the structure of arrays layout, used by the batch propagation in the constant field
+template <typename value_T, int N>
+struct TrackBlockSoA {
+  using value_t = value_T;
+  int n = 0;
+  value_t x[N];
+  value_t par[track::kNParams][N];
+  value_t cov[track::kCovMatSize][N];
+  value_t chargeScale[N]; // 1 for charged tracks, 0 for neutral ones
+  value_t xStep[N];       // X at the end of the current step, equal to x for the tracks not propagated
+  value_t arcSin[N];      // sine of the angle traversed by the tracks needing the arc length for the Z update
+  int arcSign[N];         // 0 if the linear Z update was used, 2 for the arc, +-1 for the arc of a large rotation
+  int failed[N];          // set if the track could not be propagated to xStep
+  int badCov[N];          // set if a diagonal element of the covariance exceeds its limit
+  math_utils::Rotation2D<value_t> rot[N];
+
+  template <typename TR>
+  void load(int i, const TR& trc)
+  {
+    x[i] = trc.getX();
+    for (int k = 0; k < track::kNParams; k++) {
+      par[k][i] = trc.getParam(k);
+    }
+    for (int k = 0; k < track::kCovMatSize; k++) {
+      cov[k][i] = trc.getCov()[k];
+    }
+    chargeScale[i] = trc.getAbsCharge() ? 1.f : 0.f;
+    rot[i] = math_utils::Rotation2D<value_t>(trc.getAlpha());
+  }
+
+  template <typename TR>
+  void store(int i, TR& trc) const
+  {
+    trc.setX(x[i]);
+    for (int k = 0; k < track::kNParams; k++) {
+      trc.setParam(par[k][i], k);
+    }
+    for (int k = 0; k < track::kCovMatSize; k++) {
+      trc.setCov(cov[k][i], k);
+    }
+  }
+
+  math_utils::Point3D<value_t> getXYZGlo(int i) const
+  {
+    return rot[i](math_utils::Point3D<value_t>(x[i], par[track::kY][i], par[track::kZ][i]));
+  }
+
+  void transport(value_t b);
+  void checkCovariance(int i);
+};
+
+//_______________________________________________________________________
+template <typename value_T, int N>
+O2_PROPAGATOR_BATCH_CLONES void TrackBlockSoA<value_T, N>::transport(value_t b)
+{
+  // Equivalent of the TrackParametrizationWithError::propagateTo(xStep, b) for all tracks of the block,
+  // the failed ones and those with xStep == x are left unchanged.
+  // The loop over the tracks has no branches, the Z update of the large steps, which needs asin, is done
+  // in a separate loop.
+  using namespace o2::constants::math;
+  using namespace o2::track;
+  for (int i = 0; i < n; i++) {
+    value_t dx = xStep[i] - x[i];
+    value_t crv = chargeScale[i] * par[kQ2Pt][i] * b * B2C;
+    value_t x2r = crv * dx;
+    value_t f1 = par[kSnp][i], f2 = f1 + x2r;
+    value_t r1 = gpu::CAMath::Sqrt((1.f - f1) * (1.f + f1));
+    value_t r2 = gpu::CAMath::Sqrt((1.f - f2) * (1.f + f2));
+    bool skip = gpu::CAMath::Abs(dx) < Almost0;
+    bool bad = (gpu::CAMath::Abs(f1) > Almost1) | (gpu::CAMath::Abs(f2) > Almost1) | !(gpu::CAMath::Abs(r1) >= Almost0) | !(gpu::CAMath::Abs(r2) >= Almost0);
+    bool upd = !skip & !bad;
+    failed[i] = !skip & bad;
+
+    double dy2dx = (f1 + f2) / (r1 + r2);
+    value_t dY = dx * dy2dx;
+    value_t dZ = dx * (r2 + f2 * dy2dx) * par[kTgl][i];
+    bool arc = upd & (gpu::CAMath::Abs(x2r) >= 0.05f);
+    bool large = (f1 * f1 + f2 * f2 > 1.f) & (f1 * f2 < 0.f); // special cases of large rotations or large abs angles
+    arcSin[i] = r1 * f2 - r2 * f1;
+    arcSign[i] = arc ? (large ? (f2 > 0.f ? 1 : -1) : 2) : 0;
+
+    value_t yNew = par[kY][i] + dY, zNew = par[kZ][i] + dZ, snpNew = par[kSnp][i] + x2r;
+    x[i] = upd ? xStep[i] : x[i];
+    par[kY][i] = upd ? yNew : par[kY][i];
+    par[kZ][i] = (upd & !arc) ? zNew : par[kZ][i];
+    par[kSnp][i] = upd ? snpNew : par[kSnp][i];
+
+    value_t c20 = cov[kSigSnpY][i], c21 = cov[kSigSnpZ][i], c22 = cov[kSigSnp2][i], c30 = cov[kSigTglY][i], c31 = cov[kSigTglZ][i];
+    value_t c32 = cov[kSigTglSnp][i], c33 = cov[kSigTgl2][i], c40 = cov[kSigQ2PtY][i], c41 = cov[kSigQ2PtZ][i], c42 = cov[kSigQ2PtSnp][i];
+    value_t c43 = cov[kSigQ2PtTgl][i], c44 = cov[kSigQ2Pt2][i];
+
+    // evaluate matrix in double prec.
+    double rinv = 1. / r1;
+    double r3inv = rinv * rinv * rinv;
+    double f24 = dx * b * B2C; // x2r/mP[kQ2Pt];
+    double f02 = dx * r3inv;
+    double f04 = 0.5 * f24 * f02;
+    double f12 = f02 * par[kTgl][i] * f1;
+    double f14 = 0.5 * f24 * f12; // 0.5*f24*f02*getTgl()*f1;
+    double f13 = dx * rinv;
+
+    // b = C*ft
+    double b00 = f02 * c20 + f04 * c40, b01 = f12 * c20 + f14 * c40 + f13 * c30;
+    double b02 = f24 * c40;
+    double b10 = f02 * c21 + f04 * c41, b11 = f12 * c21 + f14 * c41 + f13 * c31;
+    double b12 = f24 * c41;
+    double b20 = f02 * c22 + f04 * c42, b21 = f12 * c22 + f14 * c42 + f13 * c32;
+    double b22 = f24 * c42;
+    double b40 = f02 * c42 + f04 * c44, b41 = f12 * c42 + f14 * c44 + f13 * c43;
+    double b42 = f24 * c44;
+    double b30 = f02 * c32 + f04 * c43, b31 = f12 * c32 + f14 * c43 + f13 * c33;
+    double b32 = f24 * c43;
+
+    // a = f*b = f*C*ft
+    double a00 = f02 * b20 + f04 * b40, a01 = f02 * b21 + f04 * b41, a02 = f02 * b22 + f04 * b42;
+    double a11 = f12 * b21 + f14 * b41 + f13 * b31, a12 = f12 * b22 + f14 * b42 + f13 * b32;
+    double a22 = f24 * b42;
+
+    // F*C*Ft = C + (b + bt + a), diagonal elements are forced to be positive
+    value_t n00 = gpu::CAMath::Abs(value_t(cov[kSigY2][i] + (b00 + b00 + a00)));
+    value_t n10 = cov[kSigZY][i] + (b10 + b01 + a01);
+    value_t n20 = c20 + (b20 + b02 + a02);
+    value_t n30 = c30 + b30;
+    value_t n40 = c40 + b40;
+    value_t n11 = gpu::CAMath::Abs(value_t(cov[kSigZ2][i] + (b11 + b11 + a11)));
+    value_t n21 = c21 + (b21 + b12 + a12);
+    value_t n31 = c31 + b31;
+    value_t n41 = c41 + b41;
+    value_t n22 = gpu::CAMath::Abs(value_t(c22 + (b22 + b22 + a22)));
+    value_t n32 = c32 + b32;
+    value_t n42 = c42 + b42;
+    value_t n33 = gpu::CAMath::Abs(c33), n44 = gpu::CAMath::Abs(c44);
+
+    cov[kSigY2][i] = upd ? n00 : cov[kSigY2][i];
+    cov[kSigZY][i] = upd ? n10 : cov[kSigZY][i];
+    cov[kSigZ2][i] = upd ? n11 : cov[kSigZ2][i];
+    cov[kSigSnpY][i] = upd ? n20 : c20;
+    cov[kSigSnpZ][i] = upd ? n21 : c21;
+    cov[kSigSnp2][i] = upd ? n22 : c22;
+    cov[kSigTglY][i] = upd ? n30 : c30;
+    cov[kSigTglZ][i] = upd ? n31 : c31;
+    cov[kSigTglSnp][i] = upd ? n32 : c32;
+    cov[kSigTgl2][i] = upd ? n33 : c33;
+    cov[kSigQ2PtY][i] = upd ? n40 : c40;
+    cov[kSigQ2PtZ][i] = upd ? n41 : c41;
+    cov[kSigQ2PtSnp][i] = upd ? n42 : c42;
+    cov[kSigQ2Pt2][i] = upd ? n44 : c44;
+    badCov[i] = upd & ((n00 > kCY2max) | (n11 > kCZ2max) | (n22 > kCSnp2max) | (n33 > kCTgl2max) | (n44 > kC1Pt2max));
+  }
+
+  // for large dx/R the linear approximation of the arc by the segment is not precise enough for Z,
+  // use the traversed angle, see TrackParametrizationWithError::propagateTo
+  for (int i = 0; i < n; i++) {
+    if (!arcSign[i]) {
+      continue;
+    }
+    value_t rot = gpu::CAMath::ASin(arcSin[i]);
+    if (arcSign[i] == 1) {
+      rot = PI - rot;
+    } else if (arcSign[i] == -1) {
+      rot = -PI - rot;
+    }
+    value_t crv = chargeScale[i] * par[kQ2Pt][i] * b * B2C;
+    value_t dZ = par[kTgl][i] / crv * rot;
+    par[kZ][i] += dZ;
+  }
+}
+
+//_______________________________________________________________________
+template <typename value_T, int N>
+void TrackBlockSoA<value_T, N>::checkCovariance(int i)
+{
+  // limit the diagonal elements as TrackParametrizationWithError::checkCovariance, which is rarely needed
+  using namespace o2::track;
+  auto clamp = [this, i](int diag, value_t maxVal, std::initializer_list<int> offDiag) {
+    if (cov[diag][i] > maxVal) {
+      value_t scl = gpu::CAMath::Sqrt(maxVal / cov[diag][i]);
+      cov[diag][i] = maxVal;
+      for (auto k : offDiag) {
+        cov[k][i] *= scl;
+      }
+    }
+  };
+  clamp(kSigY2, kCY2max, {kSigZY, kSigSnpY, kSigTglY, kSigQ2PtY});
+  clamp(kSigZ2, kCZ2max, {kSigZY, kSigSnpZ, kSigTglZ, kSigQ2PtZ});
+  clamp(kSigSnp2, kCSnp2max, {kSigSnpY, kSigSnpZ, kSigTglSnp, kSigQ2PtSnp});
+  clamp(kSigTgl2, kCTgl2max, {kSigTglY, kSigTglZ, kSigTglSnp, kSigQ2PtTgl});
+  clamp(kSigQ2Pt2, kC1Pt2max, {kSigQ2PtY, kSigQ2PtZ, kSigQ2PtSnp, kSigQ2PtTgl});
+}
+} // namespace
+} // namespace o2::base
+
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::propagateToX(gsl::span<TrackParCov_t> tracks, value_type xToGo, value_type bZ, std::vector<bool>& ok,
+                                          value_type maxSnp, value_type maxStep, PropagatorImpl<value_T>::MatCorrType matCorr,
+                                          gsl::span<track::TrackLTIntegral> tofInfo, int signCorr) const
+{
+  //----------------------------------------------------------------
+  //
+  // Propagates the tracks to the plane X=xToGo (cm) in the constant field bZ,
+  // correcting for the crossed material.
+  //
+  // The tracks are processed in blocks of BATCH_SIZE stored as structure of arrays.
+  // All tracks of the block make their steps together: the transport of the parameters
+  // and covariance is done for all of them in a vectorisable loop, then the material
+  // budgets of the step are queried in a row. The material correction itself is applied
+  // by the track (it depends on its PID).
+  //----------------------------------------------------------------
+  const value_type Epsilon = 0.00001;
+  int nTracks = tracks.size(), nOK = 0;
+  bool fillLT = !tofInfo.empty();
+  ok.clear();
+  ok.resize(nTracks, false);
+  TrackBlockSoA<value_type, BATCH_SIZE> blk;
+  std::array<math_utils::Point3D<value_type>, BATCH_SIZE> xyz0;
+  std::array<MatBudget, BATCH_SIZE> mb;
+  std::array<int, BATCH_SIZE> dir, sCorr;
+  std::array<uint8_t, BATCH_SIZE> active;
+
+  for (int first = 0; first < nTracks; first += BATCH_SIZE) {
+    blk.n = std::min(BATCH_SIZE, nTracks - first);
+    int nActive = blk.n;
+    for (int i = 0; i < blk.n; i++) {
+      blk.load(i, tracks[first + i]);
+      dir[i] = xToGo - blk.x[i] > 0.f ? 1 : -1;
+      sCorr[i] = signCorr ? signCorr : -dir[i]; // sign of eloss correction is not imposed
+      active[i] = 1;
+    }
+    while (nActive) {
+      for (int i = 0; i < blk.n; i++) {
+        blk.xStep[i] = blk.x[i];
+        if (!active[i]) {
+          continue;
+        }
+        auto dx = xToGo - blk.x[i];
+        if (math_utils::detail::abs<value_type>(dx) <= Epsilon) { // arrived
+          active[i] = 0;
+          nActive--;
+          blk.x[i] = xToGo;
+          ok[first + i] = true;
+          nOK++;
+          continue;
+        }
+        auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
+        blk.xStep[i] = blk.x[i] + (dir[i] < 0 ? -step : step);
+        xyz0[i] = blk.getXYZGlo(i);
+      }
+      if (!nActive) {
+        break;
+      }
+      blk.transport(bZ);
+      for (int i = 0; i < blk.n; i++) {
+        if (!active[i]) {
+          continue;
+        }
+        if (blk.badCov[i]) {
+          blk.checkCovariance(i);
+        }
+        if (blk.failed[i] || (maxSnp > 0 && math_utils::detail::abs<value_type>(blk.par[track::kSnp][i]) >= maxSnp)) {
+          active[i] = 0;
+          nActive--;
+        }
+      }
+      if (matCorr != MatCorrType::USEMatCorrNONE) {
+        for (int i = 0; i < blk.n; i++) { // query material for all tracks of the step
+          if (active[i]) {
+            mb[i] = getMatBudget(matCorr, xyz0[i], blk.getXYZGlo(i));
+          }
+        }
+      }
+      if (matCorr == MatCorrType::USEMatCorrNONE && !fillLT) {
+        continue;
+      }
+      for (int i = 0; i < blk.n; i++) {
+        if (!active[i]) {
+          continue;
+        }
+        auto& track = tracks[first + i];
+        blk.store(i, track);
+        if (matCorr != MatCorrType::USEMatCorrNONE) {
+          if (!track.correctForMaterial(mb[i].meanX2X0, mb[i].getXRho(sCorr[i]))) {
+            blk.load(i, track);
+            active[i] = 0;
+            nActive--;
+            continue;
+          }
+          if (fillLT) {
+            tofInfo[first + i].addStep(mb[i].length, track.getP2Inv()); // fill L,ToF info using already calculated step length
+            tofInfo[first + i].addX2X0(mb[i].meanX2X0);
+          }
+          blk.load(i, track);
+        } else { // if tofInfo filling was requested w/o material correction, we need to calculate the step lenght
+          auto xyz1 = blk.getXYZGlo(i);
+          math_utils::Vector3D<value_type> stepV(xyz1.X() - xyz0[i].X(), xyz1.Y() - xyz0[i].Y(), xyz1.Z() - xyz0[i].Z());
+          tofInfo[first + i].addStep(stepV.R(), track.getP2Inv());
+        }
+      }
+    }
+    for (int i = 0; i < blk.n; i++) {
+      blk.store(i, tracks[first + i]);
+    }
+  }
+  return nOK;
+}
+
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::PropagateToXBxByBz(gsl::span<TrackParCov_t> tracks, value_type xToGo, std::vector<bool>& ok,
+                                                value_type maxSnp, value_type maxStep, PropagatorImpl<value_T>::MatCorrType matCorr,
+                                                gsl::span<track::TrackLTIntegral> tofInfo, int signCorr) const
+{
+  //----------------------------------------------------------------
+  //
+  // Propagates the tracks to the plane X=xToGo (cm) taking into account
+  // all the three components of the magnetic field and correcting for the crossed material.
+  //
+  // The tracks are processed in blocks of BATCH_SIZE making their steps together,
+  // so that the field and material queries of the step are done in a row.
+  // The transport in the 3D field is done by the tracks.
+  //----------------------------------------------------------------
+  const value_type Epsilon = 0.00001;
+  int nTracks = tracks.size(), nOK = 0;
+  bool fillLT = !tofInfo.empty();
+  ok.clear();
+  ok.resize(nTracks, false);
+  std::array<math_utils::Point3D<value_type>, BATCH_SIZE> xyz0;
+  std::array<gpu::gpustd::array<value_type, 3>, BATCH_SIZE> b;
+  std::array<MatBudget, BATCH_SIZE> mb;
+  std::array<value_type, BATCH_SIZE> xStep;
+  std::array<int, BATCH_SIZE> dir, sCorr;
+  std::array<uint8_t, BATCH_SIZE> active;
+
+  for (int first = 0; first < nTracks; first += BATCH_SIZE) {
+    int n = std::min(BATCH_SIZE, nTracks - first), nActive = n;
+    for (int i = 0; i < n; i++) {
+      dir[i] = xToGo - tracks[first + i].getX() > 0.f ? 1 : -1;
+      sCorr[i] = signCorr ? signCorr : -dir[i]; // sign of eloss correction is not imposed
+      active[i] = 1;
+    }
+    while (nActive) {
+      for (int i = 0; i < n; i++) {
+        if (!active[i]) {
+          continue;
+        }
+        auto& track = tracks[first + i];
+        auto dx = xToGo - track.getX();
+        if (math_utils::detail::abs<value_type>(dx) <= Epsilon) { // arrived
+          track.setX(xToGo);
+          active[i] = 0;
+          nActive--;
+          ok[first + i] = true;
+          nOK++;
+          continue;
+        }
+        auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
+        xStep[i] = track.getX() + (dir[i] < 0 ? -step : step);
+        xyz0[i] = track.getXYZGlo();
+      }
+      for (int i = 0; i < n; i++) { // query field for all tracks of the step
+        if (active[i]) {
+          getFieldXYZ(xyz0[i], &b[i][0]);
+        }
+      }
+      for (int i = 0; i < n; i++) {
+        if (!active[i]) {
+          continue;
+        }
+        auto& track = tracks[first + i];
+        if (!track.propagateTo(xStep[i], b[i]) || (maxSnp > 0 && math_utils::detail::abs<value_type>(track.getSnp()) >= maxSnp)) {
+          active[i] = 0;
+          nActive--;
+        }
+      }
+      if (matCorr == MatCorrType::USEMatCorrNONE) {
+        if (fillLT) { // if tofInfo filling was requested w/o material correction, we need to calculate the step lenght
+          for (int i = 0; i < n; i++) {
+            if (active[i]) {
+              auto xyz1 = tracks[first + i].getXYZGlo();
+              math_utils::Vector3D<value_type> stepV(xyz1.X() - xyz0[i].X(), xyz1.Y() - xyz0[i].Y(), xyz1.Z() - xyz0[i].Z());
+              tofInfo[first + i].addStep(stepV.R(), tracks[first + i].getP2Inv());
+            }
+          }
+        }
+        continue;
+      }
+      for (int i = 0; i < n; i++) { // query material for all tracks of the step
+        if (active[i]) {
+          mb[i] = getMatBudget(matCorr, xyz0[i], tracks[first + i].getXYZGlo());
+        }
+      }
+      for (int i = 0; i < n; i++) {
+        if (!active[i]) {
+          continue;
+        }
+        auto& track = tracks[first + i];
+        if (!track.correctForMaterial(mb[i].meanX2X0, mb[i].getXRho(sCorr[i]))) {
+          active[i] = 0;
+          nActive--;
+          continue;
+        }
+        if (fillLT) {
+          tofInfo[first + i].addStep(mb[i].length, track.getP2Inv()); // fill L,ToF info using already calculated step length
+          tofInfo[first + i].addX2X0(mb[i].meanX2X0);
+          tofInfo[first + i].addXRho(mb[i].getXRho(sCorr[i]));
+        }
+      }
+    }
+  }
+  return nOK;
+}
+
+namespace o2::base
+{
+template int PropagatorImpl<float>::PropagateToXBxByBz(gsl::span<TrackParCov_t>, value_type, std::vector<bool>&, value_type, value_type, MatCorrType, gsl::span<track::TrackLTIntegral>, int) const;
+template int PropagatorImpl<float>::propagateToX(gsl::span<TrackParCov_t>, value_type, value_type, std::vector<bool>&, value_type, value_type, MatCorrType, gsl::span<track::TrackLTIntegral>, int) const;
+template int PropagatorImpl<double>::PropagateToXBxByBz(gsl::span<TrackParCov_t>, value_type, std::vector<bool>&, value_type, value_type, MatCorrType, gsl::span<track::TrackLTIntegral>, int) const;
+template int PropagatorImpl<double>::propagateToX(gsl::span<TrackParCov_t>, value_type, value_type, std::vector<bool>&, value_type, value_type, MatCorrType, gsl::span<track::TrackLTIntegral>, int) const;
+} // namespace o2::base
@@ -0,0 +1,76 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchPropagator.cxx
+/// \brief Benchmark of the propagation of tracks to the same X, one by one and in batches
+
+#include "benchmark/benchmark.h"
+#include "DetectorsBase/Propagator.h"
+#include <random>
+#include <vector>
+
+using namespace o2::base;
+using TrackParCov = o2::track::TrackParCov;
+
+std::vector<TrackParCov> generateTracks(int nTracks)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> x(70.f, 80.f), y(-5.f, 5.f), z(-50.f, 50.f), snp(-0.3f, 0.3f), tgl(-1.f, 1.f), q2pt(-3.f, 3.f);
+  std::vector<TrackParCov> tracks;
+  tracks.reserve(nTracks);
+  for (int i = 0; i < nTracks; i++) {
+    std::array<float, 5> par{y(gen), z(gen), snp(gen), tgl(gen), q2pt(gen)};
+    std::array<float, 15> cov{1e-2, 1e-4, 1e-2, 1e-5, 1e-5, 1e-4, 1e-5, 1e-5, 1e-6, 1e-4, 1e-5, 1e-5, 1e-6, 1e-6, 1e-3};
+    tracks.emplace_back(x(gen), 0.f, par, cov);
+  }
+  return tracks;
+}
+
+static void BM_PropagateSingle(benchmark::State& state)
+{
+  auto prop = PropagatorF::Instance(true);
+  prop->setBz(5.f);
+  auto tracks0 = generateTracks(state.range(0));
+  std::vector<TrackParCov> tracks;
+  for (auto _ : state) {
+    state.PauseTiming();
+    tracks = tracks0;
+    state.ResumeTiming();
+    int nOK = 0;
+    for (auto& trc : tracks) {
+      nOK += prop->propagateToX(trc, 10.f, prop->getNominalBz(), PropagatorF::MAX_SIN_PHI, PropagatorF::MAX_STEP, PropagatorF::MatCorrType::USEMatCorrNONE);
+    }
+    benchmark::DoNotOptimize(nOK);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_PropagateBatch(benchmark::State& state)
+{
+  auto prop = PropagatorF::Instance(true);
+  prop->setBz(5.f);
+  auto tracks0 = generateTracks(state.range(0));
+  std::vector<TrackParCov> tracks;
+  std::vector<bool> ok;
+  for (auto _ : state) {
+    state.PauseTiming();
+    tracks = tracks0;
+    state.ResumeTiming();
+    int nOK = prop->propagateToX(tracks, 10.f, prop->getNominalBz(), ok, PropagatorF::MAX_SIN_PHI, PropagatorF::MAX_STEP, PropagatorF::MatCorrType::USEMatCorrNONE);
+    benchmark::DoNotOptimize(nOK);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PropagateSingle)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK(BM_PropagateBatch)->RangeMultiplier(8)->Range(64, 32768);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,200 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testPropagatorBatch.cxx
+/// \brief Test the propagation of batches of tracks against the propagation track by track
+
+#define BOOST_TEST_MODULE Test Propagator batch
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <TGeoGlobalMagField.h>
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+#include "DetectorsBase/Propagator.h"
+#include "Field/MagneticField.h"
+#include "ReconstructionDataFormats/PID.h"
+#include "ReconstructionDataFormats/TrackLTIntegral.h"
+
+using namespace o2::base;
+using TrackParCov = o2::track::TrackParCov;
+using TrackLTIntegral = o2::track::TrackLTIntegral;
+using MatCorrType = PropagatorF::MatCorrType;
+
+namespace
+{
+
+/// Barrel of vacuum with a few cylindrical shells of material, the thick iron one
+/// stops the slow protons so that some tracks fail in the material correction
+void createGeometry()
+{
+  if (gGeoManager && gGeoManager->IsClosed()) {
+    return;
+  }
+  auto gm = new TGeoManager("PropagatorBatchTest", "Cylindrical shells");
+  auto vacuum = new TGeoMedium("Vacuum", 1, new TGeoMaterial("Vacuum", 0, 0, 0));
+  auto silicon = new TGeoMedium("Silicon", 2, new TGeoMaterial("Silicon", 28.09, 14, 2.33));
+  auto iron = new TGeoMedium("Iron", 3, new TGeoMaterial("Iron", 55.85, 26, 7.87));
+  auto aluminium = new TGeoMedium("Aluminium", 4, new TGeoMaterial("Aluminium", 26.98, 13, 2.7));
+  auto top = gm->MakeBox("World", vacuum, 300., 300., 300.);
+  gm->SetTopVolume(top);
+  top->AddNode(gm->MakeTube("Shell1", silicon, 5., 5.05, 100.), 1);
+  top->AddNode(gm->MakeTube("Shell2", silicon, 20., 20.3, 100.), 1);
+  top->AddNode(gm->MakeTube("Shell3", iron, 35., 50., 100.), 1);
+  top->AddNode(gm->MakeTube("Shell4", aluminium, 70., 72., 100.), 1);
+  gm->CloseGeometry();
+}
+
+PropagatorF* getPropagator()
+{
+  if (!TGeoGlobalMagField::Instance()->GetField()) {
+    TGeoGlobalMagField::Instance()->SetField(o2::field::MagneticField::createNominalField(5));
+    TGeoGlobalMagField::Instance()->Lock();
+  }
+  createGeometry();
+  return PropagatorF::Instance();
+}
+
+/// Tracks around the beam line, most of them going outward, some inward. The low momentum
+/// ones exceed the maximal sine of the track angle or cannot be transported to the end
+std::vector<TrackParCov> generateTracks(int nTracks)
+{
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> x(0.f, 90.f), y(-2.f, 2.f), z(-30.f, 30.f), snp(-0.5f, 0.5f), tgl(-1.f, 1.f), q2pt(-6.f, 6.f);
+  std::uniform_int_distribution<int> pid(0, 4);
+  std::vector<TrackParCov> tracks;
+  tracks.reserve(nTracks);
+  for (int i = 0; i < nTracks; i++) {
+    std::array<float, 5> par{y(gen), z(gen), snp(gen), tgl(gen), q2pt(gen)};
+    std::array<float, 15> cov{1e-2, 1e-4, 1e-2, 1e-5, 1e-5, 1e-4, 1e-5, 1e-5, 1e-6, 1e-4, 1e-5, 1e-5, 1e-6, 1e-6, 1e-3};
+    auto& trc = tracks.emplace_back(i % 5 ? 3.f : x(gen), 0.f, par, cov);
+    trc.setPID(pid(gen) ? o2::track::PID::Pion : o2::track::PID::Proton);
+  }
+  return tracks;
+}
+
+void checkClose(float val, float ref, float absTol)
+{
+  // the batch code is compiled with different options, allow for the rounding differences
+  BOOST_CHECK_SMALL(val - ref, 1.e-5f * std::abs(ref) + absTol);
+}
+
+void checkSameTracks(const std::vector<TrackParCov>& tracks, const std::vector<bool>& ok,
+                     const std::vector<TrackParCov>& refTracks, const std::vector<bool>& refOK)
+{
+  BOOST_REQUIRE_EQUAL(tracks.size(), refTracks.size());
+  int nOK = 0;
+  for (size_t i = 0; i < tracks.size(); i++) {
+    BOOST_CHECK_EQUAL(ok[i], refOK[i]);
+    checkClose(tracks[i].getX(), refTracks[i].getX(), 1.e-5f);
+    for (int k = 0; k < o2::track::kNParams; k++) {
+      checkClose(tracks[i].getParam(k), refTracks[i].getParam(k), 1.e-5f);
+    }
+    for (int k = 0; k < o2::track::kCovMatSize; k++) {
+      checkClose(tracks[i].getCov()[k], refTracks[i].getCov()[k], 1.e-9f);
+    }
+    nOK += refOK[i];
+  }
+  // make sure both the successful and the failing propagations are tested
+  BOOST_CHECK(nOK > 0);
+  BOOST_CHECK(nOK < int(tracks.size()));
+}
+
+void checkSameLT(const std::vector<TrackLTIntegral>& lt, const std::vector<TrackLTIntegral>& refLT)
+{
+  BOOST_REQUIRE_EQUAL(lt.size(), refLT.size());
+  for (size_t i = 0; i < lt.size(); i++) {
+    checkClose(lt[i].getL(), refLT[i].getL(), 1.e-5f);
+    checkClose(lt[i].getX2X0(), refLT[i].getX2X0(), 1.e-7f);
+    checkClose(lt[i].getXRho(), refLT[i].getXRho(), 1.e-6f);
+    for (int id = 0; id < TrackLTIntegral::getNTOFs(); id++) {
+      checkClose(lt[i].getTOF(id), refLT[i].getTOF(id), 1.e-3f);
+    }
+  }
+}
+
+/// propagate the tracks one by one and in batch, with and without the integration of the length and time of flight
+template <typename SINGLE, typename BATCH>
+void checkBatch(SINGLE single, BATCH batch)
+{
+  // not a multiple of the batch size, to have an incomplete block
+  const int nTracks = 7 * PropagatorF::BATCH_SIZE + 5;
+  const auto tracks0 = generateTracks(nTracks);
+
+  for (bool fillLT : {false, true}) {
+    auto refTracks = tracks0;
+    std::vector<TrackLTIntegral> refLT(fillLT ? nTracks : 0);
+    std::vector<bool> refOK(nTracks);
+    int refNOK = 0;
+    for (int i = 0; i < nTracks; i++) {
+      refOK[i] = single(refTracks[i], fillLT ? &refLT[i] : nullptr);
+      refNOK += refOK[i];
+    }
+
+    auto tracks = tracks0;
+    std::vector<TrackLTIntegral> lt(fillLT ? nTracks : 0);
+    std::vector<bool> ok;
+    int nOK = batch(tracks, lt, ok);
+
+    BOOST_CHECK_EQUAL(nOK, refNOK);
+    BOOST_REQUIRE_EQUAL(ok.size(), size_t(nTracks));
+    checkSameTracks(tracks, ok, refTracks, refOK);
+    checkSameLT(lt, refLT);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PropagateToX_batch)
+{
+  const auto prop = getPropagator();
+  const float xToGo = 80.f, bZ = prop->getNominalBz();
+  for (auto matCorr : {MatCorrType::USEMatCorrNONE, MatCorrType::USEMatCorrTGeo}) {
+    checkBatch(
+      [&](TrackParCov& trc, TrackLTIntegral* lt) {
+        return prop->propagateToX(trc, xToGo, bZ, PropagatorF::MAX_SIN_PHI, PropagatorF::MAX_STEP, matCorr, lt);
+      },
+      [&](std::vector<TrackParCov>& trcs, std::vector<TrackLTIntegral>& lt, std::vector<bool>& ok) {
+        return prop->propagateToX(trcs, xToGo, bZ, ok, PropagatorF::MAX_SIN_PHI, PropagatorF::MAX_STEP, matCorr, lt);
+      });
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PropagateToXBxByBz_batch)
+{
+  const auto prop = getPropagator();
+  const float xToGo = 80.f;
+  for (auto matCorr : {MatCorrType::USEMatCorrNONE, MatCorrType::USEMatCorrTGeo}) {
+    checkBatch(
+      [&](TrackParCov& trc, TrackLTIntegral* lt) {
+        return prop->PropagateToXBxByBz(trc, xToGo, PropagatorF::MAX_SIN_PHI, PropagatorF::MAX_STEP, matCorr, lt);
+      },
+      [&](std::vector<TrackParCov>& trcs, std::vector<TrackLTIntegral>& lt, std::vector<bool>& ok) {
+        return prop->PropagateToXBxByBz(trcs, xToGo, ok, PropagatorF::MAX_SIN_PHI, PropagatorF::MAX_STEP, matCorr, lt);
+      });
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PropagateToX_emptyBatch)
+{
+  const auto prop = getPropagator();
+  std::vector<TrackParCov> tracks;
+  std::vector<bool> ok(3, true);
+  BOOST_CHECK_EQUAL(prop->propagateToX(tracks, 10.f, prop->getNominalBz(), ok), 0);
+  BOOST_CHECK(ok.empty());
+}
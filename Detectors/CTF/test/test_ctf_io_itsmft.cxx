@@ -142,3 +142,94 @@ BOOST_AUTO_TEST_CASE(CompressedClustersTest)
     BOOST_CHECK(pattVecD[i] == pattVec[i]);
   }
 }
+
+BOOST_AUTO_TEST_CASE(ConcurrentBlocksTest)
+{
+  std::vector<ROFRecord> rofRecVec;
+  std::vector<CompClusterExt> cclusVec;
+  std::vector<unsigned char> pattVec;
+  LookUp pattIdConverter;
+  for (int irof = 0; irof < 20; irof++) {
+    auto& rofr = rofRecVec.emplace_back();
+    rofr.getBCData().orbit = irof / 10;
+    rofr.getBCData().bc = irof % 10;
+    rofr.setFirstEntry(cclusVec.size());
+    int chipID = irof;
+    for (int i = 0; i < 100; i++) {
+      auto& cl = cclusVec.emplace_back(gRandom->Integer(512), gRandom->Integer(1024), gRandom->Integer(1000), chipID);
+      if (cl.getPatternID() > 900) {
+        pattVec.push_back(char(gRandom->Integer(256)));
+      }
+      chipID += gRandom->Poisson(2);
+    }
+    rofr.setNEntries(int(cclusVec.size()) - rofr.getFirstEntry());
+  }
+
+  std::vector<o2::ctf::BufferType> vecConcurrent;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder, o2::detectors::DetID::ITS);
+    coder.setNThreads(4);
+    coder.encode(vecConcurrent, rofRecVec, cclusVec, pattVec, pattIdConverter, 0);
+  }
+  auto* ctfConcurrent = o2::itsmft::CTF::get(vecConcurrent.data());
+
+  // the blocks encoded concurrently must be stored exactly as EncodedBlocks::encode writes them:
+  // decode the source of every block and encode it again directly to a new container
+  std::vector<o2::ctf::BufferType> vecEncode;
+  {
+    auto* ctfEncode = o2::itsmft::CTF::create(vecEncode);
+    ctfEncode->setHeader(ctfConcurrent->getHeader());
+    ctfEncode->setANSHeader(ctfConcurrent->getANSHeader());
+    auto reencode = [&vecEncode, ctfConcurrent](auto src, int slot) {
+      ctfConcurrent->decode(src, slot);
+      o2::itsmft::CTF::get(vecEncode.data())->encode(src, slot, 0, ctfConcurrent->getMetadata(slot).opt, &vecEncode);
+    };
+    reencode(std::vector<uint16_t>{}, o2::itsmft::CTF::BLCfirstChipROF);
+    reencode(std::vector<uint16_t>{}, o2::itsmft::CTF::BLCbcIncROF);
+    reencode(std::vector<uint32_t>{}, o2::itsmft::CTF::BLCorbitIncROF);
+    reencode(std::vector<uint32_t>{}, o2::itsmft::CTF::BLCnclusROF);
+    reencode(std::vector<uint16_t>{}, o2::itsmft::CTF::BLCchipInc);
+    reencode(std::vector<uint16_t>{}, o2::itsmft::CTF::BLCchipMul);
+    reencode(std::vector<uint16_t>{}, o2::itsmft::CTF::BLCrow);
+    reencode(std::vector<int16_t>{}, o2::itsmft::CTF::BLCcolInc);
+    reencode(std::vector<uint16_t>{}, o2::itsmft::CTF::BLCpattID);
+    reencode(std::vector<uint8_t>{}, o2::itsmft::CTF::BLCpattMap);
+  }
+  auto* ctfEncode = o2::itsmft::CTF::get(vecEncode.data());
+  for (int ib = 0; ib < o2::itsmft::CTF::getNBlocks(); ib++) {
+    const auto& mdEncode = ctfEncode->getMetadata(ib);
+    const auto& mdConcurrent = ctfConcurrent->getMetadata(ib);
+    BOOST_CHECK(mdEncode.messageLength == mdConcurrent.messageLength);
+    BOOST_CHECK(mdEncode.nLiterals == mdConcurrent.nLiterals);
+    BOOST_CHECK(mdEncode.probabilityBits == mdConcurrent.probabilityBits);
+    BOOST_CHECK(mdEncode.opt == mdConcurrent.opt);
+    BOOST_CHECK(mdEncode.min == mdConcurrent.min);
+    BOOST_CHECK(mdEncode.max == mdConcurrent.max);
+    BOOST_CHECK(mdEncode.nDictWords == mdConcurrent.nDictWords);
+    BOOST_CHECK(mdEncode.nDataWords == mdConcurrent.nDataWords);
+    BOOST_CHECK(mdEncode.nLiteralWords == mdConcurrent.nLiteralWords);
+    const auto& blEncode = ctfEncode->getBlock(ib);
+    const auto& blConcurrent = ctfConcurrent->getBlock(ib);
+    BOOST_REQUIRE(blEncode.getNDict() == blConcurrent.getNDict());
+    BOOST_REQUIRE(blEncode.getNData() == blConcurrent.getNData());
+    BOOST_REQUIRE(blEncode.getNLiterals() == blConcurrent.getNLiterals());
+    BOOST_CHECK(std::memcmp(blEncode.payload, blConcurrent.payload, blEncode.getNStored() * sizeof(*blEncode.payload)) == 0);
+  }
+
+  std::vector<ROFRecord> rofRecVecD;
+  std::vector<CompClusterExt> cclusVecD;
+  std::vector<unsigned char> pattVecD;
+  LookUp clPattLookup;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder, o2::detectors::DetID::ITS);
+    coder.setNThreads(4);
+    coder.decode(*ctfConcurrent, rofRecVecD, cclusVecD, pattVecD, nullptr, clPattLookup);
+  }
+  BOOST_REQUIRE(cclusVecD.size() == cclusVec.size());
+  for (size_t i = 0; i < cclusVec.size(); i++) {
+    BOOST_CHECK(cclusVecD[i].getChipID() == cclusVec[i].getChipID());
+    BOOST_CHECK(cclusVecD[i].getRow() == cclusVec[i].getRow());
+    BOOST_CHECK(cclusVecD[i].getCol() == cclusVec[i].getCol());
+  }
+  BOOST_CHECK(pattVecD == pattVec);
+}
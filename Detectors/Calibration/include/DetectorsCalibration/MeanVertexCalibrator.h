@@ -49,7 +49,7 @@ class MeanVertexCalibrator final : public o2::calibration::TimeSlotCalibration<o
     mBinWidthZInv = 1. / mBinWidthZ;
   }
 
-  ~MeanVertexCalibrator() final = default;
+  ~MeanVertexCalibrator() final { collectFinalizedSlots(true); }
 
   bool hasEnoughData(const Slot& slot) const final
   {
@@ -60,6 +60,9 @@ class MeanVertexCalibrator final : public o2::calibration::TimeSlotCalibration<o
   }
   void initOutput() final;
   void finalizeSlot(Slot& slot) final;
+  // the fits access only the slot, the moving average is updated in slot order
+  bool hasThreadSafeFinalization() const final { return true; }
+  std::function<void()> finalizeSlotAsync(Slot& slot) final;
   Slot& emplaceNewSlot(bool front, TFType tstart, TFType tend) final;
 
   uint64_t getNSlotsSMA() const { return mSMAslots; }
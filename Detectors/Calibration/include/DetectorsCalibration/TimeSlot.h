@@ -47,6 +47,9 @@ class TimeSlot
     return *this;
   }
 
+  TimeSlot(TimeSlot&& src) = default;
+  TimeSlot& operator=(TimeSlot&& src) = default;
+
   ~TimeSlot() = default;
 
   TFType getTFStart() const { return mTFStart; }
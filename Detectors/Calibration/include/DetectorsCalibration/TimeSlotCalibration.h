@@ -20,8 +20,12 @@
 #include "DetectorsBase/GRPGeomHelper.h"
 #include "CommonDataFormat/TFIDInfo.h"
 #include <TFile.h>
+#include <TROOT.h>
 #include <filesystem>
 #include <deque>
+#include <functional>
+#include <future>
+#include <memory>
 #include <gsl/gsl>
 #include <limits>
 #include <type_traits>
@@ -122,6 +126,30 @@ class TimeSlotCalibration
 
   virtual void print() const;
 
+  // Asynchronous finalization: slots to be finalized are moved out of the slots pool and
+  // processed by up to nThreads worker threads, while the following TFs are filling new slots.
+  // Used only if the derived class declares a thread-safe finalization, see below. The results
+  // are added to the output in the slot order, in process or checkSlotsToFinalize, once ready.
+  void setAsyncFinalization(int nThreads);
+  int getAsyncFinalizationThreads() const { return mAsyncNThreads; }
+  bool isAsyncFinalization() const { return mAsyncNThreads > 0 && hasThreadSafeFinalization(); }
+  int getNPendingSlots() const { return mPendingSlots.size(); }
+  // add the results of the finalized slots to the output, waiting for all the pending ones if requested
+  void collectFinalizedSlots(bool wait = false);
+
+  // Methods to be implemented by the derived user class supporting asynchronous finalization
+
+  // declare that finalizeSlotAsync can be run in a worker thread
+  virtual bool hasThreadSafeFinalization() const { return false; }
+  // process the time slot container, accessing only the slot, and return the callable adding the
+  // results to the output, which is invoked in the processing thread. The derived class must call
+  // collectFinalizedSlots(true) in its destructor, no worker may outlive it
+  virtual std::function<void()> finalizeSlotAsync(Slot& slot)
+  {
+    LOG(fatal) << "This method must be implemented by derived class declaring thread-safe finalization";
+    return {};
+  }
+
   const o2::dataformats::TFIDInfo& getCurrentTFInfo() const { return mCurrentTFInfo; }
   o2::dataformats::TFIDInfo& getCurrentTFInfo() { return mCurrentTFInfo; }
 
@@ -192,9 +220,18 @@ class TimeSlotCalibration
   }
 
   TFType tf2SlotMin(TFType tf) const;
+  // finalize the slot, in a worker thread if asynchronous finalization is used
+  void scheduleSlotFinalization(Slot& slot);
 
   std::deque<Slot> mSlots;
 
+  struct PendingSlot {
+    std::unique_ptr<Slot> slot;
+    std::future<std::function<void()>> result; // destroyed first, waiting for the worker to be done with the slot
+  };
+  std::deque<PendingSlot> mPendingSlots; //! slots being finalized asynchronously, in slot order
+  int mAsyncNThreads = 0;                //! number of threads for the asynchronous finalization, 0 = disabled
+
   o2::dataformats::TFIDInfo mCurrentTFInfo{};
   int mSlotLengthInSeconds = -1; // optionally provided slot length in seconds
   int mSlotLengthInOrbits = -1;  // optionally provided slot length in orbits
@@ -236,6 +273,10 @@ bool TimeSlotCalibration<Input, Container>::process(const DATA& data)
     checkSlotLength();
   }
 
+  if (!mPendingSlots.empty()) {
+    collectFinalizedSlots();
+  }
+
   // process current TF
   TFType tf = mCurrentTFInfo.tfCounter;
   uint64_t maxDelay64 = uint64_t(mSlotLength * mMaxSlotsDelay);
@@ -293,7 +334,7 @@ void TimeSlotCalibration<Input, Container>::checkSlotsToFinalize(TFType tf, int
         mSlots[0].setTFStart(mLastClosedTF);
         mSlots[0].setTFEnd(mMaxSeenTF);
         LOG(info) << "Finalizing slot for " << mSlots[0].getTFStart() << " <= TF <= " << mSlots[0].getTFEnd();
-        finalizeSlot(mSlots[0]);                  // will be removed after finalization
+        scheduleSlotFinalization(mSlots[0]);      // will be removed after finalization
         mLastClosedTF = mSlots[0].getTFEnd() < INFINITE_TF ? (mSlots[0].getTFEnd() + 1) : mSlots[0].getTFEnd() < INFINITE_TF; // will not accept any TF below this
         mSlots.erase(mSlots.begin());
         // creating a new slot if we are not at the end of run
@@ -317,7 +358,7 @@ void TimeSlotCalibration<Input, Container>::checkSlotsToFinalize(TFType tf, int
       if (tfLim < tf) {
         if (hasEnoughData(*slot)) {
           LOG(debug) << "Finalizing slot for " << slot->getTFStart() << " <= TF <= " << slot->getTFEnd();
-          finalizeSlot(*slot); // will be removed after finalization
+          scheduleSlotFinalization(*slot); // will be removed after finalization
         } else if ((slot + 1) != mSlots.end()) {
           LOG(info) << "Merging underpopulated slot " << slot->getTFStart() << " <= TF <= " << slot->getTFEnd()
                     << " to slot " << (slot + 1)->getTFStart() << " <= TF <= " << (slot + 1)->getTFEnd();
@@ -334,6 +375,63 @@ void TimeSlotCalibration<Input, Container>::checkSlotsToFinalize(TFType tf, int
       }
     }
   }
+  if (!mPendingSlots.empty()) {
+    collectFinalizedSlots(tf == INFINITE_TF); // at the end of run all the outputs must be ready
+  }
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::setAsyncFinalization(int nThreads)
+{
+  mAsyncNThreads = nThreads > 0 ? nThreads : 0;
+  if (mAsyncNThreads > 0) {
+    if (!hasThreadSafeFinalization()) {
+      LOG(warning) << "Asynchronous slot finalization requested, but the calibrator does not support it";
+      return;
+    }
+    ROOT::EnableThreadSafety(); // ROOT objects may be created by the finalization
+    LOG(info) << "Slots will be finalized asynchronously with " << mAsyncNThreads << " threads";
+  }
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::scheduleSlotFinalization(Slot& slot)
+{
+  if (!isAsyncFinalization()) {
+    finalizeSlot(slot);
+    return;
+  }
+  // bound the number of slots being finalized, waiting for the oldest
+  collectFinalizedSlots();
+  while (mPendingSlots.size() >= size_t(mAsyncNThreads)) {
+    mPendingSlots.front().result.wait();
+    collectFinalizedSlots();
+  }
+  // the slot is going to be erased from the pool, the worker takes over its content,
+  // the moved-from slot keeps only its TF range
+  auto& pending = mPendingSlots.emplace_back();
+  pending.slot = std::make_unique<Slot>(std::move(slot));
+  pending.result = std::async(std::launch::async, [this, ptr = pending.slot.get()]() { return finalizeSlotAsync(*ptr); });
+}
+
+//_________________________________________________
+template <typename Input, typename Container>
+void TimeSlotCalibration<Input, Container>::collectFinalizedSlots(bool wait)
+{
+  // outputs are added in the slot order, a slot finalized faster waits for the older ones
+  while (!mPendingSlots.empty()) {
+    auto& pending = mPendingSlots.front();
+    if (!wait && pending.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      break;
+    }
+    auto addOutput = pending.result.get();
+    if (addOutput) {
+      addOutput();
+    }
+    mPendingSlots.pop_front();
+  }
 }
 
 //_________________________________________________
@@ -345,6 +443,7 @@ void TimeSlotCalibration<Input, Container>::finalizeOldestSlot()
     LOG(warning) << "There are no slots defined";
     return;
   }
+  collectFinalizedSlots(true); // keep the outputs in the slot order
   finalizeSlot(mSlots.front());
   mLastClosedTF = mSlots.front().getTFEnd() + 1; // do not accept any TF below this
   mSlots.erase(mSlots.begin());
@@ -340,6 +340,14 @@ void MeanVertexCalibrator::fitMeanVertexCoord(int icoord, int nbins, float* arra
 
 //_____________________________________________
 void MeanVertexCalibrator::finalizeSlot(Slot& slot)
+{
+  if (auto addOutput = finalizeSlotAsync(slot)) {
+    addOutput();
+  }
+}
+
+//_____________________________________________
+std::function<void()> MeanVertexCalibrator::finalizeSlotAsync(Slot& slot)
 {
   // Extract results for the single slot
   o2::calibration::MeanVertexData* c = slot.getContainer();
@@ -348,31 +356,33 @@ void MeanVertexCalibrator::finalizeSlot(Slot& slot)
   MeanVertexObject mvo;
   // fitting
   if (!fitMeanVertex(c, mvo)) {
-    return;
+    return {};
   }
-  mTmpMVobjDqTime.emplace_back(slot.getStartTimeMS(), slot.getEndTimeMS());
-  // now we add the object to the deque
-  mTmpMVobjDq.push_back(std::move(mvo));
+  slot.print();
 
-  // moving average
-  doSimpleMovingAverage(mTmpMVobjDq, mSMAMVobj);
+  return [this, mvo = std::move(mvo), startTime = slot.getStartTimeMS(), endTime = slot.getEndTimeMS()]() mutable {
+    mTmpMVobjDqTime.emplace_back(startTime, endTime);
+    // now we add the object to the deque
+    mTmpMVobjDq.push_back(std::move(mvo));
 
-  if (mTmpMVobjDqTime.size() > mSMAslots) {
-    mTmpMVobjDqTime.pop_front();
-  }
-  long startValidity = (mTmpMVobjDqTime.front().getMin() + mTmpMVobjDqTime.back().getMax()) / 2;
-  LOG(info) << "start validity = " << startValidity;
-  std::map<std::string, std::string> md;
-  auto clName = o2::utils::MemFileHelper::getClassName(mSMAMVobj);
-  auto flName = o2::ccdb::CcdbApi::generateFileName(clName);
-  mInfoVector.emplace_back("GLO/Calib/MeanVertex", clName, flName, md, startValidity - 10 * o2::ccdb::CcdbObjectInfo::SECOND, startValidity + o2::ccdb::CcdbObjectInfo::MONTH);
-  mMeanVertexVector.emplace_back(mSMAMVobj);
-  if (mVerbose) {
-    LOG(info) << "Printing MeanVertex Object:";
-    mSMAMVobj.print();
-  }
+    // moving average
+    doSimpleMovingAverage(mTmpMVobjDq, mSMAMVobj);
 
-  slot.print();
+    if (mTmpMVobjDqTime.size() > mSMAslots) {
+      mTmpMVobjDqTime.pop_front();
+    }
+    long startValidity = (mTmpMVobjDqTime.front().getMin() + mTmpMVobjDqTime.back().getMax()) / 2;
+    LOG(info) << "start validity = " << startValidity;
+    std::map<std::string, std::string> md;
+    auto clName = o2::utils::MemFileHelper::getClassName(mSMAMVobj);
+    auto flName = o2::ccdb::CcdbApi::generateFileName(clName);
+    mInfoVector.emplace_back("GLO/Calib/MeanVertex", clName, flName, md, startValidity - 10 * o2::ccdb::CcdbObjectInfo::SECOND, startValidity + o2::ccdb::CcdbObjectInfo::MONTH);
+    mMeanVertexVector.emplace_back(mSMAMVobj);
+    if (mVerbose) {
+      LOG(info) << "Printing MeanVertex Object:";
+      mSMAMVobj.print();
+    }
+  };
 }
 
 //_____________________________________________
@@ -0,0 +1,172 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTimeSlotCalibration.cxx
+/// \brief Test the asynchronous finalization of the time slots against the synchronous one
+
+#define BOOST_TEST_MODULE Test TimeSlotCalibration
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+#include "DetectorsCalibration/TimeSlotCalibration.h"
+
+using namespace o2::calibration;
+
+namespace
+{
+
+/// sum of the values filled in a slot
+struct SumData {
+  int entries = 0;
+  double sum = 0.;
+
+  void fill(const std::vector<double>& data)
+  {
+    for (auto v : data) {
+      sum += v;
+    }
+    entries += data.size();
+  }
+  void merge(const SumData* prev)
+  {
+    entries += prev->entries;
+    sum += prev->sum;
+  }
+  void print() const { LOG(info) << "entries: " << entries << ", sum: " << sum; }
+};
+
+struct SumOutput {
+  TFType tfStart = 0;
+  TFType tfEnd = 0;
+  int entries = 0;
+  double mean = 0.;
+
+  bool operator==(const SumOutput& other) const
+  {
+    return tfStart == other.tfStart && tfEnd == other.tfEnd && entries == other.entries && mean == other.mean;
+  }
+};
+
+/// calibrator producing the mean of the values of every slot, its finalization can run in a worker thread
+class SumCalibrator final : public TimeSlotCalibration<double, SumData>
+{
+  using Slot = TimeSlot<SumData>;
+
+ public:
+  SumCalibrator(int minEntries) : mMinEntries(minEntries) {}
+  ~SumCalibrator() final { collectFinalizedSlots(true); }
+
+  void initOutput() final { mOutputs.clear(); }
+  bool hasEnoughData(const Slot& slot) const final { return slot.getContainer()->entries >= mMinEntries; }
+  Slot& emplaceNewSlot(bool front, TFType tstart, TFType tend) final
+  {
+    auto& cont = getSlots();
+    auto& slot = front ? cont.emplace_front(tstart, tend) : cont.emplace_back(tstart, tend);
+    slot.setContainer(std::make_unique<SumData>());
+    return slot;
+  }
+  void finalizeSlot(Slot& slot) final { finalizeSlotAsync(slot)(); }
+  bool hasThreadSafeFinalization() const final { return true; }
+  std::function<void()> finalizeSlotAsync(Slot& slot) final
+  {
+    const auto* c = slot.getContainer();
+    SumOutput out{slot.getTFStart(), slot.getTFEnd(), c->entries, c->sum / c->entries};
+    // every other slot takes longer, so that the workers are done out of order
+    std::this_thread::sleep_for(std::chrono::milliseconds(mNFinalized++ % 2 ? 1 : 20));
+    return [this, out]() { mOutputs.push_back(out); };
+  }
+
+  const std::vector<SumOutput>& getOutputs() const { return mOutputs; }
+
+ private:
+  int mMinEntries = 0;
+  std::atomic<int> mNFinalized{0};
+  std::vector<SumOutput> mOutputs;
+};
+
+/// feed the TFs, slightly out of order, to the calibrator and close the run as the calibration devices do
+std::vector<SumOutput> runCalibration(int nThreads, bool finalizeWhenReady)
+{
+  SumCalibrator calib(50);
+  if (finalizeWhenReady) {
+    calib.setFinalizeWhenReady();
+  } else {
+    calib.setSlotLength(10);
+  }
+  calib.setAsyncFinalization(nThreads);
+  BOOST_CHECK(calib.isAsyncFinalization() == (nThreads > 0));
+  calib.initOutput();
+
+  constexpr TFType NTFs = 500;
+  std::vector<TFType> tfs(NTFs);
+  std::iota(tfs.begin(), tfs.end(), 0);
+  std::mt19937 gen(777);
+  for (TFType i = 0; i + 5 <= NTFs; i += 5) {
+    std::shuffle(tfs.begin() + i, tfs.begin() + i + 5, gen);
+  }
+  std::uniform_int_distribution<int> nValues(0, 10);
+  std::uniform_real_distribution<double> value(-1., 1.);
+  for (auto tf : tfs) {
+    std::vector<double> data(nValues(gen));
+    for (auto& v : data) {
+      v = value(gen);
+    }
+    calib.getCurrentTFInfo().tfCounter = tf;
+    calib.getCurrentTFInfo().firstTForbit = tf * 128;
+    calib.process(data);
+  }
+  // end of stream
+  calib.checkSlotsToFinalize(SumCalibrator::INFINITE_TF);
+  BOOST_CHECK_EQUAL(calib.getNPendingSlots(), 0);
+  return calib.getOutputs();
+}
+
+void checkSameOutputs(const std::vector<SumOutput>& outputs, const std::vector<SumOutput>& refOutputs)
+{
+  BOOST_REQUIRE_EQUAL(outputs.size(), refOutputs.size());
+  for (size_t i = 0; i < outputs.size(); i++) {
+    BOOST_CHECK_EQUAL(outputs[i].tfStart, refOutputs[i].tfStart);
+    BOOST_CHECK_EQUAL(outputs[i].tfEnd, refOutputs[i].tfEnd);
+    BOOST_CHECK(outputs[i] == refOutputs[i]);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TimeSlotCalibration_asyncFinalization)
+{
+  const auto refOutputs = runCalibration(0, false);
+  // some underpopulated slots are merged
+  BOOST_CHECK(refOutputs.size() > 10);
+  BOOST_CHECK(refOutputs.size() < 50);
+  for (int nThreads : {1, 3}) {
+    checkSameOutputs(runCalibration(nThreads, false), refOutputs);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TimeSlotCalibration_asyncFinalizationWhenReady)
+{
+  const auto refOutputs = runCalibration(0, true);
+  BOOST_CHECK(refOutputs.size() > 10);
+  for (int nThreads : {1, 3}) {
+    checkSameOutputs(runCalibration(nThreads, true), refOutputs);
+  }
+}
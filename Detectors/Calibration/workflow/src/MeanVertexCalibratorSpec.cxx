@@ -50,6 +50,7 @@ void MeanVertexCalibDevice::init(InitContext& ic)
   if (useVerboseMode) {
     mCalibrator->useVerboseMode(true);
   }
+  mCalibrator->setAsyncFinalization(ic.options().get<int>("finalize-threads"));
 }
 
 //_____________________________________________________________
@@ -138,7 +139,8 @@ DataProcessorSpec getMeanVertexCalibDeviceSpec()
     inputs,
     outputs,
     AlgorithmSpec{adaptFromTask<device>(ccdbRequest)},
-    Options{{"use-verbose-mode", VariantType::Bool, false, {"Use verbose mode"}}}};
+    Options{{"use-verbose-mode", VariantType::Bool, false, {"Use verbose mode"}},
+            {"finalize-threads", VariantType::Int, 0, {"Number of threads finalizing the slots asynchronously, 0 = in the processing thread"}}}};
 }
 
 } // namespace framework
@@ -161,10 +161,20 @@ class MinorAltroDecodingError
 /// the payload, altro header and RCU trailer contents.
 ///
 /// Based on AliAltroRawStreamV3 and AliCaloRawStreamV3 by C. Cheshkov
+///
+/// The channels, their bunches and the ADC samples are stored in flat
+/// buffers owned by the decoder, the bunches and the channels being views
+/// on them. The buffers keep their capacity between two pages, so that
+/// a decoder reused for many pages (see setRawReader) does not allocate
+/// memory once it has seen the largest page. The channels are valid until
+/// the next call to decode.
 
 class AltroDecoder
 {
  public:
+  /// \brief Constructor, the raw reader has to be set before decoding
+  AltroDecoder() = default;
+
   /// \brief Constructor
   /// \param reader Raw reader instance to be decoded
   AltroDecoder(RawReaderMemory& reader);
@@ -183,6 +193,10 @@ class AltroDecoder
   /// its bunches.
   void decode();
 
+  /// \brief Set the raw reader instance to be decoded
+  /// \param reader Raw reader instance, positioned on the page to be decoded
+  void setRawReader(RawReaderMemory& reader) { mRawReader = &reader; }
+
   /// \brief Get reference to the RCU trailer object
   /// \return const reference to the RCU trailer
   /// \throw AltroDecoderError with type RCU_TRAILER_ERROR if the RCU trailer was not initialized
@@ -211,13 +225,15 @@ class AltroDecoder
   /// In case of failure an exception is thrown.
   void checkRCUTrailer();
 
-  RawReaderMemory& mRawReader;                               ///< underlying raw reader
+  RawReaderMemory* mRawReader = nullptr;                     //!<! underlying raw reader
   RCUTrailer mRCUTrailer;                                    ///< RCU trailer
   std::vector<Channel> mChannels;                            ///< vector of channels in the raw stream
+  std::vector<Bunch> mBunches;                               //!<! bunches of all channels, viewed by the channels
+  std::vector<uint16_t> mSamples;                            //!<! 10-bit words of all channels, viewed by the bunches
   std::vector<MinorAltroDecodingError> mMinorDecodingErrors; ///< Container for minor (non-crashing) errors
   bool mChannelsInitialized = false;                         ///< check whether the channels are initialized
 
-  ClassDefNV(AltroDecoder, 1);
+  ClassDefNV(AltroDecoder, 2);
 };
 
 } // namespace emcal
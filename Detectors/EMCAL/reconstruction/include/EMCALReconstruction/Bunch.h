@@ -36,6 +36,10 @@ namespace emcal
 /// case the first value has to be mapped to the end timebin
 /// and the last value to the start timebin, still iterating
 /// only over the number of samples.
+///
+/// The ADC values are either owned by the bunch (addADC, initFromRange)
+/// or a view on a buffer owned by somebody else (setADCRange), as for the
+/// bunches created by the AltroDecoder which point to its sample buffer.
 class Bunch
 {
  public:
@@ -64,12 +68,22 @@ class Bunch
   /// the last entry is the one earliest in time.
   void initFromRange(gsl::span<uint16_t> range);
 
+  /// \brief Set the ADC values in the bunch as a view on an external range
+  /// \param range Range of ADC values, must stay valid as long as the bunch is used
+  ///
+  /// No copy is done, the ADC values owned by the bunch are discarded.
+  void setADCRange(gsl::span<const uint16_t> range)
+  {
+    mADC.clear();
+    mADCRange = range;
+  }
+
   /// \brief Get range of ADC values in the bunch
   /// \return ADC values in the bunch
   ///
   /// The ADC values are stored in reversed order in time. Therefore
   /// the last entry is the one earliest in time.
-  const std::vector<uint16_t>& getADC() const { return mADC; }
+  gsl::span<const uint16_t> getADC() const { return mADC.empty() ? mADCRange : gsl::span<const uint16_t>(mADC); }
 
   /// \brief Get the length of the bunch (number of time bins)
   /// \return Length of the bunch
@@ -101,11 +115,12 @@ class Bunch
   void setStartTime(uint8_t start) { mStartTime = start; }
 
  private:
-  uint8_t mBunchLength = 0;   ///< Number of ADC samples in buffer
-  uint8_t mStartTime = 0;     ///< Start timebin (larger time bin, samples are in reversed order)
-  std::vector<uint16_t> mADC; ///< ADC samples in bunch
+  uint8_t mBunchLength = 0;            ///< Number of ADC samples in buffer
+  uint8_t mStartTime = 0;              ///< Start timebin (larger time bin, samples are in reversed order)
+  std::vector<uint16_t> mADC;          ///< ADC samples in bunch
+  gsl::span<const uint16_t> mADCRange; //!<! ADC samples in an external buffer
 
-  ClassDefNV(Bunch, 1);
+  ClassDefNV(Bunch, 2);
 };
 
 } // namespace emcal
@@ -15,6 +15,7 @@
 #include <array>
 #include <optional>
 #include <string_view>
+#include <vector>
 #include <Rtypes.h>
 #include <gsl/span>
 #include "EMCALReconstruction/CaloFitResults.h"
@@ -67,6 +68,13 @@ class CaloRawFitter
   /// \return Number of error types (4)
   static constexpr int getNumberOfErrorTypes() noexcept { return 4; }
 
+  /// \struct BatchFitResults
+  /// \brief Outcome of the raw fit of one channel evaluated in a batch
+  struct BatchFitResults {
+    CaloFitResults mFitResults;             ///< Fit results, only valid if no error is set
+    std::optional<RawFitterError_t> mError; ///< Error of the raw fit of the channel
+  };
+
   /// \brief Constructor
   CaloRawFitter(const char* name, const char* nameshort);
 
@@ -75,6 +83,14 @@ class CaloRawFitter
 
   virtual CaloFitResults evaluate(const gsl::span<const Bunch> bunchvector) = 0;
 
+  /// \brief Evaluation of the bunches of many channels at once
+  /// \param bunchlists ALTRO bunches of each channel to be fitted
+  /// \param results Fit results or fit errors, one entry per channel in the order of bunchlists
+  ///
+  /// The default implementation evaluates the channels one by one. Fitters with a
+  /// batched implementation must give the same results as evaluate for each channel.
+  virtual void evaluateBatch(const gsl::span<const gsl::span<const Bunch>> bunchlists, std::vector<BatchFitResults>& results);
+
   /// \brief Method to do the selection of what should possibly be fitted.
   /// \param bunchvector ALTRO bunches for the current channel
   /// \param adcThreshold ADC threshold applied in peak finding
@@ -176,7 +192,36 @@ class CaloRawFitter
   int getMaxTimeIndex() const { return mMaxTimeIndex; }
 
  protected:
+  /// \struct PreFitResults
+  /// \brief Results of preFitEvaluateSamples for one channel
+  struct PreFitResults {
+    int mNsamples = 0;       ///< Size of the sub-selected sample
+    int mBunchIndex = -1;    ///< Index of the bunch with maximum signal
+    float mAmpEstimate = 0;  ///< Maximum signal (pedestal subtracted)
+    short mMaxADC = 0;       ///< Maximum ADC value
+    short mTimeEstimate = 0; ///< Index of the max. amplitude in the reversed sample
+    float mPedestal = 0;     ///< Pedestal
+    int mFirst = 0;          ///< First time bin of the peak region
+    int mLast = 0;           ///< Last time bin of the peak region
+    int mTimebinOffset = 0;  ///< Time bin of the first reversed sample of the selected bunch
+  };
+
+  /// \brief Pre-fit evaluation of a channel, see preFitEvaluateSamples
+  /// \param bunchvector ALTRO bunches for the current channel
+  /// \return Pre-fit results, the reversed samples are in mReversed
+  /// \throw RawFitterError_t in the same cases as preFitEvaluateSamples
+  PreFitResults preFitEvaluate(const gsl::span<const Bunch> bunchvector);
+
+  /// \brief Pre-fit evaluation of all channels of a batch
+  /// \param bunchlists ALTRO bunches of each channel in the batch
+  /// \param results Fit results of the batch, resized to the number of channels, errors of the pre-fit evaluation are set
+  ///
+  /// Fills mBatchPreFit and mBatchReversed (EMCAL_MAXTIMEBINS reversed samples per channel).
+  void preFitEvaluateBatch(const gsl::span<const gsl::span<const Bunch>> bunchlists, std::vector<BatchFitResults>& results);
+
   std::array<double, constants::EMCAL_MAXTIMEBINS> mReversed; ///< Reversed sequence of samples (pedestalsubtracted)
+  std::vector<PreFitResults> mBatchPreFit;                    //!<! Pre-fit results of the channels in the current batch
+  std::vector<double> mBatchReversed;                         //!<! Reversed samples of the channels in the current batch
 
   int mMinTimeIndex; ///< The timebin of the max signal value must be between fMinTimeIndex and fMaxTimeIndex
   int mMaxTimeIndex; ///< The timebin of the max signal value must be between fMinTimeIndex and fMaxTimeIndex
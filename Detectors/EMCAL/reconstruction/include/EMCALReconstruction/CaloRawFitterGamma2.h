@@ -15,6 +15,8 @@
 #include <iosfwd>
 #include <array>
 #include <optional>
+#include <tuple>
+#include <vector>
 #include <Rtypes.h>
 #include "EMCALReconstruction/CaloFitResults.h"
 #include "DataFormatsEMCAL/Constants.h"
@@ -60,9 +62,51 @@ class CaloRawFitterGamma2 final : public CaloRawFitter
   /// \return Container with the fit results (amp, time, chi2, ...)
   CaloFitResults evaluate(const gsl::span<const Bunch> bunchvector) final;
 
+  /// \brief Evaluation of Amplitude and TOF for many channels at once
+  /// \param bunchlists ALTRO bunches of each channel
+  /// \param results Fit results or fit errors, one entry per channel
+  ///
+  /// The channels which need a fit run the Newton iterations together,
+  /// one lane per channel, until all lanes converged or failed.
+  void evaluateBatch(const gsl::span<const gsl::span<const Bunch>> bunchlists, std::vector<BatchFitResults>& results) final;
+
  private:
+  /// \struct FitLanes
+  /// \brief Channels of a batch fitted together, one lane per channel
+  ///
+  /// Samples are stored time bin by time bin, so that one time bin of all
+  /// lanes is processed in one contiguous loop.
+  struct FitLanes {
+    enum class Status_t : uint8_t {
+      ACTIVE,    ///< Fit still iterating
+      CONVERGED, ///< Fit converged
+      FAILED     ///< Fit failed
+    };
+    std::vector<int> mChannel;     ///< Index of the channel in the batch
+    std::vector<int> mNsamples;    ///< Number of samples in the fit
+    std::vector<int> mNiter;       ///< Number of iterations
+    std::vector<Status_t> mStatus; ///< Fit status
+    std::vector<float> mAmp;       ///< Amplitude
+    std::vector<float> mTime;      ///< Time
+    std::vector<float> mChi2;      ///< Chi2 of the last iteration
+    std::vector<double> mSamples;  ///< Reversed samples, index [timebin * nlanes + lane]
+    std::vector<double> mC11;      ///< Matrix element c11 of the Newton step
+    std::vector<double> mC12;      ///< Matrix element c12 of the Newton step
+    std::vector<double> mC21;      ///< Matrix element c21 of the Newton step
+    std::vector<double> mC22;      ///< Matrix element c22 of the Newton step
+    std::vector<double> mD1;       ///< Residual term d1 of the Newton step
+    std::vector<double> mD2;       ///< Residual term d2 of the Newton step
+
+    /// \brief Remove all lanes
+    void clear();
+
+    /// \brief Add a lane for a channel
+    void addLane(int channel, int nsamples, float amp, float time);
+  };
+
   int mNiter = 0;           ///< number of iteraions
   int mNiterationsMax = 15; ///< max number of iteraions
+  FitLanes mLanes;          //!<! lanes of the batched fit
 
   /// \brief Fits the raw signal time distribution
   /// \param firstTimeBin First timebin in the ALTRO bunch
@@ -75,12 +119,29 @@ class CaloRawFitterGamma2 final : public CaloRawFitter
   /// \throw RawFitterError_t::FIT_ERROR in case of fit errors (insufficient number of time samples, matrix diagonalization error, ...)
   float doFit_1peak(int firstTimeBin, int nSamples, float& ampl, float& time);
 
+  /// \brief Newton iterations of doFit_1peak for all lanes of mLanes
+  ///
+  /// Each lane gives the same amplitude, time and chi2 as doFit_1peak for
+  /// the channel, lanes for which doFit_1peak throws end up FAILED.
+  void doFit_1peakLanes();
+
   /// \brief Fits the raw signal time distribution
+  /// \param reversed Reversed samples of the channel
   /// \param maxTimeBin Time bin of the max. amplitude
   /// \return the fit parameters: amplitude, time.
   ///
   /// Fit performed as parabola fit to the signal
-  std::tuple<float, float> doParabolaFit(int maxTimeBin) const;
+  static std::tuple<float, float> doParabolaFit(const gsl::span<const double> reversed, int maxTimeBin);
+
+  /// \brief Check whether the samples selected in the pre-fit evaluation are fitted
+  bool isFitRequired(const PreFitResults& prefit) const { return prefit.mBunchIndex >= 0 && prefit.mAmpEstimate >= mAmpCut && prefit.mNsamples > 2 && prefit.mMaxADC < constants::OVERFLOWCUT; }
+
+  /// \brief Create the fit results from the pre-fit evaluation and the fit
+  /// \param prefit Results of the pre-fit evaluation
+  /// \param fit Amplitude, time and chi2 of the peak fit, empty if the peak fit failed
+  /// \return Container with the fit results
+  /// \throw RawFitterError_t::FIT_ERROR if the amplitude is below the amplitude cut
+  CaloFitResults buildFitResults(const PreFitResults& prefit, const std::optional<std::tuple<float, float, float>>& fit) const;
 
   ClassDefNV(CaloRawFitterGamma2, 1);
 }; // End of CaloRawFitterGamma2
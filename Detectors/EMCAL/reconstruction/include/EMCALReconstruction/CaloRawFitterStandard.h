@@ -15,12 +15,15 @@
 #include <iosfwd>
 #include <array>
 #include <optional>
+#include <tuple>
+#include <vector>
 #include <Rtypes.h>
 #include "EMCALReconstruction/CaloFitResults.h"
 #include "DataFormatsEMCAL/Constants.h"
 #include "EMCALReconstruction/Bunch.h"
 #include "EMCALReconstruction/CaloRawFitter.h"
 
+class TF1;
 class TGraph;
 
 namespace o2
@@ -62,6 +65,14 @@ class CaloRawFitterStandard final : public CaloRawFitter
   /// \throw RawFitterError_t in case the fit failed (including all possible errors from upstream)
   CaloFitResults evaluate(const gsl::span<const Bunch> bunchvector) final;
 
+  /// \brief Evaluation of Amplitude and TOF for many channels at once
+  /// \param bunchlists Calo bunches of each channel
+  /// \param results Fit results or fit errors, one entry per channel
+  ///
+  /// The pre-fit evaluation runs for all channels first, the channels
+  /// which need a fit share one fit function and one graph.
+  void evaluateBatch(const gsl::span<const gsl::span<const Bunch>> bunchlists, std::vector<BatchFitResults>& results) final;
+
   /// \brief Fits the raw signal time distribution using TMinuit
   /// \param firstTimeBin First timebin of the ALTRO bunch
   /// \param lastTimeBin Last timebin of the ALTRO bunch
@@ -70,6 +81,25 @@ class CaloRawFitterStandard final : public CaloRawFitter
   std::tuple<float, float, float> fitRaw(int firstTimeBin, int lastTimeBin) const;
 
  private:
+  /// \brief Fits the raw signal time distribution using TMinuit
+  /// \param firstTimeBin First timebin of the ALTRO bunch
+  /// \param lastTimeBin Last timebin of the ALTRO bunch
+  /// \param signalGraph Graph to be filled with the samples, reset in the fit
+  /// \param signalFunction Response function, all parameters are reset before the fit
+  /// \return the fit parameters: amplitude, time, chi2
+  /// \throw RawFitter_t::FIT_ERROR in case the fit failed
+  std::tuple<float, float, float> fitRaw(int firstTimeBin, int lastTimeBin, TGraph& signalGraph, TF1& signalFunction) const;
+
+  /// \brief Check whether the samples selected in the pre-fit evaluation are fitted
+  bool isFitRequired(const PreFitResults& prefit) const { return prefit.mBunchIndex >= 0 && prefit.mAmpEstimate >= mAmpCut && prefit.mNsamples > 1 && prefit.mMaxADC < constants::OVERFLOWCUT; }
+
+  /// \brief Create the fit results from the pre-fit evaluation and the fit
+  /// \param prefit Results of the pre-fit evaluation
+  /// \param fit Amplitude, time and chi2 of the fit, empty if the fit was not done or failed
+  /// \return Container with the fit results
+  /// \throw RawFitterError_t::FIT_ERROR if the amplitude is below the amplitude cut
+  CaloFitResults buildFitResults(const PreFitResults& prefit, const std::optional<std::tuple<float, float, float>>& fit) const;
+
   ClassDefNV(CaloRawFitterStandard, 1);
 }; // End of CaloRawFitterStandard
 
@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <exception>
 #include <vector>
+#include <gsl/span>
 #include "Rtypes.h"
 #include "EMCALReconstruction/Bunch.h"
 
@@ -35,7 +36,10 @@ namespace emcal
 ///   as total number of 10-bit words
 /// - Channel status (good or bad)
 /// In addition it contains the data of all bunches in the
-/// raw stream.
+/// raw stream. The bunches are either owned by the channel
+/// (addBunch, createBunch) or a view on a buffer owned by
+/// somebody else (setBunchRange), as for the channels created
+/// by the AltroDecoder.
 ///
 /// The hardware address itself encods
 /// - Branch ID (bit 12)
@@ -99,7 +103,7 @@ class Channel
 
   /// \brief Get list of bunches in the channel
   /// \return List of bunches
-  const std::vector<Bunch>& getBunches() const { return mBunches; }
+  gsl::span<const Bunch> getBunches() const { return mBunches.empty() ? mBunchRange : gsl::span<const Bunch>(mBunches); }
 
   /// \brief Provide the branch index for the current hardware address
   /// \return RCU branch index (0 or 1)
@@ -146,6 +150,16 @@ class Channel
   /// \param starttime Start time of the bunch
   Bunch& createBunch(uint8_t bunchlength, uint8_t starttime);
 
+  /// \brief Set the bunches of the channel as a view on an external range
+  /// \param bunches Range of bunches, must stay valid as long as the channel is used
+  ///
+  /// No copy is done, the bunches owned by the channel are discarded.
+  void setBunchRange(gsl::span<const Bunch> bunches)
+  {
+    mBunches.clear();
+    mBunchRange = bunches;
+  }
+
   /// \brief Extrcting hardware address from the channel header word
   /// \param channelheader Channel header word
   static int getHardwareAddressFromChannelHeader(int channelheader) { return channelheader & 0xFFF; };
@@ -171,12 +185,13 @@ class Channel
   static int getChannelIndexFromHwAddress(int hwaddress) { return (hwaddress & 0xF); }
 
  private:
-  int32_t mHardwareAddress = -1; ///< Hardware address
-  uint16_t mPayloadSize = 0;     ///< Payload size
-  bool mBadChannel;              ///< Bad channel status
-  std::vector<Bunch> mBunches;   ///< Bunches in channel;
+  int32_t mHardwareAddress = -1;      ///< Hardware address
+  uint16_t mPayloadSize = 0;          ///< Payload size
+  bool mBadChannel;                   ///< Bad channel status
+  std::vector<Bunch> mBunches;        ///< Bunches in channel;
+  gsl::span<const Bunch> mBunchRange; //!<! Bunches in an external buffer
 
-  ClassDefNV(Channel, 1);
+  ClassDefNV(Channel, 2);
 };
 
 } // namespace emcal
@@ -19,7 +19,7 @@
 
 using namespace o2::emcal;
 
-AltroDecoder::AltroDecoder(RawReaderMemory& reader) : mRawReader(reader),
+AltroDecoder::AltroDecoder(RawReaderMemory& reader) : mRawReader(&reader),
                                                       mRCUTrailer(),
                                                       mChannels(),
                                                       mChannelsInitialized(false)
@@ -37,7 +37,7 @@ void AltroDecoder::decode()
 void AltroDecoder::readRCUTrailer()
 {
   try {
-    auto payloadwordsOrig = mRawReader.getPayload().getPayloadWords();
+    const auto& payloadwordsOrig = mRawReader->getPayload().getPayloadWords();
     gsl::span<const uint32_t> payloadwords(payloadwordsOrig.data(), payloadwordsOrig.size());
     mRCUTrailer.constructFromRawPayload(payloadwords);
   } catch (RCUTrailer::Error& e) {
@@ -50,7 +50,7 @@ void AltroDecoder::readRCUTrailer()
 void AltroDecoder::checkRCUTrailer()
 {
   int trailersize = mRCUTrailer.getTrailerSize();
-  int buffersize = mRawReader.getPayload().getPayloadWords().size();
+  int buffersize = mRawReader->getPayload().getPayloadWords().size();
   if (trailersize > buffersize) {
     throw AltroDecoderError(AltroDecoderError::ErrorType_t::RCU_TRAILER_SIZE_ERROR, (boost::format("Trailer size %d exceeding buffer size %d") % trailersize % buffersize).str().data());
   }
@@ -60,9 +60,17 @@ void AltroDecoder::readChannels()
 {
   mChannelsInitialized = false;
   mChannels.clear();
+  mBunches.clear();
+  mSamples.clear();
   int currentpos = 0;
-  auto& buffer = mRawReader.getPayload().getPayloadWords();
+  auto& buffer = mRawReader->getPayload().getPayloadWords();
   auto maxpayloadsize = buffer.size() - mRCUTrailer.getTrailerSize();
+  // Upper limits for the page: a channel needs at least one word and a bunch at least three
+  // 10-bit words (header and one sample). The buffers are therefore never reallocated while
+  // the channels and the bunches point into them.
+  mSamples.reserve(3 * maxpayloadsize);
+  mBunches.reserve(maxpayloadsize);
+  mChannels.reserve(maxpayloadsize);
   while (currentpos < maxpayloadsize) {
     auto currentword = buffer[currentpos++];
     if (currentword >> 30 != 1) {
@@ -78,7 +86,7 @@ void AltroDecoder::readChannels()
     /// decode all words for channel
     bool foundChannelError = false;
     int numberofwords = (payloadsize + 2) / 3;
-    std::vector<uint16_t> bunchwords;
+    auto channelstart = mSamples.size();
     for (int iword = 0; iword < numberofwords; iword++) {
       if (currentpos >= maxpayloadsize) {
         mMinorDecodingErrors.emplace_back(MinorAltroDecodingError::ErrorType_t::CHANNEL_PAYLOAD_EXCEED, channelheader, currentword);
@@ -93,22 +101,26 @@ void AltroDecoder::readChannels()
         currentpos--;
         continue;
       }
-      bunchwords.push_back((currentword >> 20) & 0x3FF);
-      bunchwords.push_back((currentword >> 10) & 0x3FF);
-      bunchwords.push_back(currentword & 0x3FF);
+      mSamples.push_back((currentword >> 20) & 0x3FF);
+      mSamples.push_back((currentword >> 10) & 0x3FF);
+      mSamples.push_back(currentword & 0x3FF);
     }
     if (foundChannelError) {
       // do not decode bunch if channel payload is corrupted
+      mSamples.resize(channelstart);
       continue;
     }
     // Payload decoding for channel good - starting a new channel object
     mChannels.emplace_back(hwaddress, payloadsize);
     auto& currentchannel = mChannels.back();
     currentchannel.setBadChannel(badchannel);
+    const uint16_t* bunchwords = mSamples.data() + channelstart;
+    unsigned long nbunchwords = mSamples.size() - channelstart;
+    auto firstbunch = mBunches.size();
 
     // decode bunches
     int currentsample = 0;
-    while (currentsample < currentchannel.getPayloadSize() && bunchwords.size() > currentsample + 2) {
+    while (currentsample < currentchannel.getPayloadSize() && nbunchwords > currentsample + 2) {
       // Check if bunch word is 0 - if yes skip all following bunches as they can no longer be reliably decoded
       if (bunchwords[currentsample] == 0) {
         mMinorDecodingErrors.emplace_back(MinorAltroDecodingError::ErrorType_t::BUNCH_HEADER_NULL, channelheader, 0);
@@ -117,7 +129,7 @@ void AltroDecoder::readChannels()
       int bunchlength = bunchwords[currentsample] - 2, // remove words for bunchlength and starttime
         starttime = bunchwords[currentsample + 1];
       // Raise minor decoding error in case the bunch length exceeds the channel payload and skip the bunch
-      if ((unsigned long)bunchlength > bunchwords.size() - currentsample - 2) {
+      if ((unsigned long)bunchlength > nbunchwords - currentsample - 2) {
         mMinorDecodingErrors.emplace_back(MinorAltroDecodingError::ErrorType_t::BUNCH_LENGTH_EXCEED, channelheader, 0);
         // we must break here as well, the bunch is cut and the pointer would be set to invalid memory
         break;
@@ -130,10 +142,11 @@ void AltroDecoder::readChannels()
         currentsample += bunchlength + 2;
         continue;
       }
-      auto& currentbunch = currentchannel.createBunch(bunchlength, starttime);
-      currentbunch.initFromRange(gsl::span<uint16_t>(&bunchwords[currentsample + 2], std::min((unsigned long)bunchlength, bunchwords.size() - currentsample - 2)));
+      auto& currentbunch = mBunches.emplace_back(bunchlength, starttime);
+      currentbunch.setADCRange(gsl::span<const uint16_t>(bunchwords + currentsample + 2, std::min((unsigned long)bunchlength, nbunchwords - currentsample - 2)));
       currentsample += bunchlength + 2;
     }
+    currentchannel.setBunchRange(gsl::span<const Bunch>(mBunches.data() + firstbunch, mBunches.size() - firstbunch));
   }
   mChannelsInitialized = true;
 }
@@ -11,7 +11,9 @@
 
 /// \file CaloRawFitter.cxx
 /// \author Hadi Hassan (hadi.hassan@cern.ch)
+#include <algorithm>
 #include <numeric>
+#include <tuple>
 #include <gsl/span>
 
 // ROOT sytem
@@ -171,7 +173,7 @@ std::tuple<short, int> CaloRawFitter::getMaxAmplitudeBunch(const Bunch& bunch) c
 {
   short maxADC = -1;
   int maxIndex = -1;
-  const std::vector<uint16_t>& sig = bunch.getADC();
+  auto sig = bunch.getADC();
 
   for (int i = 0; i < bunch.getBunchLength(); i++) {
     if (sig[i] > maxADC) {
@@ -187,7 +189,7 @@ bool CaloRawFitter::isMaxADCBunchEdge(const Bunch& bunch) const
 {
   short maxADC = -1;
   int indexMax = -1;
-  const std::vector<uint16_t>& sig = bunch.getADC();
+  auto sig = bunch.getADC();
 
   for (int i = 0; i < bunch.getBunchLength(); i++) {
     if (sig[i] > maxADC) {
@@ -294,7 +296,7 @@ std::tuple<int, int, float, short, short, float, int, int> CaloRawFitter::preFit
       // use more convenient numbering and possibly subtract pedestal
 
       int bunchlength = bunchvector[bunchindex].getBunchLength();
-      const std::vector<uint16_t>& sig = bunchvector[bunchindex].getADC();
+      auto sig = bunchvector[bunchindex].getADC();
 
       if (!mIsZerosupressed) {
         pedestal = evaluatePedestal(sig, bunchlength);
@@ -331,3 +333,45 @@ std::tuple<int, int, float, short, short, float, int, int> CaloRawFitter::preFit
 
   return std::make_tuple(nsamples, bunchindex, peakADC, adcMAX, indexMaxADCRReveresed, pedestal, first, last);
 }
+
+CaloRawFitter::PreFitResults CaloRawFitter::preFitEvaluate(const gsl::span<const Bunch> bunchvector)
+{
+  PreFitResults prefit;
+  std::tie(prefit.mNsamples, prefit.mBunchIndex, prefit.mAmpEstimate,
+           prefit.mMaxADC, prefit.mTimeEstimate, prefit.mPedestal, prefit.mFirst, prefit.mLast) = preFitEvaluateSamples(bunchvector, mAmpCut);
+  if (prefit.mBunchIndex >= 0) {
+    const auto& bunch = bunchvector[prefit.mBunchIndex];
+    prefit.mTimebinOffset = bunch.getStartTime() - (bunch.getBunchLength() - 1);
+  }
+  return prefit;
+}
+
+void CaloRawFitter::preFitEvaluateBatch(const gsl::span<const gsl::span<const Bunch>> bunchlists, std::vector<BatchFitResults>& results)
+{
+  results.clear();
+  results.resize(bunchlists.size());
+  mBatchPreFit.resize(bunchlists.size());
+  mBatchReversed.resize(bunchlists.size() * constants::EMCAL_MAXTIMEBINS);
+  for (std::size_t ichannel = 0; ichannel < bunchlists.size(); ichannel++) {
+    try {
+      mBatchPreFit[ichannel] = preFitEvaluate(bunchlists[ichannel]);
+    } catch (RawFitterError_t& error) {
+      results[ichannel].mError = error;
+    }
+    // mReversed is reset by the pre-fit evaluation also in case of errors
+    std::copy(mReversed.begin(), mReversed.end(), mBatchReversed.begin() + ichannel * constants::EMCAL_MAXTIMEBINS);
+  }
+}
+
+void CaloRawFitter::evaluateBatch(const gsl::span<const gsl::span<const Bunch>> bunchlists, std::vector<BatchFitResults>& results)
+{
+  results.clear();
+  results.resize(bunchlists.size());
+  for (std::size_t ichannel = 0; ichannel < bunchlists.size(); ichannel++) {
+    try {
+      results[ichannel].mFitResults = evaluate(bunchlists[ichannel]);
+    } catch (RawFitterError_t& error) {
+      results[ichannel].mError = error;
+    }
+  }
+}
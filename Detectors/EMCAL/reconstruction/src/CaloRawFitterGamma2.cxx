@@ -13,6 +13,7 @@
 /// \author Martin Poghosyan (Martin.Poghosyan@cern.ch)
 
 #include <fairlogger/Logger.h>
+#include <algorithm>
 #include <cfloat>
 #include <random>
 
@@ -33,47 +34,107 @@ CaloRawFitterGamma2::CaloRawFitterGamma2() : CaloRawFitter("Chi Square ( Gamma2
 }
 
 CaloFitResults CaloRawFitterGamma2::evaluate(const gsl::span<const Bunch> bunchlist)
+{
+  auto prefit = preFitEvaluate(bunchlist);
+
+  std::optional<std::tuple<float, float, float>> fit;
+  if (isFitRequired(prefit)) {
+    float amp(0.), time(0.);
+    std::tie(amp, time) = doParabolaFit(mReversed, prefit.mTimeEstimate - 1);
+    mNiter = 0;
+    try {
+      float chi2 = doFit_1peak(prefit.mFirst, prefit.mNsamples, amp, time);
+      fit = std::make_tuple(amp, time, chi2);
+    } catch (RawFitterError_t& e) {
+      // Fit has failed, values are set to the estimates
+    }
+  }
+  return buildFitResults(prefit, fit);
+}
+
+void CaloRawFitterGamma2::evaluateBatch(const gsl::span<const gsl::span<const Bunch>> bunchlists, std::vector<BatchFitResults>& results)
+{
+  preFitEvaluateBatch(bunchlists, results);
+
+  // one lane for each channel which needs a fit, in the order of the channels
+  mLanes.clear();
+  for (std::size_t ichannel = 0; ichannel < bunchlists.size(); ichannel++) {
+    const auto& prefit = mBatchPreFit[ichannel];
+    if (results[ichannel].mError || !isFitRequired(prefit)) {
+      continue;
+    }
+    gsl::span<const double> reversed(mBatchReversed.data() + ichannel * constants::EMCAL_MAXTIMEBINS, constants::EMCAL_MAXTIMEBINS);
+    auto [amp, time] = doParabolaFit(reversed, prefit.mTimeEstimate - 1);
+    mLanes.addLane(ichannel, std::min(prefit.mNsamples, constants::EMCAL_MAXTIMEBINS), amp, time);
+  }
+  const std::size_t nlanes = mLanes.mChannel.size();
+  mLanes.mSamples.resize(nlanes * constants::EMCAL_MAXTIMEBINS);
+  for (std::size_t lane = 0; lane < nlanes; lane++) {
+    const double* reversed = mBatchReversed.data() + mLanes.mChannel[lane] * constants::EMCAL_MAXTIMEBINS;
+    for (int itbin = 0; itbin < constants::EMCAL_MAXTIMEBINS; itbin++) {
+      mLanes.mSamples[itbin * nlanes + lane] = reversed[itbin];
+    }
+  }
+  doFit_1peakLanes();
+
+  std::size_t lane = 0;
+  for (std::size_t ichannel = 0; ichannel < bunchlists.size(); ichannel++) {
+    if (results[ichannel].mError) {
+      continue;
+    }
+    const auto& prefit = mBatchPreFit[ichannel];
+    std::optional<std::tuple<float, float, float>> fit;
+    if (isFitRequired(prefit)) {
+      if (mLanes.mStatus[lane] == FitLanes::Status_t::CONVERGED) {
+        fit = std::make_tuple(mLanes.mAmp[lane], mLanes.mTime[lane], mLanes.mChi2[lane]);
+      }
+      lane++;
+    }
+    try {
+      results[ichannel].mFitResults = buildFitResults(prefit, fit);
+    } catch (RawFitterError_t& error) {
+      results[ichannel].mError = error;
+    }
+  }
+}
+
+CaloFitResults CaloRawFitterGamma2::buildFitResults(const PreFitResults& prefit, const std::optional<std::tuple<float, float, float>>& fit) const
 {
   float time = 0;
   float amp = 0;
   float chi2 = 0;
   int ndf = 0;
   bool fitDone = false;
+  short timeEstimate = prefit.mTimeEstimate;
 
-  auto [nsamples, bunchIndex, ampEstimate,
-        maxADC, timeEstimate, pedEstimate, first, last] = preFitEvaluateSamples(bunchlist, mAmpCut);
-
-  if (bunchIndex >= 0 && ampEstimate >= mAmpCut) {
+  if (prefit.mBunchIndex >= 0 && prefit.mAmpEstimate >= mAmpCut) {
     time = timeEstimate;
-    int timebinOffset = bunchlist[bunchIndex].getStartTime() - (bunchlist[bunchIndex].getBunchLength() - 1);
-    amp = ampEstimate;
-
-    if (nsamples > 2 && maxADC < constants::OVERFLOWCUT) {
-      std::tie(amp, time) = doParabolaFit(timeEstimate - 1);
-      mNiter = 0;
-      try {
-        chi2 = doFit_1peak(first, nsamples, amp, time);
+    amp = prefit.mAmpEstimate;
+
+    if (isFitRequired(prefit)) {
+      if (fit) {
+        std::tie(amp, time, chi2) = *fit;
         fitDone = true;
-      } catch (RawFitterError_t& e) {
+      } else {
         // Fit has failed, set values to estimates
         // TODO: Check whether we want to include cases in which the peak fit failed
-        amp = ampEstimate;
+        amp = prefit.mAmpEstimate;
         time = timeEstimate;
         chi2 = 1.e9;
       }
 
-      time += timebinOffset;
-      timeEstimate += timebinOffset;
-      ndf = nsamples - 2;
+      time += prefit.mTimebinOffset;
+      timeEstimate += prefit.mTimebinOffset;
+      ndf = prefit.mNsamples - 2;
     }
   }
 
   if (fitDone) {
-    float ampAsymm = (amp - ampEstimate) / (amp + ampEstimate);
+    float ampAsymm = (amp - prefit.mAmpEstimate) / (amp + prefit.mAmpEstimate);
     float timeDiff = time - timeEstimate;
 
     if ((TMath::Abs(ampAsymm) > 0.1) || (TMath::Abs(timeDiff) > 2)) {
-      amp = ampEstimate;
+      amp = prefit.mAmpEstimate;
       time = timeEstimate;
       fitDone = false;
     }
@@ -87,7 +148,7 @@ CaloFitResults CaloRawFitterGamma2::evaluate(const gsl::span<const Bunch> bunchl
     time = time * constants::EMCAL_TIMESAMPLE;
     time -= mL1Phase;
 
-    return CaloFitResults(maxADC, pedEstimate, 0, amp, time, (int)time, chi2, ndf);
+    return CaloFitResults(prefit.mMaxADC, prefit.mPedestal, 0, amp, time, (int)time, chi2, ndf);
   }
   // Fit failed, rethrow error
   throw RawFitterError_t::FIT_ERROR;
@@ -157,26 +218,142 @@ float CaloRawFitterGamma2::doFit_1peak(int firstTimeBin, int nSamples, float& am
   return chi2;
 }
 
-std::tuple<float, float> CaloRawFitterGamma2::doParabolaFit(int maxTimeBin) const
+void CaloRawFitterGamma2::doFit_1peakLanes()
+{
+  using Status_t = FitLanes::Status_t;
+  const std::size_t nlanes = mLanes.mChannel.size();
+  int maxSamples = 0;
+  for (auto nsamples : mLanes.mNsamples) {
+    maxSamples = std::max(maxSamples, nsamples);
+  }
+
+  std::size_t nactive = nlanes;
+  while (nactive > 0) {
+    for (std::size_t lane = 0; lane < nlanes; lane++) {
+      if (mLanes.mStatus[lane] != Status_t::ACTIVE) {
+        continue;
+      }
+      if (mLanes.mNiter[lane] > mNiterationsMax) {
+        mLanes.mStatus[lane] = Status_t::FAILED;
+        nactive--;
+        continue;
+      }
+      mLanes.mNiter[lane]++;
+      mLanes.mC11[lane] = mLanes.mC12[lane] = mLanes.mC21[lane] = mLanes.mC22[lane] = 0.;
+      mLanes.mD1[lane] = mLanes.mD2[lane] = 0.;
+      mLanes.mChi2[lane] = 0.;
+    }
+
+    // same sums as in doFit_1peak, for one time bin of all lanes at a time
+    for (int itbin = 0; itbin < maxSamples; itbin++) {
+      const double* samples = mLanes.mSamples.data() + itbin * nlanes;
+      for (std::size_t lane = 0; lane < nlanes; lane++) {
+        if (mLanes.mStatus[lane] != Status_t::ACTIVE || itbin >= mLanes.mNsamples[lane]) {
+          continue;
+        }
+        double ti = (itbin - mLanes.mTime[lane]) / constants::TAU;
+        if ((ti + 1) < 0) {
+          continue;
+        }
+
+        float ampl = mLanes.mAmp[lane];
+        double g_1i = (ti + 1) * TMath::Exp(-2 * ti);
+        double g_i = (ti + 1) * g_1i;
+        double gp_i = 2 * (g_i - g_1i);
+        double q1_i = (2 * ti + 1) * TMath::Exp(-2 * ti);
+        double q2_i = g_1i * g_1i * (4 * ti + 1);
+        mLanes.mC11[lane] += (samples[lane] - ampl * 2 * g_i) * gp_i;
+        mLanes.mC12[lane] += g_i * g_i;
+        mLanes.mC21[lane] += samples[lane] * q1_i - ampl * q2_i;
+        mLanes.mC22[lane] += g_i * g_1i;
+        double delta = ampl * g_i - samples[lane];
+        mLanes.mD1[lane] += delta * g_i;
+        mLanes.mD2[lane] += delta * g_1i;
+        mLanes.mChi2[lane] += (delta * delta);
+      }
+    }
+
+    for (std::size_t lane = 0; lane < nlanes; lane++) {
+      if (mLanes.mStatus[lane] != Status_t::ACTIVE) {
+        continue;
+      }
+      double c11 = mLanes.mC11[lane], c12 = mLanes.mC12[lane], c21 = mLanes.mC21[lane], c22 = mLanes.mC22[lane],
+             d1 = mLanes.mD1[lane], d2 = mLanes.mD2[lane];
+      double D = c11 * c22 - c12 * c21;
+      if (TMath::Abs(D) < DBL_EPSILON) {
+        mLanes.mStatus[lane] = Status_t::FAILED;
+        nactive--;
+        continue;
+      }
+
+      double dt = (d1 * c22 - d2 * c12) / D * constants::TAU;
+      double dA = (d1 * c21 - d2 * c11) / D;
+
+      mLanes.mTime[lane] += dt;
+      mLanes.mAmp[lane] += dA;
+
+      if (!(TMath::Abs(dA) > 1 || TMath::Abs(dt) > 0.01)) {
+        mLanes.mStatus[lane] = Status_t::CONVERGED;
+        nactive--;
+      }
+    }
+  }
+}
+
+std::tuple<float, float> CaloRawFitterGamma2::doParabolaFit(const gsl::span<const double> reversed, int maxTimeBin)
 {
   float amp(0.), time(0.);
 
   // The equation of parabola is "y = a*x^2 + b*x + c"
   // We have to find "a", "b", and "c"
 
-  double a = (getReversed(maxTimeBin + 2) + getReversed(maxTimeBin) - 2. * getReversed(maxTimeBin + 1)) / 2.;
+  double a = (reversed[maxTimeBin + 2] + reversed[maxTimeBin] - 2. * reversed[maxTimeBin + 1]) / 2.;
 
   if (TMath::Abs(a) < DBL_EPSILON) {
-    amp = getReversed(maxTimeBin + 1);
+    amp = reversed[maxTimeBin + 1];
     time = maxTimeBin + 1;
     return std::make_tuple(amp, time);
   }
 
-  double b = getReversed(maxTimeBin + 1) - getReversed(maxTimeBin) - a * (2. * maxTimeBin + 1);
-  double c = getReversed(maxTimeBin) - b * maxTimeBin - a * maxTimeBin * maxTimeBin;
+  double b = reversed[maxTimeBin + 1] - reversed[maxTimeBin] - a * (2. * maxTimeBin + 1);
+  double c = reversed[maxTimeBin] - b * maxTimeBin - a * maxTimeBin * maxTimeBin;
 
   time = -b / 2. / a;
   amp = a * time * time + b * time + c;
 
   return std::make_tuple(amp, time);
 }
+
+void CaloRawFitterGamma2::FitLanes::clear()
+{
+  mChannel.clear();
+  mNsamples.clear();
+  mNiter.clear();
+  mStatus.clear();
+  mAmp.clear();
+  mTime.clear();
+  mChi2.clear();
+  mC11.clear();
+  mC12.clear();
+  mC21.clear();
+  mC22.clear();
+  mD1.clear();
+  mD2.clear();
+}
+
+void CaloRawFitterGamma2::FitLanes::addLane(int channel, int nsamples, float amp, float time)
+{
+  mChannel.emplace_back(channel);
+  mNsamples.emplace_back(nsamples);
+  mNiter.emplace_back(0);
+  mStatus.emplace_back(Status_t::ACTIVE);
+  mAmp.emplace_back(amp);
+  mTime.emplace_back(time);
+  mChi2.emplace_back(0.);
+  mC11.emplace_back(0.);
+  mC12.emplace_back(0.);
+  mC21.emplace_back(0.);
+  mC22.emplace_back(0.);
+  mD1.emplace_back(0.);
+  mD2.emplace_back(0.);
+}
@@ -13,6 +13,8 @@
 /// \author Hadi Hassan (hadi.hassan@cern.ch)
 
 #include <fairlogger/Logger.h>
+#include <algorithm>
+#include <array>
 #include <random>
 
 // ROOT sytem
@@ -51,38 +53,75 @@ double CaloRawFitterStandard::rawResponseFunction(double* x, double* par)
 }
 
 CaloFitResults CaloRawFitterStandard::evaluate(const gsl::span<const Bunch> bunchlist)
+{
+  auto prefit = preFitEvaluate(bunchlist);
+
+  std::optional<std::tuple<float, float, float>> fit;
+  if (isFitRequired(prefit)) {
+    try {
+      fit = fitRaw(prefit.mFirst, prefit.mLast);
+    } catch (RawFitterError_t& error) {
+    }
+  }
+  return buildFitResults(prefit, fit);
+}
+
+void CaloRawFitterStandard::evaluateBatch(const gsl::span<const gsl::span<const Bunch>> bunchlists, std::vector<BatchFitResults>& results)
+{
+  preFitEvaluateBatch(bunchlists, results);
+
+  // Fit function and graph are shared by all channels of the batch
+  TGraph gSig(constants::EMCAL_MAXTIMEBINS);
+  TF1 signalF("signal", CaloRawFitterStandard::rawResponseFunction, 0, constants::EMCAL_MAXTIMEBINS, 5);
+  for (std::size_t ichannel = 0; ichannel < bunchlists.size(); ichannel++) {
+    if (results[ichannel].mError) {
+      continue;
+    }
+    const auto& prefit = mBatchPreFit[ichannel];
+    std::optional<std::tuple<float, float, float>> fit;
+    if (isFitRequired(prefit)) {
+      auto reversed = mBatchReversed.begin() + ichannel * constants::EMCAL_MAXTIMEBINS;
+      std::copy(reversed, reversed + constants::EMCAL_MAXTIMEBINS, mReversed.begin());
+      try {
+        fit = fitRaw(prefit.mFirst, prefit.mLast, gSig, signalF);
+      } catch (RawFitterError_t& error) {
+      }
+    }
+    try {
+      results[ichannel].mFitResults = buildFitResults(prefit, fit);
+    } catch (RawFitterError_t& error) {
+      results[ichannel].mError = error;
+    }
+  }
+}
+
+CaloFitResults CaloRawFitterStandard::buildFitResults(const PreFitResults& prefit, const std::optional<std::tuple<float, float, float>>& fit) const
 {
   float time = 0;
   float amp = 0;
   float chi2 = 0;
   int ndf = 0;
   bool fitDone = kFALSE;
+  short timeEstimate = prefit.mTimeEstimate;
 
-  auto [nsamples, bunchIndex, ampEstimate,
-        maxADC, timeEstimate, pedEstimate, first, last] = preFitEvaluateSamples(bunchlist, mAmpCut);
-
-  if (bunchIndex >= 0 && ampEstimate >= mAmpCut) {
+  if (prefit.mBunchIndex >= 0 && prefit.mAmpEstimate >= mAmpCut) {
     time = timeEstimate;
-    int timebinOffset = bunchlist[bunchIndex].getStartTime() - (bunchlist[bunchIndex].getBunchLength() - 1);
-    amp = ampEstimate;
-
-    if (nsamples > 1 && maxADC < constants::OVERFLOWCUT) {
-      try {
-        std::tie(amp, time, chi2) = fitRaw(first, last);
-        time += timebinOffset;
-        timeEstimate += timebinOffset;
-        ndf = nsamples - 2;
-        fitDone = true;
-      } catch (RawFitterError_t& error) {
-      }
+    amp = prefit.mAmpEstimate;
+
+    if (fit) {
+      std::tie(amp, time, chi2) = *fit;
+      time += prefit.mTimebinOffset;
+      timeEstimate += prefit.mTimebinOffset;
+      ndf = prefit.mNsamples - 2;
+      fitDone = true;
     }
   }
   if (fitDone) {
-    float ampAsymm = (amp - ampEstimate) / (amp + ampEstimate);
+    float ampAsymm = (amp - prefit.mAmpEstimate) / (amp + prefit.mAmpEstimate);
     float timeDiff = time - timeEstimate;
 
     if ((TMath::Abs(ampAsymm) > 0.1) || (TMath::Abs(timeDiff) > 2)) {
-      amp = ampEstimate;
+      amp = prefit.mAmpEstimate;
       time = timeEstimate;
       fitDone = kFALSE;
     }
@@ -96,12 +135,19 @@ CaloFitResults CaloRawFitterStandard::evaluate(const gsl::span<const Bunch> bunc
     time = time * constants::EMCAL_TIMESAMPLE;
     time -= mL1Phase;
 
-    return CaloFitResults(maxADC, pedEstimate, 0, amp, time, (int)time, chi2, ndf);
+    return CaloFitResults(prefit.mMaxADC, prefit.mPedestal, 0, amp, time, (int)time, chi2, ndf);
   }
   throw RawFitterError_t::FIT_ERROR;
 }
 
 std::tuple<float, float, float> CaloRawFitterStandard::fitRaw(int firstTimeBin, int lastTimeBin) const
+{
+  TGraph gSig(std::max(lastTimeBin - firstTimeBin + 1, 0));
+  TF1 signalF("signal", CaloRawFitterStandard::rawResponseFunction, 0, constants::EMCAL_MAXTIMEBINS, 5);
+  return fitRaw(firstTimeBin, lastTimeBin, gSig, signalF);
+}
+
+std::tuple<float, float, float> CaloRawFitterStandard::fitRaw(int firstTimeBin, int lastTimeBin, TGraph& gSig, TF1& signalF) const
 {
 
   float amp(0), time(0), chi2(0);
@@ -111,16 +157,14 @@ std::tuple<float, float, float> CaloRawFitterStandard::fitRaw(int firstTimeBin,
     throw RawFitterError_t::FIT_ERROR;
   }
 
-  TGraph gSig(nsamples);
-
+  gSig.Set(nsamples);
   for (int i = 0; i < nsamples; i++) {
     int timebin = firstTimeBin + i;
     gSig.SetPoint(i, timebin, getReversed(timebin));
   }
 
-  TF1 signalF("signal", CaloRawFitterStandard::rawResponseFunction, 0, constants::EMCAL_MAXTIMEBINS, 5);
-
   signalF.SetParameters(10., 5., constants::TAU, constants::ORDER, 0.); // set all defaults once, just to be safe
+  signalF.SetParErrors(std::array<double, 5>{}.data());               // parameter errors of a previous fit would be used as step sizes
   signalF.SetParNames("amp", "t0", "tau", "N", "ped");
   signalF.FixParameter(2, constants::TAU);
   signalF.FixParameter(3, constants::ORDER);
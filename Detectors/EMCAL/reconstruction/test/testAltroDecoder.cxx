@@ -0,0 +1,285 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test EMCAL AltroDecoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <cstring>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <gsl/span>
+#include "Headers/RAWDataHeader.h"
+#include "DetectorsRaw/RDHUtils.h"
+#include "EMCALBase/RCUTrailer.h"
+#include "EMCALReconstruction/AltroDecoder.h"
+#include "EMCALReconstruction/RawReaderMemory.h"
+
+using namespace o2::emcal;
+
+namespace
+{
+
+struct TestBunch {
+  uint16_t mStartTime;
+  std::vector<uint16_t> mADC;
+};
+
+struct TestChannel {
+  int mHardwareAddress;
+  bool mBadChannel;
+  std::vector<TestBunch> mBunches;
+};
+
+/// Channel header followed by the 10-bit words of the channel, three per 32-bit word
+void encodeChannel(const TestChannel& channel, std::vector<uint32_t>& payload)
+{
+  std::vector<uint32_t> words;
+  for (const auto& bunch : channel.mBunches) {
+    words.push_back(bunch.mADC.size() + 2);
+    words.push_back(bunch.mStartTime);
+    words.insert(words.end(), bunch.mADC.begin(), bunch.mADC.end());
+  }
+  payload.push_back((1u << 30) | (channel.mBadChannel ? 1u << 29 : 0) | (words.size() << 16) | channel.mHardwareAddress);
+  while (words.size() % 3) {
+    words.push_back(0);
+  }
+  for (std::size_t iword = 0; iword < words.size(); iword += 3) {
+    payload.push_back((words[iword] << 20) | (words[iword + 1] << 10) | words[iword + 2]);
+  }
+}
+
+/// Random channels with up to three bunches each
+std::vector<TestChannel> createChannels(int nchannels, std::mt19937& generator)
+{
+  std::uniform_int_distribution<int> nbunchDist(1, 3), lengthDist(1, 5), adcDist(0, 1023);
+  std::vector<TestChannel> channels;
+  for (int ichannel = 0; ichannel < nchannels; ichannel++) {
+    auto& channel = channels.emplace_back(TestChannel{ichannel * 7 % 0x1000, ichannel % 5 == 0, {}});
+    int starttime = 14;
+    for (int ibunch = nbunchDist(generator); ibunch > 0 && starttime > 0; ibunch--) {
+      int length = std::min(lengthDist(generator), starttime + 1);
+      auto& bunch = channel.mBunches.emplace_back(TestBunch{static_cast<uint16_t>(starttime), {}});
+      for (int isample = 0; isample < length; isample++) {
+        bunch.mADC.push_back(adcDist(generator));
+      }
+      starttime -= length + 1;
+    }
+  }
+  return channels;
+}
+
+/// Raw page with RDH, ALTRO payload and RCU trailer
+std::vector<char> createPage(const std::vector<uint32_t>& altropayload, int feeID)
+{
+  RCUTrailer trailer;
+  trailer.setPayloadSize(altropayload.size());
+  trailer.setTimeSamplePhaseNS(0, 100);
+  trailer.setRCUID(feeID);
+  trailer.setFirmwareVersion(2);
+  trailer.setActiveFECsA(0x0);
+  trailer.setActiveFECsB(0x1);
+  trailer.setNumberOfNonZeroSuppressedPostsamples(1);
+  trailer.setNumberOfNonZeroSuppressedPresamples(1);
+  trailer.setNumberOfSamplesPerChannel(15);
+  trailer.setZeroSuppression(true);
+  trailer.setSparseReadout(true);
+  trailer.setNumberOfAltroBuffers(RCUTrailer::BufferMode_t::NBUFFERS4);
+  auto trailerwords = trailer.encode();
+
+  o2::header::RAWDataHeaderV6 rdh;
+  int pagesize = sizeof(rdh) + (altropayload.size() + trailerwords.size()) * sizeof(uint32_t);
+  o2::raw::RDHUtils::setFEEID(rdh, feeID);
+  o2::raw::RDHUtils::setMemorySize(rdh, pagesize);
+  o2::raw::RDHUtils::setOffsetToNext(rdh, pagesize);
+  std::vector<char> page(pagesize);
+  memcpy(page.data(), &rdh, sizeof(rdh));
+  memcpy(page.data() + sizeof(rdh), altropayload.data(), altropayload.size() * sizeof(uint32_t));
+  memcpy(page.data() + sizeof(rdh) + altropayload.size() * sizeof(uint32_t), trailerwords.data(), trailerwords.size() * sizeof(uint32_t));
+  return page;
+}
+
+/// Decoding with one channel object and one bunch object owning its samples
+/// per channel and bunch, as the ALTRO decoder did before decoding into flat buffers
+std::vector<Channel> decodeReference(const std::vector<uint32_t>& buffer, int trailersize, std::vector<MinorAltroDecodingError>& minorErrors)
+{
+  std::vector<Channel> channels;
+  int currentpos = 0;
+  int maxpayloadsize = buffer.size() - trailersize;
+  while (currentpos < maxpayloadsize) {
+    auto currentword = buffer[currentpos++];
+    if (currentword >> 30 != 1) {
+      continue;
+    }
+    auto channelheader = currentword;
+    int32_t hwaddress = channelheader & 0xFFF;
+    uint16_t payloadsize = (channelheader >> 16) & 0x3FF;
+    bool badchannel = (channelheader >> 29) & 0x1;
+
+    bool foundChannelError = false;
+    int numberofwords = (payloadsize + 2) / 3;
+    std::vector<uint16_t> bunchwords;
+    for (int iword = 0; iword < numberofwords; iword++) {
+      if (currentpos >= maxpayloadsize) {
+        minorErrors.emplace_back(MinorAltroDecodingError::ErrorType_t::CHANNEL_PAYLOAD_EXCEED, channelheader, currentword);
+        foundChannelError = true;
+        break;
+      }
+      currentword = buffer[currentpos++];
+      if ((currentword >> 30) != 0) {
+        minorErrors.emplace_back(MinorAltroDecodingError::ErrorType_t::CHANNEL_END_PAYLOAD_UNEXPECT, channelheader, currentword);
+        foundChannelError = true;
+        currentpos--;
+        continue;
+      }
+      bunchwords.push_back((currentword >> 20) & 0x3FF);
+      bunchwords.push_back((currentword >> 10) & 0x3FF);
+      bunchwords.push_back(currentword & 0x3FF);
+    }
+    if (foundChannelError) {
+      continue;
+    }
+    auto& currentchannel = channels.emplace_back(hwaddress, payloadsize);
+    currentchannel.setBadChannel(badchannel);
+
+    int currentsample = 0;
+    while (currentsample < currentchannel.getPayloadSize() && bunchwords.size() > currentsample + 2) {
+      if (bunchwords[currentsample] == 0) {
+        minorErrors.emplace_back(MinorAltroDecodingError::ErrorType_t::BUNCH_HEADER_NULL, channelheader, 0);
+        break;
+      }
+      int bunchlength = bunchwords[currentsample] - 2,
+          starttime = bunchwords[currentsample + 1];
+      if ((unsigned long)bunchlength > bunchwords.size() - currentsample - 2) {
+        minorErrors.emplace_back(MinorAltroDecodingError::ErrorType_t::BUNCH_LENGTH_EXCEED, channelheader, 0);
+        break;
+      }
+      if (bunchlength == 0) {
+        minorErrors.emplace_back(MinorAltroDecodingError::ErrorType_t::BUNCH_HEADER_NULL, channelheader, 0);
+        currentsample += bunchlength + 2;
+        continue;
+      }
+      auto& currentbunch = currentchannel.createBunch(bunchlength, starttime);
+      currentbunch.initFromRange(gsl::span<uint16_t>(&bunchwords[currentsample + 2], std::min((unsigned long)bunchlength, bunchwords.size() - currentsample - 2)));
+      currentsample += bunchlength + 2;
+    }
+  }
+  return channels;
+}
+
+void checkChannels(const std::vector<Channel>& reference, const std::vector<Channel>& decoded)
+{
+  BOOST_REQUIRE_EQUAL(reference.size(), decoded.size());
+  for (std::size_t ichannel = 0; ichannel < reference.size(); ichannel++) {
+    const auto &refchannel = reference[ichannel], &channel = decoded[ichannel];
+    BOOST_CHECK_EQUAL(refchannel.getHardwareAddress(), channel.getHardwareAddress());
+    BOOST_CHECK_EQUAL(refchannel.getPayloadSize(), channel.getPayloadSize());
+    BOOST_CHECK_EQUAL(refchannel.isBadChannel(), channel.isBadChannel());
+    auto refbunches = refchannel.getBunches();
+    auto bunches = channel.getBunches();
+    BOOST_REQUIRE_EQUAL(refbunches.size(), bunches.size());
+    for (std::size_t ibunch = 0; ibunch < refbunches.size(); ibunch++) {
+      BOOST_CHECK_EQUAL(refbunches[ibunch].getBunchLength(), bunches[ibunch].getBunchLength());
+      BOOST_CHECK_EQUAL(refbunches[ibunch].getStartTime(), bunches[ibunch].getStartTime());
+      auto refadc = refbunches[ibunch].getADC();
+      auto adc = bunches[ibunch].getADC();
+      BOOST_CHECK_EQUAL_COLLECTIONS(refadc.begin(), refadc.end(), adc.begin(), adc.end());
+    }
+  }
+}
+
+void checkMinorErrors(const std::vector<MinorAltroDecodingError>& reference, const std::vector<MinorAltroDecodingError>& decoded)
+{
+  BOOST_REQUIRE_EQUAL(reference.size(), decoded.size());
+  for (std::size_t ierror = 0; ierror < reference.size(); ierror++) {
+    BOOST_CHECK(reference[ierror].getErrorType() == decoded[ierror].getErrorType());
+    BOOST_CHECK_EQUAL(reference[ierror].getChannelHeader(), decoded[ierror].getChannelHeader());
+    BOOST_CHECK_EQUAL(reference[ierror].getPayloadWord(), decoded[ierror].getPayloadWord());
+  }
+}
+
+} // namespace
+
+/// \brief Decoding into the flat buffers of the decoder gives the same channels,
+/// bunches and minor errors as the decoding into owning objects
+BOOST_AUTO_TEST_CASE(AltroDecoder_reference)
+{
+  std::mt19937 generator(1234);
+  std::vector<uint32_t> altropayload;
+  for (const auto& channel : createChannels(200, generator)) {
+    encodeChannel(channel, altropayload);
+  }
+  // channel with a bunch longer than the channel payload
+  altropayload.push_back((1u << 30) | (3u << 16) | 0x123);
+  altropayload.push_back((20u << 20) | (10u << 10) | 5u);
+  // channel with a null bunch header
+  altropayload.push_back((1u << 30) | (6u << 16) | 0x124);
+  altropayload.push_back((0u << 20) | (10u << 10) | 5u);
+  altropayload.push_back((3u << 20) | (10u << 10) | 5u);
+  // channel interrupted by the next channel header
+  altropayload.push_back((1u << 30) | (9u << 16) | 0x125);
+  altropayload.push_back((4u << 20) | (10u << 10) | 5u);
+  encodeChannel(TestChannel{0x126, false, {{12, {1, 2, 3}}}}, altropayload);
+
+  auto page = createPage(altropayload, 0);
+  RawReaderMemory reader(page);
+  reader.next();
+  AltroDecoder decoder(reader);
+  decoder.decode();
+
+  std::vector<MinorAltroDecodingError> refMinorErrors;
+  auto reference = decodeReference(reader.getPayload().getPayloadWords(), decoder.getRCUTrailer().getTrailerSize(), refMinorErrors);
+  BOOST_CHECK(reference.size() > 200);
+  checkChannels(reference, decoder.getChannels());
+  checkMinorErrors(refMinorErrors, decoder.getMinorDecodingErrors());
+}
+
+/// \brief Channel and bunch views stay valid until the next page is decoded,
+/// and a decoder reused for pages of different size decodes each page correctly
+BOOST_AUTO_TEST_CASE(AltroDecoder_views)
+{
+  std::mt19937 generator(5678);
+  std::vector<std::vector<char>> pages;
+  for (int nchannels : {10, 300, 1, 50}) {
+    std::vector<uint32_t> altropayload;
+    for (const auto& channel : createChannels(nchannels, generator)) {
+      encodeChannel(channel, altropayload);
+    }
+    pages.emplace_back(createPage(altropayload, 1));
+  }
+
+  AltroDecoder decoder;
+  for (const auto& page : pages) {
+    RawReaderMemory reader(page);
+    reader.next();
+    decoder.setRawReader(reader);
+    decoder.decode();
+
+    std::vector<MinorAltroDecodingError> refMinorErrors;
+    auto reference = decodeReference(reader.getPayload().getPayloadWords(), decoder.getRCUTrailer().getTrailerSize(), refMinorErrors);
+    BOOST_CHECK(refMinorErrors.empty());
+
+    // views taken from the first channel must not move while the other channels are read
+    const auto& channels = decoder.getChannels();
+    BOOST_REQUIRE(!channels.empty());
+    auto firstbunches = channels.front().getBunches();
+    auto firstadc = firstbunches.empty() ? gsl::span<const uint16_t>() : firstbunches.front().getADC();
+    checkChannels(reference, channels);
+    BOOST_CHECK(channels.front().getBunches().data() == firstbunches.data());
+    if (!firstbunches.empty()) {
+      BOOST_CHECK(channels.front().getBunches().front().getADC().data() == firstadc.data());
+    }
+
+    // copies of the channels view the buffers of the decoder
+    std::vector<Channel> copies(channels.begin(), channels.end());
+    checkChannels(reference, copies);
+    BOOST_CHECK(copies.front().getBunches().data() == firstbunches.data());
+  }
+}
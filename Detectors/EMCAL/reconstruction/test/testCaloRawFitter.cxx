@@ -0,0 +1,138 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test EMCAL CaloRawFitter
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <gsl/span>
+#include "DataFormatsEMCAL/Constants.h"
+#include "EMCALReconstruction/Bunch.h"
+#include "EMCALReconstruction/CaloRawFitter.h"
+#include "EMCALReconstruction/CaloRawFitterGamma2.h"
+#include "EMCALReconstruction/CaloRawFitterStandard.h"
+
+using namespace o2::emcal;
+
+namespace
+{
+
+/// Bunch with the samples of a gamma-2 shaped pulse on top of a pedestal,
+/// the first ADC value belongs to the start time
+Bunch createBunch(int starttime, int length, double amplitude, double peaktime, int pedestal, std::mt19937& generator)
+{
+  std::normal_distribution<double> noise(0., 1.5);
+  Bunch bunch(length, starttime);
+  for (int isample = 0; isample < length; isample++) {
+    double timebin = starttime - isample;
+    double xx = (timebin - peaktime + constants::TAU) / constants::TAU;
+    double signal = xx > 0 ? amplitude * xx * xx * std::exp(2 * (1 - xx)) : 0.;
+    int adc = std::lround(pedestal + signal + noise(generator));
+    bunch.addADC(std::clamp(adc, 0, 1023));
+  }
+  return bunch;
+}
+
+/// Channels with one or two bunches, including channels which fail in the raw fit
+std::vector<std::vector<Bunch>> createChannels(int nchannels, int pedestal)
+{
+  std::mt19937 generator(4321);
+  std::uniform_real_distribution<double> amplitudeDist(0., 1200.), peaktimeDist(3., 11.);
+  std::uniform_int_distribution<int> typeDist(0, 9);
+  std::vector<std::vector<Bunch>> channels;
+  for (int ichannel = 0; ichannel < nchannels; ichannel++) {
+    auto& bunches = channels.emplace_back();
+    switch (typeDist(generator)) {
+      case 0:
+        // low signal
+        bunches.emplace_back(createBunch(14, 15, 1., peaktimeDist(generator), pedestal, generator));
+        break;
+      case 1:
+        // maximum at the edge of the bunch
+        bunches.emplace_back(createBunch(6, 4, amplitudeDist(generator), 8., pedestal, generator));
+        break;
+      case 2:
+        // two bunches
+        bunches.emplace_back(createBunch(14, 5, amplitudeDist(generator) / 10., 12., pedestal, generator));
+        bunches.emplace_back(createBunch(8, 9, amplitudeDist(generator), 4.5, pedestal, generator));
+        break;
+      default:
+        bunches.emplace_back(createBunch(14, 15, amplitudeDist(generator), peaktimeDist(generator), pedestal, generator));
+        break;
+    };
+  }
+  return channels;
+}
+
+void checkBatch(CaloRawFitter& fitter, const std::vector<std::vector<Bunch>>& channels)
+{
+  std::vector<gsl::span<const Bunch>> bunchlists;
+  for (const auto& bunches : channels) {
+    bunchlists.emplace_back(bunches);
+  }
+  std::vector<CaloRawFitter::BatchFitResults> results;
+  fitter.evaluateBatch(bunchlists, results);
+  BOOST_REQUIRE_EQUAL(results.size(), channels.size());
+
+  int nfitted = 0, nfailed = 0;
+  for (std::size_t ichannel = 0; ichannel < channels.size(); ichannel++) {
+    try {
+      auto reference = fitter.evaluate(bunchlists[ichannel]);
+      BOOST_REQUIRE(!results[ichannel].mError);
+      const auto& fitresult = results[ichannel].mFitResults;
+      BOOST_CHECK_EQUAL(reference.getAmp(), fitresult.getAmp());
+      BOOST_CHECK_EQUAL(reference.getTime(), fitresult.getTime());
+      BOOST_CHECK_EQUAL(reference.getChi2(), fitresult.getChi2());
+      BOOST_CHECK_EQUAL(reference.getNdf(), fitresult.getNdf());
+      BOOST_CHECK_EQUAL(reference.getMaxSig(), fitresult.getMaxSig());
+      BOOST_CHECK_EQUAL(reference.getPed(), fitresult.getPed());
+      BOOST_CHECK(reference == fitresult);
+      nfitted++;
+    } catch (CaloRawFitter::RawFitterError_t& error) {
+      BOOST_REQUIRE(results[ichannel].mError);
+      BOOST_CHECK(error == *results[ichannel].mError);
+      nfailed++;
+    }
+  }
+  BOOST_CHECK(nfitted > 0);
+  BOOST_CHECK(nfailed > 0);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(CaloRawFitterGamma2_batch)
+{
+  for (bool zerosuppressed : {true, false}) {
+    CaloRawFitterGamma2 fitter;
+    fitter.setIsZeroSuppressed(zerosuppressed);
+    checkBatch(fitter, createChannels(500, zerosuppressed ? 0 : 30));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CaloRawFitterStandard_batch)
+{
+  for (bool zerosuppressed : {true, false}) {
+    CaloRawFitterStandard fitter;
+    fitter.setIsZeroSuppressed(zerosuppressed);
+    checkBatch(fitter, createChannels(200, zerosuppressed ? 0 : 30));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CaloRawFitter_emptyBatch)
+{
+  CaloRawFitterGamma2 fitter;
+  std::vector<CaloRawFitter::BatchFitResults> results(3);
+  fitter.evaluateBatch({}, results);
+  BOOST_CHECK(results.empty());
+}
@@ -20,6 +20,7 @@
 #include "Headers/DataHeader.h"
 #include "EMCALBase/Geometry.h"
 #include "EMCALBase/Mapper.h"
+#include "EMCALReconstruction/AltroDecoder.h"
 #include "EMCALReconstruction/CaloRawFitter.h"
 
 namespace o2
@@ -113,6 +114,14 @@ class RawToCellConverterSpec : public framework::Task
     int mHWAddressLG;          ///< HW address of LG (for monitoring)
     int mHWAddressHG;          ///< HW address of HG (for monitoring)
   };
+
+  /// \struct FitChannelInfo
+  /// \brief Channel of the current page selected for the batched raw fit
+  struct FitChannelInfo {
+    const Channel* mChannel;    ///< Channel in the ALTRO decoder
+    int mCellID;                ///< Cell ID of the channel
+    ChannelType_t mChannelType; ///< Type of the channel (high or low gain)
+  };
   bool isLostTimeframe(framework::ProcessingContext& ctx) const;
 
   /// \brief Send data to output channels
@@ -138,6 +147,10 @@ class RawToCellConverterSpec : public framework::Task
   Geometry* mGeometry = nullptr;                                     ///!<! Geometry pointer
   std::unique_ptr<MappingHandler> mMapper = nullptr;                 ///!<! Mapper
   std::unique_ptr<CaloRawFitter> mRawFitter;                         ///!<! Raw fitter
+  AltroDecoder mAltroDecoder;                                        ///!<! ALTRO decoder, buffers reused for all pages
+  std::vector<FitChannelInfo> mFitChannels;                          ///!<! Channels of the current page selected for the raw fit
+  std::vector<gsl::span<const Bunch>> mFitBunches;                   ///!<! Bunches of the channels selected for the raw fit
+  std::vector<CaloRawFitter::BatchFitResults> mFitResults;           ///!<! Raw fit results of the selected channels
   std::vector<Cell> mOutputCells;                                    ///< Container with output cells
   std::vector<TriggerRecord> mOutputTriggerRecords;                  ///< Container with output cells
   std::vector<ErrorTypeFEE> mOutputDecoderErrors;                    ///< Container with decoder errors
@@ -223,7 +223,8 @@ void RawToCellConverterSpec::run(framework::ProcessingContext& ctx)
       // std::cout<<rawreader.getRawHeader()<<std::endl;
 
       // use the altro decoder to decode the raw data, and extract the RCU trailer
-      AltroDecoder decoder(rawreader);
+      auto& decoder = mAltroDecoder;
+      decoder.setRawReader(rawreader);
       // check the words of the payload exception in altrodecoder
       try {
         decoder.decode();
@@ -326,6 +327,8 @@ void RawToCellConverterSpec::run(framework::ProcessingContext& ctx)
 
         // Loop over all the channels
         int nBunchesNotOK = 0;
+        mFitChannels.clear();
+        mFitBunches.clear();
         for (auto& chan : decoder.getChannels()) {
           int iRow, iCol;
           ChannelType_t chantype;
@@ -413,92 +416,19 @@ void RawToCellConverterSpec::run(framework::ProcessingContext& ctx)
             continue;
           }
 
-          // define the conatiner for the fit results, and perform the raw fitting using the stadnard raw fitter
-          CaloFitResults fitResults;
-          try {
-            fitResults = mRawFitter->evaluate(chan.getBunches());
-            // Prevent negative entries - we should no longer get here as the raw fit usually will end in an error state
-            if (fitResults.getAmp() < 0) {
-              fitResults.setAmp(0.);
-            }
-            if (fitResults.getTime() < 0) {
-              fitResults.setTime(0.);
-            }
-            // apply correction for bc mod 4
-            double celltime = fitResults.getTime() - timeshift - 25 * bcmod4;
-            double amp = fitResults.getAmp() * o2::emcal::constants::EMCAL_ADCENERGY;
-            if (mMergeLGHG) {
-              // Handling of HG/LG for ceratin cells
-              // Keep the high gain if it is below the threshold, otherwise
-              // change to the low gain
-              auto res = std::find_if(currentCellContainer->begin(), currentCellContainer->end(), [CellID](const RecCellInfo& test) { return test.mCellData.getTower() == CellID; });
-              if (res != currentCellContainer->end()) {
-                // Cell already existing, store LG if HG is larger then the overflow cut
-                if (chantype == o2::emcal::ChannelType_t::LOW_GAIN) {
-                  res->mHWAddressLG = chan.getHardwareAddress();
-                  res->mHGOutOfRange = false; // LG is found so it can replace the HG if the HG is out of range
-                  if (res->mCellData.getHighGain()) {
-                    double ampOld = res->mCellData.getEnergy() / o2::emcal::constants::EMCAL_ADCENERGY; // cut applied on ADC and not on energy
-                    if (ampOld > o2::emcal::constants::OVERFLOWCUT) {
-                      // High gain digit has energy above overflow cut, use low gain instead
-                      res->mCellData.setEnergy(amp * o2::emcal::constants::EMCAL_HGLGFACTOR);
-                      res->mCellData.setTimeStamp(celltime);
-                      res->mCellData.setLowGain();
-                    }
-                    res->mIsLGnoHG = false;
-                  }
-                } else {
-                  // new channel would be HG use that if it is belpw ADC cut
-                  // as the channel existed before it must have been a LG channel,
-                  /// whixh would be used in case the HG is out-of-range
-                  res->mIsLGnoHG = false;
-                  res->mHGOutOfRange = false;
-                  res->mHWAddressHG = chan.getHardwareAddress();
-                  if (amp / o2::emcal::constants::EMCAL_ADCENERGY <= o2::emcal::constants::OVERFLOWCUT) {
-                    res->mCellData.setEnergy(amp);
-                    res->mCellData.setTimeStamp(celltime);
-                    res->mCellData.setHighGain();
-                  }
-                }
-              } else {
-                // New cell
-                bool lgNoHG = false;       // Flag for filter of cells which have only low gain but no high gain
-                bool hgOutOfRange = false; // Flag if only a HG is present which is out-of-range
-                int hwAddressLG = -1,      // Hardware address of the LG of the tower (for monitoring)
-                  hwAddressHG = -1;        // Hardware address of the HG of the tower (for monitoring)
-                if (chantype == o2::emcal::ChannelType_t::LOW_GAIN) {
-                  lgNoHG = true;
-                  amp *= o2::emcal::constants::EMCAL_HGLGFACTOR;
-                  hwAddressLG = chan.getHardwareAddress();
-                } else {
-                  // High gain cell: Flag as low gain if above threshold
-                  if (amp / o2::emcal::constants::EMCAL_ADCENERGY > o2::emcal::constants::OVERFLOWCUT) {
-                    hgOutOfRange = true;
-                  }
-                  hwAddressHG = chan.getHardwareAddress();
-                }
-                int fecID = mMapper->getFEEForChannelInDDL(feeID, chan.getFECIndex(), chan.getBranchIndex());
-                currentCellContainer->push_back({o2::emcal::Cell(CellID, amp, celltime, chantype),
-                                                 lgNoHG,
-                                                 hgOutOfRange,
-                                                 fecID, feeID, hwAddressLG, hwAddressHG});
-              }
-            } else {
-              // No merge of HG/LG cells (usually MC where either
-              // of the two is simulated)
-              int hwAddressLG = chantype == ChannelType_t::LOW_GAIN ? chan.getHardwareAddress() : -1,
-                  hwAddressHG = chantype == ChannelType_t::HIGH_GAIN ? chan.getHardwareAddress() : -1;
-              // New cell
-              if (chantype == o2::emcal::ChannelType_t::LOW_GAIN) {
-                amp *= o2::emcal::constants::EMCAL_HGLGFACTOR;
-              }
-              int fecID = mMapper->getFEEForChannelInDDL(feeID, chan.getFECIndex(), chan.getBranchIndex());
-              currentCellContainer->push_back({o2::emcal::Cell(CellID, amp, celltime, chantype),
-                                               false,
-                                               false,
-                                               fecID, feeID, hwAddressLG, hwAddressHG});
-            }
-          } catch (CaloRawFitter::RawFitterError_t& fiterror) {
+          // collect the channels for the raw fit, all channels of the page are fitted in one batch
+          mFitChannels.push_back({&chan, CellID, chantype});
+          mFitBunches.emplace_back(chan.getBunches());
+        }
+
+        // perform the raw fitting using the selected raw fitter
+        mRawFitter->evaluateBatch(mFitBunches, mFitResults);
+        for (std::size_t ifit = 0; ifit < mFitChannels.size(); ifit++) {
+          const auto& chan = *mFitChannels[ifit].mChannel;
+          auto CellID = mFitChannels[ifit].mCellID;
+          auto chantype = mFitChannels[ifit].mChannelType;
+          if (mFitResults[ifit].mError) {
+            auto fiterror = *mFitResults[ifit].mError;
             if (fiterror != CaloRawFitter::RawFitterError_t::BUNCH_NOT_OK) {
               // Display
               if (mNumErrorMessages < mMaxErrorMessages) {
@@ -518,6 +448,90 @@ void RawToCellConverterSpec::run(framework::ProcessingContext& ctx)
               LOG(debug2) << "Failure in raw fitting: " << CaloRawFitter::createErrorMessage(fiterror);
               nBunchesNotOK++;
             }
+            continue;
+          }
+          // container for the fit results
+          CaloFitResults fitResults = mFitResults[ifit].mFitResults;
+          // Prevent negative entries - we should no longer get here as the raw fit usually will end in an error state
+          if (fitResults.getAmp() < 0) {
+            fitResults.setAmp(0.);
+          }
+          if (fitResults.getTime() < 0) {
+            fitResults.setTime(0.);
+          }
+          // apply correction for bc mod 4
+          double celltime = fitResults.getTime() - timeshift - 25 * bcmod4;
+          double amp = fitResults.getAmp() * o2::emcal::constants::EMCAL_ADCENERGY;
+          if (mMergeLGHG) {
+            // Handling of HG/LG for ceratin cells
+            // Keep the high gain if it is below the threshold, otherwise
+            // change to the low gain
+            auto res = std::find_if(currentCellContainer->begin(), currentCellContainer->end(), [CellID](const RecCellInfo& test) { return test.mCellData.getTower() == CellID; });
+            if (res != currentCellContainer->end()) {
+              // Cell already existing, store LG if HG is larger then the overflow cut
+              if (chantype == o2::emcal::ChannelType_t::LOW_GAIN) {
+                res->mHWAddressLG = chan.getHardwareAddress();
+                res->mHGOutOfRange = false; // LG is found so it can replace the HG if the HG is out of range
+                if (res->mCellData.getHighGain()) {
+                  double ampOld = res->mCellData.getEnergy() / o2::emcal::constants::EMCAL_ADCENERGY; // cut applied on ADC and not on energy
+                  if (ampOld > o2::emcal::constants::OVERFLOWCUT) {
+                    // High gain digit has energy above overflow cut, use low gain instead
+                    res->mCellData.setEnergy(amp * o2::emcal::constants::EMCAL_HGLGFACTOR);
+                    res->mCellData.setTimeStamp(celltime);
+                    res->mCellData.setLowGain();
+                  }
+                  res->mIsLGnoHG = false;
+                }
+              } else {
+                // new channel would be HG use that if it is belpw ADC cut
+                // as the channel existed before it must have been a LG channel,
+                /// whixh would be used in case the HG is out-of-range
+                res->mIsLGnoHG = false;
+                res->mHGOutOfRange = false;
+                res->mHWAddressHG = chan.getHardwareAddress();
+                if (amp / o2::emcal::constants::EMCAL_ADCENERGY <= o2::emcal::constants::OVERFLOWCUT) {
+                  res->mCellData.setEnergy(amp);
+                  res->mCellData.setTimeStamp(celltime);
+                  res->mCellData.setHighGain();
+                }
+              }
+            } else {
+              // New cell
+              bool lgNoHG = false;       // Flag for filter of cells which have only low gain but no high gain
+              bool hgOutOfRange = false; // Flag if only a HG is present which is out-of-range
+              int hwAddressLG = -1,      // Hardware address of the LG of the tower (for monitoring)
+                hwAddressHG = -1;        // Hardware address of the HG of the tower (for monitoring)
+              if (chantype == o2::emcal::ChannelType_t::LOW_GAIN) {
+                lgNoHG = true;
+                amp *= o2::emcal::constants::EMCAL_HGLGFACTOR;
+                hwAddressLG = chan.getHardwareAddress();
+              } else {
+                // High gain cell: Flag as low gain if above threshold
+                if (amp / o2::emcal::constants::EMCAL_ADCENERGY > o2::emcal::constants::OVERFLOWCUT) {
+                  hgOutOfRange = true;
+                }
+                hwAddressHG = chan.getHardwareAddress();
+              }
+              int fecID = mMapper->getFEEForChannelInDDL(feeID, chan.getFECIndex(), chan.getBranchIndex());
+              currentCellContainer->push_back({o2::emcal::Cell(CellID, amp, celltime, chantype),
+                                               lgNoHG,
+                                               hgOutOfRange,
+                                               fecID, feeID, hwAddressLG, hwAddressHG});
+            }
+          } else {
+            // No merge of HG/LG cells (usually MC where either
+            // of the two is simulated)
+            int hwAddressLG = chantype == ChannelType_t::LOW_GAIN ? chan.getHardwareAddress() : -1,
+                hwAddressHG = chantype == ChannelType_t::HIGH_GAIN ? chan.getHardwareAddress() : -1;
+            // New cell
+            if (chantype == o2::emcal::ChannelType_t::LOW_GAIN) {
+              amp *= o2::emcal::constants::EMCAL_HGLGFACTOR;
+            }
+            int fecID = mMapper->getFEEForChannelInDDL(feeID, chan.getFECIndex(), chan.getBranchIndex());
+            currentCellContainer->push_back({o2::emcal::Cell(CellID, amp, celltime, chantype),
+                                             false,
+                                             false,
+                                             fecID, feeID, hwAddressLG, hwAddressHG});
           }
         }
       } catch (o2::emcal::MappingHandler::DDLInvalid& ddlerror) {
@@ -145,6 +145,7 @@ struct DataBlockWrapper {
   {
     mNelements = 0;
     mNwords = 0;
+    mIsIncorrect = false; //the same block can be used to decode several ones
     if (nWords < MinNwords || nWords > MaxNwords || inputBytes.size() - srcPos < nWords * SIZE_WORD) {
       //in case of bad fields responsible for deserialization logic, byte position will be pushed to the end of binary sequence
       srcPos = inputBytes.size();
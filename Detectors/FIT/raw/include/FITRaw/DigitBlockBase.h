@@ -182,6 +182,18 @@ class DigitBlockBase //:public DigitBlock
   Digit_t mDigit;
   SubDigit_t mSubDigit;
   SingleSubDigit_t mSingleSubDigit;
+  //Reinitialize block for new InteractionRecord, keeping memory allocated for SubDigits
+  void reset(const o2::InteractionRecord& intRec)
+  {
+    mDigit = Digit_t{};
+    mDigit.setIntRecord(intRec);
+    if constexpr (DigitBlockHelper::IsSpecOfType<std::tuple, SubDigit_t>::value) {
+      std::apply([](auto&... vecSubDigit) { (vecSubDigit.clear(), ...); }, mSubDigit);
+    } else {
+      mSubDigit.clear();
+    }
+    mSingleSubDigit = SingleSubDigit_t{};
+  }
   template <typename VecDigit, typename... VecSubDigits>
   auto getSubDigits(VecDigit& vecDigits, VecSubDigits&... vecSubDigits)
     -> std::enable_if_t<sizeof...(VecSubDigits) == sNSubDigits>
@@ -21,8 +21,10 @@
 #include <iostream>
 #include <type_traits>
 #include <vector>
-#include <map>
+#include <array>
 #include <tuple>
+#include <algorithm>
+#include <numeric>
 
 #include <boost/mpl/vector.hpp>
 #include <boost/mpl/set.hpp>
@@ -31,6 +33,7 @@
 
 #include <Rtypes.h>
 #include <CommonDataFormat/InteractionRecord.h>
+#include "CommonConstants/LHCConstants.h"
 #include "Headers/RAWDataHeader.h"
 #include <Framework/Logger.h>
 
@@ -47,34 +50,82 @@ class RawReaderBase
   ~RawReaderBase() = default;
   typedef DigitBlockType DigitBlock_t;
   typedef boost::mpl::vector<DataBlockTypes...> VecDataBlocks_t;
-  std::tuple<std::vector<DataBlockTypes>...> mTupleVecDataBlocks;
-  std::map<InteractionRecord, DigitBlock_t> mMapDigits;
+  //Data blocks are decoded one by one into the same object
+  std::tuple<DataBlockTypes...> mTupleDataBlocks;
+  //Digit blocks of the TF, indexed by BC in a table for each orbit with data.
+  //Digit blocks, tables and their memory are reused from one TF to the next one.
+  typedef std::array<int, o2::constants::lhc::LHCMaxBunches> BCTable_t;
+  std::vector<DigitBlock_t> mDigitBlocks;
+  std::size_t mNDigitBlocks = 0;    // number of digit blocks in the TF
+  std::vector<uint32_t> mOrbits;    // orbit of each table, in order of arrival
+  std::vector<BCTable_t> mBCTables; // index of the digit block for each BC, -1 if none
+  std::size_t mNOrbits = 0;         // number of orbits in the TF
+  std::size_t mLastOrbit = 0;       // table of the last block, for the lookup of the next one
+  std::vector<std::size_t> mOrbitOrder;
   template <typename T>
-  constexpr std::vector<T>& getVecDataBlocks()
+  constexpr T& getDataBlock()
   {
     typedef typename boost::mpl::find<VecDataBlocks_t, T>::type it_t;
-    return std::get<it_t::pos::value>(mTupleVecDataBlocks);
+    return std::get<it_t::pos::value>(mTupleDataBlocks);
   }
-  //decoding binary data into data blocks
-  template <class DataBlockType>
-  size_t decodeBlocks(const gsl::span<const uint8_t> binaryPayload, std::vector<DataBlockType>& vecDataBlocks)
+  //preallocate digit blocks and orbit tables
+  void reserve(std::size_t nDigitBlocks, std::size_t nOrbits = 0)
+  {
+    mDigitBlocks.reserve(nDigitBlocks);
+    while (mDigitBlocks.size() < nDigitBlocks) {
+      mDigitBlocks.emplace_back(o2::InteractionRecord{});
+    }
+    mOrbits.reserve(nOrbits);
+    mBCTables.reserve(nOrbits);
+    mOrbitOrder.reserve(nOrbits);
+  }
+  //digit block of the given interaction, created if needed. nullptr if the BC is out of range
+  DigitBlock_t* getDigitBlock(const InteractionRecord& intRec)
+  {
+    if (intRec.bc >= o2::constants::lhc::LHCMaxBunches) {
+      return nullptr;
+    }
+    if (mNOrbits == 0 || mOrbits[mLastOrbit] != intRec.orbit) {
+      mLastOrbit = std::find(mOrbits.begin(), mOrbits.begin() + mNOrbits, intRec.orbit) - mOrbits.begin();
+      if (mLastOrbit == mNOrbits) {
+        if (mNOrbits == mBCTables.size()) {
+          mOrbits.emplace_back();
+          mBCTables.emplace_back();
+        }
+        mOrbits[mNOrbits] = intRec.orbit;
+        mBCTables[mNOrbits].fill(-1);
+        mNOrbits++;
+      }
+    }
+    auto& index = mBCTables[mLastOrbit][intRec.bc];
+    if (index < 0) {
+      index = mNDigitBlocks++;
+      if (static_cast<std::size_t>(index) == mDigitBlocks.size()) {
+        mDigitBlocks.emplace_back(intRec);
+      } else {
+        mDigitBlocks[index].reset(intRec);
+      }
+    }
+    return &mDigitBlocks[index];
+  }
+  //decoding binary data into data blocks, each one is passed to the callback as soon as decoded
+  template <class DataBlockType, typename F>
+  size_t decodeBlocks(const gsl::span<const uint8_t> binaryPayload, DataBlockType& dataBlock, F&& processBlock)
   {
     size_t srcPos = 0;
     while (srcPos < binaryPayload.size()) {
-      auto& refDataBlock = vecDataBlocks.emplace_back();
-      refDataBlock.decodeBlock(binaryPayload, srcPos);
-      srcPos += refDataBlock.mSize;
-      if (refDataBlock.mSize == 16) {
+      dataBlock.decodeBlock(binaryPayload, srcPos);
+      srcPos += dataBlock.mSize;
+      if (dataBlock.mSize == 16) {
         //exclude data block in case of single header(no data, total size == 16 bytes)
-        vecDataBlocks.pop_back();
         continue;
       }
-      if (!refDataBlock.isCorrect()) {
-        LOG(warning) << "INCORRECT DATA BLOCK! Byte position: " << srcPos - refDataBlock.mSize << " | Payload size: " << binaryPayload.size() << " | DataBlock size: " << refDataBlock.mSize;
-        refDataBlock.print();
-        vecDataBlocks.pop_back();
+      if (!dataBlock.isCorrect()) {
+        LOG(warning) << "INCORRECT DATA BLOCK! Byte position: " << srcPos - dataBlock.mSize << " | Payload size: " << binaryPayload.size() << " | DataBlock size: " << dataBlock.mSize;
+        dataBlock.print();
         return srcPos;
       }
+      processBlock(dataBlock);
     }
     return srcPos;
   }
@@ -83,40 +134,38 @@ class RawReaderBase
   template <class DataBlockType, typename... T>
   void processBinaryData(gsl::span<const uint8_t> payload, T&&... feeParameters)
   {
-    auto& vecDataBlocks = getVecDataBlocks<DataBlockType>();
-    auto srcPos = decodeBlocks(payload, vecDataBlocks);
-    for (const auto& dataBlock : vecDataBlocks) {
-      auto intRec = dataBlock.getInteractionRecord();
-      auto [digitIter, isNew] = mMapDigits.try_emplace(intRec, intRec);
-      digitIter->second.template processDigits<DataBlockType>(dataBlock, std::forward<T>(feeParameters)...);
-    }
-    vecDataBlocks.clear();
-    /* //Must be checked for perfomance
-    std::size_t srcPos = 0;
-    while (srcPos < payload.size()) {
-      DataBlockType dataBlock{};
-      dataBlock.decodeBlock(payload, srcPos);
-      srcPos += dataBlock.mSize;
-      if (!dataBlock.isCorrect()) {
-        LOG(warning) << "INCORRECT DATA BLOCK! Byte position: " << srcPos << " | Payload size: " << payload.size() << " | DataBlock size: " << dataBlock.mSize;
-        //dataBlock.print();
+    auto& dataBlock = getDataBlock<DataBlockType>();
+    decodeBlocks(payload, dataBlock, [&](const DataBlockType& block) {
+      auto intRec = block.getInteractionRecord();
+      auto digitBlock = getDigitBlock(intRec);
+      if (digitBlock == nullptr) {
+        static int warningCount = 0;
+        if (warningCount++ < 100) {
+          LOG(warning) << "Incorrect BC in data block! Orbit: " << intRec.orbit << " | BC: " << intRec.bc;
+        }
         return;
       }
-      auto intRec = dataBlock.getInteractionRecord();
-      auto [digitIter, isNew] = mMapDigits.try_emplace(intRec, intRec);
-      digitIter->second.template processDigits<DataBlockType>(dataBlock, std::forward<T>(feeParameters)...);
-    }
-    */
+      digitBlock->template processDigits<DataBlockType>(block, std::forward<T>(feeParameters)...);
+    });
   }
-  //pop digits
+  //pop digits, in increasing order of interaction record
   template <typename... VecDigitType>
   int getDigits(VecDigitType&... vecDigit)
   {
-    int digitCounter = mMapDigits.size();
-    for (auto& digit : mMapDigits) {
-      digit.second.getDigits(vecDigit...);
+    int digitCounter = mNDigitBlocks;
+    mOrbitOrder.resize(mNOrbits);
+    std::iota(mOrbitOrder.begin(), mOrbitOrder.end(), 0);
+    std::sort(mOrbitOrder.begin(), mOrbitOrder.end(), [this](std::size_t a, std::size_t b) { return mOrbits[a] < mOrbits[b]; });
+    for (auto iOrbit : mOrbitOrder) {
+      for (auto index : mBCTables[iOrbit]) {
+        if (index >= 0) {
+          mDigitBlocks[index].getDigits(vecDigit...);
+        }
+      }
     }
-    mMapDigits.clear();
+    mNDigitBlocks = 0;
+    mNOrbits = 0;
+    mLastOrbit = 0;
     return digitCounter;
   }
 
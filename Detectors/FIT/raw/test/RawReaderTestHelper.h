@@ -0,0 +1,266 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file RawReaderTestHelper.h
+/// \brief Generated FIT raw pages and the original map-based raw reader, for the test and the benchmark of RawReaderBase
+
+#ifndef ALICEO2_FIT_RAWREADERTESTHELPER_H_
+#define ALICEO2_FIT_RAWREADERTESTHELPER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+#include <gsl/span>
+#include "CommonConstants/LHCConstants.h"
+#include "CommonDataFormat/InteractionRecord.h"
+#include "DataFormatsFIT/RawEventData.h"
+#include "FITRaw/DataBlockFIT.h"
+#include "FITRaw/DigitBlockFIT.h"
+#include "FITRaw/RawReaderBaseFIT.h"
+
+namespace o2
+{
+namespace fit
+{
+namespace test
+{
+
+constexpr int NLinksPM = 4; // PM links for each of the two end points
+constexpr int LinkTCM = 8;  // TCM link, end point 0
+constexpr int NChannelsPM = 12;
+
+/// Lookup table of the test, no CCDB access
+struct TestLUT {
+  static TestLUT& Instance()
+  {
+    static TestLUT lut;
+    return lut;
+  }
+  bool isTCM(int linkID, int ep) const { return linkID == LinkTCM && ep == 0; }
+  int getChannel(int linkID, int ep, int chID, bool& isValid) const
+  {
+    isValid = linkID < NLinksPM && chID > 0 && chID <= NChannelsPM;
+    return (ep * NLinksPM + linkID) * NChannelsPM + chID - 1;
+  }
+};
+
+using DataBlockPM_t = DataBlockPM<EventHeader, EventData>;
+using DataBlockTCM_t = DataBlockTCM<EventHeader, TCMdata>;
+template <typename DigitType, typename ChannelDataType>
+using DigitBlock_t = DigitBlockFIT<TestLUT, DigitType, ChannelDataType>;
+template <typename DigitType, typename ChannelDataType>
+using RawReader_t = RawReaderBaseFIT<DigitBlock_t<DigitType, ChannelDataType>, DataBlockPM_t, DataBlockTCM_t>;
+
+/// Raw data reader as it was before the BC tables: data blocks are decoded into a vector
+/// for each page and the digit blocks are kept in a map
+template <typename DigitBlockType>
+class MapRawReader
+{
+ public:
+  void process(gsl::span<const uint8_t> payload, int linkID, int ep)
+  {
+    if (TestLUT::Instance().isTCM(linkID, ep)) {
+      processBinaryData(payload, mVecDataBlocksTCM, linkID, ep);
+    } else {
+      processBinaryData(payload, mVecDataBlocksPM, linkID, ep);
+    }
+  }
+  template <typename... VecDigitType>
+  int getDigits(VecDigitType&... vecDigit)
+  {
+    int digitCounter = mMapDigits.size();
+    for (auto& digit : mMapDigits) {
+      digit.second.getDigits(vecDigit...);
+    }
+    mMapDigits.clear();
+    return digitCounter;
+  }
+
+ private:
+  template <typename DataBlockType>
+  void processBinaryData(gsl::span<const uint8_t> payload, std::vector<DataBlockType>& vecDataBlocks, int linkID, int ep)
+  {
+    size_t srcPos = 0;
+    while (srcPos < payload.size()) {
+      auto& refDataBlock = vecDataBlocks.emplace_back();
+      refDataBlock.decodeBlock(payload, srcPos);
+      srcPos += refDataBlock.mSize;
+      if (refDataBlock.mSize == 16) {
+        vecDataBlocks.pop_back();
+        continue;
+      }
+      if (!refDataBlock.isCorrect()) {
+        vecDataBlocks.pop_back();
+        break;
+      }
+    }
+    for (const auto& dataBlock : vecDataBlocks) {
+      auto intRec = dataBlock.getInteractionRecord();
+      auto [digitIter, isNew] = mMapDigits.try_emplace(intRec, intRec);
+      digitIter->second.template processDigits<DataBlockType>(dataBlock, linkID, ep);
+    }
+    vecDataBlocks.clear();
+  }
+  std::vector<DataBlockPM_t> mVecDataBlocksPM;
+  std::vector<DataBlockTCM_t> mVecDataBlocksTCM;
+  std::map<InteractionRecord, DigitBlockType> mMapDigits;
+};
+
+struct Page {
+  int linkID;
+  int ep;
+  std::vector<uint8_t> payload;
+};
+
+/// Special blocks of the generated pages
+struct PageOptions {
+  int percentSingleHeader = 0; // header without data, 16 bytes
+  int percentCorrupt = 0;      // pages ending with a corrupt block, followed by a good one
+  int percentBadBC = 0;        // blocks with BC >= 3564
+};
+
+inline void appendBlock(std::vector<uint8_t>& bytes, const std::vector<char>& block)
+{
+  bytes.insert(bytes.end(), block.begin(), block.end());
+}
+
+/// Header of a PM block announcing nGBTWords data words, which are not filled
+inline std::vector<char> serializeHeaderPM(const InteractionRecord& ir, int nGBTWords)
+{
+  DataBlockPM_t block{};
+  auto& header = block.DataBlockWrapper<EventHeader>::mData[0];
+  header.setIntRec(ir);
+  header.startDescriptor = 0xf;
+  header.nGBTWords = nGBTWords;
+  std::vector<char> bytes((1 + nGBTWords) * SIZE_WORD);
+  size_t destPos = 0;
+  block.DataBlockWrapper<EventHeader>::serialize(bytes, DataBlockWrapper<EventHeader>::MaxNwords, destPos);
+  return bytes;
+}
+
+inline std::vector<char> serializePM(const InteractionRecord& ir, std::mt19937& gen)
+{
+  DataBlockPM_t block{};
+  std::vector<int> channels(NChannelsPM);
+  std::iota(channels.begin(), channels.end(), 1);
+  std::shuffle(channels.begin(), channels.end(), gen);
+  int nChannels = std::uniform_int_distribution<int>(1, NChannelsPM)(gen);
+  std::uniform_int_distribution<int> time(-2048, 2047), charge(-100, 4095), flags(0, 255);
+  for (int i = 0; i < nChannels; i++) {
+    auto& data = block.DataBlockWrapper<EventData>::mData[i];
+    data.word = uint64_t(flags(gen)) << EventData::BitFlagPos;
+    data.channelID = channels[i];
+    data.time = time(gen);
+    data.charge = charge(gen);
+  }
+  auto& header = block.DataBlockWrapper<EventHeader>::mData[0];
+  header.setIntRec(ir);
+  header.startDescriptor = 0xf;
+  header.nGBTWords = (nChannels + 1) / 2;
+  return block.serialize();
+}
+
+inline std::vector<char> serializeTCM(const InteractionRecord& ir, std::mt19937& gen)
+{
+  DataBlockTCM_t block{};
+  std::uniform_int_distribution<int> bit(0, 1), nChan(0, 96), ampl(-1000, 65535), time(-256, 255);
+  auto& tcm = block.DataBlockWrapper<TCMdata>::mData[0];
+  tcm.orA = bit(gen);
+  tcm.orC = bit(gen);
+  tcm.sCen = bit(gen);
+  tcm.cen = bit(gen);
+  tcm.vertex = bit(gen);
+  tcm.laser = bit(gen);
+  tcm.outputsAreBlocked = bit(gen);
+  tcm.dataIsValid = bit(gen);
+  tcm.nChanA = nChan(gen);
+  tcm.nChanC = nChan(gen);
+  tcm.amplA = ampl(gen);
+  tcm.amplC = ampl(gen);
+  tcm.timeA = time(gen);
+  tcm.timeC = time(gen);
+  auto& header = block.DataBlockWrapper<EventHeader>::mData[0];
+  header.setIntRec(ir);
+  header.startDescriptor = 0xf;
+  header.nGBTWords = 1;
+  return block.serialize();
+}
+
+/// Pages of one TF: in each orbit nBCs random bunch crossings, read out by the TCM and by
+/// a random subset of the PM links. The pages of all links are interleaved and the orbits
+/// of a link are not always in increasing order.
+inline std::vector<Page> generateTF(uint32_t firstOrbit, int nOrbits, int nBCs, const PageOptions& opt, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> percent(0, 99), bc(0, o2::constants::lhc::LHCMaxBunches - 1), badBC(o2::constants::lhc::LHCMaxBunches, 4095);
+  std::vector<std::pair<int, int>> links{{LinkTCM, 0}};
+  for (int ep = 0; ep < 2; ep++) {
+    for (int linkID = 0; linkID < NLinksPM; linkID++) {
+      links.emplace_back(linkID, ep);
+    }
+  }
+  std::vector<uint32_t> orbits(nOrbits);
+  std::iota(orbits.begin(), orbits.end(), firstOrbit);
+  std::vector<Page> pages;
+  for (const auto& [linkID, ep] : links) {
+    bool isTCM = TestLUT::Instance().isTCM(linkID, ep);
+    if (percent(gen) < 30) {
+      std::shuffle(orbits.begin(), orbits.end(), gen);
+    } else {
+      std::sort(orbits.begin(), orbits.end());
+    }
+    for (auto orbit : orbits) {
+      Page page{linkID, ep, {}};
+      // the same BCs in all links
+      std::mt19937 genBC(seed + orbit);
+      std::vector<uint16_t> bcs;
+      for (int i = 0; i < nBCs; i++) {
+        bcs.push_back(percent(genBC) < opt.percentBadBC ? badBC(genBC) : bc(genBC));
+      }
+      std::sort(bcs.begin(), bcs.end());
+      bcs.erase(std::unique(bcs.begin(), bcs.end()), bcs.end());
+      for (auto ibc : bcs) {
+        InteractionRecord ir{ibc, orbit};
+        if (!isTCM && percent(gen) < 30) {
+          continue; // no signal in this PM
+        }
+        auto block = isTCM ? serializeTCM(ir, gen) : serializePM(ir, gen);
+        if (page.payload.size() + block.size() > SIZE_MAX_PAYLOAD) {
+          pages.push_back(std::move(page));
+          page = Page{linkID, ep, {}};
+        }
+        appendBlock(page.payload, block);
+        if (!isTCM && percent(gen) < opt.percentSingleHeader) {
+          appendBlock(page.payload, serializeHeaderPM(ir, 0));
+        }
+      }
+      if (!isTCM && !page.payload.empty() && percent(gen) < opt.percentCorrupt) {
+        // more data words than a PM can send, the rest of the page is not decoded
+        appendBlock(page.payload, serializeHeaderPM({0, orbit}, DataBlockWrapper<EventData>::MaxNwords + 1));
+        appendBlock(page.payload, serializePM({0, orbit}, gen));
+      }
+      if (!page.payload.empty()) {
+        pages.push_back(std::move(page));
+      }
+    }
+  }
+  std::shuffle(pages.begin(), pages.end(), gen);
+  return pages;
+}
+
+} // namespace test
+} // namespace fit
+} // namespace o2
+
+#endif
@@ -0,0 +1,67 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchRawReaderBase.cxx
+/// \brief Benchmark of the FT0 raw data decoding into digits, BC tables of RawReaderBase against the original map
+///
+/// The argument is the number of orbits of the generated TF, with 100 bunch crossings per orbit.
+/// The same TF is decoded at each iteration by the same reader, as done from TF to TF in the workflow.
+
+#include "benchmark/benchmark.h"
+#include "DataFormatsFT0/ChannelData.h"
+#include "DataFormatsFT0/Digit.h"
+#include "RawReaderTestHelper.h"
+#include <vector>
+
+using namespace o2::fit;
+using namespace o2::fit::test;
+
+template <typename Reader>
+static void decodeTF(benchmark::State& state, Reader& reader)
+{
+  const auto pages = generateTF(1000, state.range(0), 100, PageOptions{}, 1);
+  std::vector<o2::ft0::Digit> digits;
+  std::vector<o2::ft0::ChannelData> channels;
+  size_t nBytes = 0;
+  for (const auto& page : pages) {
+    nBytes += page.payload.size();
+  }
+  int nDigits = 0;
+  for (auto _ : state) {
+    digits.clear();
+    channels.clear();
+    for (const auto& page : pages) {
+      reader.process(gsl::span<const uint8_t>(page.payload), page.linkID, page.ep);
+    }
+    nDigits = reader.getDigits(digits, channels);
+    benchmark::DoNotOptimize(digits.data());
+  }
+  state.SetItemsProcessed(state.iterations() * nDigits);
+  state.SetBytesProcessed(state.iterations() * nBytes);
+}
+
+static void BM_RawReaderBCTables(benchmark::State& state)
+{
+  RawReader_t<o2::ft0::Digit, o2::ft0::ChannelData> reader;
+  decodeTF(state, reader);
+}
+
+static void BM_RawReaderMap(benchmark::State& state)
+{
+  // reference: the data blocks of a page in a vector and the digit blocks in a map
+  MapRawReader<DigitBlock_t<o2::ft0::Digit, o2::ft0::ChannelData>> reader;
+  decodeTF(state, reader);
+}
+
+BENCHMARK(BM_RawReaderBCTables)->RangeMultiplier(4)->Range(8, 512);
+BENCHMARK(BM_RawReaderMap)->RangeMultiplier(4)->Range(8, 512);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,182 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testRawReaderBase.cxx
+/// \brief Test the digits of RawReaderBase against the original map-based raw reader, for FT0, FV0 and FDD
+
+#define BOOST_TEST_MODULE Test FIT RawReaderBase
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <vector>
+#include "DataFormatsFT0/ChannelData.h"
+#include "DataFormatsFT0/Digit.h"
+#include "DataFormatsFV0/ChannelData.h"
+#include "DataFormatsFV0/Digit.h"
+#include "DataFormatsFDD/ChannelData.h"
+#include "DataFormatsFDD/Digit.h"
+#include "RawReaderTestHelper.h"
+
+using namespace o2::fit;
+using namespace o2::fit::test;
+
+namespace
+{
+
+template <typename DigitType, typename ChannelDataType>
+struct TFDigits {
+  std::vector<DigitType> digits;
+  std::vector<ChannelDataType> channels;
+  int nDigits = 0; // returned by getDigits
+};
+
+template <typename Reader, typename DigitType, typename ChannelDataType>
+std::vector<TFDigits<DigitType, ChannelDataType>> readTFs(Reader& reader, const std::vector<std::vector<Page>>& tfs)
+{
+  std::vector<TFDigits<DigitType, ChannelDataType>> result;
+  for (const auto& pages : tfs) {
+    for (const auto& page : pages) {
+      reader.process(gsl::span<const uint8_t>(page.payload), page.linkID, page.ep);
+    }
+    auto& out = result.emplace_back();
+    out.nDigits = reader.getDigits(out.digits, out.channels);
+  }
+  return result;
+}
+
+template <typename DigitType>
+bool sameTriggers(const DigitType& a, const DigitType& b)
+{
+  TCMdata tcmA{}, tcmB{};
+  DigitBlockFIThelper::ConvertDigit2TCMData(a, tcmA);
+  DigitBlockFIThelper::ConvertDigit2TCMData(b, tcmB);
+  return std::memcmp(&tcmA, &tcmB, sizeof(TCMdata)) == 0;
+}
+
+template <typename ChannelDataType>
+bool sameChannel(const ChannelDataType& a, const ChannelDataType& b)
+{
+  EventData pmA{}, pmB{};
+  DigitBlockFIThelper::ConvertChData2EventData(a, pmA, 0);
+  DigitBlockFIThelper::ConvertChData2EventData(b, pmB, 0);
+  return a.getChannelID() == b.getChannelID() && pmA.word == pmB.word;
+}
+
+/// The digits are the ones of the map-based reader without the BCs >= 3564, in the same order
+template <typename DigitType, typename ChannelDataType>
+void checkSameDigits(const TFDigits<DigitType, ChannelDataType>& out, const TFDigits<DigitType, ChannelDataType>& ref, int& nBadBC)
+{
+  BOOST_CHECK_EQUAL(out.nDigits, int(out.digits.size()));
+  size_t iDigit = 0;
+  for (const auto& refDigit : ref.digits) {
+    if (refDigit.getIntRecord().bc >= o2::constants::lhc::LHCMaxBunches) {
+      nBadBC++;
+      continue;
+    }
+    BOOST_REQUIRE(iDigit < out.digits.size());
+    const auto& digit = out.digits[iDigit++];
+    BOOST_CHECK(digit.getIntRecord() == refDigit.getIntRecord());
+    BOOST_CHECK(sameTriggers(digit, refDigit));
+    BOOST_REQUIRE_EQUAL(digit.ref.getEntries(), refDigit.ref.getEntries());
+    for (int i = 0; i < refDigit.ref.getEntries(); i++) {
+      BOOST_CHECK(sameChannel(out.channels[digit.ref.getFirstEntry() + i], ref.channels[refDigit.ref.getFirstEntry() + i]));
+    }
+  }
+  BOOST_CHECK_EQUAL(iDigit, out.digits.size());
+  for (size_t i = 1; i < out.digits.size(); i++) {
+    BOOST_CHECK(out.digits[i - 1].getIntRecord() < out.digits[i].getIntRecord());
+  }
+}
+
+/// TFs of decreasing and increasing size, so that the digit blocks and the BC tables are reused
+std::vector<std::vector<Page>> generateTFs(const PageOptions& opt)
+{
+  std::vector<std::vector<Page>> tfs;
+  tfs.push_back(generateTF(1000, 8, 60, opt, 1));
+  tfs.push_back(generateTF(1008, 2, 10, opt, 2));
+  tfs.push_back(generateTF(1010, 12, 80, opt, 3));
+  tfs.push_back(generateTF(1022, 1, 1, opt, 4));
+  return tfs;
+}
+
+template <typename DigitType, typename ChannelDataType>
+void checkRawReader(const PageOptions& opt, bool reserve)
+{
+  const auto tfs = generateTFs(opt);
+  MapRawReader<DigitBlock_t<DigitType, ChannelDataType>> mapReader;
+  const auto ref = readTFs<decltype(mapReader), DigitType, ChannelDataType>(mapReader, tfs);
+  RawReader_t<DigitType, ChannelDataType> reader;
+  if (reserve) {
+    reader.reserve(100, 4);
+  }
+  const auto out = readTFs<decltype(reader), DigitType, ChannelDataType>(reader, tfs);
+  BOOST_REQUIRE_EQUAL(out.size(), ref.size());
+  int nBadBC = 0;
+  size_t nDigits = 0, nChannels = 0;
+  for (size_t itf = 0; itf < ref.size(); itf++) {
+    checkSameDigits(out[itf], ref[itf], nBadBC);
+    nDigits += out[itf].digits.size();
+    nChannels += out[itf].channels.size();
+  }
+  BOOST_CHECK(nDigits > 0);
+  BOOST_CHECK(nChannels > nDigits);
+  BOOST_CHECK_EQUAL(nBadBC > 0, opt.percentBadBC > 0);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(RawReaderBase_FT0)
+{
+  checkRawReader<o2::ft0::Digit, o2::ft0::ChannelData>(PageOptions{}, false);
+  checkRawReader<o2::ft0::Digit, o2::ft0::ChannelData>(PageOptions{10, 20, 5}, false);
+  checkRawReader<o2::ft0::Digit, o2::ft0::ChannelData>(PageOptions{10, 20, 5}, true);
+}
+
+BOOST_AUTO_TEST_CASE(RawReaderBase_FV0)
+{
+  checkRawReader<o2::fv0::Digit, o2::fv0::ChannelData>(PageOptions{}, false);
+  checkRawReader<o2::fv0::Digit, o2::fv0::ChannelData>(PageOptions{10, 20, 5}, true);
+}
+
+BOOST_AUTO_TEST_CASE(RawReaderBase_FDD)
+{
+  checkRawReader<o2::fdd::Digit, o2::fdd::ChannelData>(PageOptions{}, false);
+  checkRawReader<o2::fdd::Digit, o2::fdd::ChannelData>(PageOptions{10, 20, 5}, true);
+}
+
+BOOST_AUTO_TEST_CASE(RawReaderBase_corruptBlock)
+{
+  // a corrupt block ends the decoding of its page, the same data block object must decode
+  // the next page from scratch
+  InteractionRecord goodIR{100, 1000}, nextIR{200, 1000}, droppedIR{300, 1000};
+  std::mt19937 gen(5);
+  Page page{0, 0, {}};
+  appendBlock(page.payload, serializePM(goodIR, gen));
+  appendBlock(page.payload, serializeHeaderPM(goodIR, 0));
+  appendBlock(page.payload, serializeHeaderPM(goodIR, DataBlockWrapper<EventData>::MaxNwords + 1));
+  appendBlock(page.payload, serializePM(droppedIR, gen));
+  Page nextPage{1, 0, {}};
+  appendBlock(nextPage.payload, serializePM(nextIR, gen));
+  const std::vector<std::vector<Page>> tfs{{page, nextPage}};
+
+  MapRawReader<DigitBlock_t<o2::ft0::Digit, o2::ft0::ChannelData>> mapReader;
+  const auto ref = readTFs<decltype(mapReader), o2::ft0::Digit, o2::ft0::ChannelData>(mapReader, tfs);
+  RawReader_t<o2::ft0::Digit, o2::ft0::ChannelData> reader;
+  const auto out = readTFs<decltype(reader), o2::ft0::Digit, o2::ft0::ChannelData>(reader, tfs);
+  BOOST_REQUIRE_EQUAL(ref[0].digits.size(), 2u);
+  BOOST_CHECK(ref[0].digits[0].getIntRecord() == goodIR);
+  BOOST_CHECK(ref[0].digits[1].getIntRecord() == nextIR);
+  int nBadBC = 0;
+  checkSameDigits(out[0], ref[0], nBadBC);
+  BOOST_CHECK_EQUAL(nBadBC, 0);
+}
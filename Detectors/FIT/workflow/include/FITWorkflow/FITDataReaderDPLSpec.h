@@ -62,13 +62,16 @@ class FITDataReaderDPLSpec : public Task
     RawReader_t::LookupTable_t::Instance().printFullMap();
     auto nReserveVecDig = ic.options().get<int>("reserve-vec-dig");
     auto nReserveVecChData = ic.options().get<int>("reserve-vec-chdata");
-    auto nReserveVecBuffer = ic.options().get<int>("reserve-vec-buffer");
-    auto nReserveMapDig = ic.options().get<int>("reserve-map-dig");
+    auto nReserveDigitBlocks = ic.options().get<int>("reserve-digit-blocks");
+    auto nReserveOrbitTables = ic.options().get<int>("reserve-orbit-tables");
+    if (ic.options().get<int>("reserve-vec-buffer") || ic.options().get<int>("reserve-map-dig")) {
+      LOG(warning) << "Options reserve-vec-buffer and reserve-map-dig are obsolete and ignored, use reserve-digit-blocks and reserve-orbit-tables";
+    }
     if (nReserveVecDig || nReserveVecChData) {
       mRawReader.reserveVecDPL(nReserveVecDig, nReserveVecChData);
     }
-    if (nReserveVecBuffer || nReserveMapDig) {
-      mRawReader.reserve(nReserveVecBuffer, nReserveMapDig);
+    if (nReserveDigitBlocks || nReserveOrbitTables) {
+      mRawReader.reserve(nReserveDigitBlocks, nReserveOrbitTables);
     }
   }
   void run(ProcessingContext& pc) final
@@ -131,8 +134,10 @@ framework::DataProcessorSpec getFITDataReaderDPLSpec(const RawReaderType& rawRea
      o2::framework::ConfigParamSpec{"lut-path", VariantType::String, "", {"LookupTable path, e.g. FT0/LookupTable"}},
      o2::framework::ConfigParamSpec{"reserve-vec-dig", VariantType::Int, 0, {"Reserve memory for Digit vector, to DPL channel"}},
      o2::framework::ConfigParamSpec{"reserve-vec-chdata", VariantType::Int, 0, {"Reserve memory for ChannelData vector, to DPL channel"}},
-     o2::framework::ConfigParamSpec{"reserve-vec-buffer", VariantType::Int, 0, {"Reserve memory for DataBlock vector, buffer for each page"}},
-     o2::framework::ConfigParamSpec{"reserve-map-dig", VariantType::Int, 0, {"Reserve memory for Digit map, mapping in RawReader"}},
+     o2::framework::ConfigParamSpec{"reserve-digit-blocks", VariantType::Int, 0, {"Reserve digit blocks in RawReader, reused from TF to TF"}},
+     o2::framework::ConfigParamSpec{"reserve-orbit-tables", VariantType::Int, 0, {"Reserve memory for BC tables in RawReader, one per orbit with data"}},
+     o2::framework::ConfigParamSpec{"reserve-vec-buffer", VariantType::Int, 0, {"Obsolete, ignored"}},
+     o2::framework::ConfigParamSpec{"reserve-map-dig", VariantType::Int, 0, {"Obsolete, ignored"}},
      o2::framework::ConfigParamSpec{"disable-empty-tf-protection", VariantType::Bool, false, {"Disable empty TF protection. In case of empty payload within TF, only dummy ChannelData object will be sent."}}}};
 }
 
@@ -193,7 +193,30 @@ class MatchTOF
   void setTS(unsigned long creationTime) { mTimestamp = creationTime; }
   unsigned long getTS() const { return mTimestamp; }
 
+  ///< set number of threads for the seeds propagation and the matching
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
  private:
+  ///< seed collected from the input tracks, registered for the matching once propagated to the reference X
+  struct SeedTOF {
+    o2::track::TrackParCov trc;
+    o2::track::TrackLTIntegral intLT;
+    timeEst time;
+    o2::dataformats::GlobalTrackID gid;
+    float extraTPCFwdTime = 0.; ///< for TPC tracks only
+    int8_t side = 0;            ///< for TPC tracks only
+    int sector = -1;            ///< sector at the reference X, -1 if the propagation failed
+  };
+
+  ///< range of time-ordered tracks of the sector matched by a single thread, with the track-cluster pairs it found
+  struct MatchingChunk {
+    int sector = 0;
+    int firstTrk = 0; ///< 1st entry of the chunk in the mTracksSectIndexCache of the sector
+    int lastTrk = 0;  ///< last+1 entry of the chunk in the mTracksSectIndexCache of the sector
+    std::vector<o2::dataformats::MatchInfoTOFReco> pairs;
+  };
+
   bool prepareFITData();
   int prepareInteractionTimes();
   bool prepareTPCData();
@@ -201,12 +224,16 @@ class MatchTOF
   void addITSTPCSeed(const o2::dataformats::TrackTPCITS& _tr, o2::dataformats::GlobalTrackID srcGID);
   void addTRDSeed(const o2::trd::TrackTRD& _tr, o2::dataformats::GlobalTrackID srcGID, float time0, float terr);
   void addConstrainedSeed(o2::track::TrackParCov& trc, o2::dataformats::GlobalTrackID srcGID, o2::track::TrackLTIntegral intLT0, timeEst timeMUS);
+  bool propagateConstrainedSeed(SeedTOF& seed);
+  bool propagateTPCSeed(SeedTOF& seed);
+  void propagateSeeds(trkType type);
   //  void addTPCTRDSeed(const o2::track::TrackParCov& _tr, o2::dataformats::GlobalTrackID srcGID, int tpcID);
   //  void addITSTPCTRDSeed(const o2::track::TrackParCov& _tr, o2::dataformats::GlobalTrackID srcGID, int tpcID);
   bool prepareTOFClusters();
 
-  void doMatching(int sec);
-  void doMatchingForTPC(int sec);
+  void prepareMatchingChunks(trkType type);
+  void doMatching(MatchingChunk& chunk);
+  void doMatchingForTPC(MatchingChunk& chunk);
   void selectBestMatches();
   void selectBestMatchesHP();
   bool propagateToRefX(o2::track::TrackParCov& trc, float xRef /*in cm*/, float stepInCm /*in cm*/, o2::track::TrackLTIntegral& intLT);
@@ -226,6 +253,7 @@ class MatchTOF
   float mXRef = Geo::RMIN; ///< reference radius to propage tracks for matching
 
   bool mMCTruthON = false; ///< flag availability of MC truth
+  int mNThreads = 1;       ///< number of OMP threads
 
   ///========== Parameters to be set externally, e.g. from CCDB ====================
   float mTPCVDriftRef = -1.; ///< TPC nominal drift speed in cm/microseconds
@@ -286,6 +314,8 @@ class MatchTOF
   std::vector<o2::dataformats::GlobalTrackID> mTrackGid[trkType::SIZE]; ///<expected times and others
   ///< per sector indices of track entry in mTracksWork
   std::array<std::vector<int>, o2::constants::math::NSectors> mTracksSectIndexCache[trkType::SIZE];
+  std::vector<SeedTOF> mSeedsWork[trkType::SIZE];             //! seeds waiting for the propagation to the reference X
+  std::vector<MatchingChunk> mMatchingChunks[trkType::SIZE];  //! chunks of tracks matched in parallel
 
   std::vector<float> mExtraTPCFwdTime;                             ///<track extra params for TPC tracks: Fws Max time
   std::vector<Cluster> mTOFClusWork;                               ///<track params prepared for matching
@@ -316,6 +346,7 @@ class MatchTOF
 
   ///----------- aux stuff --------------///
   static constexpr float MAXSNP = 0.85; // max snp of ITS or TPC track at xRef to be matched
+  static constexpr int MinTracksPerChunk = 16; // min number of tracks in the chunk of the sector matched by single thread
 
   TStopwatch mTimerTot;
   TStopwatch mTimerMatchITSTPC;
@@ -174,6 +174,26 @@ struct MatchRecord {
   }
 };
 
+///< ITS track accepted as matching candidate for the TPC track, to be registered in the MatchRecords
+struct MatchCandidate {
+  int itsID = MinusOne;     ///< entry in mITSWork
+  int tpcID = MinusOne;     ///< entry in mTPCWork
+  float chi2 = -1.f;        ///< matching chi2
+  int matchedIC = MinusOne; ///< index of eventually matched InteractionCandidate
+  MatchCandidate(int iITS, int iTPC, float chi2match, int candIC) : itsID(iITS), tpcID(iTPC), chi2(chi2match), matchedIC(candIC) {}
+  MatchCandidate() = default;
+};
+
+///< range of time-ordered TPC tracks of the sector matched by a single thread, with the candidates it found
+struct MatchingChunk {
+  int sector = 0;
+  int firstTPC = 0;  ///< 1st entry of the chunk in the mTPCSectIndexCache of the sector
+  int lastTPC = 0;   ///< last+1 entry of the chunk in the mTPCSectIndexCache of the sector
+  int nCheckTPC = 0; ///< number of TPC tracks checked
+  int nCheckITS = 0; ///< number of TPC-ITS pairs compared
+  std::vector<MatchCandidate> candidates;
+};
+
 ///< Link of the AfterBurner track: update at sertain cluster
 ///< original track in the currently loaded TPC reco output
 struct ABTrackLink : public o2::track::TrackParCov {
@@ -302,6 +322,7 @@ class MatchTPCITS
   static constexpr int MaxUpDnLadders = 3;                     // max N ladders to check up and down from selected one
   static constexpr int MaxLadderCand = 2 * MaxUpDnLadders + 1; // max ladders to check for matching clusters
   static constexpr int MaxSeedsPerLayer = 50;                  // TODO
+  static constexpr int MinTPCTracksPerChunk = 32;              // min number of TPC tracks in the chunk of the sector matched by single thread
   static constexpr int NITSLayers = o2::its::RecoGeomHelper::getNLayers();
   ///< perform matching for provided input
   void run(const o2::globaltracking::RecoContainer& inp);
@@ -421,10 +442,11 @@ class MatchTPCITS
   void fillClustersForAfterBurner(int rofStart, int nROFs, ITSChipClustersRefs& itsChipClRefs);
   void flagUsedITSClusters(const o2::its::TrackITS& track);
 
-  void doMatching(int sec);
+  void doMatching();
+  void doMatching(MatchingChunk& chunk);
 
   void refitWinners();
-  bool refitTrackTPCITS(int iTPC, int& iITS);
+  bool refitTrackTPCITS(o2::dataformats::TrackTPCITS& trfit, int iTPC, int& iITS);
   bool refitTPCInward(o2::track::TrackParCov& trcIn, float& chi2, float xTgt, int trcID, float timeTB) const;
 
   void selectBestMatches();
@@ -606,6 +628,7 @@ class MatchTPCITS
   MCLabContTr mTPCLblWork;             ///< TPC track labels
   MCLabContTr mITSLblWork;             ///< ITS track labels
   std::vector<float> mWinnerChi2Refit; ///< vector of refitChi2 for winners
+  std::vector<MatchingChunk> mMatchingChunks; ///< chunks of TPC tracks matched in parallel
 
   // ------------------------------
   std::vector<TPCABSeed> mTPCABSeeds; ///< pool of primary TPC seeds for AB
@@ -76,6 +76,7 @@ void MatchTOF::run(const o2::globaltracking::RecoContainer& inp)
   for (int i = 0; i < trkType::SIZE; i++) {
     mTracksWork[i].clear();
     mTrackGid[i].clear();
+    mMatchingChunks[i].clear();
   }
   for (int it = 0; it < trkType::SIZE; it++) {
     mMatchedTracksIndex[it].clear();
@@ -115,20 +116,41 @@ void MatchTOF::run(const o2::globaltracking::RecoContainer& inp)
   LOGF(info, "Timing prepare FIT data: Cpu: %.3e s Real: %.3e s in %d slots", mTimerTot.CpuTime(), mTimerTot.RealTime(), mTimerTot.Counter() - 1);
 
   mTimerTot.Start();
+  // sectors are independent until the best matches selection: the tracks of all sectors are matched in parallel
+  Geo::Init(); // lazily initialized geometry tables must be ready before the threads use them
+  Geo::InitIndices();
+  if (mIsITSTPCused || mIsTPCTRDused || mIsITSTPCTRDused) {
+    mTimerMatchITSTPC.Start();
+    prepareMatchingChunks(trkType::CONSTR);
+    auto& chunks = mMatchingChunks[trkType::CONSTR];
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+    for (int ich = 0; ich < (int)chunks.size(); ich++) {
+      doMatching(chunks[ich]);
+    }
+    mTimerMatchITSTPC.Stop();
+  }
+  if (mIsTPCused) {
+    mTimerMatchTPC.Start();
+    prepareMatchingChunks(trkType::UNCONS);
+    auto& chunks = mMatchingChunks[trkType::UNCONS];
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+    for (int ich = 0; ich < (int)chunks.size(); ich++) {
+      doMatchingForTPC(chunks[ich]);
+    }
+    mTimerMatchTPC.Stop();
+  }
+  // the pairs of every sector are merged in the order of the sequential matching
+  int ichunk[trkType::SIZE] = {0};
   for (int sec = o2::constants::math::NSectors; sec--;) {
     mMatchedTracksPairs.clear(); // new sector
-    LOG(debug) << "Doing matching for sector " << sec << "...";
-    if (mIsITSTPCused || mIsTPCTRDused || mIsITSTPCTRDused) {
-      mTimerMatchITSTPC.Start(sec == o2::constants::math::NSectors - 1);
-      doMatching(sec);
-      mTimerMatchITSTPC.Stop();
-    }
-    if (mIsTPCused) {
-      mTimerMatchTPC.Start(sec == o2::constants::math::NSectors - 1);
-      doMatchingForTPC(sec);
-      mTimerMatchTPC.Stop();
+    for (auto type : {trkType::CONSTR, trkType::UNCONS}) {
+      const auto& chunks = mMatchingChunks[type];
+      for (; ichunk[type] < (int)chunks.size() && chunks[ichunk[type]].sector == sec; ichunk[type]++) {
+        const auto& pairs = chunks[ichunk[type]].pairs;
+        mMatchedTracksPairs.insert(mMatchedTracksPairs.end(), pairs.begin(), pairs.end());
+      }
     }
-    LOG(debug) << "...done. Now check the best matches";
+    LOG(debug) << "Matching for sector " << sec << " done. Now check the best matches";
     selectBestMatches();
   }
 
@@ -225,6 +247,10 @@ bool MatchTOF::prepareTPCData()
   };
   mRecoCont->createTracksVariadic(creator);
 
+  for (int it = 0; it < trkType::SIZE; it++) {
+    propagateSeeds(trkType(it));
+  }
+
   for (int it = 0; it < trkType::SIZE; it++) {
     mMatchedTracksIndex[it].resize(mTracksWork[it].size());
     std::fill(mMatchedTracksIndex[it].begin(), mMatchedTracksIndex[it].end(), -1); // initializing all to -1
@@ -280,9 +306,18 @@ void MatchTOF::addITSTPCSeed(const o2::dataformats::TrackTPCITS& _tr, o2::datafo
 //______________________________________________
 void MatchTOF::addConstrainedSeed(o2::track::TrackParCov& trc, o2::dataformats::GlobalTrackID srcGID, o2::track::TrackLTIntegral intLT0, timeEst timeMUS)
 {
+  // the seed will be propagated to the matching reference X in propagateSeeds
+  auto& seed = mSeedsWork[trkType::CONSTR].emplace_back();
+  seed.trc = trc;
+  seed.intLT = intLT0;
+  seed.time = timeMUS;
+  seed.gid = srcGID;
+}
+//______________________________________________
+bool MatchTOF::propagateConstrainedSeed(SeedTOF& seed)
+{
+  auto& trc = seed.trc;
   std::array<float, 3> globalPos;
-  // current track index
-  int it = mTracksWork[trkType::CONSTR].size();
 
   // propagate to matching Xref
   trc.getXYZGlo(globalPos);
@@ -290,14 +325,12 @@ void MatchTOF::addConstrainedSeed(o2::track::TrackParCov& trc, o2::dataformats::
   LOG(debug) << "Radius xy Before propagating to 371 cm = " << TMath::Sqrt(globalPos[0] * globalPos[0] + globalPos[1] * globalPos[1]);
   LOG(debug) << "Radius xyz Before propagating to 371 cm = " << TMath::Sqrt(globalPos[0] * globalPos[0] + globalPos[1] * globalPos[1] + globalPos[2] * globalPos[2]);
   if (!propagateToRefXWithoutCov(trc, mXRef, 2, mBz)) { // we first propagate to 371 cm without considering the covariance matrix
-    mNotPropagatedToTOF[trkType::CONSTR]++;
-    return;
+    return false;
   }
 
   // the "rough" propagation worked; now we can propagate considering also the cov matrix
-  if (!propagateToRefX(trc, mXRef, 2, intLT0) || TMath::Abs(trc.getZ()) > Geo::MAXHZTOF) { // we check that the propagation with the cov matrix worked; CHECK: can it happen that it does not if the prop>
-    mNotPropagatedToTOF[trkType::CONSTR]++;
-    return;
+  if (!propagateToRefX(trc, mXRef, 2, seed.intLT) || TMath::Abs(trc.getZ()) > Geo::MAXHZTOF) { // we check that the propagation with the cov matrix worked; CHECK: can it happen that it does not if the prop>
+    return false;
   }
 
   trc.getXYZGlo(globalPos);
@@ -307,20 +340,10 @@ void MatchTOF::addConstrainedSeed(o2::track::TrackParCov& trc, o2::dataformats::
   LOG(debug) << "Radius xyz After propagating to 371 cm = " << TMath::Sqrt(globalPos[0] * globalPos[0] + globalPos[1] * globalPos[1] + globalPos[2] * globalPos[2]);
   LOG(debug) << "The track will go to sector " << o2::math_utils::angle2Sector(TMath::ATan2(globalPos[1], globalPos[0]));
 
-  int sector = o2::math_utils::angle2Sector(TMath::ATan2(globalPos[1], globalPos[0]));
-
-  // create working copy of track param
-  mTracksWork[trkType::CONSTR].emplace_back(std::make_pair(trc, timeMUS));
-  mTrackGid[trkType::CONSTR].emplace_back(srcGID);
-  mLTinfos[trkType::CONSTR].emplace_back(intLT0);
-
-  if (mMCTruthON) {
-    mTracksLblWork[trkType::CONSTR].emplace_back(mRecoCont->getTPCITSTrackMCLabel(srcGID));
-  }
-
-  mTracksSectIndexCache[trkType::CONSTR][sector].push_back(it);
-  //delete trc; // Check: is this needed?
-} //______________________________________________
+  seed.sector = o2::math_utils::angle2Sector(TMath::ATan2(globalPos[1], globalPos[0]));
+  return true;
+}
+//______________________________________________
 void MatchTOF::addTRDSeed(const o2::trd::TrackTRD& _tr, o2::dataformats::GlobalTrackID srcGID, float time0, float terr)
 {
   if (srcGID.getSource() == o2::dataformats::GlobalTrackID::TPCTRD) {
@@ -346,61 +369,89 @@ void MatchTOF::addTPCSeed(const o2::tpc::TrackTPC& _tr, o2::dataformats::GlobalT
 {
   mIsTPCused = true;
 
-  std::array<float, 3> globalPos;
-
-  // current track index
-  int it = mTracksWork[trkType::UNCONS].size();
-
-  // create working copy of track param
-  timeEst timeInfo;
   // set
   float extraErr = 0;
   if (mIsCosmics) {
     extraErr = 100;
   }
 
-  auto trc = _tr.getOuterParam();
+  // the seed will be propagated to the matching reference X in propagateSeeds
+  auto& seed = mSeedsWork[trkType::UNCONS].emplace_back();
+  seed.trc = _tr.getOuterParam();
+  seed.gid = srcGID;
+  seed.time.setTimeStamp(_tr.getTime0() * mTPCTBinMUS);
+  seed.time.setTimeStampError((_tr.getDeltaTBwd() + 5) * mTPCTBinMUS + extraErr);
+  seed.side = _tr.hasASideClustersOnly() ? 1 : (_tr.hasCSideClustersOnly() ? -1 : 0);
+  seed.extraTPCFwdTime = (_tr.getDeltaTFwd() + 5) * mTPCTBinMUS + extraErr;
+}
+//______________________________________________
+bool MatchTOF::propagateTPCSeed(SeedTOF& seed)
+{
+  auto& trc = seed.trc;
+  std::array<float, 3> globalPos;
 
   if (!propagateToRefXWithoutCov(trc, mXRef, 10, mBz)) { // we first propagate to 371 cm without considering the covariance matri
-    mNotPropagatedToTOF[trkType::UNCONS]++;
-    return;
+    return false;
   }
 
-  o2::track::TrackLTIntegral intLT0; //mTPCTracksWork.back().getLTIntegralOut(); // we get the integrated length from TPC-ITC outward propagation
+  auto& intLT0 = seed.intLT; //mTPCTracksWork.back().getLTIntegralOut(); // we get the integrated length from TPC-ITC outward propagation
   // compute track length up to now
   o2::base::Propagator::Instance()->estimateLTFast(intLT0, trc);
 
   if (trc.getX() < o2::constants::geom::XTPCOuterRef - 1.) {
     if (!propagateToRefX(trc, o2::constants::geom::XTPCOuterRef, 10, intLT0) || TMath::Abs(trc.getZ()) > Geo::MAXHZTOF) { // we check that the propagation with the cov matrix worked; CHECK: can it happ
-      mNotPropagatedToTOF[trkType::UNCONS]++;
-      return;
+      return false;
     }
   }
 
   // the "rough" propagation worked; now we can propagate considering also the cov matrix
   if (!propagateToRefX(trc, mXRef, 2, intLT0)) { // || TMath::Abs(trc.getZ()) > Geo::MAXHZTOF) { // we check that the propagation with the cov matrix worked; CHECK: can it happen that it does not if the prop>
-    mNotPropagatedToTOF[trkType::UNCONS]++;
-    return;
+    return false;
   }
 
-  timeInfo.setTimeStamp(_tr.getTime0() * mTPCTBinMUS);
-  timeInfo.setTimeStampError((_tr.getDeltaTBwd() + 5) * mTPCTBinMUS + extraErr);
-  mSideTPC.push_back(_tr.hasASideClustersOnly() ? 1 : (_tr.hasCSideClustersOnly() ? -1 : 0));
-  mExtraTPCFwdTime.push_back((_tr.getDeltaTFwd() + 5) * mTPCTBinMUS + extraErr);
-
   trc.getXYZGlo(globalPos);
-  int sector = o2::math_utils::angle2Sector(TMath::ATan2(globalPos[1], globalPos[0]));
+  seed.sector = o2::math_utils::angle2Sector(TMath::ATan2(globalPos[1], globalPos[0]));
+  return true;
+}
+//______________________________________________
+void MatchTOF::propagateSeeds(trkType type)
+{
+  ///< propagate the collected seeds to the matching reference X and create the working copies of those which reached it.
+  ///< The propagation is done in parallel, the working copies are created in the order of the input tracks
+  auto& seeds = mSeedsWork[type];
+  int nSeeds = seeds.size();
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+  for (int is = 0; is < nSeeds; is++) {
+    auto& seed = seeds[is];
+    if (!(type == trkType::UNCONS ? propagateTPCSeed(seed) : propagateConstrainedSeed(seed))) {
+      seed.sector = -1;
+    }
+  }
 
-  mTracksWork[trkType::UNCONS].emplace_back(std::make_pair(trc, timeInfo));
-  mTrackGid[trkType::UNCONS].emplace_back(srcGID);
+  for (const auto& seed : seeds) {
+    if (seed.sector < 0) {
+      mNotPropagatedToTOF[type]++;
+      continue;
+    }
+    // current track index
+    int it = mTracksWork[type].size();
 
-  if (mMCTruthON) {
-    mTracksLblWork[trkType::UNCONS].emplace_back(mRecoCont->getTPCTrackMCLabel(srcGID));
-  }
-  mLTinfos[trkType::UNCONS].emplace_back(intLT0);
+    // create working copy of track param
+    mTracksWork[type].emplace_back(std::make_pair(seed.trc, seed.time));
+    mTrackGid[type].emplace_back(seed.gid);
+    mLTinfos[type].emplace_back(seed.intLT);
+
+    if (mMCTruthON) {
+      mTracksLblWork[type].emplace_back(type == trkType::UNCONS ? mRecoCont->getTPCTrackMCLabel(seed.gid) : mRecoCont->getTPCITSTrackMCLabel(seed.gid));
+    }
+    if (type == trkType::UNCONS) {
+      mSideTPC.push_back(seed.side);
+      mExtraTPCFwdTime.push_back(seed.extraTPCFwdTime);
+    }
 
-  mTracksSectIndexCache[trkType::UNCONS][sector].push_back(it);
-  //delete trc; // Check: is this needed?
+    mTracksSectIndexCache[type][seed.sector].push_back(it);
+  }
+  seeds.clear();
 }
 //______________________________________________
 bool MatchTOF::prepareTOFClusters()
@@ -462,11 +513,12 @@ bool MatchTOF::prepareTOFClusters()
   return true;
 }
 //______________________________________________
-void MatchTOF::doMatching(int sec)
+void MatchTOF::doMatching(MatchingChunk& chunk)
 {
   trkType type = trkType::CONSTR;
+  int sec = chunk.sector;
 
-  ///< do the real matching per sector
+  ///< do the real matching for the chunk of tracks of the sector
   auto& cacheTOF = mTOFClusSectIndexCache[sec];      // array of cached TOF cluster indices for this sector; reminder: they are ordered in time!
   auto& cacheTrk = mTracksSectIndexCache[type][sec]; // array of cached tracks indices for this sector; reminder: they are ordered in time!
   int nTracks = cacheTrk.size(), nTOFCls = cacheTOF.size();
@@ -486,8 +538,8 @@ void MatchTOF::doMatching(int sec)
 
   // prematching for TPC only tracks (identify BC candidate to correct z for TPC track accordingly to v_drift)
 
-  LOG(debug) << "Trying to match %d tracks" << cacheTrk.size();
-  for (int itrk = 0; itrk < cacheTrk.size(); itrk++) {
+  LOG(debug) << "Trying to match %d tracks" << chunk.lastTrk - chunk.firstTrk;
+  for (int itrk = chunk.firstTrk; itrk < chunk.lastTrk; itrk++) {
     for (int ii = 0; ii < 2; ii++) {
       detId[ii][2] = -1; // before trying to match, we need to inizialize the detId corresponding to the strip number to -1; this is the array that we will use to save the det id of the maximum 2 strips matched
       nStepsInsideSameStrip[ii] = 0;
@@ -694,7 +746,7 @@ void MatchTOF::doMatching(int sec)
           foundCluster = true;
           // set event indexes (to be checked)
           int eventIndexTOFCluster = mTOFClusSectIndexCache[indices[0]][itof];
-          mMatchedTracksPairs.emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[iPropagation], mTrackGid[type][cacheTrk[itrk]], type, (trefTOF.getTime() - (minTrkTime + maxTrkTime) * 0.5) * 1E-6, 0., resX, resZ); // TODO: check if this is correct!
+          chunk.pairs.emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[iPropagation], mTrackGid[type][cacheTrk[itrk]], type, (trefTOF.getTime() - (minTrkTime + maxTrkTime) * 0.5) * 1E-6, 0., resX, resZ); // TODO: check if this is correct!
         }
       }
     }
@@ -702,8 +754,9 @@ void MatchTOF::doMatching(int sec)
   return;
 }
 //______________________________________________
-void MatchTOF::doMatchingForTPC(int sec)
+void MatchTOF::doMatchingForTPC(MatchingChunk& chunk)
 {
+  int sec = chunk.sector;
   float vdriftInBC = Geo::BC_TIME_INPS * 1E-6 * mTPCVDrift;
 
   int bc_grouping = 40;
@@ -711,7 +764,7 @@ void MatchTOF::doMatchingForTPC(int sec)
   int bc_grouping_half = (bc_grouping + 1) / 2;
   double BCgranularity = Geo::BC_TIME_INPS * bc_grouping;
 
-  ///< do the real matching per sector
+  ///< do the real matching for the chunk of tracks of the sector
   auto& cacheTOF = mTOFClusSectIndexCache[sec];                 // array of cached TOF cluster indices for this sector; reminder: they are ordered in time!
   auto& cacheTrk = mTracksSectIndexCache[trkType::UNCONS][sec]; // array of cached tracks indices for this sector; reminder: they are ordered in time!
   int nTracks = cacheTrk.size(), nTOFCls = cacheTOF.size();
@@ -735,9 +788,9 @@ void MatchTOF::doMatchingForTPC(int sec)
   std::vector<std::array<std::array<float, 3>, 2>> deltaPos;
   std::vector<std::array<int, 2>> nStepsInsideSameStrip;
 
-  LOG(debug) << "Trying to match %d tracks" << cacheTrk.size();
+  LOG(debug) << "Trying to match %d tracks" << chunk.lastTrk - chunk.firstTrk;
 
-  for (int itrk = 0; itrk < cacheTrk.size(); itrk++) {
+  for (int itrk = chunk.firstTrk; itrk < chunk.lastTrk; itrk++) {
     auto& trackWork = mTracksWork[trkType::UNCONS][cacheTrk[itrk]];
     auto& trefTrk = trackWork.first;
     auto& intLT = mLTinfos[trkType::UNCONS][cacheTrk[itrk]];
@@ -1020,7 +1073,7 @@ void MatchTOF::doMatchingForTPC(int sec)
             foundCluster = true;
             // set event indexes (to be checked)
             int eventIndexTOFCluster = mTOFClusSectIndexCache[indices[0]][itof];
-            mMatchedTracksPairs.emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[ibc][iPropagation], mTrackGid[trkType::UNCONS][cacheTrk[itrk]], trkType::UNCONS, resZ / mTPCVDrift * side, trefTOF.getZ(), resX, resZ); // TODO: check if this is correct!
+            chunk.pairs.emplace_back(cacheTrk[itrk], eventIndexTOFCluster, mTOFClusWork[cacheTOF[itof]].getTime(), chi2, trkLTInt[ibc][iPropagation], mTrackGid[trkType::UNCONS][cacheTrk[itrk]], trkType::UNCONS, resZ / mTPCVDrift * side, trefTOF.getZ(), resX, resZ); // TODO: check if this is correct!
           }
         }
       }
@@ -1029,6 +1082,27 @@ void MatchTOF::doMatchingForTPC(int sec)
   return;
 }
 //______________________________________________
+void MatchTOF::prepareMatchingChunks(trkType type)
+{
+  ///< split the time-ordered tracks of every sector in chunks to be matched by single thread, ordered as in the sequential matching
+  auto& chunks = mMatchingChunks[type];
+  chunks.clear();
+  int nTracksTot = mTracksWork[type].size();
+  int chunkSize = mNThreads > 1 ? std::max(MinTracksPerChunk, nTracksTot / (mNThreads * 8)) : std::max(1, nTracksTot);
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    int nTracks = mTracksSectIndexCache[type][sec].size(), nTOFCls = mTOFClusSectIndexCache[sec].size();
+    if (!nTracks || !nTOFCls) {
+      continue;
+    }
+    for (int itrk = 0; itrk < nTracks; itrk += chunkSize) {
+      auto& chunk = chunks.emplace_back();
+      chunk.sector = sec;
+      chunk.firstTrk = itrk;
+      chunk.lastTrk = std::min(itrk + chunkSize, nTracks);
+    }
+  }
+}
+//______________________________________________
 int MatchTOF::findFITIndex(int bc)
 {
   if (mFITRecPoints.size() == 0) {
@@ -1444,3 +1518,13 @@ void MatchTOF::checkRefitter()
                                                                   nullptr, o2::base::Propagator::Instance());
   }
 }
+//______________________________________________
+void MatchTOF::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  LOG(warning) << "Multithreading is not supported, imposing single thread";
+  mNThreads = 1;
+#endif
+}
@@ -90,9 +90,7 @@ void MatchTPCITS::run(const o2::globaltracking::RecoContainer& inp)
     }
 
     mTimer[SWDoMatching].Start(false);
-    for (int sec = o2::constants::math::NSectors; sec--;) {
-      doMatching(sec);
-    }
+    doMatching();
     mTimer[SWDoMatching].Stop();
     if (0) { // enabling this creates very verbose output
       mTimer[SWTot].Stop();
@@ -693,40 +691,91 @@ bool MatchTPCITS::prepareFITData()
 }
 
 //_____________________________________________________
-void MatchTPCITS::doMatching(int sec)
+void MatchTPCITS::doMatching()
 {
-  ///< run matching for currently cached ITS data for given TPC sector
+  ///< run matching for currently cached ITS and TPC data of all sectors.
+  ///< The time-ordered TPC tracks of every sector are split in chunks matched in parallel, the candidates found
+  ///< are then registered in the same order as in the sequential processing, so that the best-match
+  ///< competition does not depend on the number of threads
+  mMatchingChunks.clear();
+  int nTPCToCheck = 0;
+  std::array<int, o2::constants::math::NSectors> idxMinTPC{};
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    idxMinTPC[sec] = -1;
+    auto& cacheITS = mITSSectIndexCache[sec];
+    auto& cacheTPC = mTPCSectIndexCache[sec];
+    int nTracksTPC = cacheTPC.size(), nTracksITS = cacheITS.size();
+    if (!nTracksTPC || !nTracksITS) {
+      if (mParams->verbosity > 0) {
+        LOG(info) << "Matchng sector " << sec << " : N tracks TPC:" << nTracksTPC << " ITS:" << nTracksITS << " in sector " << sec;
+      }
+      continue;
+    }
+    // get min ROFrame of ITS tracks currently in cache
+    auto minROFITS = mITSWork[cacheITS.front()].roFrame;
+    if (minROFITS >= int(mTPCTimeStart[sec].size())) {
+      LOG(info) << "ITS min ROFrame " << minROFITS << " exceeds all cached TPC track ROF eqiuvalent " << cacheTPC.size() - 1;
+      continue;
+    }
+    idxMinTPC[sec] = mTPCTimeStart[sec][minROFITS]; // index of 1st cached TPC track within cached ITS ROFrames
+    nTPCToCheck += nTracksTPC - idxMinTPC[sec];
+  }
+  int chunkSize = mNThreads > 1 ? std::max(MinTPCTracksPerChunk, nTPCToCheck / (mNThreads * 8)) : std::max(1, nTPCToCheck);
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    int nTracksTPC = mTPCSectIndexCache[sec].size();
+    for (int itpc = idxMinTPC[sec]; itpc >= 0 && itpc < nTracksTPC; itpc += chunkSize) {
+      auto& chunk = mMatchingChunks.emplace_back();
+      chunk.sector = sec;
+      chunk.firstTPC = itpc;
+      chunk.lastTPC = std::min(itpc + chunkSize, nTracksTPC);
+    }
+  }
+  int nChunks = mMatchingChunks.size();
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+  for (int ich = 0; ich < nChunks; ich++) {
+    doMatching(mMatchingChunks[ich]);
+  }
+
+  int nCheckTPCControl = 0, nCheckITSControl = 0, nMatchesControl = 0; // temporary
+  for (int ich = 0; ich < nChunks; ich++) {
+    const auto& chunk = mMatchingChunks[ich];
+    for (const auto& cand : chunk.candidates) {
+      registerMatchRecordTPC(cand.itsID, cand.tpcID, cand.chi2, cand.matchedIC); // register matching candidate
+    }
+    nCheckTPCControl += chunk.nCheckTPC;
+    nCheckITSControl += chunk.nCheckITS;
+    nMatchesControl += chunk.candidates.size();
+    if (mParams->verbosity > 0 && (ich + 1 == nChunks || mMatchingChunks[ich + 1].sector != chunk.sector)) {
+      int sec = chunk.sector;
+      LOG(info) << "Match sector " << sec << " N tracks TPC:" << mTPCSectIndexCache[sec].size() << " ITS:" << mITSSectIndexCache[sec].size()
+                << " N TPC tracks checked: " << nCheckTPCControl << " (starting from " << idxMinTPC[sec]
+                << "), checks: " << nCheckITSControl << ", matches:" << nMatchesControl;
+      nCheckTPCControl = nCheckITSControl = nMatchesControl = 0;
+    }
+  }
+}
+
+//_____________________________________________________
+void MatchTPCITS::doMatching(MatchingChunk& chunk)
+{
+  ///< find matching candidates for the chunk of cached TPC tracks of the sector, w/o modifying the match records
+  int sec = chunk.sector;
   auto& cacheITS = mITSSectIndexCache[sec]; // array of cached ITS track indices for this sector
   auto& cacheTPC = mTPCSectIndexCache[sec]; // array of cached ITS track indices for this sector
-  auto& timeStartTPC = mTPCTimeStart[sec];  // array of 1st TPC track with timeMax in ITS ROFrame
   auto& timeStartITS = mITSTimeStart[sec];
-  int nTracksTPC = cacheTPC.size(), nTracksITS = cacheITS.size();
-  if (!nTracksTPC || !nTracksITS) {
-    if (mParams->verbosity > 0) {
-      LOG(info) << "Matchng sector " << sec << " : N tracks TPC:" << nTracksTPC << " ITS:" << nTracksITS << " in sector " << sec;
-    }
-    return;
-  }
+  int nTracksITS = cacheITS.size();
+  chunk.candidates.clear();
+  chunk.nCheckTPC = chunk.nCheckITS = 0;
 
   /// full drift time + safety margin
   float maxTDriftSafe = tpcTimeBin2MUS(mNTPCBinsFullDrift + mParams->safeMarginTPCITSTimeBin + mTPCTimeEdgeTSafeMargin);
   float vdErrT = tpcTimeBin2MUS(mZ2TPCBin * mParams->maxVDriftUncertainty);
 
-  // get min ROFrame of ITS tracks currently in cache
-  auto minROFITS = mITSWork[cacheITS.front()].roFrame;
-
-  if (minROFITS >= int(timeStartTPC.size())) {
-    LOG(info) << "ITS min ROFrame " << minROFITS << " exceeds all cached TPC track ROF eqiuvalent " << cacheTPC.size() - 1;
-    return;
-  }
-
-  int nCheckTPCControl = 0, nCheckITSControl = 0, nMatchesControl = 0; // temporary
-  int idxMinTPC = timeStartTPC[minROFITS];                             // index of 1st cached TPC track within cached ITS ROFrames
   auto t2nbs = tpcTimeBin2MUS(mZ2TPCBin * mParams->tpcTimeICMatchingNSigma);
   bool checkInteractionCandidates = mUseFT0 && mParams->validateMatchByFIT != MatchTPCITSParams::Disable;
 
   int itsROBin = 0;
-  for (int itpc = idxMinTPC; itpc < nTracksTPC; itpc++) {
+  for (int itpc = chunk.firstTPC; itpc < chunk.lastTPC; itpc++) {
     auto& trefTPC = mTPCWork[cacheTPC[itpc]];
     // estimate ITS 1st ROframe bin this track may match to: TPC track are sorted according to their
     // timeMax, hence the timeMax - MaxmNTPCBinsFullDrift are non-decreasing
@@ -737,7 +786,7 @@ void MatchTPCITS::doMatching(int sec)
       break;
     }
     int iits0 = timeStartITS[itsROBin];
-    nCheckTPCControl++;
+    chunk.nCheckTPC++;
     for (auto iits = iits0; iits < nTracksITS; iits++) {
       auto& trefITS = mITSWork[cacheITS[iits]];
       // compare if the ITS and TPC tracks may overlap in time
@@ -767,12 +816,13 @@ void MatchTPCITS::doMatching(int sec)
         }
       }
 
-      nCheckITSControl++;
+      chunk.nCheckITS++;
       float chi2 = -1;
       int rejFlag = compareTPCITSTracks(trefITS, trefTPC, chi2);
 
 #ifdef _ALLOW_DEBUG_TREES_
       if (mDBGOut && ((rejFlag == Accept && isDebugFlag(MatchTreeAccOnly)) || isDebugFlag(MatchTreeAll))) {
+#pragma omp critical(MatchTPCITS_dbg)
         fillTPCITSmatchTree(cacheITS[iits], cacheTPC[itpc], rejFlag, chi2, timeCorr);
       }
 #endif
@@ -831,15 +881,9 @@ void MatchTPCITS::doMatching(int sec)
           continue;
         }
       }
-      registerMatchRecordTPC(cacheITS[iits], cacheTPC[itpc], chi2, matchedIC); // register matching candidate
-      nMatchesControl++;
+      chunk.candidates.emplace_back(cacheITS[iits], cacheTPC[itpc], chi2, matchedIC); // to be registered after all chunks are processed
     }
   }
-  if (mParams->verbosity > 0) {
-    LOG(info) << "Match sector " << sec << " N tracks TPC:" << nTracksTPC << " ITS:" << nTracksITS
-              << " N TPC tracks checked: " << nCheckTPCControl << " (starting from " << idxMinTPC
-              << "), checks: " << nCheckITSControl << ", matches:" << nMatchesControl;
-  }
 }
 
 //______________________________________________
@@ -1222,20 +1266,76 @@ void MatchTPCITS::refitWinners()
   mTimer[SWRefit].Start(false);
   LOG(debug) << "Refitting winner matches";
   mWinnerChi2Refit.resize(mITSWork.size(), -1.f);
-  int iITS;
+  std::vector<int> winnersTPC, winnersITS;
   for (int iTPC = 0; iTPC < (int)mTPCWork.size(); iTPC++) {
-    if (!refitTrackTPCITS(iTPC, iITS)) {
+    if (!isDisabledTPC(mTPCWork[iTPC])) {
+      winnersTPC.push_back(iTPC);
+    }
+  }
+  // refit in parallel in the slots of the output vector, then compact it preserving the order of TPC tracks
+  int nWinners = winnersTPC.size(), offset = mMatchedTracks.size(), nRefitted = 0;
+  winnersITS.resize(nWinners, MinusOne);
+  mMatchedTracks.resize(offset + nWinners);
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+  for (int iw = 0; iw < nWinners; iw++) {
+    int iITS;
+    if (refitTrackTPCITS(mMatchedTracks[offset + iw], winnersTPC[iw], iITS)) {
+      winnersITS[iw] = iITS;
+    }
+  }
+  for (int iw = 0; iw < nWinners; iw++) {
+    int iTPC = winnersTPC[iw], iITS = winnersITS[iw];
+    if (iITS == MinusOne) {
       continue;
     }
-    mWinnerChi2Refit[iITS] = mMatchedTracks.back().getChi2Refit();
+    if (iw != nRefitted) {
+      mMatchedTracks[offset + nRefitted] = mMatchedTracks[offset + iw];
+    }
+    const auto& trfit = mMatchedTracks[offset + nRefitted++];
+    mWinnerChi2Refit[iITS] = trfit.getChi2Refit();
+    const auto& tTPC = mTPCWork[iTPC];
+    const auto& tITS = mITSWork[iITS];
+
+#ifdef _ALLOW_DEBUG_TREES_
+    if (mDBGOut) {
+      auto tpcOrigC = mTPCTracksArray[tTPC.sourceID];
+      auto itsOrigC = mITSTracksArray[tITS.sourceID];
+      auto tITSC = tITS;
+      auto tTPCC = tTPC;
+      auto trfitC = trfit;
+      o2::MCCompLabel lblITS, lblTPC;
+      (*mDBGOut) << "refit"
+                 << "tpcOrig=" << tpcOrigC << "itsOrig=" << itsOrigC << "itsRef=" << tITSC << "tpcRef=" << tTPCC << "matchRefit=" << trfitC;
+      if (mMCTruthON) {
+        lblITS = mITSLblWork[iITS];
+        lblTPC = mTPCLblWork[iTPC];
+        (*mDBGOut) << "refit"
+                   << "itsLbl=" << lblITS << "tpcLbl=" << lblTPC;
+      }
+      (*mDBGOut) << "refit"
+                 << "\n";
+    }
+#endif
+
+    if (mMCTruthON) { // store MC info: we assign TPC track label and declare the match fake if the ITS and TPC labels are different (their fake flag is ignored)
+      auto& lbl = mOutLabels.emplace_back(mTPCLblWork[iTPC]);
+      lbl.setFakeFlag(mITSLblWork[iITS] != mTPCLblWork[iTPC]);
+    }
+
+    // if requested, fill the difference of ITS and TPC tracks tgl for vdrift calibation
+    if (mVDriftCalibOn) {
+      mTglITSTPC.emplace_back(tITS.getTgl(), tTPC.getTgl());
+    }
   }
+  mMatchedTracks.resize(offset + nRefitted);
   mTimer[SWRefit].Stop();
 }
 
 //______________________________________________
-bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
+bool MatchTPCITS::refitTrackTPCITS(o2::dataformats::TrackTPCITS& trfit, int iTPC, int& iITS)
 {
-  ///< refit in inward direction the pair of TPC and ITS tracks
+  ///< refit in inward direction the pair of TPC and ITS tracks into trfit.
+  ///< May be called concurrently for different TPC tracks, hence it must not modify the shared containers
 
   const float maxStep = 2.f; // max propagation step (TODO: tune)
   const auto& tTPC = mTPCWork[iTPC];
@@ -1247,8 +1347,7 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   const auto& tITS = mITSWork[iITS];
   const auto& itsTrOrig = mITSTracksArray[tITS.sourceID];
 
-  mMatchedTracks.emplace_back(tTPC, tITS); // create a copy of TPC track at xRef
-  auto& trfit = mMatchedTracks.back();
+  trfit = o2::dataformats::TrackTPCITS(tTPC, tITS); // create a copy of TPC track at xRef
   // in continuos mode the Z of TPC track is meaningless, unless it is CE crossing
   // track (currently absent, TODO)
   if (!mCompareTracksDZ) {
@@ -1263,7 +1362,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   float timeC = tTPC.getCorrectedTime(deltaT);                                                                                                    /// precise time estimate
   if (timeC < 0) {                                                                                                                                // RS TODO similar check is needed for other edge of TF
     if (timeC + std::min(timeErr, mParams->tfEdgeTimeToleranceMUS * mTPCTBinMUSInv) < 0) {
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     timeC = 0.;
@@ -1304,7 +1402,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   if (nclRefit != ncl) {
     LOGP(debug, "Refit in ITS failed after ncl={}, match between TPC track #{} and ITS track #{}", nclRefit, tTPC.sourceID, tITS.sourceID);
     LOGP(debug, "{:s}", trfit.asString());
-    mMatchedTracks.pop_back(); // destroy failed track
     return false;
   }
 
@@ -1326,7 +1423,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     if (!tracOut.getXatLabR(o2::constants::geom::XTPCInnerRef, xtogo, mBz, o2::track::DirOutward) ||
         !propagator->PropagateToXBxByBz(tracOut, xtogo, MaxSnp, 10., mUseMatCorrFlag, &tofL)) {
       LOG(debug) << "Propagation to inner TPC boundary X=" << xtogo << " failed, Xtr=" << tracOut.getX() << " snp=" << tracOut.getSnp();
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     if (mVDriftCalibOn) {
@@ -1338,13 +1434,11 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     if (std::abs(tImposed - mTPCTracksArray[tTPC.sourceID].getTime0()) > 550) {
       LOGP(error, "Impossible imposed timebin {} for TPC track time0:{}, dBwd:{} dFwd:{} TB | ZShift:{}, TShift:{} | Trc: {}", tImposed, mTPCTracksArray[tTPC.sourceID].getTime0(),
            mTPCTracksArray[tTPC.sourceID].getDeltaTBwd(), mTPCTracksArray[tTPC.sourceID].getDeltaTFwd(), trfit.getZ() - tTPC.getZ(), deltaT, mTPCTracksArray[tTPC.sourceID].asString());
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     int retVal = mTPCRefitter->RefitTrackAsTrackParCov(tracOut, mTPCTracksArray[tTPC.sourceID].getClusterRef(), tImposed, &chi2Out, true, false); // outward refit
     if (retVal < 0) {
       LOG(debug) << "Refit failed";
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     auto posEnd = tracOut.getXYZGlo();
@@ -1375,35 +1469,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   trfit.setRefTPC({unsigned(tTPC.sourceID), o2::dataformats::GlobalTrackID::TPC});
   trfit.setRefITS({unsigned(tITS.sourceID), o2::dataformats::GlobalTrackID::ITS});
 
-#ifdef _ALLOW_DEBUG_TREES_
-  if (mDBGOut) {
-    auto tpcOrigC = mTPCTracksArray[tTPC.sourceID];
-    auto itsOrigC = itsTrOrig;
-    auto tITSC = tITS;
-    auto tTPCC = tTPC;
-    o2::MCCompLabel lblITS, lblTPC;
-    (*mDBGOut) << "refit"
-               << "tpcOrig=" << tpcOrigC << "itsOrig=" << itsOrigC << "itsRef=" << tITSC << "tpcRef=" << tTPCC << "matchRefit=" << trfit;
-    if (mMCTruthON) {
-      lblITS = mITSLblWork[iITS];
-      lblTPC = mTPCLblWork[iTPC];
-      (*mDBGOut) << "refit"
-                 << "itsLbl=" << lblITS << "tpcLbl=" << lblTPC;
-    }
-    (*mDBGOut) << "refit"
-               << "\n";
-  }
-#endif
-
-  if (mMCTruthON) { // store MC info: we assign TPC track label and declare the match fake if the ITS and TPC labels are different (their fake flag is ignored)
-    auto& lbl = mOutLabels.emplace_back(mTPCLblWork[iTPC]);
-    lbl.setFakeFlag(mITSLblWork[iITS] != mTPCLblWork[iTPC]);
-  }
-
-  // if requested, fill the difference of ITS and TPC tracks tgl for vdrift calibation
-  if (mVDriftCalibOn) {
-    mTglITSTPC.emplace_back(tITS.getTgl(), tTPC.getTgl());
-  }
   //  trfit.print(); // DBG
 
   return true;
@@ -79,6 +79,7 @@ void PrimaryVertexingSpec::init(InitContext& ic)
     throw std::runtime_error(fmt::format("directory {} for raw data dumps does not exist", dumpDir));
   }
   mVertexer.setPoolDumpDirectory(dumpDir);
+  mVertexer.setNThreads(std::max(1, ic.options().get<int>("nthreads")));
 }
 
 void PrimaryVertexingSpec::run(ProcessingContext& pc)
@@ -239,7 +240,8 @@ DataProcessorSpec getPrimaryVertexingSpec(GTrackID::mask_t src, bool skip, bool
     dataRequest->inputs,
     outputs,
     AlgorithmSpec{adaptFromTask<PrimaryVertexingSpec>(dataRequest, ggRequest, src, skip, validateWithFT0, useMC)},
-    Options{{"pool-dumps-directory", VariantType::String, "", {"Destination directory for the tracks pool dumps"}}}};
+    Options{{"pool-dumps-directory", VariantType::String, "", {"Destination directory for the tracks pool dumps"}},
+            {"nthreads", VariantType::Int, 1, {"Number of threads for the time-Z clusters processing"}}}};
 }
 
 } // namespace vertexing
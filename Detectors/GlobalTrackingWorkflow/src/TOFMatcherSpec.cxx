@@ -89,6 +89,7 @@ void TOFMatcherSpec::init(InitContext& ic)
     mMatcher.setHighPurity();
   }
   mMatcher.setExtraTimeToleranceTRD(mExtraTolTRD);
+  mMatcher.setNThreads(std::max(1, ic.options().get<int>("nthreads")));
 }
 
 void TOFMatcherSpec::updateTimeDependentParams(ProcessingContext& pc)
@@ -267,7 +268,7 @@ DataProcessorSpec getTOFMatcherSpec(GID::mask_t src, bool useMC, bool useFIT, bo
     dataRequest->inputs,
     outputs,
     AlgorithmSpec{adaptFromTask<TOFMatcherSpec>(dataRequest, ggRequest, useMC, useFIT, tpcRefit, strict)},
-    Options{}};
+    Options{{"nthreads", VariantType::Int, 1, {"Number of threads for the seeds propagation and matching"}}}};
 }
 
 } // namespace globaltracking
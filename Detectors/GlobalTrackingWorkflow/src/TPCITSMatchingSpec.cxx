@@ -240,7 +240,7 @@ DataProcessorSpec getTPCITSMatchingSpec(GTrackID::mask_t src, bool useFT0, bool
     outputs,
     AlgorithmSpec{adaptFromTask<TPCITSMatchingDPL>(dataRequest, ggRequest, useFT0, calib, skipTPCOnly, useMC)},
     Options{
-      {"nthreads", VariantType::Int, 1, {"Number of afterburner threads"}},
+      {"nthreads", VariantType::Int, 1, {"Number of threads for the matching, refit and afterburner"}},
       {"ignore-bc-check", VariantType::Bool, false, {"Do not check match candidate against BC filling"}},
       {"debug-tree-flags", VariantType::Int, 0, {"DebugFlagTypes bit-pattern for debug tree"}}}};
 }
@@ -106,6 +106,7 @@ struct VertexingParameters {
   int maxTrackletsPerCluster = 2e3;
   int phiSpan = -1;
   int zSpan = -1;
+  int nLinesBinnedSearch = -1; // number of lines in a ROF above which the pairs of lines are searched only among the lines close in z, -1: never. Changes the vertices, see VertexerTraits::computeVertices
 };
 
 struct VertexerHistogramsConfiguration {
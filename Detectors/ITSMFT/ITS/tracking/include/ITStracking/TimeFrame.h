@@ -93,6 +93,10 @@ class TimeFrame
                       const itsmft::TopologyDictionary* dict,
                       const dataformats::MCTruthContainer<MCCompLabel>* mcLabels = nullptr);
 
+  /// Add a ROF of clusters given in the global frame, one vector of {x, y, z} per layer.
+  /// No geometry is needed, the tracking frame is the one of a sensor at the cluster azimuth.
+  int loadROFrameData(const std::vector<std::vector<std::array<float, 3>>>& clustersPerLayer);
+
   int getTotalClusters() const;
   bool empty() const;
 
@@ -33,6 +33,8 @@ struct VertexerParamConfig : public o2::conf::ConfigurableParamHelper<VertexerPa
   int maxTrackletsPerCluster = 1e2;
   int phiSpan = -1;
   int zSpan = -1;
+  int nLinesBinnedSearch = -1; // number of lines in a ROF above which the pairs of lines are searched only among the lines close in z, -1: never. Changes the vertices, see VertexerTraits::computeVertices
+  int nThreads = 1;
 
   O2ParamDef(VertexerParamConfig, "ITSVertexerParam");
 };
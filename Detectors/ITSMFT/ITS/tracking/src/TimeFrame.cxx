@@ -207,6 +207,30 @@ int TimeFrame::loadROFrameData(gsl::span<o2::itsmft::ROFRecord> rofs,
   return mNrof;
 }
 
+int TimeFrame::loadROFrameData(const std::vector<std::vector<std::array<float, 3>>>& clustersPerLayer)
+{
+  int nClusters{0};
+  for (unsigned int iL{0}; iL < std::min(clustersPerLayer.size(), mUnsortedClusters.size()); ++iL) {
+    for (auto& xyz : clustersPerLayer[iL]) {
+      const float alpha{math_utils::computePhi(xyz[0], xyz[1])};
+      addTrackingFrameInfoToLayer(iL, xyz[0], xyz[1], xyz[2], math_utils::hypot(xyz[0], xyz[1]), alpha,
+                                  std::array<float, 2>{0.f, xyz[2]},
+                                  std::array<float, 3>{DefClusError2Row, 0.f, DefClusError2Col});
+      addClusterToLayer(iL, xyz[0], xyz[1], xyz[2], mUnsortedClusters[iL].size());
+      addClusterExternalIndexToLayer(iL, nClusters++);
+    }
+  }
+
+  for (unsigned int iL{0}; iL < mUnsortedClusters.size(); ++iL) {
+    mROframesClusters[iL].push_back(mUnsortedClusters[iL].size());
+    if (iL < 2) {
+      mTrackletsIndexROf[iL].push_back(mUnsortedClusters[1].size()); // Tracklets used in vertexer are always computed starting from L1
+    }
+  }
+  mNrof++;
+  return nClusters;
+}
+
 int TimeFrame::getTotalClusters() const
 {
   size_t totalClusters{0};
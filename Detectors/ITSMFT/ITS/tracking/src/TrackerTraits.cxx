@@ -15,6 +15,7 @@
 
 #include "ITStracking/TrackerTraits.h"
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
 
@@ -61,7 +62,28 @@ void TrackerTraits::computeLayerTracklets(const int iteration)
 
   const Vertex diamondVert({mTrkParams[iteration].Diamond[0], mTrkParams[iteration].Diamond[1], mTrkParams[iteration].Diamond[2]}, {25.e-6f, 0.f, 0.f, 25.e-6f, 0.f, 36.f}, 1, 1.f);
   gsl::span<const Vertex> diamondSpan(&diamondVert, 1);
-  for (int rof0{0}; rof0 < tf->getNrof(); ++rof0) {
+
+  /// ROFs are processed in parallel, each thread fills its own tracklet buffers which are then
+  /// compacted into the TimeFrame ones. The lookup table entries are per cluster, hence per ROF.
+  /// The order of the tracklets does not matter, they are sorted afterwards.
+  std::vector<std::vector<std::vector<Tracklet>>> threadTracklets(mNThreads, std::vector<std::vector<Tracklet>>(mTrkParams[iteration].TrackletsPerRoad()));
+  /// The memory is still checked after each ROF, counting the tracklets sitting in the thread
+  /// buffers: as soon as one thread exceeds the limit the remaining ROFs are skipped by all of them.
+  const unsigned long artefactsMemory{tf->getArtefactsMemory()};
+  std::atomic<unsigned long> bufferedTracklets{0};
+  std::atomic<bool> memoryExceeded{false};
+
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+  for (int rof0 = 0; rof0 < tf->getNrof(); ++rof0) {
+    if (memoryExceeded.load(std::memory_order_relaxed)) {
+      continue;
+    }
+    unsigned long rofTracklets{0};
+#ifdef WITH_OPENMP
+    auto& tracklets = threadTracklets[omp_get_thread_num()];
+#else
+    auto& tracklets = threadTracklets[0];
+#endif
     gsl::span<const Vertex> primaryVertices = mTrkParams[iteration].UseDiamond ? diamondSpan : tf->getPrimaryVertices(rof0);
     int minRof = (rof0 >= mTrkParams[iteration].DeltaROF) ? rof0 - mTrkParams[iteration].DeltaROF : 0;
     int maxRof = (rof0 == tf->getNrof() - mTrkParams[iteration].DeltaROF) ? rof0 : rof0 + mTrkParams[iteration].DeltaROF;
@@ -159,6 +181,7 @@ void TrackerTraits::computeLayerTracklets(const int iteration)
                     break;
                   }
                 }
+#pragma omp critical
                 off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, label.isValid(), (tanLambda * (nextCluster.radius - currentCluster.radius) + currentCluster.zCoordinate - nextCluster.zCoordinate) / sigmaZ, tanLambda, resolution, sigmaZ) << std::endl;
 #endif
 
@@ -172,19 +195,45 @@ void TrackerTraits::computeLayerTracklets(const int iteration)
                                                                 currentCluster.xCoordinate - nextCluster.xCoordinate)};
                   const float tanL{(currentCluster.zCoordinate - nextCluster.zCoordinate) /
                                    (currentCluster.radius - nextCluster.radius)};
-                  tf->getTracklets()[iLayer].emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), tanL, phi, rof0, rof1);
+                  tracklets[iLayer].emplace_back(currentSortedIndex, tf->getSortedIndex(rof1, iLayer + 1, iNextCluster), tanL, phi, rof0, rof1);
+                  ++rofTracklets;
                 }
               }
             }
           }
         }
       }
-      if (!tf->checkMemory(mTrkParams[iteration].MaxMemory)) {
-        return;
-      }
+    }
+    const unsigned long buffered{bufferedTracklets.fetch_add(rofTracklets) + rofTracklets};
+    if (artefactsMemory + sizeof(Tracklet) * buffered >= mTrkParams[iteration].MaxMemory) {
+      memoryExceeded = true;
     }
   }
 
+  /// The tracklets found so far are compacted also when the memory limit was exceeded, so that the
+  /// Tracker sees it. Each thread buffer is released as soon as it is copied, or moved if it is the only one.
+  for (int iLayer{0}; iLayer < mTrkParams[iteration].TrackletsPerRoad(); ++iLayer) {
+    auto& layerTracklets{tf->getTracklets()[iLayer]};
+    auto hasTracklets = [iLayer](const std::vector<std::vector<Tracklet>>& buffers) { return !buffers[iLayer].empty(); };
+    if (layerTracklets.empty() && std::count_if(threadTracklets.begin(), threadTracklets.end(), hasTracklets) == 1) {
+      layerTracklets.swap((*std::find_if(threadTracklets.begin(), threadTracklets.end(), hasTracklets))[iLayer]);
+      continue;
+    }
+    std::vector<size_t> offsets(mNThreads + 1, layerTracklets.size());
+    for (int iThread{0}; iThread < mNThreads; ++iThread) {
+      offsets[iThread + 1] = offsets[iThread] + threadTracklets[iThread][iLayer].size();
+    }
+    layerTracklets.resize(offsets[mNThreads]);
+#pragma omp parallel for num_threads(mNThreads)
+    for (int iThread = 0; iThread < mNThreads; ++iThread) {
+      std::copy(threadTracklets[iThread][iLayer].begin(), threadTracklets[iThread][iLayer].end(), layerTracklets.begin() + offsets[iThread]);
+      std::vector<Tracklet>().swap(threadTracklets[iThread][iLayer]);
+    }
+  }
+  if (memoryExceeded) {
+    return;
+  }
+
   for (int iLayer{0}; iLayer < mTrkParams[iteration].CellsPerRoad(); ++iLayer) {
     /// Sort tracklets
     auto& trkl{tf->getTracklets()[iLayer + 1]};
@@ -230,7 +279,13 @@ void TrackerTraits::computeLayerTracklets(const int iteration)
   /// Create tracklets labels
   if (tf->hasMCinformation()) {
     for (int iLayer{0}; iLayer < mTrkParams[iteration].TrackletsPerRoad(); ++iLayer) {
-      for (auto& trk : tf->getTracklets()[iLayer]) {
+      auto& labels = tf->getTrackletsLabel(iLayer);
+      const size_t labelsOffset{labels.size()};
+      const int trackletsNum{static_cast<int>(tf->getTracklets()[iLayer].size())};
+      labels.resize(labelsOffset + trackletsNum);
+#pragma omp parallel for num_threads(mNThreads)
+      for (int iTracklet = 0; iTracklet < trackletsNum; ++iTracklet) {
+        const Tracklet& trk{tf->getTracklets()[iLayer][iTracklet]};
         MCCompLabel label;
         int currentId{tf->getClusters()[iLayer][trk.firstClusterIndex].clusterId};
         int nextId{tf->getClusters()[iLayer + 1][trk.secondClusterIndex].clusterId};
@@ -245,7 +300,7 @@ void TrackerTraits::computeLayerTracklets(const int iteration)
             break;
           }
         }
-        tf->getTrackletsLabel(iLayer).emplace_back(label);
+        labels[labelsOffset + iTracklet] = label;
       }
     }
   }
@@ -273,47 +328,71 @@ void TrackerTraits::computeLayerCells(const int iteration)
 #endif
     const int currentLayerTrackletsNum{static_cast<int>(tf->getTracklets()[iLayer].size())};
 
-    for (int iTracklet{0}; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
-
-      const Tracklet& currentTracklet{tf->getTracklets()[iLayer][iTracklet]};
-      const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
-      const int nextLayerFirstTrackletIndex{
-        tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex]};
-      const int nextLayerLastTrackletIndex{
-        tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex + 1]};
-
-      if (nextLayerFirstTrackletIndex == nextLayerLastTrackletIndex) {
-        continue;
-      }
-
-      for (int iNextTracklet{nextLayerFirstTrackletIndex}; iNextTracklet < nextLayerLastTrackletIndex; ++iNextTracklet) {
-        if (tf->getTracklets()[iLayer + 1][iNextTracklet].firstClusterIndex != nextLayerClusterIndex) {
-          break;
+    /// Each thread processes a contiguous range of tracklets into its own cells buffer, counting
+    /// the cells of each tracklet: concatenating the buffers in thread order gives the same
+    /// cells and lookup table as a sequential loop.
+    std::vector<std::vector<Cell>> threadCells(mNThreads);
+    std::vector<int> cellsPerTracklet(currentLayerTrackletsNum + 1, 0);
+    const int chunkSize{(currentLayerTrackletsNum + mNThreads - 1) / mNThreads};
+
+#pragma omp parallel for num_threads(mNThreads) schedule(static, 1)
+    for (int iThread = 0; iThread < mNThreads; ++iThread) {
+      auto& cells = threadCells[iThread];
+      const int lastTracklet{std::min(currentLayerTrackletsNum, (iThread + 1) * chunkSize)};
+      for (int iTracklet{iThread * chunkSize}; iTracklet < lastTracklet; ++iTracklet) {
+
+        const Tracklet& currentTracklet{tf->getTracklets()[iLayer][iTracklet]};
+        const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
+        const int nextLayerFirstTrackletIndex{
+          tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex]};
+        const int nextLayerLastTrackletIndex{
+          tf->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex + 1]};
+
+        if (nextLayerFirstTrackletIndex == nextLayerLastTrackletIndex) {
+          continue;
         }
-        const Tracklet& nextTracklet{tf->getTracklets()[iLayer + 1][iNextTracklet]};
-        const float deltaTanLambda{std::abs(currentTracklet.tanLambda - nextTracklet.tanLambda)};
-        const float tanLambda{(currentTracklet.tanLambda + nextTracklet.tanLambda) * 0.5f};
+
+        const size_t firstCell{cells.size()};
+        for (int iNextTracklet{nextLayerFirstTrackletIndex}; iNextTracklet < nextLayerLastTrackletIndex; ++iNextTracklet) {
+          if (tf->getTracklets()[iLayer + 1][iNextTracklet].firstClusterIndex != nextLayerClusterIndex) {
+            break;
+          }
+          const Tracklet& nextTracklet{tf->getTracklets()[iLayer + 1][iNextTracklet]};
+          const float deltaTanLambda{std::abs(currentTracklet.tanLambda - nextTracklet.tanLambda)};
+          const float tanLambda{(currentTracklet.tanLambda + nextTracklet.tanLambda) * 0.5f};
 
 #ifdef OPTIMISATION_OUTPUT
-        bool good{tf->getTrackletsLabel(iLayer)[iTracklet] == tf->getTrackletsLabel(iLayer + 1)[iNextTracklet]};
-        float signedDelta{currentTracklet.tanLambda - nextTracklet.tanLambda};
-        off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, good, signedDelta, signedDelta / (mTrkParams[iteration].CellDeltaTanLambdaSigma), tanLambda, resolution) << std::endl;
+          bool good{tf->getTrackletsLabel(iLayer)[iTracklet] == tf->getTrackletsLabel(iLayer + 1)[iNextTracklet]};
+          float signedDelta{currentTracklet.tanLambda - nextTracklet.tanLambda};
+#pragma omp critical
+          off << fmt::format("{}\t{:d}\t{}\t{}\t{}\t{}", iLayer, good, signedDelta, signedDelta / (mTrkParams[iteration].CellDeltaTanLambdaSigma), tanLambda, resolution) << std::endl;
 #endif
 
-        if (deltaTanLambda / mTrkParams[iteration].CellDeltaTanLambdaSigma < mTrkParams[iteration].NSigmaCut) {
-
-          if (iLayer > 0 && (int)tf->getCellsLookupTable()[iLayer - 1].size() <= iTracklet) {
-            tf->getCellsLookupTable()[iLayer - 1].resize(iTracklet + 1, tf->getCells()[iLayer].size());
+          if (deltaTanLambda / mTrkParams[iteration].CellDeltaTanLambdaSigma < mTrkParams[iteration].NSigmaCut) {
+            cells.emplace_back(
+              currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
+              iTracklet, iNextTracklet, tanLambda);
           }
-
-          tf->getCells()[iLayer].emplace_back(
-            currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
-            iTracklet, iNextTracklet, tanLambda);
         }
+        cellsPerTracklet[iTracklet] = cells.size() - firstCell;
       }
     }
+
+    /// Compact the cells in the TimeFrame, the lookup table gives the first cell of each tracklet
+    auto& layerCells{tf->getCells()[iLayer]};
+    std::vector<size_t> offsets(mNThreads + 1, layerCells.size());
+    for (int iThread{0}; iThread < mNThreads; ++iThread) {
+      offsets[iThread + 1] = offsets[iThread] + threadCells[iThread].size();
+    }
+    layerCells.resize(offsets[mNThreads]);
+#pragma omp parallel for num_threads(mNThreads)
+    for (int iThread = 0; iThread < mNThreads; ++iThread) {
+      std::copy(threadCells[iThread].begin(), threadCells[iThread].end(), layerCells.begin() + offsets[iThread]);
+    }
     if (iLayer > 0) {
-      tf->getCellsLookupTable()[iLayer - 1].resize(currentLayerTrackletsNum + 1, tf->getCells()[iLayer].size());
+      auto& lut{tf->getCellsLookupTable()[iLayer - 1]};
+      lut.resize(currentLayerTrackletsNum + 1);
+      std::exclusive_scan(cellsPerTracklet.begin(), cellsPerTracklet.end(), lut.begin(), (int)offsets[0]);
     }
     if (!tf->checkMemory(mTrkParams[iteration].MaxMemory)) {
       return;
@@ -323,10 +402,16 @@ void TrackerTraits::computeLayerCells(const int iteration)
   /// Create cells labels
   if (tf->hasMCinformation()) {
     for (int iLayer{0}; iLayer < mTrkParams[iteration].CellsPerRoad(); ++iLayer) {
-      for (auto& cell : tf->getCells()[iLayer]) {
+      auto& labels = tf->getCellsLabel(iLayer);
+      const size_t labelsOffset{labels.size()};
+      const int cellsNum{static_cast<int>(tf->getCells()[iLayer].size())};
+      labels.resize(labelsOffset + cellsNum);
+#pragma omp parallel for num_threads(mNThreads)
+      for (int iCell = 0; iCell < cellsNum; ++iCell) {
+        const Cell& cell{tf->getCells()[iLayer][iCell]};
         MCCompLabel currentLab{tf->getTrackletsLabel(iLayer)[cell.getFirstTrackletIndex()]};
         MCCompLabel nextLab{tf->getTrackletsLabel(iLayer + 1)[cell.getSecondTrackletIndex()]};
-        tf->getCellsLabel(iLayer).emplace_back(currentLab == nextLab ? currentLab : MCCompLabel());
+        labels[labelsOffset + iCell] = currentLab == nextLab ? currentLab : MCCompLabel();
       }
     }
   }
@@ -354,32 +439,71 @@ void TrackerTraits::findCellsNeighbours(const int iteration)
     const int nextLayerCellsNum{static_cast<int>(mTimeFrame->getCells()[iLayer + 1].size())};
     mTimeFrame->getCellsNeighbours()[iLayer].resize(nextLayerCellsNum);
 
-    for (int iCell{0}; iCell < layerCellsNum; ++iCell) {
+    /// First the (next cell, cell) pairs are found in parallel, each thread on a contiguous range of cells,
+    /// then they are grouped by next cell keeping the order of the cells, as in a sequential loop.
+    std::vector<std::vector<std::pair<int, int>>> threadNeighbours(mNThreads);
+    const int chunkSize{(layerCellsNum + mNThreads - 1) / mNThreads};
 
-      const Cell& currentCell{mTimeFrame->getCells()[iLayer][iCell]};
-      const int nextLayerTrackletIndex{currentCell.getSecondTrackletIndex()};
-      const int nextLayerFirstCellIndex{mTimeFrame->getCellsLookupTable()[iLayer][nextLayerTrackletIndex]};
-      const int nextLayerLastCellIndex{mTimeFrame->getCellsLookupTable()[iLayer][nextLayerTrackletIndex + 1]};
-      for (int iNextCell{nextLayerFirstCellIndex}; iNextCell < nextLayerLastCellIndex; ++iNextCell) {
+#pragma omp parallel for num_threads(mNThreads) schedule(static, 1)
+    for (int iThread = 0; iThread < mNThreads; ++iThread) {
+      const int lastCell{std::min(layerCellsNum, (iThread + 1) * chunkSize)};
+      for (int iCell{iThread * chunkSize}; iCell < lastCell; ++iCell) {
 
-        Cell& nextCell{mTimeFrame->getCells()[iLayer + 1][iNextCell]};
-        if (nextCell.getFirstTrackletIndex() != nextLayerTrackletIndex) {
-          break;
-        }
+        const Cell& currentCell{mTimeFrame->getCells()[iLayer][iCell]};
+        const int nextLayerTrackletIndex{currentCell.getSecondTrackletIndex()};
+        const int nextLayerFirstCellIndex{mTimeFrame->getCellsLookupTable()[iLayer][nextLayerTrackletIndex]};
+        const int nextLayerLastCellIndex{mTimeFrame->getCellsLookupTable()[iLayer][nextLayerTrackletIndex + 1]};
+        for (int iNextCell{nextLayerFirstCellIndex}; iNextCell < nextLayerLastCellIndex; ++iNextCell) {
+
+          const Cell& nextCell{mTimeFrame->getCells()[iLayer + 1][iNextCell]};
+          if (nextCell.getFirstTrackletIndex() != nextLayerTrackletIndex) {
+            break;
+          }
 
 #ifdef OPTIMISATION_OUTPUT
-        bool good{mTimeFrame->getCellsLabel(iLayer)[iCell] == mTimeFrame->getCellsLabel(iLayer + 1)[iNextCell]};
-        float signedDelta{currentCell.getTanLambda() - nextCell.getTanLambda()};
-        off << fmt::format("{}\t{:d}\t{}\t{}", iLayer, good, signedDelta, signedDelta / mTrkParams[iteration].CellDeltaTanLambdaSigma) << std::endl;
+          bool good{mTimeFrame->getCellsLabel(iLayer)[iCell] == mTimeFrame->getCellsLabel(iLayer + 1)[iNextCell]};
+          float signedDelta{currentCell.getTanLambda() - nextCell.getTanLambda()};
+#pragma omp critical
+          off << fmt::format("{}\t{:d}\t{}\t{}", iLayer, good, signedDelta, signedDelta / mTrkParams[iteration].CellDeltaTanLambdaSigma) << std::endl;
 #endif
-        mTimeFrame->getCellsNeighbours()[iLayer][iNextCell].push_back(iCell);
+          threadNeighbours[iThread].emplace_back(iNextCell, iCell);
+        }
+      }
+    }
+
+    std::vector<int> neighboursLUT(nextLayerCellsNum + 1, 0);
+    for (auto& neighbours : threadNeighbours) {
+      for (auto& [iNextCell, iCell] : neighbours) {
+        neighboursLUT[iNextCell]++;
+      }
+    }
+    std::exclusive_scan(neighboursLUT.begin(), neighboursLUT.end(), neighboursLUT.begin(), 0);
+    std::vector<int> sortedNeighbours(neighboursLUT.back());
+    {
+      std::vector<int> filled(neighboursLUT.begin(), neighboursLUT.end() - 1);
+      for (auto& neighbours : threadNeighbours) {
+        for (auto& [iNextCell, iCell] : neighbours) {
+          sortedNeighbours[filled[iNextCell]++] = iCell;
+        }
+      }
+    }
+
+#pragma omp parallel for num_threads(mNThreads)
+    for (int iNextCell = 0; iNextCell < nextLayerCellsNum; ++iNextCell) {
+      if (neighboursLUT[iNextCell] == neighboursLUT[iNextCell + 1]) {
+        continue;
+      }
+      Cell& nextCell{mTimeFrame->getCells()[iLayer + 1][iNextCell]};
+      auto& cellNeighbours{mTimeFrame->getCellsNeighbours()[iLayer][iNextCell]};
+      for (int iNeighbour{neighboursLUT[iNextCell]}; iNeighbour < neighboursLUT[iNextCell + 1]; ++iNeighbour) {
+        const int iCell{sortedNeighbours[iNeighbour]};
+        cellNeighbours.push_back(iCell);
 
-        const int currentCellLevel{currentCell.getLevel()};
+        const int currentCellLevel{mTimeFrame->getCells()[iLayer][iCell].getLevel()};
 
         if (currentCellLevel >= nextCell.getLevel()) {
           nextCell.setLevel(currentCellLevel + 1);
         }
-        // }
       }
     }
   }
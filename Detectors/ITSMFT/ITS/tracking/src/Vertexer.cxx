@@ -67,8 +67,10 @@ void Vertexer::getGlobalConfiguration()
   verPar.clusterContributorsCut = vc.clusterContributorsCut;
   verPar.maxTrackletsPerCluster = vc.maxTrackletsPerCluster;
   verPar.phiSpan = vc.phiSpan;
+  verPar.nLinesBinnedSearch = vc.nLinesBinnedSearch;
 
   mTraits->updateVertexingParameters(verPar);
+  mTraits->setNThreads(vc.nThreads);
 }
 
 void Vertexer::adoptTimeFrame(TimeFrame& tf)
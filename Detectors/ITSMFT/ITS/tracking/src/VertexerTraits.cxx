@@ -17,6 +17,9 @@
 #include "ITStracking/ClusterLines.h"
 #include "ITStracking/Tracklet.h"
 
+#include <algorithm>
+#include <memory>
+
 #ifdef VTX_DEBUG
 #include "TTree.h"
 #include "TFile.h"
@@ -117,6 +120,75 @@ void trackletSelectionKernelSerial(
   }
 }
 
+/// Index of the lines of a ROF by their z at the beam axis, to find the lines which can be
+/// closer than pairCut to a given one within maxR from the beam axis, without a pairwise scan.
+/// The points of a line within maxR have z in [z0 - dz, z0 + dz], dz = maxR * |tanLambda|.
+/// Lines almost parallel to the beam are always candidates.
+class LinesZIndex
+{
+ public:
+  LinesZIndex(const std::vector<Line>& lines, const float maxR, const float pairCut) : mPairCut{pairCut}
+  {
+    const int nLines{static_cast<int>(lines.size())};
+    mZ0.resize(nLines);
+    mDZ.resize(nLines);
+    for (int iLine{0}; iLine < nLines; ++iLine) {
+      const auto& origin{lines[iLine].originPoint};
+      const auto& dir{lines[iLine].cosinesDirector};
+      const float dirT2{dir[0] * dir[0] + dir[1] * dir[1]};
+      if (dirT2 < 1.e-6f) {
+        mUnbinned.push_back(iLine);
+        continue;
+      }
+      mZ0[iLine] = origin[2] - (origin[0] * dir[0] + origin[1] * dir[1]) / dirT2 * dir[2];
+      mDZ[iLine] = maxR * o2::gpu::GPUCommonMath::Abs(dir[2]) / o2::gpu::GPUCommonMath::Sqrt(dirT2);
+      mMaxDZ = o2::gpu::GPUCommonMath::Max(mMaxDZ, mDZ[iLine]);
+      mSorted.push_back(iLine);
+    }
+    std::sort(mSorted.begin(), mSorted.end(), [this](int a, int b) { return mZ0[a] < mZ0[b]; });
+    mSortedZ0.reserve(mSorted.size());
+    for (auto iLine : mSorted) {
+      mSortedZ0.push_back(mZ0[iLine]);
+    }
+  }
+
+  /// indices of the candidate lines after iLine, in increasing order
+  void getCandidates(const int iLine, std::vector<int>& candidates) const
+  {
+    candidates.clear();
+    if (std::binary_search(mUnbinned.begin(), mUnbinned.end(), iLine)) {
+      for (int iOther{iLine + 1}; iOther < static_cast<int>(mZ0.size()); ++iOther) {
+        candidates.push_back(iOther);
+      }
+      return;
+    }
+    const float window{mDZ[iLine] + mMaxDZ + mPairCut};
+    auto first{std::lower_bound(mSortedZ0.begin(), mSortedZ0.end(), mZ0[iLine] - window)};
+    auto last{std::upper_bound(first, mSortedZ0.end(), mZ0[iLine] + window)};
+    for (auto it{first}; it != last; ++it) {
+      const int iOther{mSorted[it - mSortedZ0.begin()]};
+      if (iOther > iLine && o2::gpu::GPUCommonMath::Abs(mZ0[iOther] - mZ0[iLine]) <= mDZ[iLine] + mDZ[iOther] + mPairCut) {
+        candidates.push_back(iOther);
+      }
+    }
+    for (auto iOther : mUnbinned) {
+      if (iOther > iLine) {
+        candidates.push_back(iOther);
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+  }
+
+ private:
+  std::vector<float> mZ0;
+  std::vector<float> mDZ;
+  std::vector<int> mSorted;
+  std::vector<float> mSortedZ0;
+  std::vector<int> mUnbinned;
+  float mMaxDZ{0.f};
+  float mPairCut;
+};
+
 const std::vector<std::pair<int, int>> VertexerTraits::selectClusters(const int* indexTable,
                                                                       const std::array<int, 4>& selectedBinsRect,
                                                                       const IndexTableUtils& utils)
@@ -148,13 +220,16 @@ void VertexerTraits::updateVertexingParameters(const VertexingParameters& vrtPar
 
 void VertexerTraits::computeTracklets()
 {
-  for (int rofId{0}; rofId < mTimeFrame->getNrof(); ++rofId) {
+  /// ROFs are independent, the tracklets of each ROF are merged in the ROF order afterwards
+  std::vector<std::array<std::vector<Tracklet>, 2>> rofTracklets(mTimeFrame->getNrof());
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+  for (int rofId = 0; rofId < mTimeFrame->getNrof(); ++rofId) {
     trackleterKernelSerial<TrackletMode::Layer0Layer1>(
       mTimeFrame->getClustersOnLayer(rofId, 0),
       mTimeFrame->getClustersOnLayer(rofId, 1),
       mTimeFrame->getIndexTable(rofId, 0).data(),
       mVrtParams.phiCut,
-      mTimeFrame->getTracklets()[0],
+      rofTracklets[rofId][0],
       mTimeFrame->getNTrackletsCluster(rofId, 0),
       mIndexTableUtils,
       rofId,
@@ -164,7 +239,7 @@ void VertexerTraits::computeTracklets()
       mTimeFrame->getClustersOnLayer(rofId, 1),
       mTimeFrame->getIndexTable(rofId, 2).data(),
       mVrtParams.phiCut,
-      mTimeFrame->getTracklets()[1],
+      rofTracklets[rofId][1],
       mTimeFrame->getNTrackletsCluster(rofId, 1),
       mIndexTableUtils,
       rofId,
@@ -172,11 +247,29 @@ void VertexerTraits::computeTracklets()
     mTimeFrame->getNTrackletsROf(rofId, 0) = std::accumulate(mTimeFrame->getNTrackletsCluster(rofId, 0).begin(), mTimeFrame->getNTrackletsCluster(rofId, 0).end(), 0);
     mTimeFrame->getNTrackletsROf(rofId, 1) = std::accumulate(mTimeFrame->getNTrackletsCluster(rofId, 1).begin(), mTimeFrame->getNTrackletsCluster(rofId, 1).end(), 0);
   }
+  for (int iComb{0}; iComb < 2; ++iComb) {
+    auto& tracklets{mTimeFrame->getTracklets()[iComb]};
+    std::vector<size_t> offsets(mTimeFrame->getNrof() + 1, tracklets.size());
+    for (int rofId{0}; rofId < mTimeFrame->getNrof(); ++rofId) {
+      offsets[rofId + 1] = offsets[rofId] + rofTracklets[rofId][iComb].size();
+    }
+    tracklets.resize(offsets.back());
+#pragma omp parallel for num_threads(mNThreads)
+    for (int rofId = 0; rofId < mTimeFrame->getNrof(); ++rofId) {
+      std::copy(rofTracklets[rofId][iComb].begin(), rofTracklets[rofId][iComb].end(), tracklets.begin() + offsets[rofId]);
+    }
+  }
   mTimeFrame->computeTrackletsScans();
 
   /// Create tracklets labels for L0-L1, information is as flat as in tracklets vector (no rofId)
   if (mTimeFrame->hasMCinformation()) {
-    for (auto& trk : mTimeFrame->getTracklets()[0]) {
+    auto& labels{mTimeFrame->getTrackletsLabel(0)};
+    const size_t labelsOffset{labels.size()};
+    const int trackletsNum{static_cast<int>(mTimeFrame->getTracklets()[0].size())};
+    labels.resize(labelsOffset + trackletsNum);
+#pragma omp parallel for num_threads(mNThreads)
+    for (int iTracklet = 0; iTracklet < trackletsNum; ++iTracklet) {
+      const auto& trk{mTimeFrame->getTracklets()[0][iTracklet]};
       MCCompLabel label;
       int sortedId0{mTimeFrame->getSortedIndex(trk.rof[0], 0, trk.firstClusterIndex)};
       int sortedId1{mTimeFrame->getSortedIndex(trk.rof[0], 1, trk.secondClusterIndex)};
@@ -191,7 +284,7 @@ void VertexerTraits::computeTracklets()
           break;
         }
       }
-      mTimeFrame->getTrackletsLabel(0).emplace_back(label);
+      labels[labelsOffset + iTracklet] = label;
     }
   }
 
@@ -235,7 +328,8 @@ void VertexerTraits::computeTracklets()
 
 void VertexerTraits::computeTrackletMatching()
 {
-  for (int rofId{0}; rofId < mTimeFrame->getNrof(); ++rofId) {
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+  for (int rofId = 0; rofId < mTimeFrame->getNrof(); ++rofId) {
     trackletSelectionKernelSerial(
       mTimeFrame->getClustersOnLayer(rofId, 0),
       mTimeFrame->getClustersOnLayer(rofId, 1),
@@ -287,14 +381,30 @@ void VertexerTraits::computeVertices()
   std::vector<std::vector<ClusterLines>> dbg_clusLines(mTimeFrame->getNrof());
 #endif
   std::vector<int> noClustersVec(mTimeFrame->getNrof(), 0);
-  for (int rofId{0}; rofId < mTimeFrame->getNrof(); ++rofId) {
+  /// ROFs are independent, each one fills its own tracklet clusters
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+  for (int rofId = 0; rofId < mTimeFrame->getNrof(); ++rofId) {
     const int numTracklets{static_cast<int>(mTimeFrame->getLines(rofId).size())};
     std::vector<bool> usedTracklets(numTracklets, false);
+    /// optionally, in high multiplicity ROFs the pairs are looked for only among the lines close in z which can meet
+    /// within the accepted vertex radius, instead of all of them. This is not equivalent to the pairwise scan: there,
+    /// line1 is dropped at its first compatible pair meeting outside the vertex radius, while the binned search never
+    /// sees such pairs and lets line1 pair with a later line
+    std::unique_ptr<LinesZIndex> linesIndex;
+    if (mVrtParams.nLinesBinnedSearch >= 0 && numTracklets > mVrtParams.nLinesBinnedSearch) {
+      linesIndex = std::make_unique<LinesZIndex>(mTimeFrame->getLines(rofId), 2.f + mVrtParams.pairCut, mVrtParams.pairCut);
+    }
+    std::vector<int> candidates;
     for (int line1{0}; line1 < numTracklets; ++line1) {
       if (usedTracklets[line1]) {
         continue;
       }
-      for (int line2{line1 + 1}; line2 < numTracklets; ++line2) {
+      if (linesIndex) {
+        linesIndex->getCandidates(line1, candidates);
+      }
+      const int numCandidates{linesIndex ? static_cast<int>(candidates.size()) : numTracklets - line1 - 1};
+      for (int iCandidate{0}; iCandidate < numCandidates; ++iCandidate) {
+        const int line2{linesIndex ? candidates[iCandidate] : line1 + 1 + iCandidate};
         if (usedTracklets[line2]) {
           continue;
         }
@@ -525,5 +635,15 @@ void VertexerTraits::computeVertices()
 //     }
 //   }
 // }
+
+void VertexerTraits::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 } // namespace its
 } // namespace o2
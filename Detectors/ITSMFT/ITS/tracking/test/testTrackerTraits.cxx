@@ -0,0 +1,160 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITS TrackerTraits
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "ITStracking/Configuration.h"
+#include "ITStracking/TimeFrame.h"
+#include "ITStracking/TrackerTraits.h"
+
+using namespace o2::its;
+
+namespace
+{
+/// Straight tracks from one vertex per ROF plus some noise,
+/// the same for every call.
+void fillTimeFrame(TimeFrame& tf, const TrackingParameters& params, int nRofs)
+{
+  std::mt19937 gen(4242);
+  std::uniform_real_distribution<float> phiDist(0.f, 2.f * M_PI);
+  std::uniform_real_distribution<float> tanLDist(-0.8f, 0.8f);
+  std::uniform_real_distribution<float> vertexZDist(-5.f, 5.f);
+  std::normal_distribution<float> smearing(0.f, 5.e-4f);
+  constexpr int nTracks{150};
+  constexpr int nNoise{50};
+
+  for (int rof{0}; rof < nRofs; ++rof) {
+    const float vertexZ{vertexZDist(gen)};
+    std::vector<std::vector<std::array<float, 3>>> clusters(params.NLayers);
+    for (int iTrack{0}; iTrack < nTracks; ++iTrack) {
+      const float phi{phiDist(gen)};
+      const float tanL{tanLDist(gen)};
+      for (int iLayer{0}; iLayer < params.NLayers; ++iLayer) {
+        const float r{params.LayerRadii[iLayer]};
+        const float z{vertexZ + r * tanL};
+        if (std::abs(z) < params.LayerZ[iLayer] - 1.f) {
+          clusters[iLayer].push_back({r * std::cos(phi) + smearing(gen), r * std::sin(phi) + smearing(gen), z + smearing(gen)});
+        }
+      }
+    }
+    for (int iLayer{0}; iLayer < params.NLayers; ++iLayer) {
+      std::uniform_real_distribution<float> zDist(-params.LayerZ[iLayer] + 1.f, params.LayerZ[iLayer] - 1.f);
+      const float r{params.LayerRadii[iLayer]};
+      for (int iNoise{0}; iNoise < nNoise; ++iNoise) {
+        const float phi{phiDist(gen)};
+        clusters[iLayer].push_back({r * std::cos(phi), r * std::sin(phi), zDist(gen)});
+      }
+    }
+    tf.loadROFrameData(clusters);
+    std::vector<Vertex> vertices;
+    vertices.emplace_back(o2::math_utils::Point3D<float>(0.f, 0.f, vertexZ), std::array<float, 6>{1.e-4f, 0.f, 1.e-4f, 0.f, 0.f, 1.e-4f}, nTracks, 1.f);
+    tf.addPrimaryVertices(vertices);
+  }
+  tf.setMultiplicityCutMask(std::vector<bool>(nRofs, true));
+}
+
+struct Artefacts {
+  std::vector<std::vector<Tracklet>> tracklets;
+  std::vector<std::vector<int>> trackletsLookupTable;
+  std::vector<std::vector<Cell>> cells;
+  std::vector<std::vector<int>> cellsLookupTable;
+  std::vector<std::vector<std::vector<int>>> cellsNeighbours;
+};
+
+Artefacts runTrackerTraits(int nThreads)
+{
+  TrackingParameters params;
+  TimeFrame tf;
+  fillTimeFrame(tf, params, 5);
+
+  TrackerTraits traits;
+  traits.adoptTimeFrame(&tf);
+  traits.UpdateTrackingParameters({params});
+  traits.setNThreads(nThreads);
+  traits.initialiseTimeFrame(0);
+  traits.computeLayerTracklets(0);
+  traits.computeLayerCells(0);
+  traits.findCellsNeighbours(0);
+
+  return Artefacts{tf.getTracklets(), tf.getTrackletsLookupTable(), tf.getCells(), tf.getCellsLookupTable(), tf.getCellsNeighbours()};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TrackerTraits_threads_invariance)
+{
+  const auto reference = runTrackerTraits(1);
+  const auto threaded = runTrackerTraits(4);
+
+  BOOST_REQUIRE_EQUAL(reference.tracklets.size(), threaded.tracklets.size());
+  size_t nTracklets{0};
+  for (size_t iLayer{0}; iLayer < reference.tracklets.size(); ++iLayer) {
+    BOOST_REQUIRE_EQUAL(reference.tracklets[iLayer].size(), threaded.tracklets[iLayer].size());
+    for (size_t iTracklet{0}; iTracklet < reference.tracklets[iLayer].size(); ++iTracklet) {
+      BOOST_CHECK(reference.tracklets[iLayer][iTracklet] == threaded.tracklets[iLayer][iTracklet]);
+    }
+    nTracklets += reference.tracklets[iLayer].size();
+  }
+  BOOST_CHECK(nTracklets > 0);
+  BOOST_CHECK(reference.trackletsLookupTable == threaded.trackletsLookupTable);
+
+  BOOST_REQUIRE_EQUAL(reference.cells.size(), threaded.cells.size());
+  size_t nCells{0};
+  for (size_t iLayer{0}; iLayer < reference.cells.size(); ++iLayer) {
+    BOOST_REQUIRE_EQUAL(reference.cells[iLayer].size(), threaded.cells[iLayer].size());
+    for (size_t iCell{0}; iCell < reference.cells[iLayer].size(); ++iCell) {
+      const auto& ref = reference.cells[iLayer][iCell];
+      const auto& thr = threaded.cells[iLayer][iCell];
+      BOOST_CHECK_EQUAL(ref.getFirstClusterIndex(), thr.getFirstClusterIndex());
+      BOOST_CHECK_EQUAL(ref.getSecondClusterIndex(), thr.getSecondClusterIndex());
+      BOOST_CHECK_EQUAL(ref.getThirdClusterIndex(), thr.getThirdClusterIndex());
+      BOOST_CHECK_EQUAL(ref.getFirstTrackletIndex(), thr.getFirstTrackletIndex());
+      BOOST_CHECK_EQUAL(ref.getSecondTrackletIndex(), thr.getSecondTrackletIndex());
+      BOOST_CHECK_EQUAL(ref.getTanLambda(), thr.getTanLambda());
+      BOOST_CHECK_EQUAL(ref.getLevel(), thr.getLevel());
+    }
+    nCells += reference.cells[iLayer].size();
+  }
+  BOOST_CHECK(nCells > 0);
+  BOOST_CHECK(reference.cellsLookupTable == threaded.cellsLookupTable);
+  BOOST_CHECK(reference.cellsNeighbours == threaded.cellsNeighbours);
+}
+
+BOOST_AUTO_TEST_CASE(TrackerTraits_tracklets_memory_limit)
+{
+  auto countTracklets = [](unsigned long maxMemory, TimeFrame& tf) {
+    TrackingParameters params;
+    params.MaxMemory = maxMemory;
+    fillTimeFrame(tf, params, 20);
+    TrackerTraits traits;
+    traits.adoptTimeFrame(&tf);
+    traits.UpdateTrackingParameters({params});
+    traits.setNThreads(4);
+    traits.initialiseTimeFrame(0);
+    traits.computeLayerTracklets(0);
+    return tf.getNumberOfTracklets();
+  };
+  TimeFrame unlimited, limited;
+  const unsigned long maxMemory{100 * sizeof(Tracklet)};
+  const int allTracklets{countTracklets(TrackingParameters{}.MaxMemory, unlimited)};
+  const int someTracklets{countTracklets(maxMemory, limited)};
+
+  /// The ROFs left once the limit is exceeded are not processed, but the limit is visible to the Tracker
+  BOOST_CHECK(!limited.checkMemory(maxMemory));
+  BOOST_CHECK(someTracklets < allTracklets);
+}
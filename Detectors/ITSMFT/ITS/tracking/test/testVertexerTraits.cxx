@@ -0,0 +1,180 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITS VertexerTraits
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "ITStracking/Configuration.h"
+#include "ITStracking/TimeFrame.h"
+#include "ITStracking/VertexerTraits.h"
+
+using namespace o2::its;
+
+namespace
+{
+constexpr int NRofs{4};
+constexpr int NVerticesPerRof{3};
+constexpr int NTracksPerVertex{500};
+
+/// Straight tracks from a few vertices per ROF plus some noise, the same for every call.
+/// With NVerticesPerRof * NTracksPerVertex tracks there are more than 1000 lines per ROF.
+std::vector<std::array<float, 3>> fillTimeFrame(TimeFrame& tf, const TrackingParameters& params)
+{
+  std::mt19937 gen(2121);
+  std::uniform_real_distribution<float> phiDist(0.f, 2.f * M_PI);
+  std::uniform_real_distribution<float> tanLDist(-0.8f, 0.8f);
+  std::uniform_real_distribution<float> vertexZDist(-8.f, 8.f);
+  std::uniform_real_distribution<float> vertexXYDist(-0.02f, 0.02f);
+  std::normal_distribution<float> smearing(0.f, 1.e-4f);
+  constexpr int nNoise{100};
+
+  std::vector<std::array<float, 3>> trueVertices;
+  for (int rof{0}; rof < NRofs; ++rof) {
+    std::vector<std::vector<std::array<float, 3>>> clusters(params.NLayers);
+    for (int iVertex{0}; iVertex < NVerticesPerRof; ++iVertex) {
+      const std::array<float, 3> vertex{vertexXYDist(gen), vertexXYDist(gen), vertexZDist(gen)};
+      trueVertices.push_back(vertex);
+      for (int iTrack{0}; iTrack < NTracksPerVertex; ++iTrack) {
+        const float phi{phiDist(gen)};
+        const float tanL{tanLDist(gen)};
+        for (int iLayer{0}; iLayer < params.NLayers; ++iLayer) {
+          const float r{params.LayerRadii[iLayer]};
+          const float z{vertex[2] + r * tanL};
+          if (std::abs(z) < params.LayerZ[iLayer] - 1.f) {
+            clusters[iLayer].push_back({vertex[0] + r * std::cos(phi) + smearing(gen), vertex[1] + r * std::sin(phi) + smearing(gen), z + smearing(gen)});
+          }
+        }
+      }
+    }
+    for (int iLayer{0}; iLayer < params.NLayers; ++iLayer) {
+      std::uniform_real_distribution<float> zDist(-params.LayerZ[iLayer] + 1.f, params.LayerZ[iLayer] - 1.f);
+      const float r{params.LayerRadii[iLayer]};
+      for (int iNoise{0}; iNoise < nNoise; ++iNoise) {
+        const float phi{phiDist(gen)};
+        clusters[iLayer].push_back({r * std::cos(phi), r * std::sin(phi), zDist(gen)});
+      }
+    }
+    tf.loadROFrameData(clusters);
+  }
+  return trueVertices;
+}
+
+struct Result {
+  std::vector<std::vector<Vertex>> vertices;
+  int maxLines{0};
+};
+
+Result runVertexerTraits(int nThreads, const VertexingParameters& vrtParams)
+{
+  TrackingParameters params;
+  TimeFrame tf;
+  fillTimeFrame(tf, params);
+
+  VertexerTraits traits;
+  traits.adoptTimeFrame(&tf);
+  traits.updateVertexingParameters(vrtParams);
+  traits.setNThreads(nThreads);
+  traits.initialise(params);
+  traits.computeTracklets();
+  traits.computeTrackletMatching();
+  traits.computeVertices();
+
+  Result result;
+  for (int rof{0}; rof < tf.getNrof(); ++rof) {
+    auto vertices{tf.getPrimaryVertices(rof)};
+    result.vertices.emplace_back(vertices.begin(), vertices.end());
+    result.maxLines = std::max(result.maxLines, static_cast<int>(tf.getLines(rof).size()));
+  }
+  return result;
+}
+
+void checkSameVertices(const Result& result, const Result& reference)
+{
+  BOOST_CHECK_EQUAL(result.maxLines, reference.maxLines);
+  BOOST_REQUIRE_EQUAL(result.vertices.size(), reference.vertices.size());
+  for (size_t rof{0}; rof < reference.vertices.size(); ++rof) {
+    BOOST_REQUIRE_EQUAL(result.vertices[rof].size(), reference.vertices[rof].size());
+    for (size_t iVertex{0}; iVertex < reference.vertices[rof].size(); ++iVertex) {
+      const auto& vtx{result.vertices[rof][iVertex]};
+      const auto& ref{reference.vertices[rof][iVertex]};
+      BOOST_CHECK_EQUAL(vtx.getX(), ref.getX());
+      BOOST_CHECK_EQUAL(vtx.getY(), ref.getY());
+      BOOST_CHECK_EQUAL(vtx.getZ(), ref.getZ());
+      BOOST_CHECK_EQUAL(vtx.getNContributors(), ref.getNContributors());
+      BOOST_CHECK_EQUAL(vtx.getChi2(), ref.getChi2());
+      BOOST_CHECK_EQUAL(vtx.getTimeStamp().getTimeStamp(), ref.getTimeStamp().getTimeStamp());
+      for (int i{0}; i < 6; ++i) {
+        BOOST_CHECK_EQUAL(vtx.getCov()[i], ref.getCov()[i]);
+      }
+    }
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(VertexerTraits_pairwise_default)
+{
+  /// the binned search of the pairs of lines changes the vertices, it must be asked for explicitly
+  VertexingParameters defaultParams;
+  BOOST_CHECK(defaultParams.nLinesBinnedSearch < 0);
+
+  const auto reference{runVertexerTraits(1, defaultParams)};
+  BOOST_CHECK(reference.maxLines > 1000);
+
+  /// the vertices are found close to the generated ones
+  TimeFrame tf;
+  const auto trueVertices{fillTimeFrame(tf, TrackingParameters{})};
+  int nFound{0};
+  for (size_t rof{0}; rof < reference.vertices.size(); ++rof) {
+    for (const auto& vtx : reference.vertices[rof]) {
+      for (int iVertex{0}; iVertex < NVerticesPerRof; ++iVertex) {
+        if (std::abs(vtx.getZ() - trueVertices[rof * NVerticesPerRof + iVertex][2]) < 0.05f) {
+          ++nFound;
+          break;
+        }
+      }
+    }
+  }
+  BOOST_CHECK(nFound >= NRofs * NVerticesPerRof / 2);
+
+  for (int nThreads : {2, 4}) {
+    checkSameVertices(runVertexerTraits(nThreads, defaultParams), reference);
+  }
+
+  /// a threshold above the number of lines keeps the pairwise search
+  VertexingParameters highThreshold;
+  highThreshold.nLinesBinnedSearch = reference.maxLines;
+  checkSameVertices(runVertexerTraits(4, highThreshold), reference);
+}
+
+BOOST_AUTO_TEST_CASE(VertexerTraits_binned_threads_invariance)
+{
+  VertexingParameters binnedParams;
+  binnedParams.nLinesBinnedSearch = 1000;
+  const auto reference{runVertexerTraits(1, binnedParams)};
+  BOOST_CHECK(reference.maxLines > binnedParams.nLinesBinnedSearch);
+  size_t nVertices{0};
+  for (const auto& vertices : reference.vertices) {
+    nVertices += vertices.size();
+  }
+  BOOST_CHECK(nVertices > 0);
+
+  for (int nThreads : {2, 4}) {
+    checkSameVertices(runVertexerTraits(nThreads, binnedParams), reference);
+  }
+}
@@ -114,24 +114,26 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>&
 
   ec->setHeader(compCl.header);
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
-  // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
-  o2::ctf::CTFIOSize iosize;
-#define ENCODEITSMFT(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+  ec->getANSHeader().majorVersion = 1;
+  ec->getANSHeader().minorVersion = 0;
+  // the blocks are encoded concurrently to standalone images which are then stored to the buffer
+  const auto ansHeader = ec->getANSHeader(); // copy, the buffer may be expanded while storing the blocks
+  std::array<std::function<CTF::preparedBlock_t()>, CTF::getNBlocks()> tasks;
+#define ENCODEITSMFT(part, slot, bits) tasks[int(slot)] = [&]() { return CTF::prepareBlock(part, ansHeader, bits, optField[int(slot)], mCoders[int(slot)].get(), getMemMarginFactor()); }
   // clang-format off
-  iosize += ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0);
-  iosize += ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0);
-  iosize += ENCODEITSMFT(compCl.orbitIncROF, CTF::BLCorbitIncROF, 0);
-  iosize += ENCODEITSMFT(compCl.nclusROF, CTF::BLCnclusROF, 0);
+  ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0);
+  ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0);
+  ENCODEITSMFT(compCl.orbitIncROF, CTF::BLCorbitIncROF, 0);
+  ENCODEITSMFT(compCl.nclusROF, CTF::BLCnclusROF, 0);
   //
-  iosize += ENCODEITSMFT(compCl.chipInc, CTF::BLCchipInc, 0);
-  iosize += ENCODEITSMFT(compCl.chipMul, CTF::BLCchipMul, 0);
-  iosize += ENCODEITSMFT(compCl.row, CTF::BLCrow, 0);
-  iosize += ENCODEITSMFT(compCl.colInc, CTF::BLCcolInc, 0);
-  iosize += ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0);
-  iosize += ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0);
+  ENCODEITSMFT(compCl.chipInc, CTF::BLCchipInc, 0);
+  ENCODEITSMFT(compCl.chipMul, CTF::BLCchipMul, 0);
+  ENCODEITSMFT(compCl.row, CTF::BLCrow, 0);
+  ENCODEITSMFT(compCl.colInc, CTF::BLCcolInc, 0);
+  ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0);
+  ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0);
   // clang-format on
+  o2::ctf::CTFIOSize iosize = encodeBlocks<CTF>(buff, tasks);
   //CTF::get(buff.data())->print(getPrefix());
   iosize.rawIn = rofRecVec.size() * sizeof(ROFRecord) + cclusVec.size() * sizeof(CompClusterExt) + pattVec.size() * sizeof(unsigned char);
   return iosize;
@@ -17,12 +17,15 @@
 /// Short LookUp descritpion
 ///
 /// This class is for the association of the cluster topology with the corresponding
-/// entry in the dictionary
+/// entry in the dictionary. When the dictionary is set, its hash maps are converted
+/// to a flat open addressing table for the common topologies and to a dense array
+/// for the groups of rare topologies, which are used for the lookups.
 ///
 
 #ifndef ALICEO2_ITSMFT_LOOKUP_H
 #define ALICEO2_ITSMFT_LOOKUP_H
 #include <array>
+#include <vector>
 #include "DataFormatsITSMFT/ClusterTopology.h"
 #include "DataFormatsITSMFT/TopologyDictionary.h"
 
@@ -44,12 +47,23 @@ class LookUp
   int size() const { return mDictionary.getSize(); }
   auto getPattern(int id) const { return mDictionary.getPattern(id); }
   auto getDictionaty() const { return mDictionary; }
+  /// build the transient lookup tables from the dictionary, also called by the ROOT I/O once the object is read
+  void buildLookUpTables();
 
  private:
+  struct HashSlot {
+    unsigned long hash = 0; ///< hash of the common topology
+    int id = -1;            ///< its position in the dictionary, -1 for empty slot
+  };
+  int findCommonID(unsigned long hash) const;
+
   TopologyDictionary mDictionary;
   int mTopologiesOverThreshold;
+  int mHashShift = 64;                                               //! 64 - log2 of the mHashTable size
+  std::vector<HashSlot> mHashTable;                                  //! open addressing table of the common topologies
+  std::array<int, TopologyDictionary::NumberOfRareGroups> mGroupIDs; //! dictionary entry of each group of rare topologies
 
-  ClassDefNV(LookUp, 3);
+  ClassDefNV(LookUp, 4);
 };
 } // namespace itsmft
 } // namespace o2
@@ -25,6 +25,7 @@
 #pragma link C++ class o2::itsmft::ChipPixelData + ;
 #pragma link C++ class o2::itsmft::BuildTopologyDictionary + ;
 #pragma link C++ class o2::itsmft::LookUp + ;
+#pragma read sourceClass = "o2::itsmft::LookUp" targetClass = "o2::itsmft::LookUp" source = "" version = "[1-]" target = "" code = "{ newObj->buildLookUpTables(); }"
 #pragma link C++ class o2::itsmft::TopologyFastSimulation + ;
 #pragma link C++ class o2::itsmft::ChipMappingITS + ;
 #pragma link C++ class o2::itsmft::ChipMappingMFT + ;
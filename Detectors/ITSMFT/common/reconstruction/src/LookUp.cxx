@@ -26,7 +26,10 @@ namespace o2
 namespace itsmft
 {
 
-LookUp::LookUp() : mDictionary{}, mTopologiesOverThreshold{0} {}
+LookUp::LookUp() : mDictionary{}, mTopologiesOverThreshold{0}
+{
+  buildLookUpTables();
+}
 
 LookUp::LookUp(std::string fileName)
 {
@@ -36,7 +39,7 @@ LookUp::LookUp(std::string fileName)
 void LookUp::loadDictionary(std::string fileName)
 {
   mDictionary.readFromFile(fileName);
-  mTopologiesOverThreshold = mDictionary.mCommonMap.size();
+  buildLookUpTables();
 }
 
 void LookUp::setDictionary(const TopologyDictionary* dict)
@@ -44,7 +47,50 @@ void LookUp::setDictionary(const TopologyDictionary* dict)
   if (dict) {
     mDictionary = *dict;
   }
+  buildLookUpTables();
+}
+
+void LookUp::buildLookUpTables()
+{
+  // The hash maps of the dictionary are replaced by flat tables, built once: the common topologies
+  // go to an open addressing table with linear probing filled at most by half, the groups of rare
+  // topologies to an array indexed by the group number.
   mTopologiesOverThreshold = mDictionary.mCommonMap.size();
+  size_t tableSize = 2;
+  mHashShift = 63;
+  while (tableSize < 2 * mDictionary.mCommonMap.size()) {
+    tableSize <<= 1;
+    mHashShift--;
+  }
+  mHashTable.clear();
+  mHashTable.resize(tableSize);
+  for (const auto& [hash, id] : mDictionary.mCommonMap) {
+    auto slot = (hash * 0x9e3779b97f4a7c15UL) >> mHashShift;
+    while (mHashTable[slot].id >= 0) {
+      slot = (slot + 1) & (tableSize - 1);
+    }
+    mHashTable[slot] = HashSlot{hash, id};
+  }
+  mGroupIDs.fill(CompCluster::InvalidPatternID);
+  for (const auto& [group, id] : mDictionary.mGroupMap) {
+    if (group >= 0 && group < TopologyDictionary::NumberOfRareGroups) {
+      mGroupIDs[group] = id;
+    }
+  }
+}
+
+int LookUp::findCommonID(unsigned long hash) const
+{
+  if (mHashTable.empty()) { // tables not built
+    return -1;
+  }
+  auto mask = mHashTable.size() - 1;
+  for (auto slot = (hash * 0x9e3779b97f4a7c15UL) >> mHashShift;; slot = (slot + 1) & mask) {
+    const auto& entry = mHashTable[slot];
+    if (entry.id < 0 || entry.hash == hash) {
+      return entry.id;
+    }
+  }
 }
 
 int LookUp::groupFinder(int nRow, int nCol)
@@ -75,18 +121,14 @@ int LookUp::findGroupID(int nRow, int nCol, const unsigned char patt[ClusterPatt
       return ID;
     }
   } else { // Big unique topology
-    unsigned long hash = ClusterTopology::getCompleteHash(nRow, nCol, patt);
-    auto ret = mDictionary.mCommonMap.find(hash);
-    if (ret != mDictionary.mCommonMap.end()) {
-      return ret->second;
+    int ID = findCommonID(ClusterTopology::getCompleteHash(nRow, nCol, patt));
+    if (ID >= 0) {
+      return ID;
     }
   }
-  if (!mDictionary.mGroupMap.empty()) { // rare valid topology group
-    int index = groupFinder(nRow, nCol);
-    auto res = mDictionary.mGroupMap.find(index);
-    return res == mDictionary.mGroupMap.end() ? CompCluster::InvalidPatternID : res->second;
-  }
-  return CompCluster::InvalidPatternID;
+  // rare valid topology group
+  int index = groupFinder(nRow, nCol);
+  return (index >= 0 && index < TopologyDictionary::NumberOfRareGroups) ? mGroupIDs[index] : CompCluster::InvalidPatternID;
 }
 
 } // namespace itsmft
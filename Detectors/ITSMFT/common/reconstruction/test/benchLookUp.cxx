@@ -0,0 +1,130 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchLookUp.cxx
+/// \brief Benchmark of the topology dictionary lookup of the clusterer
+///
+/// The dictionary is read from the file given by the ITSMFT_DICTIONARY_FILE environment
+/// variable, ITSdictionary.bin by default. The clusters are generated from its entries
+/// with their frequencies, plus a fraction of random big topologies ending in the groups.
+
+#include "benchmark/benchmark.h"
+#include "ITSMFTReconstruction/LookUp.h"
+#include "DataFormatsITSMFT/ClusterTopology.h"
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace o2::itsmft;
+
+struct TestCluster {
+  int nRow;
+  int nCol;
+  std::array<unsigned char, ClusterPattern::MaxPatternBytes> patt;
+};
+
+static const LookUp& getLookUp()
+{
+  static LookUp lookUp;
+  static bool loaded = false;
+  if (!loaded) {
+    const char* fileName = std::getenv("ITSMFT_DICTIONARY_FILE");
+    lookUp.loadDictionary(fileName ? fileName : "ITSdictionary.bin");
+    loaded = true;
+  }
+  return lookUp;
+}
+
+static std::vector<TestCluster> generateClusters(const LookUp& lookUp, int nClusters)
+{
+  std::mt19937 gen(1234);
+  const auto dict = lookUp.getDictionaty();
+  std::vector<double> freq;
+  for (int i = 0; i < dict.getSize(); i++) {
+    freq.push_back(dict.isGroup(i) ? 0. : dict.getFrequency(i));
+  }
+  std::discrete_distribution<int> entry(freq.begin(), freq.end());
+  std::uniform_int_distribution<int> span(3, 10), byte(0, 255), rare(0, 99);
+  std::vector<TestCluster> clusters(nClusters);
+  for (auto& cl : clusters) {
+    cl.patt.fill(0);
+    if (rare(gen) < 5) {
+      cl.nRow = span(gen);
+      cl.nCol = span(gen);
+      for (int i = 0; i < (cl.nRow * cl.nCol + 7) / 8; i++) {
+        cl.patt[i] = byte(gen);
+      }
+    } else {
+      const auto& patt = lookUp.getPattern(entry(gen));
+      cl.nRow = patt.getRowSpan();
+      cl.nCol = patt.getColumnSpan();
+      std::copy(patt.getPattern().begin() + 2, patt.getPattern().end(), cl.patt.begin());
+    }
+  }
+  return clusters;
+}
+
+static void BM_LookUpFlat(benchmark::State& state)
+{
+  const auto& lookUp = getLookUp();
+  auto clusters = generateClusters(lookUp, state.range(0));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& cl : clusters) {
+      sum += lookUp.findGroupID(cl.nRow, cl.nCol, cl.patt.data());
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_LookUpUnorderedMap(benchmark::State& state)
+{
+  // reference: the lookup in the hash maps of the dictionary
+  const auto& lookUp = getLookUp();
+  const auto dict = lookUp.getDictionaty();
+  std::unordered_map<unsigned long, int> commonMap;
+  std::unordered_map<int, int> groupMap;
+  for (int i = 0; i < dict.getSize(); i++) {
+    if (dict.isGroup(i)) {
+      groupMap.emplace((int)(dict.getHash(i) >> 32) & 0x00000000ffffffff, i);
+    } else {
+      commonMap.emplace(dict.getHash(i), i);
+    }
+  }
+  auto clusters = generateClusters(lookUp, state.range(0));
+  for (auto _ : state) {
+    int sum = 0;
+    for (const auto& cl : clusters) {
+      int id = CompCluster::InvalidPatternID;
+      if (cl.nRow * cl.nCol < 9) {
+        id = lookUp.findGroupID(cl.nRow, cl.nCol, cl.patt.data());
+      } else {
+        auto ret = commonMap.find(ClusterTopology::getCompleteHash(cl.nRow, cl.nCol, cl.patt.data()));
+        if (ret != commonMap.end()) {
+          id = ret->second;
+        } else {
+          auto res = groupMap.find(LookUp::groupFinder(cl.nRow, cl.nCol));
+          id = res == groupMap.end() ? CompCluster::InvalidPatternID : res->second;
+        }
+      }
+      sum += id;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_LookUpFlat)->RangeMultiplier(10)->Range(1000, 1000000);
+BENCHMARK(BM_LookUpUnorderedMap)->RangeMultiplier(10)->Range(1000, 1000000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,187 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testLookUp.cxx
+/// \brief Test the flat lookup tables of LookUp against the hash maps of the dictionary
+
+#define BOOST_TEST_MODULE Test ITSMFT LookUp
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <TMemFile.h>
+#include "DataFormatsITSMFT/ClusterTopology.h"
+#include "DataFormatsITSMFT/CompCluster.h"
+#include "ITSMFTReconstruction/BuildTopologyDictionary.h"
+#include "ITSMFTReconstruction/LookUp.h"
+
+using namespace o2::itsmft;
+
+namespace
+{
+
+constexpr int MaxTestSpan = 20;
+
+/// only the bytes of the bounding box are read from the pattern
+struct TestCluster {
+  int nRow;
+  int nCol;
+  std::array<unsigned char, (MaxTestSpan * MaxTestSpan + 7) / 8> patt;
+};
+
+/// random topology, the bits beyond the bounding box are cleared and the first pixel is fired
+TestCluster randomCluster(std::mt19937& gen, int maxSpan)
+{
+  std::uniform_int_distribution<int> span(1, maxSpan), byte(0, 255);
+  TestCluster cl;
+  cl.patt.fill(0);
+  cl.nRow = span(gen);
+  cl.nCol = span(gen);
+  int nBits = cl.nRow * cl.nCol;
+  for (int i = 0; i < (nBits + 7) / 8; i++) {
+    cl.patt[i] = byte(gen);
+  }
+  if (nBits % 8) {
+    cl.patt[nBits / 8] &= (unsigned char)(0xff << (8 - nBits % 8));
+  }
+  cl.patt[0] |= 0x80;
+  return cl;
+}
+
+/// topologies with a few frequent ones, to have common topologies of all sizes and rare ones in the groups
+std::vector<TestCluster> generateClusters(int nClusters, int nFrequent, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::vector<TestCluster> frequent;
+  for (int i = 0; i < nFrequent; i++) {
+    frequent.push_back(randomCluster(gen, i % 3 ? 4 : 12));
+  }
+  std::uniform_int_distribution<int> pick(0, 2 * nFrequent - 1);
+  std::vector<TestCluster> clusters;
+  for (int i = 0; i < nClusters; i++) {
+    int k = pick(gen);
+    clusters.push_back(k < nFrequent ? frequent[k] : randomCluster(gen, MaxTestSpan));
+  }
+  return clusters;
+}
+
+TopologyDictionary buildDictionary(const std::vector<TestCluster>& clusters, unsigned int nCommon)
+{
+  BuildTopologyDictionary builder;
+  for (const auto& cl : clusters) {
+    builder.accountTopology(ClusterTopology(cl.nRow, cl.nCol, cl.patt.data()));
+  }
+  builder.setNCommon(nCommon);
+  builder.groupRareTopologies();
+  return builder.getDictionary();
+}
+
+/// the lookup with hash maps of the dictionary entries, as done before the flat tables
+class MapLookUp
+{
+ public:
+  MapLookUp(const TopologyDictionary& dict)
+  {
+    for (int i = 0; i < dict.getSize(); i++) {
+      if (dict.isGroup(i)) {
+        mGroupMap.emplace((int)(dict.getHash(i) >> 32) & 0x00000000ffffffff, i);
+      } else {
+        mCommonMap.emplace(dict.getHash(i), i);
+      }
+    }
+  }
+  int findGroupID(int nRow, int nCol, const unsigned char patt[ClusterPattern::MaxPatternBytes]) const
+  {
+    auto ret = mCommonMap.find(ClusterTopology::getCompleteHash(nRow, nCol, patt));
+    if (ret != mCommonMap.end()) {
+      return ret->second;
+    }
+    auto res = mGroupMap.find(LookUp::groupFinder(nRow, nCol));
+    return res == mGroupMap.end() ? CompCluster::InvalidPatternID : res->second;
+  }
+
+ private:
+  std::unordered_map<unsigned long, int> mCommonMap;
+  std::unordered_map<int, int> mGroupMap;
+};
+
+void checkSameIDs(const LookUp& lookUp, const MapLookUp& reference, const std::vector<TestCluster>& clusters, bool requireBoth = true)
+{
+  int nCommon = 0, nGroups = 0;
+  for (const auto& cl : clusters) {
+    int id = lookUp.findGroupID(cl.nRow, cl.nCol, cl.patt.data());
+    BOOST_CHECK_EQUAL(id, reference.findGroupID(cl.nRow, cl.nCol, cl.patt.data()));
+    if (id != CompCluster::InvalidPatternID) {
+      (lookUp.isGroup(id) ? nGroups : nCommon)++;
+    }
+  }
+  if (requireBoth) { // make sure both kinds of entries are tested
+    BOOST_CHECK(nCommon > 0);
+    BOOST_CHECK(nGroups > 0);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(LookUp_flatTables)
+{
+  const auto clusters = generateClusters(20000, 300, 1234);
+  // table sizes around the powers of 2
+  for (unsigned int nCommon : {1, 2, 3, 64, 65, 300}) {
+    auto dict = buildDictionary(clusters, nCommon);
+    LookUp lookUp;
+    lookUp.setDictionary(&dict);
+    BOOST_CHECK_EQUAL(lookUp.getTopologiesOverThreshold(), int(nCommon));
+    MapLookUp reference(dict);
+    checkSameIDs(lookUp, reference, clusters);
+    // topologies which were never seen
+    checkSameIDs(lookUp, reference, generateClusters(5000, 300, 4321), false);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(LookUp_emptyDictionary)
+{
+  const auto clusters = generateClusters(1000, 10, 99);
+  LookUp lookUp;
+  BOOST_CHECK_EQUAL(lookUp.getTopologiesOverThreshold(), 0);
+  for (const auto& cl : clusters) {
+    BOOST_CHECK_EQUAL(lookUp.findGroupID(cl.nRow, cl.nCol, cl.patt.data()), CompCluster::InvalidPatternID);
+  }
+  TopologyDictionary empty;
+  lookUp.setDictionary(&empty);
+  for (const auto& cl : clusters) {
+    BOOST_CHECK_EQUAL(lookUp.findGroupID(cl.nRow, cl.nCol, cl.patt.data()), CompCluster::InvalidPatternID);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(LookUp_streamer)
+{
+  // the transient tables must be rebuilt when the object is read back
+  const auto clusters = generateClusters(20000, 300, 1234);
+  auto dict = buildDictionary(clusters, 100);
+  LookUp lookUp;
+  lookUp.setDictionary(&dict);
+
+  TMemFile file("LookUp.root", "RECREATE");
+  file.WriteObjectAny(&lookUp, "o2::itsmft::LookUp", "lookup");
+  std::unique_ptr<LookUp> readLookUp(file.Get<LookUp>("lookup"));
+  BOOST_REQUIRE(readLookUp != nullptr);
+  BOOST_CHECK_EQUAL(readLookUp->size(), lookUp.size());
+  for (const auto& cl : clusters) {
+    BOOST_CHECK_EQUAL(readLookUp->findGroupID(cl.nRow, cl.nCol, cl.patt.data()), lookUp.findGroupID(cl.nRow, cl.nCol, cl.patt.data()));
+  }
+  checkSameIDs(*readLookUp, MapLookUp(dict), clusters);
+}
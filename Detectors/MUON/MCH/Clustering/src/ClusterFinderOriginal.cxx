@@ -28,10 +28,9 @@
 #include <stdexcept>
 #include <string>
 
-#include <TH2I.h>
-#include <TAxis.h>
 #include <TMath.h>
 #include <TRandom.h>
+#include <TRandom3.h>
 
 #include <fairlogger/Logger.h>
 
@@ -40,6 +39,7 @@
 #include "MCHClustering/ClusterizerParam.h"
 #include "PadOriginal.h"
 #include "ClusterOriginal.h"
+#include "PixelGrid.h"
 
 namespace o2::mch
 {
@@ -47,7 +47,11 @@ namespace o2::mch
 //_________________________________________________________________________________________________
 ClusterFinderOriginal::ClusterFinderOriginal()
   : mMathiesons(std::make_unique<MathiesonOriginal[]>(2)),
-    mPreCluster(std::make_unique<ClusterOriginal>())
+    mPreCluster(std::make_unique<ClusterOriginal>()),
+    mPixelCharges(std::make_unique<PixelGrid<double>>()),
+    mPixelEntries(std::make_unique<PixelGrid<int>>()),
+    mAnodeGrid(std::make_unique<PixelGrid<double>>()),
+    mMLEMGrid(std::make_unique<PixelGrid<double>>())
 {
   /// default constructor
 }
@@ -112,6 +116,18 @@ void ClusterFinderOriginal::deinit()
   mPreClusterFinder.deinit();
 }
 
+//_________________________________________________________________________________________________
+void ClusterFinderOriginal::setRandomSeed(unsigned int seed)
+{
+  /// use a random generator of its own, initialized with this seed, instead of gRandom
+  /// e.g. to get reproducible results when several cluster finders are used in parallel
+  if (mRandom) {
+    mRandom->SetSeed(seed);
+  } else {
+    mRandom = std::make_unique<TRandom3>(seed);
+  }
+}
+
 //_________________________________________________________________________________________________
 void ClusterFinderOriginal::reset()
 {
@@ -401,9 +417,8 @@ void ClusterFinderOriginal::processPreCluster()
   } else {
 
     // find the local maxima in the pixel array
-    std::unique_ptr<TH2D> histAnode(nullptr);
     std::multimap<double, std::pair<int, int>, std::greater<>> localMaxima{};
-    findLocalMaxima(histAnode, localMaxima);
+    findLocalMaxima(*mAnodeGrid, localMaxima);
     if (localMaxima.empty()) {
       return;
     }
@@ -419,7 +434,7 @@ void ClusterFinderOriginal::processPreCluster()
       for (const auto& localMaximum : localMaxima) {
 
         // select the part of the precluster that is around the local maximum
-        restrictPreCluster(*histAnode, localMaximum.second.first, localMaximum.second.second);
+        restrictPreCluster(*mAnodeGrid, localMaximum.second.first, localMaximum.second.second);
 
         // treat it
         process();
@@ -489,23 +504,25 @@ void ClusterFinderOriginal::buildPixArray()
     area[ixy][1] = area[ixy][0] + nbins[ixy] * width[ixy] * 2.;
   }
 
-  // book pixel histograms and fill them
-  TH2D hCharges("Charges", "", nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
-  TH2I hEntries("Entries", "", nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
+  // book pixel grids and fill them
+  auto& hCharges = *mPixelCharges;
+  auto& hEntries = *mPixelEntries;
+  hCharges.reset(nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
+  hEntries.reset(nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
   for (const auto& pad : *mPreCluster) {
     ProjectPadOverPixels(pad, hCharges, hEntries);
   }
 
   // store fired pixels with an entry from both planes if both planes are fired
   for (int i = 1; i <= nbins[0]; ++i) {
-    double x = hCharges.GetXaxis()->GetBinCenter(i);
+    double x = hCharges.binCenterX(i);
     for (int j = 1; j <= nbins[1]; ++j) {
-      int entries = hEntries.GetBinContent(i, j);
+      int entries = hEntries.content(i, j);
       if (entries == 0 || (plane0 != plane1 && (entries < 1000 || entries % 1000 < 1))) {
         continue;
       }
-      double y = hCharges.GetYaxis()->GetBinCenter(j);
-      double charge = hCharges.GetBinContent(i, j);
+      double y = hCharges.binCenterY(j);
+      double charge = hCharges.content(i, j);
       mPixels.emplace_back(x, y, width[0], width[1], charge);
     }
   }
@@ -529,39 +546,36 @@ void ClusterFinderOriginal::buildPixArray()
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::ProjectPadOverPixels(const PadOriginal& pad, TH2D& hCharges, TH2I& hEntries) const
+void ClusterFinderOriginal::ProjectPadOverPixels(const PadOriginal& pad, PixelGrid<double>& hCharges, PixelGrid<int>& hEntries) const
 {
-  /// project the pad over pixel histograms
+  /// project the pad over pixel grids
 
-  const TAxis* xaxis = hCharges.GetXaxis();
-  const TAxis* yaxis = hCharges.GetYaxis();
-
-  int iMin = TMath::Max(1, xaxis->FindBin(pad.x() - pad.dx() + SDistancePrecision));
-  int iMax = TMath::Min(hCharges.GetNbinsX(), xaxis->FindBin(pad.x() + pad.dx() - SDistancePrecision));
-  int jMin = TMath::Max(1, yaxis->FindBin(pad.y() - pad.dy() + SDistancePrecision));
-  int jMax = TMath::Min(hCharges.GetNbinsY(), yaxis->FindBin(pad.y() + pad.dy() - SDistancePrecision));
+  int iMin = TMath::Max(1, hCharges.findBinX(pad.x() - pad.dx() + SDistancePrecision));
+  int iMax = TMath::Min(hCharges.nBinsX(), hCharges.findBinX(pad.x() + pad.dx() - SDistancePrecision));
+  int jMin = TMath::Max(1, hCharges.findBinY(pad.y() - pad.dy() + SDistancePrecision));
+  int jMax = TMath::Min(hCharges.nBinsY(), hCharges.findBinY(pad.y() + pad.dy() - SDistancePrecision));
 
   double charge = pad.charge();
   int entry = 1 + pad.plane() * 999;
 
   for (int i = iMin; i <= iMax; ++i) {
     for (int j = jMin; j <= jMax; ++j) {
-      int entries = hEntries.GetBinContent(i, j);
-      hCharges.SetBinContent(i, j, (entries > 0) ? TMath::Min(hCharges.GetBinContent(i, j), charge) : charge);
-      hEntries.SetBinContent(i, j, entries + entry);
+      int entries = hEntries.content(i, j);
+      hCharges.setContent(i, j, (entries > 0) ? TMath::Min(hCharges.content(i, j), charge) : charge);
+      hEntries.setContent(i, j, entries + entry);
     }
   }
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
+void ClusterFinderOriginal::findLocalMaxima(PixelGrid<double>& histAnode,
                                             std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima)
 {
   /// find local maxima in pixel space for large preclusters in order to
   /// try to split them into smaller pieces (to speed up the MLEM procedure)
   /// and tag the corresponding pixels
 
-  // create a 2D histogram from the pixel array
+  // create a 2D grid from the pixel array
   double xMin(std::numeric_limits<double>::max()), xMax(-std::numeric_limits<double>::max());
   double yMin(std::numeric_limits<double>::max()), yMax(-std::numeric_limits<double>::max());
   double dx(mPixels.front().dx()), dy(mPixels.front().dy());
@@ -573,29 +587,27 @@ void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
   }
   int nBinsX = TMath::Nint((xMax - xMin) / dx / 2.) + 1;
   int nBinsY = TMath::Nint((yMax - yMin) / dy / 2.) + 1;
-  histAnode = std::make_unique<TH2D>("anode", "anode", nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
+  histAnode.reset(nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
   for (const auto& pixel : mPixels) {
-    histAnode->Fill(pixel.x(), pixel.y(), pixel.charge());
+    histAnode.fill(pixel.x(), pixel.y(), pixel.charge());
   }
 
   // find the local maxima
   std::vector<std::vector<int>> isLocalMax(nBinsX, std::vector<int>(nBinsY, 0));
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
-      if (isLocalMax[i - 1][j - 1] == 0 && histAnode->GetBinContent(i, j) >= mLowestPixelCharge) {
-        flagLocalMaxima(*histAnode, i, j, isLocalMax);
+      if (isLocalMax[i - 1][j - 1] == 0 && histAnode.content(i, j) >= mLowestPixelCharge) {
+        flagLocalMaxima(histAnode, i, j, isLocalMax);
       }
     }
   }
 
   // store local maxima and tag corresponding pixels
-  TAxis* xAxis = histAnode->GetXaxis();
-  TAxis* yAxis = histAnode->GetYaxis();
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
       if (isLocalMax[i - 1][j - 1] > 0) {
-        localMaxima.emplace(histAnode->GetBinContent(i, j), std::make_pair(i, j));
-        auto itPixel = findPad(mPixels, xAxis->GetBinCenter(i), yAxis->GetBinCenter(j), mLowestPixelCharge);
+        localMaxima.emplace(histAnode.content(i, j), std::make_pair(i, j));
+        auto itPixel = findPad(mPixels, histAnode.binCenterX(i), histAnode.binCenterY(j), mLowestPixelCharge);
         itPixel->setStatus(PadOriginal::kMustKeep);
         if (localMaxima.size() > 99) {
           break;
@@ -610,18 +622,18 @@ void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::flagLocalMaxima(const TH2D& histAnode, int i0, int j0, std::vector<std::vector<int>>& isLocalMax) const
+void ClusterFinderOriginal::flagLocalMaxima(const PixelGrid<double>& histAnode, int i0, int j0, std::vector<std::vector<int>>& isLocalMax) const
 {
   /// flag the bin (i,j) as a local maximum or not by comparing its charge to the one of its neighbours
   /// and flag the neighbours accordingly (recursive procedure in case the charges are equal)
 
   int idxi0 = i0 - 1;
   int idxj0 = j0 - 1;
-  int charge0 = TMath::Nint(histAnode.GetBinContent(i0, j0));
+  int charge0 = TMath::Nint(histAnode.content(i0, j0));
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histAnode.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(histAnode.nBinsX(), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histAnode.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(histAnode.nBinsY(), j0 + 1);
 
   for (int j = jMin; j <= jMax; ++j) {
     int idxj = j - 1;
@@ -630,7 +642,7 @@ void ClusterFinderOriginal::flagLocalMaxima(const TH2D& histAnode, int i0, int j
         continue;
       }
       int idxi = i - 1;
-      int charge = TMath::Nint(histAnode.GetBinContent(i, j));
+      int charge = TMath::Nint(histAnode.content(i, j));
       if (charge0 < charge) {
         isLocalMax[idxi0][idxj0] = -1;
         return;
@@ -655,27 +667,25 @@ void ClusterFinderOriginal::flagLocalMaxima(const TH2D& histAnode, int i0, int j
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::restrictPreCluster(const TH2D& histAnode, int i0, int j0)
+void ClusterFinderOriginal::restrictPreCluster(const PixelGrid<double>& histAnode, int i0, int j0)
 {
   /// keep in the pixel array only the ones around the local maximum
   /// and tag the pads in the precluster that overlap with them
 
   // drop all pixels from the array and put back the ones around the local maximum
   mPixels.clear();
-  const TAxis* xAxis = histAnode.GetXaxis();
-  const TAxis* yAxis = histAnode.GetYaxis();
-  double dx = xAxis->GetBinWidth(1) / 2.;
-  double dy = yAxis->GetBinWidth(1) / 2.;
-  double charge0 = histAnode.GetBinContent(i0, j0);
+  double dx = histAnode.binWidthX() / 2.;
+  double dy = histAnode.binWidthY() / 2.;
+  double charge0 = histAnode.content(i0, j0);
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histAnode.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(histAnode.nBinsX(), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histAnode.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(histAnode.nBinsY(), j0 + 1);
   for (int j = jMin; j <= jMax; ++j) {
     for (int i = iMin; i <= iMax; ++i) {
-      double charge = histAnode.GetBinContent(i, j);
+      double charge = histAnode.content(i, j);
       if (charge >= mLowestPixelCharge && charge <= charge0) {
-        mPixels.emplace_back(xAxis->GetBinCenter(i), yAxis->GetBinCenter(j), dx, dy, charge);
+        mPixels.emplace_back(histAnode.binCenterX(i), histAnode.binCenterY(j), dx, dy, charge);
       }
     }
   }
@@ -779,7 +789,7 @@ void ClusterFinderOriginal::process()
 
   std::vector<double> coef(0);
   std::vector<double> prob(0);
-  std::unique_ptr<TH2D> histMLEM(nullptr);
+  auto& histMLEM = *mMLEMGrid;
   while (true) {
 
     // calculate pad-pixel coupling coefficients and pixel visibilities
@@ -800,14 +810,13 @@ void ClusterFinderOriginal::process()
       return;
     }
 
-    // create a 2D histogram from the pixel array
+    // create a 2D grid from the pixel array
     double dx(mPixels.front().dx()), dy(mPixels.front().dy());
     int nBinsX = TMath::Nint((xMax - xMin) / dx / 2.) + 1;
     int nBinsY = TMath::Nint((yMax - yMin) / dy / 2.) + 1;
-    histMLEM.reset(nullptr); // delete first to avoid "Replacing existing TH1: mlem (Potential memory leak)"
-    histMLEM = std::make_unique<TH2D>("mlem", "mlem", nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
+    histMLEM.reset(nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
     for (const auto& pixel : mPixels) {
-      histMLEM->Fill(pixel.x(), pixel.y(), pixel.charge());
+      histMLEM.fill(pixel.x(), pixel.y(), pixel.charge());
     }
 
     // stop here if the pixel size is small enough
@@ -817,14 +826,14 @@ void ClusterFinderOriginal::process()
 
     // calculate the position of the center-of-gravity around the pixel with maximum charge
     double xyCOG[2] = {0., 0.};
-    findCOG(*histMLEM, xyCOG);
+    findCOG(histMLEM, xyCOG);
 
     // decrease the pixel size and align the array with the position of the center-of-gravity
     refinePixelArray(xyCOG, npadOK, xMin, xMax, yMin, yMax);
   }
 
   // discard pixels with low visibility by moving their charge to their nearest neighbour (cuts are empirical !!!)
-  double threshold = TMath::Min(TMath::Max(histMLEM->GetMaximum() / 100., 2.0 * mLowestPixelCharge), 100.0 * mLowestPixelCharge);
+  double threshold = TMath::Min(TMath::Max(histMLEM.maximum() / 100., 2.0 * mLowestPixelCharge), 100.0 * mLowestPixelCharge);
   cleanPixelArray(threshold, prob);
 
   // re-run the MLEM algorithm with 2 iterations
@@ -835,13 +844,13 @@ void ClusterFinderOriginal::process()
     return;
   }
 
-  // update the histogram
+  // update the grid
   for (const auto& pixel : mPixels) {
-    histMLEM->SetBinContent(histMLEM->GetXaxis()->FindBin(pixel.x()), histMLEM->GetYaxis()->FindBin(pixel.y()), pixel.charge());
+    histMLEM.setContent(histMLEM.findBinX(pixel.x()), histMLEM.findBinY(pixel.y()), pixel.charge());
   }
 
   // split the precluster into clusters
-  split(*histMLEM, coef);
+  split(histMLEM, coef);
 }
 
 //_________________________________________________________________________________________________
@@ -1059,29 +1068,27 @@ double ClusterFinderOriginal::mlem(const std::vector<double>& coef, const std::v
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
+void ClusterFinderOriginal::findCOG(const PixelGrid<double>& histMLEM, double xy[2]) const
 {
   /// calculate the position of the center-of-gravity around the pixel with maximum charge
 
   // define the range of pixels and the minimum charge to consider
-  int ix0(0), iy0(0), iz0(0);
-  double chargeThreshold = histMLEM.GetBinContent(histMLEM.GetMaximumBin(ix0, iy0, iz0)) / 10.;
+  int ix0(0), iy0(0);
+  double chargeThreshold = histMLEM.maximumBin(ix0, iy0) / 10.;
   int ixMin = TMath::Max(1, ix0 - 1);
-  int ixMax = TMath::Min(histMLEM.GetNbinsX(), ix0 + 1);
+  int ixMax = TMath::Min(histMLEM.nBinsX(), ix0 + 1);
   int iyMin = TMath::Max(1, iy0 - 1);
-  int iyMax = TMath::Min(histMLEM.GetNbinsY(), iy0 + 1);
+  int iyMax = TMath::Min(histMLEM.nBinsY(), iy0 + 1);
 
   // first only consider pixels above threshold
-  const TAxis* xAxis = histMLEM.GetXaxis();
-  const TAxis* yAxis = histMLEM.GetYaxis();
   double xq(0.), yq(0.), q(0.);
   bool onePixelWidthX(true), onePixelWidthY(true);
   for (int iy = iyMin; iy <= iyMax; ++iy) {
     for (int ix = ixMin; ix <= ixMax; ++ix) {
-      double charge = histMLEM.GetBinContent(ix, iy);
+      double charge = histMLEM.content(ix, iy);
       if (charge >= chargeThreshold) {
-        xq += xAxis->GetBinCenter(ix) * charge;
-        yq += yAxis->GetBinCenter(iy) * charge;
+        xq += histMLEM.binCenterX(ix) * charge;
+        yq += histMLEM.binCenterY(iy) * charge;
         q += charge;
         if (ix != ix0) {
           onePixelWidthX = false;
@@ -1100,10 +1107,10 @@ void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
     for (int iy = iyMin; iy <= iyMax; ++iy) {
       if (iy != iy0) {
         for (int ix = ixMin; ix <= ixMax; ++ix) {
-          double charge = histMLEM.GetBinContent(ix, iy);
+          double charge = histMLEM.content(ix, iy);
           if (charge > chargePixel) {
-            xPixel = xAxis->GetBinCenter(ix);
-            yPixel = yAxis->GetBinCenter(iy);
+            xPixel = histMLEM.binCenterX(ix);
+            yPixel = histMLEM.binCenterY(iy);
             chargePixel = charge;
             ixPixel = ix;
           }
@@ -1124,10 +1131,10 @@ void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
     for (int ix = ixMin; ix <= ixMax; ++ix) {
       if (ix != ix0) {
         for (int iy = iyMin; iy <= iyMax; ++iy) {
-          double charge = histMLEM.GetBinContent(ix, iy);
+          double charge = histMLEM.content(ix, iy);
           if (charge > chargePixel) {
-            xPixel = xAxis->GetBinCenter(ix);
-            yPixel = yAxis->GetBinCenter(iy);
+            xPixel = histMLEM.binCenterX(ix);
+            yPixel = histMLEM.binCenterY(iy);
             chargePixel = charge;
           }
         }
@@ -1619,7 +1626,7 @@ double ClusterFinderOriginal::fit(double currentParam[SNFitParamMax + 2],
       }
       if (nFail > 10) {
         currentParam[iDerivMax] -= shift[iDerivMax];
-        shift[iDerivMax] = 4. * shiftSave * (gRandom->Rndm(0) - 0.5);
+        shift[iDerivMax] = 4. * shiftSave * ((mRandom ? mRandom.get() : gRandom)->Rndm(0) - 0.5);
         currentParam[iDerivMax] += shift[iDerivMax];
       }
     }
@@ -1695,7 +1702,7 @@ float ClusterFinderOriginal::chargeIntegration(double x, double y, const PadOrig
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double>& coef)
+void ClusterFinderOriginal::split(const PixelGrid<double>& histMLEM, const std::vector<double>& coef)
 {
   /// group the pixels in clusters then group together the clusters coupled to the same pads,
   /// split them into sub-groups if they are too many, merge them if they are not coupled to enough pads
@@ -1709,13 +1716,13 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
   }
 
   // find clusters of pixels
-  int nBinsX = histMLEM.GetNbinsX();
-  int nBinsY = histMLEM.GetNbinsY();
+  int nBinsX = histMLEM.nBinsX();
+  int nBinsY = histMLEM.nBinsY();
   std::vector<std::vector<int>> clustersOfPixels{};
   std::vector<std::vector<bool>> isUsed(nBinsX, std::vector<bool>(nBinsY, false));
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
-      if (!isUsed[i - 1][j - 1] && histMLEM.GetBinContent(i, j) >= mLowestPixelCharge) {
+      if (!isUsed[i - 1][j - 1] && histMLEM.content(i, j) >= mLowestPixelCharge) {
         // add a new cluster of pixels and the associated pixels recursively
         clustersOfPixels.emplace_back();
         addPixel(histMLEM, i, j, clustersOfPixels.back(), isUsed);
@@ -1761,10 +1768,8 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
   }
 
   // define the fit range
-  const TAxis* xAxis = histMLEM.GetXaxis();
-  const TAxis* yAxis = histMLEM.GetYaxis();
-  double fitRange[2][2] = {{xAxis->GetXmin() - xAxis->GetBinWidth(1), xAxis->GetXmax() + xAxis->GetBinWidth(1)},
-                           {yAxis->GetXmin() - yAxis->GetBinWidth(1), yAxis->GetXmax() + yAxis->GetBinWidth(1)}};
+  double fitRange[2][2] = {{histMLEM.xMin() - histMLEM.binWidthX(), histMLEM.xMax() + histMLEM.binWidthX()},
+                           {histMLEM.yMin() - histMLEM.binWidthY(), histMLEM.yMax() + histMLEM.binWidthY()}};
 
   std::vector<bool> isClUsed(clustersOfPixels.size(), false);
   std::vector<int> coupledClusters{};
@@ -1830,22 +1835,22 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::addPixel(const TH2D& histMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<std::vector<bool>>& isUsed)
+void ClusterFinderOriginal::addPixel(const PixelGrid<double>& histMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<std::vector<bool>>& isUsed)
 {
   /// add a pixel to the cluster of pixels then add recursively its neighbours,
   /// if their charge is higher than mLowestPixelCharge and excluding corners
 
-  auto itPixel = findPad(mPixels, histMLEM.GetXaxis()->GetBinCenter(i0), histMLEM.GetYaxis()->GetBinCenter(j0), mLowestPixelCharge);
+  auto itPixel = findPad(mPixels, histMLEM.binCenterX(i0), histMLEM.binCenterY(j0), mLowestPixelCharge);
   pixels.push_back(std::distance(mPixels.begin(), itPixel));
   isUsed[i0 - 1][j0 - 1] = true;
 
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histMLEM.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(histMLEM.nBinsX(), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histMLEM.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(histMLEM.nBinsY(), j0 + 1);
   for (int j = jMin; j <= jMax; ++j) {
     for (int i = iMin; i <= iMax; ++i) {
-      if (!isUsed[i - 1][j - 1] && (i == i0 || j == j0) && histMLEM.GetBinContent(i, j) >= mLowestPixelCharge) {
+      if (!isUsed[i - 1][j - 1] && (i == i0 || j == j0) && histMLEM.content(i, j) >= mLowestPixelCharge) {
         addPixel(histMLEM, i, j, pixels, isUsed);
       }
     }
@@ -0,0 +1,125 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PixelGrid.h
+/// \brief Definition of the 2D grid of pixels used by the original cluster finder algorithm
+
+#ifndef O2_MCH_PIXELGRID_H_
+#define O2_MCH_PIXELGRID_H_
+
+#include <limits>
+#include <vector>
+
+namespace o2
+{
+namespace mch
+{
+
+/// 2D grid of pixels with uniform binning, for internal use in place of a TH2.
+/// The bin numbering (from 1 to nBins, with the underflow and overflow bins),
+/// the binning and the search of the maximum follow the ROOT histograms
+/// so that the clustering results are unchanged. The memory is reused when
+/// the grid is reset, so that no allocation is needed for most preclusters.
+template <typename T>
+class PixelGrid
+{
+ public:
+  PixelGrid() = default;
+  ~PixelGrid() = default;
+
+  PixelGrid(const PixelGrid&) = delete;
+  PixelGrid& operator=(const PixelGrid&) = delete;
+  PixelGrid(PixelGrid&&) = default;
+  PixelGrid& operator=(PixelGrid&&) = default;
+
+  /// set the binning and clear the content
+  void reset(int nBinsX, double xMin, double xMax, int nBinsY, double yMin, double yMax)
+  {
+    mNBins[0] = (nBinsX > 0) ? nBinsX : 1;
+    mNBins[1] = (nBinsY > 0) ? nBinsY : 1;
+    mMin[0] = xMin;
+    mMax[0] = xMax;
+    mMin[1] = yMin;
+    mMax[1] = yMax;
+    mContent.assign((mNBins[0] + 2) * (mNBins[1] + 2), T(0));
+  }
+
+  /// return the number of bins in x (y)
+  int nBinsX() const { return mNBins[0]; }
+  int nBinsY() const { return mNBins[1]; }
+  /// return the lower and upper limits in x (y)
+  double xMin() const { return mMin[0]; }
+  double xMax() const { return mMax[0]; }
+  double yMin() const { return mMin[1]; }
+  double yMax() const { return mMax[1]; }
+  /// return the bin width in x (y)
+  double binWidthX() const { return binWidth(0); }
+  double binWidthY() const { return binWidth(1); }
+  /// return the center of bin i (j) in x (y)
+  double binCenterX(int i) const { return binCenter(0, i); }
+  double binCenterY(int j) const { return binCenter(1, j); }
+  /// return the bin containing x (y), 0 for underflow and nBins + 1 for overflow
+  int findBinX(double x) const { return findBin(0, x); }
+  int findBinY(double y) const { return findBin(1, y); }
+
+  /// return the content of bin (i,j)
+  T content(int i, int j) const { return mContent[index(i, j)]; }
+  /// set the content of bin (i,j)
+  void setContent(int i, int j, T value) { mContent[index(i, j)] = value; }
+  /// add the weight w to the bin containing (x,y)
+  void fill(double x, double y, T w) { mContent[index(findBinX(x), findBinY(y))] += w; }
+
+  /// return the maximum content, excluding underflow and overflow bins
+  T maximum() const
+  {
+    int i(0), j(0);
+    return maximumBin(i, j);
+  }
+  /// return the maximum content and the first bin (i,j) where it is reached, scanning x within y
+  T maximumBin(int& i0, int& j0) const
+  {
+    T max = std::numeric_limits<T>::lowest();
+    for (int j = 1; j <= mNBins[1]; ++j) {
+      for (int i = 1; i <= mNBins[0]; ++i) {
+        if (content(i, j) > max) {
+          max = content(i, j);
+          i0 = i;
+          j0 = j;
+        }
+      }
+    }
+    return max;
+  }
+
+ private:
+  double binWidth(int ixy) const { return (mMax[ixy] - mMin[ixy]) / mNBins[ixy]; }
+  double binCenter(int ixy, int bin) const { return mMin[ixy] + (bin - 1) * binWidth(ixy) + 0.5 * binWidth(ixy); }
+  int findBin(int ixy, double xy) const
+  {
+    if (xy < mMin[ixy]) {
+      return 0;
+    } else if (!(xy < mMax[ixy])) {
+      return mNBins[ixy] + 1;
+    }
+    return 1 + int(mNBins[ixy] * (xy - mMin[ixy]) / (mMax[ixy] - mMin[ixy]));
+  }
+  int index(int i, int j) const { return j * (mNBins[0] + 2) + i; }
+
+  int mNBins[2] = {1, 1};    ///< number of bins in x and y
+  double mMin[2] = {0., 0.}; ///< lower limits in x and y
+  double mMax[2] = {1., 1.}; ///< upper limits in x and y
+  std::vector<T> mContent{}; ///< content of the bins, including underflows and overflows
+};
+
+} // namespace mch
+} // namespace o2
+
+#endif // O2_MCH_PIXELGRID_H_
@@ -0,0 +1,204 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testPixelGrid.cxx
+/// \brief Test the pixel grid of the original cluster finder against the ROOT histograms it replaces
+
+#define BOOST_TEST_MODULE Test MCH PixelGrid
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <random>
+#include <utility>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <TH2D.h>
+#include <TH2I.h>
+#include "PixelGrid.h"
+
+using o2::mch::PixelGrid;
+
+namespace
+{
+
+/// binnings similar to the pixel grids of the cluster finder, with the
+/// limits of one precluster extended by half a pixel size on each side
+struct Binning {
+  int nBinsX;
+  double xMin;
+  double xMax;
+  int nBinsY;
+  double yMin;
+  double yMax;
+};
+
+const std::vector<Binning> binnings = {{1, -0.5, 0.5, 1, -0.5, 0.5},
+                                       {7, -12.3, -8.1, 4, 30.25, 31.75},
+                                       {25, 53.1, 68.6, 3, -2.5, 2.5},
+                                       {2, 1.e-3, 2.e-3, 40, -110., -30.}};
+
+template <typename T, typename H>
+void checkSameGrid(const PixelGrid<T>& grid, const H& hist)
+{
+  BOOST_REQUIRE_EQUAL(grid.nBinsX(), hist.GetNbinsX());
+  BOOST_REQUIRE_EQUAL(grid.nBinsY(), hist.GetNbinsY());
+  BOOST_CHECK_EQUAL(grid.xMin(), hist.GetXaxis()->GetXmin());
+  BOOST_CHECK_EQUAL(grid.xMax(), hist.GetXaxis()->GetXmax());
+  BOOST_CHECK_EQUAL(grid.yMin(), hist.GetYaxis()->GetXmin());
+  BOOST_CHECK_EQUAL(grid.yMax(), hist.GetYaxis()->GetXmax());
+  BOOST_CHECK_EQUAL(grid.binWidthX(), hist.GetXaxis()->GetBinWidth(1));
+  BOOST_CHECK_EQUAL(grid.binWidthY(), hist.GetYaxis()->GetBinWidth(1));
+  for (int i = 1; i <= grid.nBinsX(); ++i) {
+    BOOST_CHECK_EQUAL(grid.binCenterX(i), hist.GetXaxis()->GetBinCenter(i));
+  }
+  for (int j = 1; j <= grid.nBinsY(); ++j) {
+    BOOST_CHECK_EQUAL(grid.binCenterY(j), hist.GetYaxis()->GetBinCenter(j));
+  }
+  // contents, including underflow and overflow bins
+  for (int j = 0; j <= grid.nBinsY() + 1; ++j) {
+    for (int i = 0; i <= grid.nBinsX() + 1; ++i) {
+      BOOST_CHECK_EQUAL(grid.content(i, j), hist.GetBinContent(i, j));
+    }
+  }
+}
+
+template <typename T, typename H>
+void checkSameMaximum(const PixelGrid<T>& grid, const H& hist)
+{
+  int i(0), j(0), iHist(0), jHist(0), kHist(0);
+  auto max = grid.maximumBin(i, j);
+  hist.GetMaximumBin(iHist, jHist, kHist);
+  BOOST_CHECK_EQUAL(max, hist.GetMaximum());
+  BOOST_CHECK_EQUAL(grid.maximum(), hist.GetMaximum());
+  BOOST_CHECK_EQUAL(i, iHist);
+  BOOST_CHECK_EQUAL(j, jHist);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(PixelGridFindBin)
+{
+  TH1::AddDirectory(false);
+  std::mt19937 generator(123);
+  PixelGrid<double> grid;
+  for (const auto& b : binnings) {
+    grid.reset(b.nBinsX, b.xMin, b.xMax, b.nBinsY, b.yMin, b.yMax);
+    TH2D hist("hist", "", b.nBinsX, b.xMin, b.xMax, b.nBinsY, b.yMin, b.yMax);
+    checkSameGrid(grid, hist);
+
+    // positions outside, inside and exactly on the bin edges
+    std::uniform_real_distribution<double> xDist(b.xMin - (b.xMax - b.xMin), b.xMax + (b.xMax - b.xMin));
+    std::uniform_real_distribution<double> yDist(b.yMin - (b.yMax - b.yMin), b.yMax + (b.yMax - b.yMin));
+    std::vector<double> xs{b.xMin, b.xMax}, ys{b.yMin, b.yMax};
+    for (int i = 1; i <= b.nBinsX; ++i) {
+      xs.push_back(hist.GetXaxis()->GetBinLowEdge(i));
+    }
+    for (int j = 1; j <= b.nBinsY; ++j) {
+      ys.push_back(hist.GetYaxis()->GetBinLowEdge(j));
+    }
+    for (int n = 0; n < 1000; ++n) {
+      xs.push_back(xDist(generator));
+      ys.push_back(yDist(generator));
+    }
+    for (auto x : xs) {
+      BOOST_CHECK_EQUAL(grid.findBinX(x), hist.GetXaxis()->FindBin(x));
+    }
+    for (auto y : ys) {
+      BOOST_CHECK_EQUAL(grid.findBinY(y), hist.GetYaxis()->FindBin(y));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PixelGridFill)
+{
+  TH1::AddDirectory(false);
+  std::mt19937 generator(456);
+  PixelGrid<double> charges;
+  PixelGrid<int> entries;
+  // the grids are reused for all binnings, as in the cluster finder
+  for (const auto& b : binnings) {
+    charges.reset(b.nBinsX, b.xMin, b.xMax, b.nBinsY, b.yMin, b.yMax);
+    entries.reset(b.nBinsX, b.xMin, b.xMax, b.nBinsY, b.yMin, b.yMax);
+    TH2D hCharges("Charges", "", b.nBinsX, b.xMin, b.xMax, b.nBinsY, b.yMin, b.yMax);
+    TH2I hEntries("Entries", "", b.nBinsX, b.xMin, b.xMax, b.nBinsY, b.yMin, b.yMax);
+
+    std::uniform_real_distribution<double> xDist(b.xMin - 0.1 * (b.xMax - b.xMin), b.xMax + 0.1 * (b.xMax - b.xMin));
+    std::uniform_real_distribution<double> yDist(b.yMin - 0.1 * (b.yMax - b.yMin), b.yMax + 0.1 * (b.yMax - b.yMin));
+    std::uniform_real_distribution<double> chargeDist(0., 100.);
+    for (int n = 0; n < 500; ++n) {
+      double x = xDist(generator), y = yDist(generator), q = chargeDist(generator);
+      charges.fill(x, y, q);
+      hCharges.Fill(x, y, q);
+      entries.fill(x, y, 1);
+      hEntries.Fill(x, y, 1);
+    }
+    checkSameGrid(charges, hCharges);
+    checkSameGrid(entries, hEntries);
+    checkSameMaximum(charges, hCharges);
+    checkSameMaximum(entries, hEntries);
+
+    // overwrite some bins
+    charges.setContent(1, 1, 12.5);
+    hCharges.SetBinContent(1, 1, 12.5);
+    charges.setContent(b.nBinsX, b.nBinsY, 0.);
+    hCharges.SetBinContent(b.nBinsX, b.nBinsY, 0.);
+    checkSameGrid(charges, hCharges);
+    checkSameMaximum(charges, hCharges);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PixelGridMaximum)
+{
+  TH1::AddDirectory(false);
+  PixelGrid<double> grid;
+  grid.reset(4, 0., 4., 3, 0., 3.);
+  TH2D hist("hist", "", 4, 0., 4., 3, 0., 3.);
+
+  // the first bin reached when scanning x within y is the maximum bin in case of ties
+  for (auto [i, j] : {std::pair{3, 1}, std::pair{2, 2}, std::pair{1, 3}}) {
+    grid.setContent(i, j, 5.);
+    hist.SetBinContent(i, j, 5.);
+  }
+  // underflow and overflow bins are ignored
+  grid.setContent(0, 1, 10.);
+  hist.SetBinContent(0, 1, 10.);
+  grid.setContent(5, 4, 10.);
+  hist.SetBinContent(5, 4, 10.);
+  checkSameMaximum(grid, hist);
+
+  // all bins negative
+  grid.reset(2, 0., 2., 2, 0., 2.);
+  TH2D hNeg("hNeg", "", 2, 0., 2., 2, 0., 2.);
+  for (int j = 1; j <= 2; ++j) {
+    for (int i = 1; i <= 2; ++i) {
+      grid.setContent(i, j, -1. * (i + j));
+      hNeg.SetBinContent(i, j, -1. * (i + j));
+    }
+  }
+  checkSameMaximum(grid, hNeg);
+}
+
+BOOST_AUTO_TEST_CASE(PixelGridReset)
+{
+  PixelGrid<double> grid;
+  grid.reset(3, 0., 3., 3, 0., 3.);
+  grid.fill(1.5, 1.5, 4.);
+  grid.reset(2, 0., 1., 5, 0., 1.);
+  for (int j = 0; j <= 6; ++j) {
+    for (int i = 0; i <= 3; ++i) {
+      BOOST_CHECK_EQUAL(grid.content(i, j), 0.);
+    }
+  }
+  // a binning without bins has one bin, as in ROOT
+  grid.reset(0, 0., 1., -2, 0., 1.);
+  BOOST_CHECK_EQUAL(grid.nBinsX(), 1);
+  BOOST_CHECK_EQUAL(grid.nBinsY(), 1);
+}
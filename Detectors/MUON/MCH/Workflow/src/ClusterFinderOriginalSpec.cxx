@@ -19,12 +19,18 @@
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <exception>
+#include <memory>
 #include <vector>
 #include <stdexcept>
 #include <string>
 
 #include <gsl/span>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 #include "Framework/CallbackService.h"
 #include "Framework/ConfigParamRegistry.h"
 #include "Framework/ControlService.h"
@@ -67,10 +73,29 @@ class ClusterFinderOriginalTask
 
     mAttachInitalPrecluster = ic.options().get<bool>("attach-initial-precluster");
 
+    mNThreads = ic.options().get<int>("nthreads");
+#ifndef WITH_OPENMP
+    if (mNThreads > 1) {
+      LOG(warning) << "Multithreading is not supported, imposing single thread";
+      mNThreads = 1;
+    }
+#endif
+    if (mNThreads > 1) {
+      // one cluster finder per thread
+      LOG(info) << "clusterizing the preclusters with " << mNThreads << " threads";
+      for (int i = 0; i < mNThreads; ++i) {
+        mClusterFinders.emplace_back(std::make_unique<ClusterFinderOriginal>());
+        mClusterFinders.back()->init(run2Config);
+      }
+    }
+
     /// Print the timer and clear the clusterizer when the processing is over
     ic.services().get<CallbackService>().set(CallbackService::Id::Stop, [this]() {
       LOG(info) << "cluster finder duration = " << mTimeClusterFinder.count() << " s";
       this->mClusterFinder.deinit();
+      for (auto& clusterFinder : this->mClusterFinders) {
+        clusterFinder->deinit();
+      }
     });
   }
 
@@ -94,6 +119,18 @@ class ClusterFinderOriginalTask
 
       // prepare to clusterize the current ROF
       auto clusterOffset = clusters.size();
+
+      if (mNThreads > 1) {
+        // clusterize the preclusters of the current ROF in parallel
+        auto tStart = std::chrono::high_resolution_clock::now();
+        findClustersParallel(preClusters, preClusterROF.getFirstIdx(), preClusterROF.getNEntries(), digits, clusters, usedDigits);
+        auto tEnd = std::chrono::high_resolution_clock::now();
+        mTimeClusterFinder += tEnd - tStart;
+        clusterROFs.emplace_back(preClusterROF.getBCData(), clusterOffset, clusters.size() - clusterOffset,
+                                 preClusterROF.getBCWidth());
+        continue;
+      }
+
       mClusterFinder.reset();
 
       for (const auto& preCluster : preClusters.subspan(preClusterROF.getFirstIdx(), preClusterROF.getNEntries())) {
@@ -128,6 +165,86 @@ class ClusterFinderOriginalTask
   }
 
  private:
+  //_________________________________________________________________________________________________
+  void findClustersParallel(gsl::span<const PreCluster> preClusters, int firstPreCluster, int nPreClusters,
+                            gsl::span<const Digit> digits,
+                            std::vector<Cluster, o2::pmr::polymorphic_allocator<Cluster>>& clusters,
+                            std::vector<Digit, o2::pmr::polymorphic_allocator<Digit>>& usedDigits)
+  {
+    /// clusterize the preclusters of one ROF in parallel, each thread using its own cluster finder
+    /// the results are stored per precluster then written in the order of the preclusters, so that
+    /// the clusters and attached digits are the same as with the sequential processing, except
+    /// that the random generator of the finder is reseeded for each precluster to be reproducible
+
+    if (mClustersPerPreCluster.size() < static_cast<size_t>(nPreClusters)) {
+      mClustersPerPreCluster.resize(nPreClusters);
+      mDigitsPerPreCluster.resize(nPreClusters);
+    }
+
+    // an exception cannot leave the parallel region: keep the one of the first failing precluster,
+    // as with the sequential processing, and rethrow it once all the threads are done
+    std::exception_ptr exception = nullptr;
+    int failedPreCluster = nPreClusters;
+
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+    for (int iPreCluster = 0; iPreCluster < nPreClusters; ++iPreCluster) {
+      int iThread = 0;
+#ifdef WITH_OPENMP
+      iThread = omp_get_thread_num();
+#endif
+      auto& clusterFinder = *mClusterFinders[iThread];
+      const auto& preCluster = preClusters[firstPreCluster + iPreCluster];
+      try {
+        clusterFinder.reset();
+        clusterFinder.setRandomSeed(firstPreCluster + iPreCluster + 1);
+        clusterFinder.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
+        mClustersPerPreCluster[iPreCluster].assign(clusterFinder.getClusters().begin(), clusterFinder.getClusters().end());
+        mDigitsPerPreCluster[iPreCluster].assign(clusterFinder.getUsedDigits().begin(), clusterFinder.getUsedDigits().end());
+      } catch (...) {
+#ifdef WITH_OPENMP
+#pragma omp critical(mch_clustering_exception)
+#endif
+        if (iPreCluster < failedPreCluster) {
+          failedPreCluster = iPreCluster;
+          exception = std::current_exception();
+        }
+      }
+    }
+
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+
+    // write the clusters, numbered within the ROF, and their digits
+    int clusterIdx = 0;
+    for (int iPreCluster = 0; iPreCluster < nPreClusters; ++iPreCluster) {
+      const auto& preCluster = preClusters[firstPreCluster + iPreCluster];
+      const auto& newClusters = mClustersPerPreCluster[iPreCluster];
+      if (newClusters.empty()) {
+        continue;
+      }
+      auto digitOffset = usedDigits.size();
+      for (auto cluster : newClusters) {
+        cluster.uid = Cluster::buildUniqueId(cluster.getChamberId(), cluster.getDEId(), clusterIdx++);
+        if (mAttachInitalPrecluster) {
+          cluster.firstDigit = digitOffset;
+          cluster.nDigits = preCluster.nDigits;
+        } else {
+          cluster.firstDigit += digitOffset;
+        }
+        clusters.emplace_back(cluster);
+      }
+      if (mAttachInitalPrecluster) {
+        auto preclusterDigits = digits.subspan(preCluster.firstDigit, preCluster.nDigits);
+        usedDigits.insert(usedDigits.end(), preclusterDigits.begin(), preclusterDigits.end());
+      } else {
+        usedDigits.insert(usedDigits.end(), mDigitsPerPreCluster[iPreCluster].begin(), mDigitsPerPreCluster[iPreCluster].end());
+      }
+    }
+  }
+
   //_________________________________________________________________________________________________
   void writeClusters(const gsl::span<const Digit>& preclusterDigits, size_t firstClusterIdx,
                      std::vector<Cluster, o2::pmr::polymorphic_allocator<Cluster>>& clusters,
@@ -173,6 +290,11 @@ class ClusterFinderOriginalTask
   bool mAttachInitalPrecluster = false;               ///< attach all digits of initial precluster to cluster
   ClusterFinderOriginal mClusterFinder{};             ///< clusterizer
   std::chrono::duration<double> mTimeClusterFinder{}; ///< timer
+
+  int mNThreads = 1;                                                     ///< number of threads
+  std::vector<std::unique_ptr<ClusterFinderOriginal>> mClusterFinders{}; ///< clusterizers of the threads
+  std::vector<std::vector<Cluster>> mClustersPerPreCluster{};            ///< clusters found in each precluster of the ROF
+  std::vector<std::vector<Digit>> mDigitsPerPreCluster{};                ///< digits used in each precluster of the ROF
 };
 
 //_________________________________________________________________________________________________
@@ -189,7 +311,8 @@ o2::framework::DataProcessorSpec getClusterFinderOriginalSpec(const char* specNa
     AlgorithmSpec{adaptFromTask<ClusterFinderOriginalTask>()},
     Options{{"mch-config", VariantType::String, "", {"JSON or INI file with clustering parameters"}},
             {"run2-config", VariantType::Bool, false, {"setup for run2 data"}},
-            {"attach-initial-precluster", VariantType::Bool, false, {"attach all digits of initial precluster to cluster"}}}};
+            {"attach-initial-precluster", VariantType::Bool, false, {"attach all digits of initial precluster to cluster"}},
+            {"nthreads", VariantType::Int, 1, {"number of threads used to clusterize the preclusters in parallel"}}}};
 }
 
 } // end namespace mch
@@ -204,14 +204,16 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
   ec->setHeader(CTFHeader{o2::detectors::DetID::TPC, 0, 1, 0, // dummy timestamp, version 1.0
                           ccl, flags});
   assignDictVersion(static_cast<o2::ctf::CTFDictHeader&>(ec->getHeader()));
-  ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->getANSHeader().majorVersion = 1;
+  ec->getANSHeader().minorVersion = 0;
 
-  o2::ctf::CTFIOSize iosize;
-  auto encodeTPC = [&buff, &optField, &coders = mCoders, mfc = this->getMemMarginFactor(), &iosize](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
-    // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
+  // the blocks are encoded concurrently to standalone images which are then stored to the buffer
+  std::array<std::function<CTF::preparedBlock_t()>, CTF::getNBlocks()> tasks;
+  auto encodeTPC = [&tasks, ansHeader = ec->getANSHeader(), &optField, &coders = mCoders, mfc = this->getMemMarginFactor()](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
     const auto slotVal = static_cast<int>(slot);
-    iosize += CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal].get(), mfc);
+    tasks[slotVal] = [begin, end, slotVal, probabilityBits, ansHeader, &optField, &coders, mfc]() {
+      return CTF::prepareBlock(begin, end, ansHeader, probabilityBits, optField[slotVal], coders[slotVal].get(), mfc);
+    };
   };
 
   if (mCombineColumns) {
@@ -276,6 +278,7 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
 
   encodeTPC(ccl.nTrackClusters, ccl.nTrackClusters + ccl.nTracks, CTF::BLCnTrackClusters, 0);
   encodeTPC(ccl.nSliceRowClusters, ccl.nSliceRowClusters + ccl.nSliceRows, CTF::BLCnSliceRowClusters, 0);
+  o2::ctf::CTFIOSize iosize = encodeBlocks<CTF>(buff, tasks);
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = iosize.ctfIn;
@@ -306,10 +309,10 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
   ec.print(getPrefix(), mVerbosity);
 
   // decode encoded data directly to destination buff
-  o2::ctf::CTFIOSize iosize;
-  auto decodeTPC = [&ec, &coders = mCoders, &iosize](auto begin, CTF::Slots slot) {
+  std::array<std::function<o2::ctf::CTFIOSize()>, CTF::getNBlocks()> tasks;
+  auto decodeTPC = [&ec, &coders = mCoders, &tasks](auto begin, CTF::Slots slot) {
     const auto slotVal = static_cast<int>(slot);
-    iosize += ec.decode(begin, slotVal, coders[slotVal].get());
+    tasks[slotVal] = [&ec, &coders, begin, slotVal]() { return ec.decode(begin, slotVal, coders[slotVal].get()); };
   };
 
   if (mCombineColumns) {
@@ -364,6 +367,7 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
 
   decodeTPC(cc.nTrackClusters, CTF::BLCnTrackClusters);
   decodeTPC(cc.nSliceRowClusters, CTF::BLCnSliceRowClusters);
+  o2::ctf::CTFIOSize iosize = decodeBlocks<CTF>(tasks);
   iosize.rawIn = iosize.ctfIn;
   return iosize;
 }
@@ -18,6 +18,8 @@
 
 #include <deque>
 #include <algorithm>
+#include <memory>
+#include <vector>
 #include "TPCBase/CRU.h"
 #include "DataFormatsTPC/Defs.h"
 #include "TPCSimulation/DigitTime.h"
@@ -37,6 +39,7 @@ class Digit;
 /// sorted into after amplification
 /// The structure assures proper sorting of the Digits when later on written out for further processing.
 /// This class holds the time bin containers.
+/// The time bin containers are owned by a pool and recycled once written out.
 
 class DigitContainer
 {
@@ -80,12 +83,21 @@ class DigitContainer
   size_t size() const { return mTimeBins.size(); }
 
  private:
+  /// Get a time bin container from the pool
+  DigitTime* getTimeBin();
+
+  /// Return a time bin container to the pool
+  void releaseTimeBin(DigitTime* time);
+
   TimeBin mFirstTimeBin = 0;                                  ///< First time bin to consider
   TimeBin mEffectiveTimeBin = 0;                              ///< Effective time bin of that digit
   TimeBin mTmaxTriggered = 0;                                 ///< Maximum time bin in case of triggered mode (hard cut at average drift speed with additional margin)
   TimeBin mOffset;                                            ///< Size of the container for one event
   std::deque<DigitTime*> mTimeBins;                           ///< Time bin Container for the ADC value
+  std::vector<std::unique_ptr<DigitTime>> mTimeBinStore;     ///< Pool of all the time bin containers
+  std::vector<DigitTime*> mFreeTimeBins;                      ///< Time bin containers of the pool not in use
   std::unique_ptr<DigitTime::PrevDigitInfoArray> mPrevDigArr; ///< Keep track of ToT and ion tail cumul from last time bin
+  DigitTime::PadList mPrevDigPads;                            ///< Pads with ToT or ion tail cumul from last time bin
   o2::utils::DebugStreamer mStreamer;                         ///< Debug streamer
 };
 
@@ -107,12 +119,30 @@ inline void DigitContainer::reset()
   mEffectiveTimeBin = 0;
   for (auto& time : mTimeBins) {
     if (time) {
-      time->reset();
+      releaseTimeBin(time);
+      time = nullptr;
     }
   }
   if (mPrevDigArr) {
     std::fill(mPrevDigArr->begin(), mPrevDigArr->end(), PrevDigitInfo{});
   }
+  mPrevDigPads.clear();
+}
+
+inline DigitTime* DigitContainer::getTimeBin()
+{
+  if (mFreeTimeBins.empty()) {
+    return mTimeBinStore.emplace_back(std::make_unique<DigitTime>()).get();
+  }
+  auto time = mFreeTimeBins.back();
+  mFreeTimeBins.pop_back();
+  return time;
+}
+
+inline void DigitContainer::releaseTimeBin(DigitTime* time)
+{
+  time->reset();
+  mFreeTimeBins.emplace_back(time);
 }
 
 inline void DigitContainer::reserve(TimeBin eventTimeBin)
@@ -128,7 +158,7 @@ inline void DigitContainer::addDigit(const MCCompLabel& label, const CRU& cru, T
 {
   mEffectiveTimeBin = timeBin - mFirstTimeBin;
   if (mTimeBins[mEffectiveTimeBin] == nullptr) {
-    mTimeBins[mEffectiveTimeBin] = new DigitTime();
+    mTimeBins[mEffectiveTimeBin] = getTimeBin();
   }
 
   mTimeBins[mEffectiveTimeBin]->addDigit(label, cru, globalPad, signal);
@@ -16,6 +16,10 @@
 #ifndef ALICEO2_TPC_DigitTime_H_
 #define ALICEO2_TPC_DigitTime_H_
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
 #include "TPCBase/Mapper.h"
 #include "TPCSimulation/DigitGlobalPad.h"
 #include "SimulationDataFormat/LabelContainer.h"
@@ -32,12 +36,16 @@ class Digit;
 /// sorted into after amplification
 /// The structure assures proper sorting of the Digits when later on written out for further processing.
 /// This class holds the individual Pad Row containers and is contained within the CRU Container.
+/// Only the pads with signal are stored, in the order of their first signal, together with their pad numbers.
+/// A per-pad index locates them. The output is still filled in increasing pad number. The container keeps
+/// its memory when reset, so that it can be reused for another time bin.
 
 class DigitTime
 {
  public:
   using Streamer = o2::utils::DebugStreamer;
   using PrevDigitInfoArray = std::array<PrevDigitInfo, Mapper::getPadsInSector()>;
+  using PadList = std::vector<GlobalPadNumber>;
 
   /// Constructor
   DigitTime();
@@ -48,6 +56,9 @@ class DigitTime
   /// Resets the container
   void reset();
 
+  /// Get the number of pads with signal
+  size_t getNumberOfPads() const { return mOccupiedPads.size(); }
+
   /// Get common mode for a given GEM stack
   /// \param gemstack GEM stack of the digit
   /// \return Common mode value in that time bin for a given GEM ROC
@@ -74,33 +85,50 @@ class DigitTime
   /// \param timeBin Time bin
   /// \param commonMode Common mode value of that specific ROC
   /// \param prevTime Previous time bin to calculate CM and ToT
+  /// \param prevPads Pads with ion tail or ToT from the previous time bin, in increasing order, updated for this time bin.
+  ///                 If not given together with prevTime all pads are processed
   template <DigitzationMode MODE>
   void fillOutputContainer(std::vector<Digit>& output, dataformats::MCTruthContainer<MCCompLabel>& mcTruth,
-                           std::vector<CommonMode>& commonModeOutput, const Sector& sector, TimeBin timeBin, PrevDigitInfoArray* prevTime = nullptr, Streamer* debugStream = nullptr);
+                           std::vector<CommonMode>& commonModeOutput, const Sector& sector, TimeBin timeBin, PrevDigitInfoArray* prevTime = nullptr,
+                           PadList* prevPads = nullptr, Streamer* debugStream = nullptr);
 
  private:
-  std::array<float, GEMSTACKSPERSECTOR> mCommonMode;                 ///< Common mode container - 4 GEM ROCs per sector
-  std::array<DigitGlobalPad, Mapper::getPadsInSector()> mGlobalPads; ///< Pad Container for the ADC value
-  int mDigitCounter = 0;                                             ///< counts the number of digits in this timebin
+  static constexpr unsigned short EmptyPad = std::numeric_limits<unsigned short>::max();
+  static_assert(Mapper::getPadsInSector() < EmptyPad, "pad index does not fit");
+
+  /// Get the pad container of a given pad, create it if the pad has no signal yet
+  DigitGlobalPad& getPad(GlobalPadNumber globalPad);
+
+  std::array<float, GEMSTACKSPERSECTOR> mCommonMode;                  ///< Common mode container - 4 GEM ROCs per sector
+  std::array<unsigned short, Mapper::getPadsInSector()> mPadIndex;    ///< Index of each pad in mGlobalPads, EmptyPad if no signal
+  std::vector<DigitGlobalPad> mGlobalPads;                            ///< Pad Container for the ADC value of the pads with signal
+  PadList mOccupiedPads;                                              ///< Pad number of the entries in mGlobalPads
+  PadList mPadsToProcess;                                             ///< Workspace with the pads to process in fillOutputContainer
 
   o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false> mLabels;
-  // std::deque<int> mOccupiedPads; // iterable container of occupied pads
 };
 
-inline DigitTime::DigitTime() : mCommonMode(), mGlobalPads()
+inline DigitTime::DigitTime() : mCommonMode(), mPadIndex()
 {
   mCommonMode.fill(0.f);
-  mLabels.reserve(Mapper::getPadsInSector() / 3);
+  mPadIndex.fill(EmptyPad);
 }
 
-inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal)
+inline DigitGlobalPad& DigitTime::getPad(GlobalPadNumber globalPad)
 {
-  auto& paddigit = mGlobalPads[globalPad];
-  if (paddigit.getID() == -1) {
-    // this means we have a new digit
-    paddigit.setID(mDigitCounter++);
-    // could also register this pad in a vector of digits
+  auto& index = mPadIndex[globalPad];
+  if (index == EmptyPad) {
+    // this means we have a new digit, its ID in the labels is its index
+    index = mGlobalPads.size();
+    mGlobalPads.emplace_back().setID(index);
+    mOccupiedPads.emplace_back(globalPad);
   }
+  return mGlobalPads[index];
+}
+
+inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal)
+{
+  auto& paddigit = getPad(globalPad);
 
   // previous digit for CM and ToT calculation
   paddigit.addDigit(label, signal, mLabels);
@@ -109,9 +137,12 @@ inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, Global
 
 inline void DigitTime::reset()
 {
-  for (auto& pad : mGlobalPads) {
-    pad.reset();
+  for (auto pad : mOccupiedPads) {
+    mPadIndex[pad] = EmptyPad;
   }
+  mGlobalPads.clear();
+  mOccupiedPads.clear();
+  mLabels.clear();
   mCommonMode.fill(0.f);
 }
 
@@ -126,21 +157,41 @@ inline float DigitTime::getCommonMode(const GEMstack& gemstack) const
 template <DigitzationMode MODE>
 inline void DigitTime::fillOutputContainer(std::vector<Digit>& output, dataformats::MCTruthContainer<MCCompLabel>& mcTruth,
                                            std::vector<CommonMode>& commonModeOutput, const Sector& sector, TimeBin timeBin,
-                                           PrevDigitInfoArray* prevTime, Streamer* debugStream)
+                                           PrevDigitInfoArray* prevTime, PadList* prevPads, Streamer* debugStream)
 {
   const auto& mapper = Mapper::instance();
   const auto& eleParam = ParameterElectronics::Instance();
 
+  // the other pads have no charge and do not change the previous digit info nor the common mode
+  mPadsToProcess.clear();
+  if (eleParam.doNoiseEmptyPads || (prevTime && !prevPads)) {
+    mPadsToProcess.resize(Mapper::getPadsInSector());
+    std::iota(mPadsToProcess.begin(), mPadsToProcess.end(), 0);
+  } else {
+    mPadsToProcess.insert(mPadsToProcess.end(), mOccupiedPads.begin(), mOccupiedPads.end());
+    if (prevTime) {
+      mPadsToProcess.insert(mPadsToProcess.end(), prevPads->begin(), prevPads->end());
+    }
+    std::sort(mPadsToProcess.begin(), mPadsToProcess.end());
+    mPadsToProcess.erase(std::unique(mPadsToProcess.begin(), mPadsToProcess.end()), mPadsToProcess.end());
+  }
+  if (prevPads) {
+    prevPads->clear();
+  }
+
   // at this point we only have the pure signals from tracks
   // loop over all pads to calculated ion tail, common mode and ToT for saturated signals
-  for (size_t iPad = 0; iPad < mGlobalPads.size(); ++iPad) {
-    auto& digit = mGlobalPads[iPad];
+  for (const auto iPad : mPadsToProcess) {
+    auto& digit = getPad(iPad);
     if (prevTime) {
       auto& prevDigit = (*prevTime)[iPad];
       if (prevDigit.hasSignal()) {
         digit.foldSignal(prevDigit, sector.getSector(), iPad, timeBin, debugStream);
       }
       prevDigit.signal = digit.getChargePad(); // to make hasSignal() check work in next time bin
+      if (prevPads && prevDigit.hasSignal()) {
+        prevPads->emplace_back(iPad);
+      }
     }
     const CRU cru = mapper.getCRU(sector, iPad);
     mCommonMode[cru.gemStack()] += digit.getChargePad() * 0.5; // TODO: Replace 0.5 by k-factor, take into account ion tail
@@ -154,8 +205,8 @@ inline void DigitTime::fillOutputContainer(std::vector<Digit>& output, dataforma
     }
   }
 
-  for (size_t iPad = 0; iPad < mGlobalPads.size(); ++iPad) {
-    auto& digit = mGlobalPads[iPad];
+  for (const auto iPad : mPadsToProcess) {
+    auto& digit = mGlobalPads[mPadIndex[iPad]];
     if (eleParam.doNoiseEmptyPads || (digit.getChargePad() > 0.f)) {
       PrevDigitInfo prevDigit;
       if (prevTime) {
@@ -58,7 +58,7 @@ void DigitContainer::fillOutputContainer(std::vector<Digit>& output,
 
     // fill also time bins without signal to get noise, ion tail and saturated signals
     if (needsEmptyTimeBins && !time) {
-      time = new DigitTime;
+      time = getTimeBin();
     }
 
     // fmt::print("Processing secotor: {}, time bin: {}, mFirstTimeBin: {}, dgitTime: {}\n", sector.getSector(), timeBin, mFirstTimeBin, (void*)time);
@@ -66,23 +66,23 @@ void DigitContainer::fillOutputContainer(std::vector<Digit>& output,
     if (time) {
       switch (digitizationMode) {
         case DigitzationMode::FullMode: {
-          time->fillOutputContainer<DigitzationMode::FullMode>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), debugStream);
+          time->fillOutputContainer<DigitzationMode::FullMode>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), mPrevDigArr ? &mPrevDigPads : nullptr, debugStream);
           break;
         }
         case DigitzationMode::ZeroSuppression: {
-          time->fillOutputContainer<DigitzationMode::ZeroSuppression>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), debugStream);
+          time->fillOutputContainer<DigitzationMode::ZeroSuppression>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), mPrevDigArr ? &mPrevDigPads : nullptr, debugStream);
           break;
         }
         case DigitzationMode::SubtractPedestal: {
-          time->fillOutputContainer<DigitzationMode::SubtractPedestal>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), debugStream);
+          time->fillOutputContainer<DigitzationMode::SubtractPedestal>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), mPrevDigArr ? &mPrevDigPads : nullptr, debugStream);
           break;
         }
         case DigitzationMode::NoSaturation: {
-          time->fillOutputContainer<DigitzationMode::NoSaturation>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), debugStream);
+          time->fillOutputContainer<DigitzationMode::NoSaturation>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), mPrevDigArr ? &mPrevDigPads : nullptr, debugStream);
           break;
         }
         case DigitzationMode::PropagateADC: {
-          time->fillOutputContainer<DigitzationMode::PropagateADC>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), debugStream);
+          time->fillOutputContainer<DigitzationMode::PropagateADC>(output, mcTruth, commonModeOutput, sector, timeBin, mPrevDigArr.get(), mPrevDigArr ? &mPrevDigPads : nullptr, debugStream);
           break;
         }
       }
@@ -97,7 +97,9 @@ void DigitContainer::fillOutputContainer(std::vector<Digit>& output,
     while (nProcessedTimeBins--) {
       auto popped = mTimeBins.front();
       mTimeBins.pop_front();
-      delete popped;
+      if (popped) {
+        releaseTimeBin(popped);
+      }
     }
   }
 }
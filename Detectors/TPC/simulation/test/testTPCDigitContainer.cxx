@@ -167,5 +167,60 @@ BOOST_AUTO_TEST_CASE(DigitContainer_test2)
     BOOST_CHECK_CLOSE(commonMode[i].getCommonMode(), chargeSum[i] / nPads, 1E-6);
   }
 }
+
+/// \brief Test of the DigitContainer
+/// The time bins written out in continuous mode are reused for the following ones,
+/// we check that no digits or MC labels of the previous time bins are left in them
+BOOST_AUTO_TEST_CASE(DigitContainer_test3)
+{
+  auto& cdb = CDBInterface::instance();
+  cdb.setUseDefaults();
+  o2::conf::ConfigurableParam::updateFromString(fmt::format("TPCEleParam.DigiMode={}", (int)o2::tpc::DigitzationMode::PropagateADC)); // propagate the ADC values, otherwise the computation get complicated
+  const Mapper& mapper = Mapper::instance();
+  DigitContainer digitContainer;
+  digitContainer.reset();
+  dataformats::MCTruthContainer<MCCompLabel> mMCTruthArray;
+
+  const CRU cru(0);
+  const GlobalPadNumber padFirst = mapper.getPadNumberInROC(PadROCPos(cru.roc(), PadPos(12, 1)));
+  const GlobalPadNumber padSecond = mapper.getPadNumberInROC(PadROCPos(cru.roc(), PadPos(5, 15)));
+  const std::vector<int> TimeFirst = {0, 1, 2};
+  const std::vector<int> TimeSecond = {5, 6};
+
+  for (const auto time : TimeFirst) {
+    digitContainer.addDigit(MCCompLabel(22, 1, 0, false), cru, time, padFirst, 60);
+  }
+
+  // write out the time bins before the next event
+  std::vector<Digit> mDigitsArray;
+  std::vector<o2::tpc::CommonMode> commonMode;
+  digitContainer.fillOutputContainer(mDigitsArray, mMCTruthArray, commonMode, 0, TimeFirst.size(), true, false);
+  BOOST_CHECK(mDigitsArray.size() == TimeFirst.size());
+
+  for (const auto time : TimeSecond) {
+    digitContainer.addDigit(MCCompLabel(3, 62, 0, false), cru, time, padSecond, 100);
+  }
+
+  mDigitsArray.clear();
+  commonMode.clear();
+  mMCTruthArray.clear();
+  digitContainer.fillOutputContainer(mDigitsArray, mMCTruthArray, commonMode, 0, 0, true, true);
+
+  BOOST_CHECK(mDigitsArray.size() == TimeSecond.size());
+
+  int digits = 0;
+  for (const auto& digit : mDigitsArray) {
+    const auto& mcArray = mMCTruthArray.getLabels(digits);
+    BOOST_CHECK(mcArray.size() == 1);
+    for (const auto& label : mcArray) {
+      BOOST_CHECK(label.getTrackID() == 3);
+      BOOST_CHECK(label.getEventID() == 62);
+    }
+    BOOST_CHECK(digit.getTimeStamp() == TimeSecond[digits]);
+    BOOST_CHECK(digit.getRow() == 5);
+    BOOST_CHECK(digit.getPad() == 15);
+    ++digits;
+  }
+}
 } // namespace tpc
 } // namespace o2
@@ -100,7 +100,8 @@ class PoissonSolver
   const RegularGrid& mGrid3D{};                                      ///< grid properties
   inline static DataT sConvergenceError{1e-6};                       ///< Error tolerated
   static constexpr DataT INVTWOPI = 1. / o2::constants::math::TwoPI; ///< inverse of 2*pi
-  inline static int sNThreads{4};                                    ///< number of threads which are used during some of the calculations (increasing this number has no big impact)
+  inline static int sNThreads{4};                                    ///< number of threads which are used during the calculations
+  static constexpr int ZBLOCKSIZE = 16;                              ///< number of z rows of one phi slice relaxed in one go in relax3D
 
   /// Relative error calculation: comparison with exact solution
   ///
@@ -235,6 +236,8 @@ class PoissonSolver
   /// \param coefficient2 coefficients for \f$  V_{x-1,y,z} \f$
   /// \param coefficient3 coefficients for z
   /// \param coefficient4 coefficients for f(r,\phi,z)
+  ///
+  /// The red-black Gauss-Seidel relaxation is parallelised over the phi slices and gives the same result for any number of threads
   void relax3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2, const DataT tempRatioZ,
                const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const;
 
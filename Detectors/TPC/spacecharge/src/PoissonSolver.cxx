@@ -22,6 +22,7 @@
 #include "TPCSpaceCharge/PoissonSolverHelpers.h"
 #include "Framework/Logger.h"
 #include <numeric>
+#include <algorithm>
 #include <fmt/core.h>
 #include "TPCSpaceCharge/Vector3D.h"
 #include "TPCSpaceCharge/DataContainer3D.h"
@@ -934,7 +935,7 @@ template <typename DataT>
 void PoissonSolver<DataT>::residue3D(Vector& residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int tnPhi, const int symmetry,
                                      const DataT ih2, const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& inverseCoefficient4) const
 {
-#pragma omp parallel for num_threads(sNThreads) // parallising this loop is possible - but using more than 2 cores makes it slower -
+#pragma omp parallel for num_threads(sNThreads) schedule(static)
   for (int m = 0; m < tnPhi; ++m) {
     int mp1 = m + 1;
     int signPlus = 1;
@@ -984,6 +985,8 @@ void PoissonSolver<DataT>::interp3D(Vector& matricesCurrentV, const Vector& matr
 {
   // Do restrict 2 D for each slice
   if (newPhiSlice == 2 * oldPhiSlice) {
+    // each iteration writes only the phi slices m and m + 1
+#pragma omp parallel for num_threads(sNThreads)
     for (int m = 0; m < newPhiSlice; m += 2) {
       // assuming no symmetry
       int mm = m / 2;
@@ -1092,6 +1095,8 @@ void PoissonSolver<DataT>::addInterp3D(Vector& matricesCurrentV, const Vector& m
 {
   // Do restrict 2 D for each slice
   if (newPhiSlice == 2 * oldPhiSlice) {
+    // each iteration writes only the phi slices m and m + 1
+#pragma omp parallel for num_threads(sNThreads)
     for (int m = 0; m < newPhiSlice; m += 2) {
       // assuming no symmetry
       int mm = m / 2;
@@ -1198,52 +1203,85 @@ template <typename DataT>
 void PoissonSolver<DataT>::relax3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2,
                                    const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const
 {
-  // Gauss-Seidel (Read Black}
+  // Gauss-Seidel (Red Black)
   if (MGParameters::relaxType == RelaxType::GaussSeidel) {
-    // for each slice
-    for (int iPass = 1; iPass <= 2; ++iPass) {
-      const int msw = (iPass % 2) ? 1 : 2;
-      for (int m = 0; m < iPhi; ++m) {
-        const int jsw = ((msw + m) % 2) ? 1 : 2;
-        int mp1 = m + 1;
-        int signPlus = 1;
-        int mm1 = m - 1;
-        int signMinus = 1;
-        // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
-        if (symmetry == 1) {
-          if (mp1 > iPhi - 1) {
-            mp1 = iPhi - 2;
-          }
-          if (mm1 < 0) {
-            mm1 = 1;
-          }
+    DataT* const potential = matricesCurrentV.data().data();
+    const DataT* const charge = matricesCurrentCharge.data().data();
+    const DataT* const coeff1 = coefficient1.data();
+    const DataT* const coeff2 = coefficient2.data();
+    const DataT* const coeff3 = coefficient3.data();
+    const DataT* const coeff4 = coefficient4.data();
+
+    // relax the vertices of one colour in the z rows [jBegin, jEnd) of phi slice m
+    auto relaxSlice = [&](const int msw, const int m, const int jBegin, const int jEnd) {
+      const int jsw = ((msw + m) % 2) ? 1 : 2;
+      int mp1 = m + 1;
+      int signPlus = 1;
+      int mm1 = m - 1;
+      int signMinus = 1;
+      // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
+      if (symmetry == 1) {
+        if (mp1 > iPhi - 1) {
+          mp1 = iPhi - 2;
         }
-        // Anti-symmetry in phi
-        else if (symmetry == -1) {
-          if (mp1 > iPhi - 1) {
-            mp1 = iPhi - 2;
-            signPlus = -1;
-          }
-          if (mm1 < 0) {
-            mm1 = 1;
-            signMinus = -1;
-          }
-        } else { // No Symmetries in phi, no boundaries, the calculation is continuous across all phi
-          if (mp1 > iPhi - 1) {
-            mp1 = m + 1 - iPhi;
-          }
-          if (mm1 < 0) {
-            mm1 = m - 1 + iPhi;
-          }
+        if (mm1 < 0) {
+          mm1 = 1;
         }
-        int isw = jsw;
-        for (int j = 1; j < tnZColumn - 1; ++j, isw = 3 - isw) {
-          for (int i = isw; i < tnRRow - 1; i += 2) {
-            (matricesCurrentV)(i, j, m) = (coefficient2[i] * (matricesCurrentV)(i - 1, j, m) + tempRatioZ * ((matricesCurrentV)(i, j - 1, m) + (matricesCurrentV)(i, j + 1, m)) + coefficient1[i] * (matricesCurrentV)(i + 1, j, m) + coefficient3[i] * (signPlus * (matricesCurrentV)(i, j, mp1) + signMinus * (matricesCurrentV)(i, j, mm1)) + (h2 * (matricesCurrentCharge)(i, j, m))) * coefficient4[i];
-          } // end cols
-        }   // end mParamGrid.NRVertices
-      }     // end phi
-    }       // end sweep
+      }
+      // Anti-symmetry in phi
+      else if (symmetry == -1) {
+        if (mp1 > iPhi - 1) {
+          mp1 = iPhi - 2;
+          signPlus = -1;
+        }
+        if (mm1 < 0) {
+          mm1 = 1;
+          signMinus = -1;
+        }
+      } else { // No Symmetries in phi, no boundaries, the calculation is continuous across all phi
+        if (mp1 > iPhi - 1) {
+          mp1 = m + 1 - iPhi;
+        }
+        if (mm1 < 0) {
+          mm1 = m - 1 + iPhi;
+        }
+      }
+      for (int j = jBegin; j < jEnd; ++j) {
+        const int isw = ((j - 1) % 2) ? 3 - jsw : jsw;
+        DataT* const v = potential + matricesCurrentV.getIndex(0, j, m);
+        const DataT* const vZMinus = potential + matricesCurrentV.getIndex(0, j - 1, m);
+        const DataT* const vZPlus = potential + matricesCurrentV.getIndex(0, j + 1, m);
+        const DataT* const vPhiPlus = potential + matricesCurrentV.getIndex(0, j, mp1);
+        const DataT* const vPhiMinus = potential + matricesCurrentV.getIndex(0, j, mm1);
+        const DataT* const q = charge + matricesCurrentCharge.getIndex(0, j, m);
+#pragma omp simd
+        for (int i = isw; i < tnRRow - 1; i += 2) {
+          v[i] = (coeff2[i] * v[i - 1] + tempRatioZ * (vZMinus[i] + vZPlus[i]) + coeff1[i] * v[i + 1] + coeff3[i] * (signPlus * vPhiPlus[i] + signMinus * vPhiMinus[i]) + (h2 * q[i])) * coeff4[i];
+        } // end cols
+      }   // end mParamGrid.NRVertices
+    };
+
+    // the colour of a vertex is given by the parity of i + j + m: during one pass the vertices of one colour are only
+    // updated from the vertices of the other colour and the phi slices can be relaxed in parallel with the same result.
+    // Only for an odd number of phi slices without symmetry the first and the last slice have the same colour and are neighbours:
+    // the last slice is then relaxed afterwards, as in the sequential loop.
+    // Each thread relaxes the same range of phi slices block of z rows by block of z rows, to keep the rows of the neighbouring phi slices in the cache
+    const int nPhiParallel = ((symmetry == 0) && (iPhi % 2)) ? iPhi - 1 : iPhi;
+    for (int iPass = 1; iPass <= 2; ++iPass) {
+      const int msw = (iPass % 2) ? 1 : 2;
+#pragma omp parallel num_threads(sNThreads)
+      for (int jBlock = 1; jBlock < tnZColumn - 1; jBlock += ZBLOCKSIZE) {
+        const int jBlockEnd = std::min(jBlock + ZBLOCKSIZE, tnZColumn - 1);
+#pragma omp for schedule(static) nowait
+        for (int m = 0; m < nPhiParallel; ++m) {
+          relaxSlice(msw, m, jBlock, jBlockEnd);
+        } // end phi
+      }   // end z blocks
+
+      for (int m = nPhiParallel; m < iPhi; ++m) {
+        relaxSlice(msw, m, 1, tnZColumn - 1);
+      }
+    } // end sweep
   } else if (MGParameters::relaxType == RelaxType::Jacobi) {
     // for each slice
     for (int m = 0; m < iPhi; ++m) {
@@ -1367,8 +1405,9 @@ template <typename DataT>
 void PoissonSolver<DataT>::restrict3D(Vector& matricesCurrentCharge, const Vector& residue, const int tnRRow, const int tnZColumn, const int newPhiSlice, const int oldPhiSlice) const
 {
   if (2 * newPhiSlice == oldPhiSlice) {
-    int mm = 0;
-    for (int m = 0; m < newPhiSlice; m++, mm += 2) {
+#pragma omp parallel for num_threads(sNThreads)
+    for (int m = 0; m < newPhiSlice; m++) {
+      const int mm = 2 * m;
       // assuming no symmetry
       int mp1 = mm + 1;
       int mm1 = mm - 1;
@@ -1380,8 +1419,8 @@ void PoissonSolver<DataT>::restrict3D(Vector& matricesCurrentCharge, const Vecto
         mm1 = mm - 1 + (oldPhiSlice);
       }
 
-      for (int i = 1, ii = 2; i < tnRRow - 1; ++i, ii += 2) {
-        for (int j = 1, jj = 2; j < tnZColumn - 1; ++j, jj += 2) {
+      for (int j = 1, jj = 2; j < tnZColumn - 1; ++j, jj += 2) {
+        for (int i = 1, ii = 2; i < tnRRow - 1; ++i, ii += 2) {
 
           // at the same plane
           const int iip1 = ii + 1;
@@ -1398,8 +1437,8 @@ void PoissonSolver<DataT>::restrict3D(Vector& matricesCurrentCharge, const Vecto
                            (residue(iim1, jjm1, mm1) + residue(iim1, jjp1, mm1) + residue(iim1, jjm1, mp1) + residue(iim1, jjp1, mp1));
 
           matricesCurrentCharge(i, j, m) = residue(ii, jj, mm) / 8 + s1 / 16 + s2 / 32 + s3 / 64;
-        } // end cols
-      }   // end mParamGrid.NRVertices
+        } // end mParamGrid.NRVertices
+      }   // end cols
 
       // for boundary
       for (int j = 0, jj = 0; j < tnZColumn; ++j, jj += 2) {
@@ -1415,6 +1454,7 @@ void PoissonSolver<DataT>::restrict3D(Vector& matricesCurrentCharge, const Vecto
     } // end phis
 
   } else {
+#pragma omp parallel for num_threads(sNThreads)
     for (int m = 0; m < newPhiSlice; ++m) {
       restrict2D(matricesCurrentCharge, residue, tnRRow, tnZColumn, m);
     }
@@ -1424,8 +1464,8 @@ void PoissonSolver<DataT>::restrict3D(Vector& matricesCurrentCharge, const Vecto
 template <typename DataT>
 void PoissonSolver<DataT>::restrict2D(Vector& matricesCurrentCharge, const Vector& residue, const int tnRRow, const int tnZColumn, const int iphi) const
 {
-  for (int i = 1, ii = 2; i < tnRRow - 1; ++i, ii += 2) {
-    for (int j = 1, jj = 2; j < tnZColumn - 1; ++j, jj += 2) {
+  for (int j = 1, jj = 2; j < tnZColumn - 1; ++j, jj += 2) {
+    for (int i = 1, ii = 2; i < tnRRow - 1; ++i, ii += 2) {
       const int iip1 = ii + 1;
       const int iim1 = ii - 1;
       const int jjp1 = jj + 1;
@@ -1437,8 +1477,8 @@ void PoissonSolver<DataT>::restrict2D(Vector& matricesCurrentCharge, const Vecto
         matricesCurrentCharge(i, j, iphi) = residue(ii, jj, iphi) / 4 + (residue(iip1, jj, iphi) + residue(iim1, jj, iphi) + residue(ii, jjp1, iphi) + residue(ii, jjm1, iphi)) / 8 +
                                             (residue(iip1, jjp1, iphi) + residue(iim1, jjp1, iphi) + residue(iip1, jjm1, iphi) + residue(iim1, jjm1, iphi)) / 16;
       }
-    } // end cols
-  }   // end mParamGrid.NRVertices
+    } // end mParamGrid.NRVertices
+  }   // end cols
   // boundary
   // for boundary
   for (int j = 0, jj = 0; j < tnZColumn; ++j, jj += 2) {
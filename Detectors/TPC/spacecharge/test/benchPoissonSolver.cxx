@@ -0,0 +1,70 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchPoissonSolver.cxx
+/// \brief Benchmark of the scaling of the 3D poisson solver with the number of threads on the default 129x129x180 grid
+
+#include "benchmark/benchmark.h"
+#include "TPCSpaceCharge/PoissonSolver.h"
+#include "TPCSpaceCharge/PoissonSolverHelpers.h"
+#include "TPCSpaceCharge/SpaceChargeHelpers.h"
+#include "TPCSpaceCharge/DataContainer3D.h"
+
+using namespace o2::tpc;
+
+using DataT = double;
+static constexpr unsigned short NR = 129;
+static constexpr unsigned short NZ = 129;
+static constexpr unsigned short NPHI = 180;
+
+static void BM_PoissonSolver3D(benchmark::State& state)
+{
+  MGParameters::isFull3D = true;
+  o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NZVertices", NZ);
+  o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NRVertices", NR);
+  o2::conf::ConfigurableParam::setValue<unsigned short>("TPCSpaceChargeParam", "NPhiVertices", NPHI);
+
+  using GridProp = GridProperties<DataT>;
+  const RegularGrid3D<DataT> grid3D{GridProp::ZMIN, GridProp::RMIN, GridProp::PHIMIN, GridProp::getGridSpacingZ(NZ), GridProp::getGridSpacingR(NR), GridProp::getGridSpacingPhi(NPHI)};
+
+  // charge and boundary potential from the analytical formulas
+  const AnalyticalFields<DataT> formulas;
+  DataContainer3D<DataT> charge(NZ, NR, NPHI);
+  DataContainer3D<DataT> potential0(NZ, NR, NPHI);
+  for (size_t iPhi = 0; iPhi < NPHI; ++iPhi) {
+    const DataT phi = grid3D.getPhiVertex(iPhi);
+    for (size_t iR = 0; iR < NR; ++iR) {
+      const DataT radius = grid3D.getRVertex(iR);
+      for (size_t iZ = 0; iZ < NZ; ++iZ) {
+        const DataT z = grid3D.getZVertex(iZ);
+        charge(iZ, iR, iPhi) = formulas.evalDensity(z, radius, phi);
+        if (iR == 0 || iR == NR - 1 || iZ == 0 || iZ == NZ - 1) {
+          potential0(iZ, iR, iPhi) = formulas.evalPotential(z, radius, phi);
+        }
+      }
+    }
+  }
+
+  PoissonSolver<DataT>::setNThreads(state.range(0));
+  PoissonSolver<DataT> poissonSolver(grid3D);
+  DataContainer3D<DataT> potential;
+  for (auto _ : state) {
+    state.PauseTiming();
+    potential = potential0;
+    state.ResumeTiming();
+    poissonSolver.poissonSolver3D(potential, charge, 0);
+    benchmark::DoNotOptimize(potential.getData().data());
+  }
+}
+
+BENCHMARK(BM_PoissonSolver3D)->RangeMultiplier(2)->Range(1, 32)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
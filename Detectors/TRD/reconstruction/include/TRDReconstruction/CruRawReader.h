@@ -20,6 +20,8 @@
 #include <cstdint>
 #include <bitset>
 #include <array>
+#include <utility>
+#include <vector>
 #include "Headers/RAWDataHeader.h"
 #include "Headers/RDHAny.h"
 #include "DetectorsRaw/RDHUtils.h"
@@ -86,10 +88,23 @@ class CruRawReader
   int getTrackletsFound() const { return mTrackletsFound; }
 
   int getWordsRejected() const { return mWordsRejected + mDigitWordsRejected + mTrackletWordsRejected; }
+  int getDigitWordsRead() const { return mDigitWordsRead; }
+  int getTrackletWordsRead() const { return mTrackletWordsRead; }
+
+  // the events parsed since the last reset
+  const EventRecordContainer& getEventRecords() const { return mEventRecords; }
 
   // reset the event storage and the counters
   void reset();
 
+  // move the events and the counters of another reader into this one and reset it
+  // the output is the same as if this reader had also processed the input data of the other one
+  void merge(CruRawReader& other);
+
+  // parse the HBF messages of a TF, given as pointer and size, with one thread per reader, each thread on a contiguous range of the messages
+  // the other readers are then merged into the first one in the order of the messages, so that the output does not depend on the number of readers
+  static void runParallel(const std::vector<std::pair<const char*, size_t>>& hbfs, const std::vector<CruRawReader*>& readers);
+
   // the parsing starts here, payload from all available RDHs is copied into mHBFPayload and afterwards processHalfCRU() is called
   // returns the total number of bytes read, including RDH header
   int processHBFs();
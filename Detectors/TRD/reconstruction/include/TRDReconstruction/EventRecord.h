@@ -50,6 +50,9 @@ class EventRecord
   // needed, in order to check if a trigger already exist for this bunch crossing
   bool operator==(const EventRecord& o) const { return mBCData == o.mBCData; }
 
+  // append the data and the statistics of another EventRecord for the same bunch crossing
+  void append(const EventRecord& other);
+
   // only the tracklets are sorted by detector ID
   // TODO: maybe at some point a finer sorting might be helpful (padrow, padcolumn?)
   void sortTrackletsByDetector();
@@ -117,6 +120,13 @@ class EventRecordContainer
   void reset();
   void accumulateStats();
 
+  const std::vector<EventRecord>& getEventRecords() const { return mEventRecords; }
+  const TRDDataCountersPerTimeFrame& getTFStats() const { return mTFStats; }
+
+  // move the EventRecords of another container into this one, adding the data of the same bunch crossings, and add up the statistics
+  // the EventRecords keep the order in which they were first seen, if other was filled with data following the data of this container
+  void merge(EventRecordContainer& other);
+
  private:
   int mCurrEventRecord = 0;
   std::vector<EventRecord> mEventRecords;
@@ -32,6 +32,7 @@
 #include "DataFormatsCTP/TriggerOffsetsParam.h"
 
 #include <string>
+#include <algorithm>
 #include <numeric>
 #include <iomanip>
 
@@ -484,7 +485,7 @@ bool CruRawReader::processHalfCRU(int iteration)
 
     linksizeAccum32 += currentlinksize32;
     if (currentlinksize32 == 0) {
-      mEventRecords.incLinkNoData(detectorId, side, stack_layer);
+      mEventRecords.incLinkNoData(mFEEID.supermodule, side, stack_layer);
     }
     if (mOptions[TRDVerboseBit]) {
       if (currentlinksize32 > 0) {
@@ -1091,6 +1092,43 @@ void CruRawReader::reset()
   mWordsRejected = 0;
 }
 
+void CruRawReader::merge(CruRawReader& other)
+{
+  mEventRecords.merge(other.mEventRecords);
+  mTrackletsFound += other.mTrackletsFound;
+  mDigitsFound += other.mDigitsFound;
+  mDigitWordsRead += other.mDigitWordsRead;
+  mDigitWordsRejected += other.mDigitWordsRejected;
+  mTrackletWordsRead += other.mTrackletWordsRead;
+  mTrackletWordsRejected += other.mTrackletWordsRejected;
+  mWordsRejected += other.mWordsRejected;
+  other.reset();
+}
+
+void CruRawReader::runParallel(const std::vector<std::pair<const char*, size_t>>& hbfs, const std::vector<CruRawReader*>& readers)
+{
+  const int nThreads = std::max(1, std::min((int)readers.size(), (int)hbfs.size()));
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nThreads)
+#endif
+  for (int iThread = 0; iThread < nThreads; ++iThread) {
+    auto& reader = *readers[iThread];
+    const size_t first = hbfs.size() * iThread / nThreads;
+    const size_t last = hbfs.size() * (iThread + 1) / nThreads;
+    for (size_t iHBF = first; iHBF < last; ++iHBF) {
+      reader.setDataBuffer(hbfs[iHBF].first);
+      reader.setDataBufferSize(hbfs[iHBF].second);
+      reader.run();
+      if (reader.mOptions[TRDVerboseBit]) {
+        LOG(info) << "relevant vectors to read : " << reader.getTrackletsFound() << " tracklets and " << reader.getDigitsFound() << " compressed digits";
+      }
+    }
+  }
+  for (int iThread = 1; iThread < nThreads; ++iThread) {
+    readers[0]->merge(*readers[iThread]);
+  }
+}
+
 void CruRawReader::checkNoWarn()
 {
   if (!mOptions[TRDVerboseErrorsBit]) {
@@ -26,6 +26,8 @@
 #include "DataFormatsCTP/TriggerOffsetsParam.h"
 #include "DataFormatsTRD/Constants.h"
 
+#include <algorithm>
+
 namespace o2::trd
 {
 
@@ -33,8 +35,23 @@ void DataReaderTask::init(InitContext& ic)
 {
   LOG(info) << "o2::trd::DataReadTask init";
 
-  mReader.setMaxErrWarnPrinted(ic.options().get<int>("log-max-errors"), ic.options().get<int>("log-max-warnings"));
-  mReader.configure(mTrackletHCHeaderState, mHalfChamberWords, mHalfChamberMajor, mOptions);
+  int nThreads = std::max(1, ic.options().get<int>("nthreads"));
+#ifndef WITH_OPENMP
+  if (nThreads > 1) {
+    LOG(warning) << "Multiple threads requested, but OpenMP is not available. Using a single thread";
+    nThreads = 1;
+  }
+#endif
+  mReaders.push_back(&mReader);
+  for (int iThread = 1; iThread < nThreads; ++iThread) {
+    mThreadReaders.emplace_back(std::make_unique<CruRawReader>());
+    mReaders.push_back(mThreadReaders.back().get());
+  }
+  for (auto* reader : mReaders) {
+    reader->setMaxErrWarnPrinted(ic.options().get<int>("log-max-errors"), ic.options().get<int>("log-max-warnings"));
+    reader->configure(mTrackletHCHeaderState, mHalfChamberWords, mHalfChamberMajor, mOptions);
+    reader->reset();
+  }
 }
 
 void DataReaderTask::endOfStream(o2::framework::EndOfStreamContext& ec)
@@ -51,7 +68,9 @@ void DataReaderTask::finaliseCCDB(ConcreteDataMatcher& matcher, void* obj)
     return;
   } else if (matcher == ConcreteDataMatcher("TRD", "LinkToHcid", 0)) {
     LOG(info) << "Updated Link ID to HCID mapping";
-    mReader.setLinkMap((const o2::trd::LinkToHCIDMapping*)obj);
+    for (auto* reader : mReaders) {
+      reader->setLinkMap((const o2::trd::LinkToHCIDMapping*)obj);
+    }
     return;
   }
 }
@@ -107,25 +126,24 @@ void DataReaderTask::run(ProcessingContext& pc)
   size_t datasizeInTF = 0;
   std::vector<InputSpec> sel{InputSpec{"filter", ConcreteDataTypeMatcher{"TRD", "RAWDATA"}}};
   uint64_t tfCount = 0;
+  // first collect the incoming HBFs from all half-CRUs (typically 128 * 72 per TF), which can be parsed independently
+  std::vector<std::pair<const char*, size_t>> hbfs;
   for (auto& ref : InputRecordWalker(pc.inputs(), sel)) {
-    // loop over incoming HBFs from all half-CRUs (typically 128 * 72 iterations per TF)
     const auto* dh = DataRefUtils::getHeader<o2::header::DataHeader*>(ref);
     tfCount = dh->tfCounter;
-    const char* payloadIn = ref.payload;
     auto payloadInSize = DataRefUtils::getPayloadSize(ref);
     if (mOptions[TRDVerboseBit]) {
       LOGP(info, "Found input [{}/{}/{:#x}] TF#{} 1st_orbit:{} Payload {} : ",
            dh->dataOrigin.str, dh->dataDescription.str, dh->subSpecification, dh->tfCounter, dh->firstTForbit, payloadInSize);
     }
-    mReader.setDataBuffer(payloadIn);
-    mReader.setDataBufferSize(payloadInSize);
-    mReader.run();
+    hbfs.emplace_back(ref.payload, payloadInSize);
     datasizeInTF += payloadInSize;
-    if (mOptions[TRDVerboseBit]) {
-      LOG(info) << "relevant vectors to read : " << mReader.getTrackletsFound() << " tracklets and " << mReader.getDigitsFound() << " compressed digits";
-    }
   }
 
+  // each thread parses a contiguous range of the HBFs with its own reader, the readers are then merged in the order of the HBFs
+  // so that the output does not depend on the number of threads
+  CruRawReader::runParallel(hbfs, mReaders);
+
   mReader.buildDPLOutputs(pc);
   std::chrono::duration<double, std::milli> dataReadTime = std::chrono::high_resolution_clock::now() - dataReadStart;
   LOGP(info, "Digits: {}, Tracklets: {}, DataRead in: {:.3f} MB, Rejected: {:.3f} kB for TF {} in {} ms",
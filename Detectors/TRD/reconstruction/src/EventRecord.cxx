@@ -40,6 +40,20 @@
 namespace o2::trd
 {
 
+void EventRecord::append(const EventRecord& other)
+{
+  mDigits.insert(mDigits.end(), other.getDigits().begin(), other.getDigits().end());
+  mTracklets.insert(mTracklets.end(), other.getTracklets().begin(), other.getTracklets().end());
+  const auto& stats = other.getEventStats();
+  mEventStats.mTimeTaken += stats.mTimeTaken;
+  mEventStats.mTimeTakenForDigits += stats.mTimeTakenForDigits;
+  mEventStats.mTimeTakenForTracklets += stats.mTimeTakenForTracklets;
+  mEventStats.mWordsRead += stats.mWordsRead;
+  mEventStats.mWordsRejected += stats.mWordsRejected;
+  mEventStats.mTrackletsFound += stats.mTrackletsFound;
+  mEventStats.mDigitsFound += stats.mDigitsFound;
+}
+
 void EventRecord::sortTrackletsByDetector()
 {
   // sort the tracklets by detector ID
@@ -125,4 +139,34 @@ void EventRecordContainer::reset()
   mEventRecords.clear();
   mTFStats.clear();
 }
+
+void EventRecordContainer::merge(EventRecordContainer& other)
+{
+  for (const auto& event : other.mEventRecords) {
+    setCurrentEventRecord(event.getBCData());
+    getCurrentEventRecord().append(event);
+  }
+  auto addArray = [](auto& to, const auto& from) {
+    for (size_t i = 0; i < to.size(); ++i) {
+      to[i] += from[i];
+    }
+  };
+  const auto& stats = other.mTFStats;
+  for (size_t i = 0; i < mTFStats.mLinkErrorFlag.size(); ++i) {
+    mTFStats.mLinkErrorFlag[i] |= stats.mLinkErrorFlag[i];
+  }
+  addArray(mTFStats.mLinkNoData, stats.mLinkNoData);
+  addArray(mTFStats.mLinkWords, stats.mLinkWords);
+  addArray(mTFStats.mLinkWordsRead, stats.mLinkWordsRead);
+  addArray(mTFStats.mLinkWordsRejected, stats.mLinkWordsRejected);
+  addArray(mTFStats.mParsingErrors, stats.mParsingErrors);
+  addArray(mTFStats.mParsingErrorsByLink, stats.mParsingErrorsByLink);
+  addArray(mTFStats.mDataFormatRead, stats.mDataFormatRead);
+  mTFStats.mTimeTaken += stats.mTimeTaken;
+  mTFStats.mTimeTakenForDigits += stats.mTimeTakenForDigits;
+  mTFStats.mTimeTakenForTracklets += stats.mTimeTakenForTracklets;
+  mTFStats.mDigitsFound += stats.mDigitsFound;
+  mTFStats.mTrackletsFound += stats.mTrackletsFound;
+  other.reset();
+}
 } // namespace o2::trd
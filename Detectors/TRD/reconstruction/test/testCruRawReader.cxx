@@ -0,0 +1,436 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testCruRawReader.cxx
+/// \brief Test the merging of the event records and the parsing of the HBFs of a TF with several readers
+
+#define BOOST_TEST_MODULE Test TRD CruRawReader
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+#include "DataFormatsCTP/TriggerOffsetsParam.h"
+#include "DataFormatsTRD/Constants.h"
+#include "DataFormatsTRD/HelperMethods.h"
+#include "DataFormatsTRD/RawData.h"
+#include "DetectorsRaw/RDHUtils.h"
+#include "Headers/RAWDataHeader.h"
+#include "TRDReconstruction/CruRawReader.h"
+#include "TRDReconstruction/EventRecord.h"
+
+using namespace o2::trd;
+using namespace o2::trd::constants;
+using RDHUtils = o2::raw::RDHUtils;
+
+namespace
+{
+
+constexpr size_t MaxPageSize = 8192;
+constexpr uint32_t FirstOrbit = 1000;
+constexpr int NOrbits = 8;
+const std::array<int, 5> HalfCRUs{0, 3, 17, 40, 71};
+
+struct GeneratedTF {
+  std::vector<std::vector<char>> hbfs;
+  int nTracklets = 0;
+  int nDigits = 0;
+};
+
+LinkToHCIDMapping makeLinkMap()
+{
+  LinkToHCIDMapping map;
+  for (int link = 0; link < NHALFCRU * NLINKSPERHALFCRU; ++link) {
+    int hcid = HelperMethods::getHCIDFromLinkID(link);
+    map.linkIDToHCID[link] = hcid;
+    map.hcIDToLinkID[hcid] = link;
+  }
+  return map;
+}
+
+/// a few distinct values in [0, n), in increasing order
+std::vector<int> pickSorted(int n, int nPicked, std::mt19937& gen)
+{
+  std::vector<int> values(n);
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), gen);
+  values.resize(nPicked);
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+/// tracklets, and digits for the calibration triggers, of one link padded to 256 bits, returns the link size in 256-bit words
+int writeLinkData(std::vector<uint32_t>& words, int hcid, int bc, bool isCalib, std::mt19937& gen, GeneratedTF& tf)
+{
+  const size_t start = words.size();
+  std::uniform_int_distribution<int> nMCMs(1, 3), cpuMask(1, 7), hpid(0, 0xfe), slope(0, 0xff), lpid(0, 0xfff), pos(0, 0x7ff), adc(0, 0x3ff);
+  TrackletHCHeader hcHeader;
+  constructTrackletHCHeader(hcHeader, hcid, bc, 12);
+  words.push_back(hcHeader.word);
+  for (int mcmPos : pickSorted(NROBC1 * NMCMROBINROW, nMCMs(gen), gen)) {
+    TrackletMCMHeader mcmHeader;
+    mcmHeader.word = 0;
+    mcmHeader.onea = 1;
+    mcmHeader.oneb = 1;
+    mcmHeader.padrow = mcmPos / 4;
+    mcmHeader.col = mcmPos % 4;
+    std::bitset<3> cpus(cpuMask(gen));
+    mcmHeader.pid0 = cpus[0] ? hpid(gen) : 0xff;
+    mcmHeader.pid1 = cpus[1] ? hpid(gen) : 0xff;
+    mcmHeader.pid2 = cpus[2] ? hpid(gen) : 0xff;
+    words.push_back(mcmHeader.word);
+    for (size_t iCpu = 0; iCpu < cpus.count(); ++iCpu) {
+      TrackletMCMData mcmData;
+      do {
+        mcmData.word = 0;
+        mcmData.slope = slope(gen);
+        mcmData.pid = lpid(gen);
+        mcmData.pos = pos(gen);
+      } while (mcmData.word == TRACKLETENDMARKER);
+      words.push_back(mcmData.word);
+      ++tf.nTracklets;
+    }
+  }
+  words.push_back(TRACKLETENDMARKER);
+  words.push_back(TRACKLETENDMARKER);
+
+  if (isCalib) {
+    int det = hcid / 2;
+    DigitHCHeader digitHCHeader;
+    digitHCHeader.word = 0;
+    digitHCHeader.res = 1;
+    digitHCHeader.side = hcid % 2;
+    digitHCHeader.stack = HelperMethods::getStack(det);
+    digitHCHeader.layer = HelperMethods::getLayer(det);
+    digitHCHeader.supermodule = HelperMethods::getSector(det);
+    digitHCHeader.numberHCW = 1;
+    digitHCHeader.minor = 42;
+    digitHCHeader.major = 0x21; // zero suppressed
+    digitHCHeader.version = 1;
+    words.push_back(digitHCHeader.word);
+    DigitHCHeader1 digitHCHeader1;
+    digitHCHeader1.word = 0;
+    digitHCHeader1.res = 1;
+    digitHCHeader1.ptrigcount = 1;
+    digitHCHeader1.ptrigphase = 1;
+    digitHCHeader1.bunchcrossing = bc;
+    digitHCHeader1.numtimebins = TIMEBINS;
+    words.push_back(digitHCHeader1.word);
+    std::uniform_int_distribution<int> nDigitMCMs(1, 2), nChannels(1, 3);
+    for (int mcmPos : pickSorted(NROBC1 * NMCMROB, nDigitMCMs(gen), gen)) {
+      DigitMCMHeader mcmHeader;
+      mcmHeader.word = 0;
+      mcmHeader.res = 0xc;
+      mcmHeader.eventcount = 1;
+      mcmHeader.rob = mcmPos / NMCMROB;
+      mcmHeader.mcm = mcmPos % NMCMROB;
+      mcmHeader.yearflag = 1;
+      words.push_back(mcmHeader.word);
+      auto channels = pickSorted(NADCMCM, nChannels(gen), gen);
+      DigitMCMADCMask adcMask = constructBlankADCMask();
+      for (int channel : channels) {
+        incrementADCMask(adcMask, channel);
+      }
+      words.push_back(adcMask.word);
+      for (int channel : channels) {
+        for (int iWord = 0; iWord < TIMEBINS / 3; ++iWord) {
+          DigitMCMData data;
+          data.word = 0;
+          data.f = (channel % 2) ? 0x2 : 0x3;
+          data.z = adc(gen);
+          data.y = adc(gen);
+          data.x = adc(gen);
+          words.push_back(data.word);
+        }
+        ++tf.nDigits;
+      }
+    }
+    words.push_back(DIGITENDMARKER);
+    words.push_back(DIGITENDMARKER);
+  }
+
+  while ((words.size() - start) % 8) {
+    words.push_back(PADDINGWORD);
+  }
+  return (words.size() - start) / 8;
+}
+
+/// one trigger of a half-CRU: the HalfCRUHeader followed by the data of a few links
+void writeHalfCRU(std::vector<uint32_t>& words, int halfCru, int bc, bool isCalib, const LinkToHCIDMapping& linkMap, std::mt19937& gen, GeneratedTF& tf)
+{
+  std::uniform_int_distribution<int> nLinks(1, 4), percent(0, 99), errorFlag(1, MAXCRUERRORVALUE);
+  HalfCRUHeader header;
+  clearHalfCRUHeader(header);
+  setHalfCRUHeaderFirstWord(header, 1, bc + o2::ctp::TriggerOffsetsParam::Instance().LM_L0, 0, halfCru % 2,
+                            isCalib ? ETYPECALIBRATIONTRIGGER : ETYPEPHYSICSTRIGGER, 0, 0);
+  const size_t headerPos = words.size();
+  words.resize(words.size() + sizeof(HalfCRUHeader) / 4);
+  auto links = pickSorted(NLINKSPERHALFCRU, nLinks(gen), gen);
+  for (int link = 0; link < NLINKSPERHALFCRU; ++link) {
+    int size = 0;
+    if (std::find(links.begin(), links.end(), link) != links.end()) {
+      size = writeLinkData(words, linkMap.getHCID(halfCru * NLINKSPERHALFCRU + link), bc, isCalib, gen, tf);
+    }
+    setHalfCRUHeaderLinkSizeAndFlags(header, link, size, percent(gen) < 5 ? errorFlag(gen) : 0);
+  }
+  std::memcpy(&words[headerPos], &header, sizeof(HalfCRUHeader));
+}
+
+/// HBF of a half-CRU with a single page followed by the RDH with the stop bit
+std::vector<char> makeHBF(int halfCru, uint32_t orbit, const std::vector<uint32_t>& payload)
+{
+  o2::header::RAWDataHeader rdh;
+  RDHUtils::setFEEID(rdh, constructTRDFeeID(halfCru / 4, (halfCru / 2) % 2, halfCru % 2));
+  RDHUtils::setEndPointID(rdh, halfCru % 2);
+  RDHUtils::setCRUID(rdh, halfCru / 2);
+  RDHUtils::setTriggerOrbit(rdh, orbit);
+  RDHUtils::setHeartBeatOrbit(rdh, orbit);
+  RDHUtils::setTriggerBC(rdh, 0);
+  RDHUtils::setPacketCounter(rdh, 0);
+  RDHUtils::setStop(rdh, 0);
+  const size_t pageSize = sizeof(rdh) + payload.size() * sizeof(uint32_t);
+  BOOST_REQUIRE(pageSize <= MaxPageSize);
+  RDHUtils::setMemorySize(rdh, pageSize);
+  RDHUtils::setOffsetToNext(rdh, pageSize);
+  auto stopRdh = rdh;
+  RDHUtils::setMemorySize(stopRdh, sizeof(rdh));
+  RDHUtils::setOffsetToNext(stopRdh, sizeof(rdh));
+  RDHUtils::setPacketCounter(stopRdh, 1);
+  RDHUtils::setStop(stopRdh, 1);
+
+  std::vector<char> hbf(pageSize + sizeof(rdh));
+  std::memcpy(hbf.data(), &rdh, sizeof(rdh));
+  std::memcpy(hbf.data() + sizeof(rdh), payload.data(), payload.size() * sizeof(uint32_t));
+  std::memcpy(hbf.data() + pageSize, &stopRdh, sizeof(rdh));
+  return hbf;
+}
+
+/// HBFs of a few half-CRUs, ordered by half-CRU and then by orbit as they arrive from the CRUs,
+/// so that the triggers seen first are not the first ones in time. All half-CRUs see the same triggers.
+GeneratedTF generateTF(const LinkToHCIDMapping& linkMap, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> nTriggers(0, 3), percent(0, 99);
+  std::vector<std::vector<std::pair<int, bool>>> triggers(NOrbits);
+  for (auto& orbitTriggers : triggers) {
+    for (int bc : pickSorted(2900, nTriggers(gen), gen)) {
+      orbitTriggers.emplace_back(bc + 100, percent(gen) < 30);
+    }
+  }
+  GeneratedTF tf;
+  for (int halfCru : HalfCRUs) {
+    for (int iOrbit = 0; iOrbit < NOrbits; ++iOrbit) {
+      std::vector<uint32_t> payload;
+      for (const auto& [bc, isCalib] : triggers[iOrbit]) {
+        writeHalfCRU(payload, halfCru, bc, isCalib, linkMap, gen, tf);
+      }
+      tf.hbfs.push_back(makeHBF(halfCru, FirstOrbit + iOrbit, payload));
+    }
+  }
+  return tf;
+}
+
+std::vector<std::unique_ptr<CruRawReader>> makeReaders(int nReaders, const LinkToHCIDMapping& linkMap)
+{
+  std::vector<std::unique_ptr<CruRawReader>> readers;
+  for (int i = 0; i < nReaders; ++i) {
+    auto& reader = readers.emplace_back(std::make_unique<CruRawReader>());
+    reader->configure(2, 0, 0, std::bitset<16>{});
+    reader->setLinkMap(&linkMap);
+    reader->setMaxErrWarnPrinted(0, 0);
+    reader->reset();
+  }
+  return readers;
+}
+
+void runReaders(const GeneratedTF& tf, std::vector<std::unique_ptr<CruRawReader>>& readers)
+{
+  std::vector<std::pair<const char*, size_t>> hbfs;
+  for (const auto& hbf : tf.hbfs) {
+    hbfs.emplace_back(hbf.data(), hbf.size());
+  }
+  std::vector<CruRawReader*> readerPtrs;
+  for (auto& reader : readers) {
+    readerPtrs.push_back(reader.get());
+  }
+  CruRawReader::runParallel(hbfs, readerPtrs);
+}
+
+/// the same events with the same data and the same statistics, apart from the time taken
+void checkSameOutput(const CruRawReader& reader, const CruRawReader& ref)
+{
+  BOOST_CHECK_EQUAL(reader.getTrackletsFound(), ref.getTrackletsFound());
+  BOOST_CHECK_EQUAL(reader.getDigitsFound(), ref.getDigitsFound());
+  BOOST_CHECK_EQUAL(reader.getWordsRejected(), ref.getWordsRejected());
+  BOOST_CHECK_EQUAL(reader.getTrackletWordsRead(), ref.getTrackletWordsRead());
+  BOOST_CHECK_EQUAL(reader.getDigitWordsRead(), ref.getDigitWordsRead());
+
+  const auto& events = reader.getEventRecords().getEventRecords();
+  const auto& refEvents = ref.getEventRecords().getEventRecords();
+  BOOST_REQUIRE_EQUAL(events.size(), refEvents.size());
+  for (size_t i = 0; i < refEvents.size(); ++i) {
+    BOOST_CHECK(events[i].getBCData() == refEvents[i].getBCData());
+    BOOST_CHECK(events[i].getTracklets() == refEvents[i].getTracklets());
+    BOOST_CHECK(events[i].getDigits() == refEvents[i].getDigits());
+    const auto& stats = events[i].getEventStats();
+    const auto& refStats = refEvents[i].getEventStats();
+    BOOST_CHECK_EQUAL(stats.mWordsRead, refStats.mWordsRead);
+    BOOST_CHECK_EQUAL(stats.mWordsRejected, refStats.mWordsRejected);
+    BOOST_CHECK_EQUAL(stats.mTrackletsFound, refStats.mTrackletsFound);
+    BOOST_CHECK_EQUAL(stats.mDigitsFound, refStats.mDigitsFound);
+  }
+
+  const auto& stats = reader.getEventRecords().getTFStats();
+  const auto& refStats = ref.getEventRecords().getTFStats();
+  BOOST_CHECK(stats.mLinkErrorFlag == refStats.mLinkErrorFlag);
+  BOOST_CHECK(stats.mLinkNoData == refStats.mLinkNoData);
+  BOOST_CHECK(stats.mLinkWordsRead == refStats.mLinkWordsRead);
+  BOOST_CHECK(stats.mLinkWordsRejected == refStats.mLinkWordsRejected);
+  BOOST_CHECK(stats.mParsingErrors == refStats.mParsingErrors);
+  BOOST_CHECK(stats.mParsingErrorsByLink == refStats.mParsingErrorsByLink);
+  BOOST_CHECK(stats.mDataFormatRead == refStats.mDataFormatRead);
+  BOOST_CHECK_EQUAL(stats.mDigitsFound, refStats.mDigitsFound);
+  BOOST_CHECK_EQUAL(stats.mTrackletsFound, refStats.mTrackletsFound);
+}
+
+Tracklet64 makeTracklet(int hcid, int padrow)
+{
+  return Tracklet64(12, hcid, padrow, 0, 0x80, 0x80, 1, 2, 3);
+}
+
+Digit makeDigit(int det, int rob, int mcm, int channel)
+{
+  ArrayADC adc{};
+  adc.fill(channel + 1);
+  return Digit(det, rob, mcm, channel, adc);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(EventRecordContainer_merge)
+{
+  const o2::InteractionRecord ir1{100, 1000}, ir2{50, 1001}, ir3{200, 1000};
+  EventRecordContainer first, second;
+  first.reset();
+  second.reset();
+
+  first.setCurrentEventRecord(ir1);
+  first.getCurrentEventRecord().addTracklet(makeTracklet(10, 0));
+  first.getCurrentEventRecord().incTrackletsFound(1);
+  first.setCurrentEventRecord(ir2);
+  first.getCurrentEventRecord().addTracklet(makeTracklet(10, 1));
+  first.getCurrentEventRecord().addDigit(makeDigit(5, 0, 1, 2));
+  first.getCurrentEventRecord().incTrackletsFound(1);
+  first.getCurrentEventRecord().incDigitsFound(1);
+  first.getCurrentEventRecord().incWordsRead(20);
+  first.incTrackletsFound(2);
+  first.incDigitsFound(1);
+  first.incLinkErrorFlags(1, 0, 3, 0x1);
+  first.incLinkNoData(1, 0, 4);
+  first.incLinkWordsRead(1, 0, 3, 20);
+  first.incParsingError(TrackletDataWrongOrdering, 10);
+  first.incMajorVersion(0x21);
+
+  second.setCurrentEventRecord(ir2);
+  second.getCurrentEventRecord().addTracklet(makeTracklet(11, 2));
+  second.getCurrentEventRecord().addDigit(makeDigit(5, 1, 3, 4));
+  second.getCurrentEventRecord().addDigit(makeDigit(5, 1, 4, 5));
+  second.getCurrentEventRecord().incTrackletsFound(1);
+  second.getCurrentEventRecord().incDigitsFound(2);
+  second.getCurrentEventRecord().incWordsRead(30);
+  second.setCurrentEventRecord(ir3);
+  second.getCurrentEventRecord().addTracklet(makeTracklet(12, 3));
+  second.getCurrentEventRecord().incTrackletsFound(1);
+  second.incTrackletsFound(2);
+  second.incDigitsFound(2);
+  second.incLinkErrorFlags(1, 0, 3, 0x2);
+  second.incLinkNoData(1, 0, 4);
+  second.incLinkWordsRead(1, 0, 3, 30);
+  second.incParsingError(TrackletDataWrongOrdering, 10);
+  second.incMajorVersion(0x21);
+
+  first.merge(second);
+
+  // the events keep the order in which they were first seen, ir3 is not sorted before ir2
+  const auto& events = first.getEventRecords();
+  BOOST_REQUIRE_EQUAL(events.size(), 3u);
+  BOOST_CHECK(events[0].getBCData() == ir1);
+  BOOST_CHECK(events[1].getBCData() == ir2);
+  BOOST_CHECK(events[2].getBCData() == ir3);
+
+  BOOST_CHECK_EQUAL(events[0].getTracklets().size(), 1u);
+  BOOST_CHECK(events[0].getDigits().empty());
+  // the data of the same bunch crossing are appended in the order of the containers
+  BOOST_REQUIRE_EQUAL(events[1].getTracklets().size(), 2u);
+  BOOST_CHECK(events[1].getTracklets()[0] == makeTracklet(10, 1));
+  BOOST_CHECK(events[1].getTracklets()[1] == makeTracklet(11, 2));
+  BOOST_REQUIRE_EQUAL(events[1].getDigits().size(), 3u);
+  BOOST_CHECK(events[1].getDigits()[0] == makeDigit(5, 0, 1, 2));
+  BOOST_CHECK(events[1].getDigits()[1] == makeDigit(5, 1, 3, 4));
+  BOOST_CHECK(events[1].getDigits()[2] == makeDigit(5, 1, 4, 5));
+  BOOST_CHECK_EQUAL(events[1].getEventStats().mTrackletsFound, 2);
+  BOOST_CHECK_EQUAL(events[1].getEventStats().mDigitsFound, 3);
+  BOOST_CHECK_EQUAL(events[1].getEventStats().mWordsRead, 50u);
+  BOOST_CHECK_EQUAL(events[2].getTracklets().size(), 1u);
+  BOOST_CHECK_EQUAL(events[2].getEventStats().mTrackletsFound, 1);
+
+  const auto& stats = first.getTFStats();
+  const int index = (1 * 2 + 0) * 30;
+  BOOST_CHECK_EQUAL(stats.mTrackletsFound, 4u);
+  BOOST_CHECK_EQUAL(stats.mDigitsFound, 3u);
+  BOOST_CHECK_EQUAL(stats.mLinkErrorFlag[index + 3], 0x3);
+  BOOST_CHECK_EQUAL(stats.mLinkNoData[index + 4], 2);
+  BOOST_CHECK_EQUAL(stats.mLinkWordsRead[index + 3], 50);
+  BOOST_CHECK_EQUAL(stats.mParsingErrors[TrackletDataWrongOrdering], 2);
+  BOOST_CHECK_EQUAL(stats.mParsingErrorsByLink[10 * TRDLastParsingError + TrackletDataWrongOrdering], 2u);
+  BOOST_CHECK_EQUAL(stats.mDataFormatRead[0x21], 2u);
+
+  // the merged container is left empty
+  BOOST_CHECK(second.getEventRecords().empty());
+  BOOST_CHECK_EQUAL(second.getTFStats().mTrackletsFound, 0u);
+  BOOST_CHECK_EQUAL(second.getTFStats().mParsingErrors[TrackletDataWrongOrdering], 0);
+}
+
+BOOST_AUTO_TEST_CASE(CruRawReader_threads)
+{
+  const auto linkMap = makeLinkMap();
+  const auto tf = generateTF(linkMap, 4242);
+  BOOST_REQUIRE(tf.nDigits > 0);
+
+  auto reference = makeReaders(1, linkMap);
+  runReaders(tf, reference);
+  const auto& ref = *reference[0];
+  BOOST_CHECK_EQUAL(ref.getTrackletsFound(), tf.nTracklets);
+  BOOST_CHECK_EQUAL(ref.getDigitsFound(), tf.nDigits);
+  BOOST_CHECK_EQUAL(ref.getWordsRejected(), 0);
+  const auto& parsingErrors = ref.getEventRecords().getTFStats().mParsingErrors;
+  BOOST_CHECK_EQUAL(std::accumulate(parsingErrors.begin(), parsingErrors.end(), 0), 0);
+  BOOST_CHECK(ref.getEventRecords().getEventRecords().size() > 1);
+
+  // more readers than HBFs as well
+  for (int nReaders : {2, 3, 7, int(tf.hbfs.size()) + 2}) {
+    auto readers = makeReaders(nReaders, linkMap);
+    runReaders(tf, readers);
+    checkSameOutput(*readers[0], ref);
+    for (int i = 1; i < nReaders; ++i) {
+      BOOST_CHECK(readers[i]->getEventRecords().getEventRecords().empty());
+      BOOST_CHECK_EQUAL(readers[i]->getTrackletsFound(), 0);
+    }
+  }
+}
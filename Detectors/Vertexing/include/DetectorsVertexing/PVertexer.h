@@ -121,6 +121,9 @@ class PVertexer
 
   void setPoolDumpDirectory(const std::string& d) { mPoolDumpDirectory = d; }
 
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   void printInpuTracksStatus(const VertexingInput& input) const;
 
  private:
@@ -177,6 +180,8 @@ class PVertexer
 
   o2::InteractionRecord mStartIR{0, 0}; ///< IR corresponding to the start of the TF
 
+  std::vector<std::pair<int, int>> mDBSTimeWindow; ///< [first, last) of pool tracks within mDBScanDeltaT from each track
+
   // structure for the vertex refit
   o2d::VertexBase mVtxRefitOrig{};   ///< original vertex whose tracks are refitted
   std::vector<int> mRefitTrackIDs{}; ///< dummy IDs for refitted tracks
@@ -195,6 +200,7 @@ class PVertexer
   long mLongestClusterTimeMS = 0;
   int mLongestClusterMult = 0;
   bool mPoolDumpProduced = false;
+  int mNThreads = 1;
   TStopwatch mTimeDBScan;
   TStopwatch mTimeVertexing;
   TStopwatch mTimeDebris;
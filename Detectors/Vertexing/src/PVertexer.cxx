@@ -57,9 +57,20 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
   std::vector<float> validationTimes;
   std::vector<o2::MCEventLabel> lblVtxLoc;
   mTimeVertexing.Start();
-  int cntTZ = 0;
-  for (auto tc : mTimeZClusters) {
-    size_t nnold = verticesLoc.size();
+  // TZ-clusters share no tracks, they are processed in parallel into their own buffers, which are
+  // merged in the clusters order, so that the result does not depend on the number of threads
+  int nTZClusters = mTimeZClusters.size();
+  std::vector<std::vector<PVertex>> verticesTZ(nTZClusters);
+  std::vector<std::vector<uint32_t>> trackIDsTZ(nTZClusters);
+  std::vector<std::vector<V2TRef>> v2tRefsTZ(nTZClusters);
+#ifdef _PV_DEBUG_TREE_
+  int nThreads = 1; // debug output is not thread-safe
+#else
+  int nThreads = mNThreads;
+#endif
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+  for (int itz = 0; itz < nTZClusters; itz++) {
+    auto& tc = mTimeZClusters[itz];
     VertexingInput inp;
     inp.idRange = gsl::span<int>(tc.trackIDs);
     inp.scaleSigma2 = mPVParams->iniScale2;
@@ -67,7 +78,26 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
 #ifdef _PV_DEBUG_TREE_
     doDBScanDump(inp, lblTracks);
 #endif
-    findVertices(inp, verticesLoc, trackIDs, v2tRefsLoc);
+    findVertices(inp, verticesTZ[itz], trackIDsTZ[itz], v2tRefsTZ[itz]);
+  }
+  size_t nVerticesTot = 0, nTrackIDsTot = 0;
+  for (int itz = 0; itz < nTZClusters; itz++) {
+    nVerticesTot += verticesTZ[itz].size();
+    nTrackIDsTot += trackIDsTZ[itz].size();
+  }
+  verticesLoc.reserve(nVerticesTot);
+  v2tRefsLoc.reserve(nVerticesTot);
+  trackIDs.reserve(nTrackIDsTot);
+  for (int itz = 0; itz < nTZClusters; itz++) {
+    int vtxOffset = verticesLoc.size(), trcOffset = trackIDs.size();
+    for (auto tid : trackIDsTZ[itz]) {
+      mTracksPool[tid].vtxID += vtxOffset; // vertex IDs were assigned within the cluster
+      trackIDs.push_back(tid);
+    }
+    for (const auto& ref : v2tRefsTZ[itz]) {
+      v2tRefsLoc.emplace_back(ref.getFirstEntry() + trcOffset, ref.getEntries());
+    }
+    verticesLoc.insert(verticesLoc.end(), verticesTZ[itz].begin(), verticesTZ[itz].end());
   }
   mTimeVertexing.Stop();
   // sort in time
@@ -204,19 +234,25 @@ int PVertexer::findVertices(const VertexingInput& input, std::vector<PVertex>& v
     auto clTime = tCurr - tStart;
     if (clTime > mPVParams->maxTimeMSPerCluster) {
       LOGP(warn, "Time per TZ-cluster ({}ms) of {} tracks exceeded limit after {} trials, abandon", clTime, mult, nTrials);
-      if (!mPoolDumpProduced) {
-        dumpPool();
+#pragma omp critical(PVertexer_dump)
+      {
+        if (!mPoolDumpProduced) {
+          dumpPool();
+        }
       }
       break;
     }
   }
-  mTotTrials += nTrials;
-  if (size_t(nTrials) > mMaxTrialPerCluster) {
-    mMaxTrialPerCluster = nTrials;
-  }
-  if (tCurr - tStart > mLongestClusterTimeMS) {
-    mLongestClusterTimeMS = tCurr - tStart;
-    mLongestClusterMult = mult;
+#pragma omp critical(PVertexer_stat)
+  {
+    mTotTrials += nTrials;
+    if (size_t(nTrials) > mMaxTrialPerCluster) {
+      mMaxTrialPerCluster = nTrials;
+    }
+    if (tCurr - tStart > mLongestClusterTimeMS) {
+      mLongestClusterTimeMS = tCurr - tStart;
+      mLongestClusterMult = mult;
+    }
   }
   return nfound;
 }
@@ -871,18 +907,13 @@ int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int
   if (tI.sig2ZI < mDBSMaxZ2InvCorePoint) {
     return nFound;
   }
-  int ntr = mTracksPool.size();
 
   auto procPnt = [this, &tI, &status, &cand, &nFound, id](int idN) {
-    const auto& tL = this->mTracksPool[idN];
-    if (std::abs(tI.timeEst.getTimeStamp() - tL.timeEst.getTimeStamp()) > this->mDBScanDeltaT) {
-      return -1;
-    }
     auto statN = status[idN], stat = status[id];
     if (statN >= 0 && (stat < 0 || (stat >= 0 && statN != stat))) { // do not consider as a neighbour if already added to other cluster
-      return 0;
+      return;
     }
-    auto dist2 = tL.getDist2(tI);
+    auto dist2 = this->mTracksPool[idN].getDist2(tI);
     if (dist2 < this->mPVParams->dbscanMaxDist2) {
       nFound++;
       if (statN < 0 && statN > DBS_INCHECK) { // no point in adding for check already assigned point, or which is already in the list (i.e. < INCHECK)
@@ -890,19 +921,14 @@ int PVertexer::dbscan_RangeQuery(int id, std::vector<int>& cand, std::vector<int
         status[idN] += DBS_INCHECK; // flag that the track is in the candidates list (i.e. DBS_UDEF-10 = -12 or DPB_NOISE-10 = -11).
       }
     }
-    return 1;
   };
-  int idL = id;
-  while (--idL >= 0) { // index in time decreasing direction
-    if (procPnt(idL) < 0) {
-      break;
-    }
+  // only the tracks within mDBScanDeltaT in time may be neighbours
+  const auto& win = mDBSTimeWindow[id];
+  for (int idL = id - 1; idL >= win.first; idL--) { // index in time decreasing direction
+    procPnt(idL);
   }
-  int idU = id;
-  while (++idU < ntr) { // index in time increasing direction
-    if (procPnt(idU) < 0) {
-      break;
-    }
+  for (int idU = id + 1; idU < win.second; idU++) { // index in time increasing direction
+    procPnt(idU);
   }
   return nFound;
 }
@@ -915,6 +941,22 @@ void PVertexer::dbscan_clusterize()
   std::vector<int> status(ntr, DBS_UNDEF);
   int clID = -1;
 
+  // for every track of the time-sorted pool find the range of tracks within mDBScanDeltaT in time
+  mDBSTimeWindow.resize(ntr);
+  for (int it = 0, itL = 0, itU = 0; it < ntr; it++) {
+    auto t = mTracksPool[it].timeEst.getTimeStamp();
+    while (t - mTracksPool[itL].timeEst.getTimeStamp() > mDBScanDeltaT) {
+      itL++;
+    }
+    if (itU <= it) {
+      itU = it + 1;
+    }
+    while (itU < ntr && mTracksPool[itU].timeEst.getTimeStamp() - t <= mDBScanDeltaT) {
+      itU++;
+    }
+    mDBSTimeWindow[it] = {itL, itU};
+  }
+
   std::vector<int> nbVec;
   for (int it = 0; it < ntr; it++) {
     if (status[it] != DBS_UNDEF) {
@@ -1195,6 +1237,17 @@ void PVertexer::dumpPool()
   }
   mPoolDumpProduced = true;
 }
+//______________________________________________
+void PVertexer::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  LOG(warning) << "Multithreading is not supported, imposing single thread";
+  mNThreads = 1;
+#endif
+}
+
 //______________________________________________
 int PVertexer::processFromExternalPool(const std::vector<TrackVF>& pool, std::vector<PVertex>& vertices, std::vector<o2d::VtxTrackIndex>& vertexTrackIDs, std::vector<V2TRef>& v2tRefs)
 {
@@ -11,6 +11,8 @@
 
 #include <map>
 #include <deque>
+#include <utility>
+#include <vector>
 #include <gsl/span>
 #include <TFile.h>
 #include <TTree.h>
@@ -60,6 +62,28 @@ struct DigiRecoTDC {
   o2::InteractionRecord ir;
 };
 
+/// Pedestals of an orbit
+struct DigiRecoPedestal {
+  float offset[NChannels];   /// Offset of each channel
+  uint8_t source[NChannels]; /// Source of pedestal
+};
+
+/// Samples of a signal in a sequence of consecutive bunch crossings, stored contiguously
+/// with TSL copies of the first (last) sample before (after) them, and configuration of
+/// their interpolation. Each thread uses its own instance
+struct DigiRecoSignal {
+  int nbun;  // Number of adjacent bunches
+  int nsam;  // Number of acquired samples
+  int ntot;  // Total number of points in the interpolated arrays
+  int ilast; // Index of last acquired sample
+  int nint;  // Total points in the interpolation region (-1)
+  O2_ZDC_DIGIRECO_FLT firstSample;
+  O2_ZDC_DIGIRECO_FLT lastSample;
+  std::vector<O2_ZDC_DIGIRECO_FLT> samples; // Padded samples
+  std::vector<O2_ZDC_DIGIRECO_FLT> inter;   // Interpolated points of the whole sequence
+  bool inError = false;                     // Error in the interpolation
+};
+
 class DigiReco
 {
  public:
@@ -76,6 +100,9 @@ class DigiReco
     mVerbosity = v;
   }
   int getVerbosity() const { return mVerbosity; }
+  // Number of threads processing independent sequences of bunch crossings
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
   void setDebugOutput(bool state = true)
   {
     mTreeDbg = state;
@@ -140,35 +167,39 @@ class DigiReco
 
   const uint32_t* getTDCMask() const { return mTDCMask; }
   const uint32_t* getChMask() const { return mChMask; }
+  const uint32_t* getMissingPed() const { return mMissingPed; }
   const std::vector<o2::zdc::RecEventAux>& getReco() { return mReco; }
 
  private:
-  const ModuleConfig* mModuleConfig = nullptr;              /// Trigger/readout configuration object
-  void updateOffsets(int ibun);                             /// Update offsets to process current bunch
-  void lowPassFilter();                                     /// low-pass filtering of digitized data
-  int reconstructTDC(int seq_beg, int seq_end);             /// Reconstruction of uncorrected TDCs
-  int reconstruct(int seq_beg, int seq_end);                /// Main method for data reconstruction
-  int processTrigger(int itdc, int ibeg, int iend);         /// Replay of trigger algorithm on acquired data
-  int processTriggerExtended(int itdc, int ibeg, int iend); /// Replay of trigger algorithm on acquired data
-  int interpolate(int itdc, int ibeg, int iend);            /// Interpolation of samples to evaluate signal amplitude and arrival time
-  int fullInterpolation(int itdc, int ibeg, int iend);      /// Interpolation of samples
-  void correctTDCPile();                                    /// Correction of pile-up in TDC
-  bool mLowPassFilter = true;                               /// Enable low pass filtering
-  bool mLowPassFilterSet = false;                           /// Low pass filtering set via function call
-  bool mFullInterpolation = false;                          /// Full waveform interpolation
-  bool mFullInterpolationSet = false;                       /// Full waveform interpolation set via function call
-  int mInterpolationStep = 25;                              /// Coarse interpolation step
-  bool mCorrSignal = true;                                  /// Enable TDC signal correction
-  bool mCorrSignalSet = false;                              /// TDC signal correction set via function call
-  bool mCorrBackground = true;                              /// Enable TDC pile-up correction
-  bool mCorrBackgroundSet = false;                          /// TDC pile-up correction set via function call
-  bool mInError = false;                                    /// ZDC reconstruction ends in error
+  const ModuleConfig* mModuleConfig = nullptr;                                   /// Trigger/readout configuration object
+  int findSequences();                                                           /// Find sequences of consecutive bunch crossings
+  void preparePedestals();                                                       /// Pedestals of the orbits in the time frame
+  void lowPassFilter();                                                          /// low-pass filtering of digitized data
+  int reconstructTDC(int seq_beg, int seq_end, DigiRecoSignal& sig);             /// Reconstruction of uncorrected TDCs
+  int reconstruct(int seq_beg, int seq_end);                                     /// Main method for data reconstruction
+  int processTrigger(int itdc, int ibeg, int iend, DigiRecoSignal& sig);         /// Replay of trigger algorithm on acquired data
+  int processTriggerExtended(int itdc, int ibeg, int iend, DigiRecoSignal& sig); /// Replay of trigger algorithm on acquired data
+  int interpolate(int itdc, int ibeg, int iend, DigiRecoSignal& sig);            /// Interpolation of samples to evaluate signal amplitude and arrival time
+  int fullInterpolation(int isig, int ibeg, int iend, DigiRecoSignal& sig);      /// Interpolation of samples
+  void correctTDCPile();                                                         /// Correction of pile-up in TDC
+  bool mLowPassFilter = true;                                                    /// Enable low pass filtering
+  bool mLowPassFilterSet = false;                                                /// Low pass filtering set via function call
+  bool mFullInterpolation = false;                                               /// Full waveform interpolation
+  bool mFullInterpolationSet = false;                                            /// Full waveform interpolation set via function call
+  int mInterpolationStep = 25;                                                   /// Coarse interpolation step
+  bool mCorrSignal = true;                                                       /// Enable TDC signal correction
+  bool mCorrSignalSet = false;                                                   /// TDC signal correction set via function call
+  bool mCorrBackground = true;                                                   /// Enable TDC pile-up correction
+  bool mCorrBackgroundSet = false;                                               /// TDC pile-up correction set via function call
+  bool mInError = false;                                                         /// ZDC reconstruction ends in error
 
   int correctTDCSignal(int itdc, int16_t TDCVal, float TDCAmp, float& fTDCVal, float& fTDCAmp, bool isbeg, bool isend); /// Correct TDC single signal
   int correctTDCBackground(int ibc, int itdc, std::deque<DigiRecoTDC>& tdc);                                            /// TDC amplitude and time corrections due to pile-up from previous bunches
 
-  O2_ZDC_DIGIRECO_FLT getPoint(int itdc, int ibeg, int iend, int i); /// Interpolation for current TDC
-  void setPoint(int itdc, int ibeg, int iend, int i);                /// Interpolation for current TDC
+  int prepareSignal(int isig, int ibeg, int iend, DigiRecoSignal& sig); /// Copy samples to be interpolated
+  O2_ZDC_DIGIRECO_FLT getPoint(int isig, int i, DigiRecoSignal& sig);   /// Interpolation for current signal
+  void setPoints(int isig, int ibeg, int iend, DigiRecoSignal& sig);    /// Interpolation of all points for current signal
+  const DigiRecoPedestal& getPedestal(int ibun) const { return mPedestal[mBCPedestal[ibun]]; }
 
   void assignTDC(int ibun, int ibeg, int iend, int itdc, int tdc, float amp); /// Set reconstructed TDC values
   void findSignals(int ibeg, int iend);                                       /// Find signals around main-main that satisfy condition on TDC
@@ -186,7 +217,11 @@ class DigiReco
   uint32_t mChMask[NChannels] = {0};             /// Identify all channels in readout pattern
   const RecoConfigZDC* mRecoConfigZDC = nullptr; /// CCDB configuration parameters
   int32_t mVerbosity = DbgMinimal;
+  int mNThreads = 1;                                /// Number of threads
   O2_ZDC_DIGIRECO_FLT mTS[NTS];                     /// Tapered sinc function
+  static constexpr int mNTSW = 2 * TSL;             /// Number of samples contributing to an interpolated point
+  O2_ZDC_DIGIRECO_FLT mTSW[mNTSW][TSN];             /// Tapered sinc function for each sample and position of the point
+  O2_ZDC_DIGIRECO_FLT mTSWSum[TSN];                 /// Normalization for each position of the point
   bool mTreeDbg = false;                            /// Write reconstructed data in debug output file
   std::unique_ptr<TFile> mDbg = nullptr;            /// Debug output file
   std::unique_ptr<TTree> mTDbg = nullptr;           /// Debug tree
@@ -195,9 +230,11 @@ class DigiReco
   gsl::span<const o2::zdc::ChannelData> mChData;    /// Payload
   std::vector<o2::zdc::RecEventAux> mReco;          /// Reconstructed data
   std::map<uint32_t, int> mOrbit;                   /// Information about orbit
-  float mOffset[NChannels];                         /// Offset in current orbit
-  uint32_t mOffsetOrbit = 0xffffffff;               /// Current orbit
-  uint8_t mSource[NChannels];                       /// Source of pedestal
+  std::vector<DigiRecoPedestal> mPedestal;          /// Pedestals of the orbits in the time frame
+  std::vector<int> mBCPedestal;                     /// Pedestals for each bunch crossing
+  std::vector<std::pair<int, int>> mSequences;      /// Sequences of consecutive bunch crossings
+  std::vector<int> mSeqStatus;                      /// Return value of the processing of each sequence
+  std::vector<DigiRecoSignal> mSignal;              /// Interpolation buffers for each thread
   static constexpr int mNSB = TSN * NTimeBinsPerBC; /// Total number of interpolated points per bunch crossing
   RecEventAux mRec;                                 /// Debug reconstruction event
   int mNBC = 0;
@@ -209,14 +246,6 @@ class DigiReco
   float tdc_calib[NTDCChannels] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}; /// TDC correction factor
   constexpr static uint16_t mMask[NTimeBinsPerBC] = {0x0001, 0x002, 0x004, 0x008, 0x0010, 0x0020, 0x0040, 0x0080, 0x0100, 0x0200, 0x0400, 0x0800};
   O2_ZDC_DIGIRECO_FLT mAlpha = 3; // Parameter of interpolation function
-  // Configuration of interpolation for current TDC
-  int mNbun;  // Number of adjacent bunches
-  int mNsam;  // Number of acquired samples
-  int mNtot;  // Total number of points in the interpolated arrays
-  int mIlast; // Index of last acquired sample
-  int mNint;  // Total points in the interpolation region (-1)
-  O2_ZDC_DIGIRECO_FLT mFirstSample;
-  O2_ZDC_DIGIRECO_FLT mLastSample;
 };
 } // namespace zdc
 } // namespace o2
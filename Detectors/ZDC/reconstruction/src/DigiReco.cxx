@@ -10,10 +10,15 @@
 // or submit itself to any jurisdiction.
 
 #include <TMath.h>
+#include <algorithm>
 #include "Framework/Logger.h"
 #include "ZDCReconstruction/DigiReco.h"
 #include "ZDCReconstruction/RecoParamZDC.h"
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 namespace o2
 {
 namespace zdc
@@ -336,6 +341,17 @@ void DigiReco::init()
   }
 } // init
 
+void DigiReco::setNThreads(int n)
+{
+  mNThreads = n > 0 ? n : 1;
+#ifndef WITH_OPENMP
+  if (mNThreads > 1) {
+    LOG(warn) << "Multiple threads requested, but OpenMP is not available. Using a single thread";
+    mNThreads = 1;
+  }
+#endif
+}
+
 void DigiReco::eor()
 {
   if (mTreeDbg) {
@@ -386,6 +402,16 @@ void DigiReco::prepareInterpolation()
     mTS[n + tsi] = fs * fg;
     mTS[n - tsi] = mTS[n + tsi]; // Function is even
   }
+  // Rearrangement of the function for the interpolation: the point at position im after
+  // an acquired sample is the weighted sum of the mNTSW samples around it, with weights
+  // mTSW[j][im] contiguous in im and normalization mTSWSum[im]
+  for (int im = 0; im < TSN; im++) {
+    mTSWSum[im] = 0;
+    for (int j = 0; j < mNTSW; j++) {
+      mTSW[j][im] = mTS[(j + 1) * TSN - im];
+      mTSWSum[im] += mTSW[j][im];
+    }
+  }
   LOG(info) << "Interpolation numeric precision is " << sizeof(O2_ZDC_DIGIRECO_FLT);
   LOG(info) << "Interpolation alpha = " << mAlpha;
 }
@@ -484,6 +510,9 @@ int DigiReco::process(const gsl::span<const o2::zdc::OrbitData>& orbitdata, cons
     }
   }
 
+  // Pedestals of the orbits in the time frame
+  preparePedestals();
+
   // Low pass filtering
   if (mLowPassFilter) {
     // N.B. At the moment low pass filtering is performed only on TDC
@@ -523,23 +552,113 @@ int DigiReco::process(const gsl::span<const o2::zdc::OrbitData>& orbitdata, cons
     }
   }
 
+  if (mVerbosity > DbgMinimal) {
+    LOG(info) << "Processing ZDC reconstruction for " << mNBC << " bunch crossings";
+  }
+  int rval = findSequences();
+  if (rval != 0) {
+    return rval;
+  }
+
+  // The sequences of consecutive bunch crossings are independent and are processed
+  // in parallel, each thread with its own interpolation buffers
+  int nseq = mSequences.size();
+  mSignal.resize(mNThreads);
+  for (auto& sig : mSignal) {
+    sig.inError = false;
+  }
+  mSeqStatus.assign(nseq, 0);
+
+  // TDC reconstruction
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iseq = 0; iseq < nseq; iseq++) {
+    int ithread = 0;
+#ifdef WITH_OPENMP
+    ithread = omp_get_thread_num();
+#endif
+    mSeqStatus[iseq] = reconstructTDC(mSequences[iseq].first, mSequences[iseq].second, mSignal[ithread]);
+  }
+  for (auto& sig : mSignal) {
+    if (sig.inError) {
+      mInError = true;
+    }
+  }
+  for (int iseq = 0; iseq < nseq; iseq++) {
+    if (mSeqStatus[iseq] != 0) {
+      return mSeqStatus[iseq];
+    }
+  }
+
+  // Apply pile-up correction for TDCs to get corrected TDC amplitudes and values
+  correctTDCPile();
+
+  // ADC reconstruction
+  for (auto& seq : mSequences) {
+    if (seq.first == seq.second) {
+      // Cannot reconstruct lonely bunch
+      // LOG(info) << "Lonely bunch " << mReco[seq.first].ir.orbit << "." << mReco[seq.first].ir.bc;
+      mNLonely++;
+      mLonely[mReco[seq.first].ir.bc]++;
+      if (mBCData[seq.first].triggers != 0x0) {
+        mLonelyTrig[mReco[seq.first].ir.bc]++;
+      }
+    }
+  }
+  // After pile-up correction, find signals around main-main that satisfy condition on TDC.
+  // This is done for all the sequences before the reconstruction of the energies, which
+  // looks also at the bunch crossings preceding the sequence
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iseq = 0; iseq < nseq; iseq++) {
+    if (mSequences[iseq].first != mSequences[iseq].second) {
+      findSignals(mSequences[iseq].first, mSequences[iseq].second);
+    }
+  }
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int iseq = 0; iseq < nseq; iseq++) {
+    if (mSequences[iseq].first != mSequences[iseq].second) {
+      mSeqStatus[iseq] = reconstruct(mSequences[iseq].first, mSequences[iseq].second);
+    }
+  }
+  for (int iseq = 0; iseq < nseq; iseq++) {
+    if (mSeqStatus[iseq] != 0) {
+      return mSeqStatus[iseq];
+    }
+  }
+
+  if (mTreeDbg) {
+    for (auto& seq : mSequences) {
+      if (seq.first != seq.second) {
+        for (int ibun = seq.first; ibun <= seq.second; ibun++) {
+          mRec = mReco[ibun];
+          mTDbg->Fill();
+        }
+      }
+    }
+  }
+  return 0;
+} // process
+
+int DigiReco::findSequences()
+{
   // Find consecutive bunch crossings by taking into account just the presence
   // of bunch crossing data and then perform signal interpolation in the identified ranges.
   // With this definition of "consecutive" bunch crossings gaps in the sample data
   // may be present, therefore in the reconstruction method we take into account for signals
   // that do not span the entire range
+  mSequences.clear();
   int seq_beg = 0;
   int seq_end = 0;
-  if (mVerbosity > DbgMinimal) {
-    LOG(info) << "Processing ZDC reconstruction for " << mNBC << " bunch crossings";
-  }
-
-  // TDC reconstruction
   for (int ibc = 0; ibc < mNBC; ibc++) {
     auto& ir = mBCData[seq_end].ir;
     auto bcd = mBCData[ibc].ir.differenceInBC(ir);
     if (bcd < 0) {
-      LOG(error) << "Bunch order error in TDC reconstruction";
+      LOG(error) << "Bunch order error in ZDC reconstruction";
       for (int ibcdump = 0; ibcdump < mNBC; ibcdump++) {
         LOG(error) << "mBCData[" << ibcdump << "] @ " << mBCData[ibcdump].ir.orbit << "." << mBCData[ibcdump].ir.bc;
       }
@@ -547,21 +666,13 @@ int DigiReco::process(const gsl::span<const o2::zdc::OrbitData>& orbitdata, cons
       return __LINE__;
     } else if (bcd > 1) {
       // Detected a gap
-      int rval = reconstructTDC(seq_beg, seq_end);
-      if (rval) {
-        return rval;
-      }
-
+      mSequences.emplace_back(seq_beg, seq_end);
       seq_beg = ibc;
       seq_end = ibc;
     } else if (ibc == (mNBC - 1)) {
       // Last bunch
       seq_end = ibc;
-      int rval = reconstructTDC(seq_beg, seq_end);
-      if (rval) {
-        return rval;
-      }
-
+      mSequences.emplace_back(seq_beg, seq_end);
       seq_beg = mNBC;
       seq_end = mNBC;
     } else {
@@ -573,47 +684,71 @@ int DigiReco::process(const gsl::span<const o2::zdc::OrbitData>& orbitdata, cons
     mBCData[ibc].print(mTriggerMask);
 #endif
   }
+  return 0;
+} // findSequences
 
-  // Apply pile-up correction for TDCs to get corrected TDC amplitudes and values
-  correctTDCPile();
-
-  // ADC reconstruction
-  seq_beg = 0;
-  seq_end = 0;
+void DigiReco::preparePedestals()
+{
+  // Pedestals are looked up once for each orbit, so that the bunch crossings can be processed
+  // in any order
+  mPedestal.clear();
+  mBCPedestal.resize(mNBC);
   for (int ibc = 0; ibc < mNBC; ibc++) {
-    auto& ir = mBCData[seq_end].ir;
-    auto bcd = mBCData[ibc].ir.differenceInBC(ir);
-    if (bcd < 0) {
-      LOG(error) << "Bunch order error in ADC reconstruction";
-      for (int ibcdump = 0; ibcdump < mNBC; ibcdump++) {
-        LOG(error) << "mBCData[" << ibcdump << "] @ " << mBCData[ibcdump].ir.orbit << "." << mBCData[ibcdump].ir.bc;
+    auto orbit = mBCData[ibc].ir.orbit;
+    if (ibc > 0 && orbit == mBCData[ibc - 1].ir.orbit) {
+      mBCPedestal[ibc] = mBCPedestal[ibc - 1];
+      continue;
+    }
+    mBCPedestal[ibc] = mPedestal.size();
+    auto& ped = mPedestal.emplace_back();
+
+    // Reset information about pedestal origin
+    for (int ich = 0; ich < NChannels; ich++) {
+      ped.source[ich] = PedND;
+      ped.offset[ich] = std::numeric_limits<float>::infinity();
+    }
+
+    // Default TDC pedestal is from orbit
+    // Look for Orbit pedestal offset
+    std::map<uint32_t, int>::iterator it = mOrbit.find(orbit);
+    if (it != mOrbit.end()) {
+      auto& orbitdata = mOrbitData[it->second];
+      for (int ich = 0; ich < NChannels; ich++) {
+        auto myped = float(orbitdata.data[ich]) * mModuleConfig->baselineFactor;
+        if (myped >= ADCMin && myped <= ADCMax) {
+          // Pedestal information is present for this channel
+          ped.offset[ich] = myped;
+          ped.source[ich] = PedOr;
+        }
       }
-      LOG(error) << "Orbit number is not increasing " << mBCData[seq_end].ir.orbit << "." << mBCData[seq_end].ir.bc << " followed by " << mBCData[ibc].ir.orbit << "." << mBCData[ibc].ir.bc;
-      return __LINE__;
-    } else if (bcd > 1) {
-      // Detected a gap
-      int rval = reconstruct(seq_beg, seq_end);
-      if (rval != 0) {
-        return rval;
+    }
+
+    // Use average "QC" pedestal if orbit pedestals are missing
+    if (mPedParam != nullptr) {
+      for (int ich = 0; ich < NChannels; ich++) {
+        if (ped.source[ich] == PedND) {
+          auto myped = mPedParam->getCalib(ich);
+          if (myped >= ADCMin && myped <= ADCMax) {
+            ped.offset[ich] = myped;
+            ped.source[ich] = PedQC;
+          }
+        }
       }
-      seq_beg = ibc;
-      seq_end = ibc;
-    } else if (ibc == (mNBC - 1)) {
-      // Last bunch
-      seq_end = ibc;
-      int rval = reconstruct(seq_beg, seq_end);
-      if (rval != 0) {
-        return rval;
+    }
+
+    for (int ich = 0; ich < NChannels; ich++) {
+      if (ped.source[ich] == PedND) {
+        mMissingPed[ich]++;
+        if (mVerbosity > DbgMinimal) {
+          LOGF(error, "Missing pedestal for ch %2d %s orbit %u ", ich, ChannelNames[ich], orbit);
+        }
       }
-      seq_beg = mNBC;
-      seq_end = mNBC;
-    } else {
-      // Look for another bunch
-      seq_end = ibc;
+#ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
+      LOGF(info, "Pedestal for ch %2d %s orbit %u %s: %f", ich, ChannelNames[ich], orbit, ped.source[ich] == PedOr ? "OR" : (ped.source[ich] == PedQC ? "QC" : "??"), ped.offset[ich]);
+#endif
     }
   }
-  return 0;
-} // process
+} // preparePedestals
 
 void DigiReco::lowPassFilter()
 {
@@ -625,9 +760,13 @@ void DigiReco::lowPassFilter()
   LOG(info) << __func__;
 #endif
   constexpr int MaxTimeBin = NTimeBinsPerBC - 1;
-  for (int itdc = 0; itdc < NTDCChannels; itdc++) {
-    auto isig = TDCSignal[itdc];
-    for (int ibc = 0; ibc < mNBC; ibc++) {
+  // Bunch crossings are independent
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNThreads)
+#endif
+  for (int ibc = 0; ibc < mNBC; ibc++) {
+    for (int itdc = 0; itdc < NTDCChannels; itdc++) {
+      auto isig = TDCSignal[itdc];
       // Indexes of current, previous and next recorded bunch crossings
       auto ref_c = mReco[ibc].ref[isig];
       uint32_t ref_p = ZDCRefInitVal;
@@ -643,53 +782,29 @@ void DigiReco::lowPassFilter()
         bcd_n = mReco[ibc + 1].ir.differenceInBC(mReco[ibc].ir); // b.c. number of (ibc+1) -  b.c. number (ibc)
       }
       if (ref_c != ZDCRefInitVal) { // Should always be true
+        // Samples of the bunch crossing with the last sample of previous bunch crossing and the first
+        // sample of next one. As a backup we count twice the first (last) sample
+        int32_t sam[NTimeBinsPerBC + 2];
+        sam[0] = (ref_p != ZDCRefInitVal && bcd_p == 1) ? mChData[ref_p].data[MaxTimeBin] : mChData[ref_c].data[0];
         for (int is = 0; is < NTimeBinsPerBC; is++) {
-          int32_t sum = mChData[ref_c].data[is];
-          if (is == 0) {
-            sum += mChData[ref_c].data[1];
-            if (ref_p != ZDCRefInitVal && bcd_p == 1) {
-              // Add last sample of previous bunch crossing
-              sum += mChData[ref_p].data[MaxTimeBin];
-            } else {
-              // As a backup we count twice the first sample
-              sum += mChData[ref_c].data[0];
-            }
-          } else if (is == MaxTimeBin) {
-            sum += mChData[ref_c].data[MaxTimeBin - 1];
-            if (ref_n != ZDCRefInitVal && bcd_n == 1) {
-              // Add first sample of next bunch crossing
-              sum += mChData[ref_n].data[0];
-            } else {
-              // As a backup we count twice the last sample
-              sum += mChData[ref_c].data[MaxTimeBin];
-            }
-          } else {
-            // Not on the bunch boundary
-            sum += mChData[ref_c].data[is - 1];
-            sum += mChData[ref_c].data[is + 1];
-          }
-          // Make the average taking into account rounding and sign
-          bool isNegative = sum < 0;
-          if (isNegative) {
-            sum = -sum;
-          }
-          auto mod = sum % 3;
-          sum = sum / 3;
-          if (mod == 2) {
-            sum++;
-          }
-          if (isNegative) {
-            sum = -sum;
-          }
+          sam[is + 1] = mChData[ref_c].data[is];
+        }
+        sam[NTimeBinsPerBC + 1] = (ref_n != ZDCRefInitVal && bcd_n == 1) ? mChData[ref_n].data[0] : mChData[ref_c].data[MaxTimeBin];
+        auto& data = mReco[ibc].data[isig];
+        for (int is = 0; is < NTimeBinsPerBC; is++) {
+          int32_t sum = sam[is] + sam[is + 1] + sam[is + 2];
+          // Make the average taking into account rounding and sign: a remainder of 2
+          // is rounded up in absolute value
+          int32_t avg = (std::abs(sum) + 1) / 3;
           // Store filtered values
-          mReco[ibc].data[isig][is] = sum;
+          data[is] = sum < 0 ? -avg : avg;
         }
       }
     }
   }
 }
 
-int DigiReco::reconstructTDC(int ibeg, int iend)
+int DigiReco::reconstructTDC(int ibeg, int iend, DigiRecoSignal& sig)
 {
 #ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
   LOG(info) << "________________________________________________________________________________";
@@ -714,9 +829,9 @@ int DigiReco::reconstructTDC(int ibeg, int iend)
           // Need data for at least two consecutive bunch crossings
           int rval = 0;
           if (mRecoConfigZDC->extendedSearch) {
-            rval = processTriggerExtended(itdc, istart, istop);
+            rval = processTriggerExtended(itdc, istart, istop, sig);
           } else {
-            rval = processTrigger(itdc, istart, istop);
+            rval = processTrigger(itdc, istart, istop, sig);
           }
           if (rval) {
             return rval;
@@ -730,9 +845,9 @@ int DigiReco::reconstructTDC(int ibeg, int iend)
     if (istart >= 0 && (istop - istart) > 0) {
       int rval = 0;
       if (mRecoConfigZDC->extendedSearch) {
-        rval = processTriggerExtended(itdc, istart, istop);
+        rval = processTriggerExtended(itdc, istart, istop, sig);
       } else {
-        rval = processTrigger(itdc, istart, istop);
+        rval = processTrigger(itdc, istart, istop, sig);
       }
       if (rval) {
         return rval;
@@ -767,7 +882,7 @@ int DigiReco::reconstructTDC(int ibeg, int iend)
           // A gap is detected
           if (istart >= 0 && (istop - istart) > 0) {
             // Need data for at least two consecutive bunch crossings
-            int rval = fullInterpolation(isig, istart, istop);
+            int rval = fullInterpolation(isig, istart, istop, sig);
             if (rval) {
               return rval;
             }
@@ -778,7 +893,7 @@ int DigiReco::reconstructTDC(int ibeg, int iend)
       }
       // Check if there are consecutive bunch crossings at the end of group
       if (istart >= 0 && (istop - istart) > 0) {
-        int rval = fullInterpolation(isig, istart, istop);
+        int rval = fullInterpolation(isig, istart, istop, sig);
         if (rval) {
           return rval;
         }
@@ -794,17 +909,7 @@ int DigiReco::reconstruct(int ibeg, int iend)
   LOG(info) << "________________________________________________________________________________";
   LOG(info) << __func__ << "(" << ibeg << ", " << iend << "): " << mReco[ibeg].ir.orbit << "." << mReco[ibeg].ir.bc << " - " << mReco[iend].ir.orbit << "." << mReco[iend].ir.bc;
 #endif
-  // Process consecutive BCs
-  if (ibeg == iend) {
-    mNLonely++;
-    mLonely[mReco[ibeg].ir.bc]++;
-    if (mBCData[ibeg].triggers != 0x0) {
-      mLonelyTrig[mReco[ibeg].ir.bc]++;
-    }
-    // Cannot reconstruct lonely bunch
-    // LOG(info) << "Lonely bunch " << mReco[ibeg].ir.orbit << "." << mReco[ibeg].ir.bc;
-    return 0;
-  }
+  // Process consecutive BCs (lonely bunches are not reconstructed)
 #ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
   for (int ibun = ibeg; ibun <= iend; ibun++) {
     printf("%d CH Mask: 0x%08x TDC data for:", ibun, mBCData[ibun].channels);
@@ -819,9 +924,6 @@ int DigiReco::reconstruct(int ibeg, int iend)
   }
 #endif
 
-  // After pile-up correction, find signals around main-main that satisfy condition on TDC
-  findSignals(ibeg, iend);
-
   // For each calorimeter that has detects a collision at the time of main-main
   // collisions we reconstruct integrated charges and fill output tree
   for (int ich = 0; ich < NChannels; ich++) {
@@ -877,7 +979,7 @@ int DigiReco::reconstruct(int ibeg, int iend)
     }
     // Analyze all bunches
     for (int ibun = ibeg; ibun <= iend; ibun++) {
-      updateOffsets(ibun); // Get Orbit pedestals
+      auto& ped = getPedestal(ibun); // Get Orbit pedestals
       auto& rec = mReco[ibun];
       // Check if the corresponding TDC is fired
       ref[0] = mReco[ibun].ref[ich];
@@ -916,8 +1018,8 @@ int DigiReco::reconstruct(int ibeg, int iend)
           // (reference can be orbit or QC). If pile-up is detected we use orbit pedestal
           // instead of event pedestal
           // TODO: pedestal event could have a TM..
-          if (hasEvPed && (mSource[ich] == PedOr || mSource[ich] == PedQC)) {
-            auto pedref = mOffset[ich];
+          if (hasEvPed && (ped.source[ich] == PedOr || ped.source[ich] == PedQC)) {
+            auto pedref = ped.offset[ich];
             if (evPed > pedref && (evPed - pedref) > mRopt->ped_thr_hi[ich]) {
               // Anomalous offset (put a warning but use event pedestal)
               rec.offPed[ich] = true;
@@ -931,11 +1033,11 @@ int DigiReco::reconstruct(int ibeg, int iend)
           if (hasEvPed && rec.pilePed[ich] == false) {
             myPed = evPed;
             rec.adcPedEv[ich] = true;
-          } else if (mSource[ich] == PedOr) {
-            myPed = mOffset[ich];
+          } else if (ped.source[ich] == PedOr) {
+            myPed = ped.offset[ich];
             rec.adcPedOr[ich] = true;
-          } else if (mSource[ich] == PedQC) {
-            myPed = mOffset[ich];
+          } else if (ped.source[ich] == PedQC) {
+            myPed = ped.offset[ich];
             rec.adcPedQC[ich] = true;
           } else {
             rec.adcPedMissing[ich] = true;
@@ -981,72 +1083,10 @@ int DigiReco::reconstruct(int ibeg, int iend)
       }
     } // Loop on bunches
   }   // Loop on channels
-  if (mTreeDbg) {
-    for (int ibun = ibeg; ibun <= iend; ibun++) {
-      auto& rec = mReco[ibun];
-      mRec = rec;
-      mTDbg->Fill();
-    }
-  }
   return 0;
 } // reconstruct
 
-void DigiReco::updateOffsets(int ibun)
-{
-  auto orbit = mBCData[ibun].ir.orbit;
-  if (orbit == mOffsetOrbit) {
-    return;
-  }
-  mOffsetOrbit = orbit;
-
-  // Reset information about pedestal origin
-  for (int ich = 0; ich < NChannels; ich++) {
-    mSource[ich] = PedND;
-    mOffset[ich] = std::numeric_limits<float>::infinity();
-  }
-
-  // Default TDC pedestal is from orbit
-  // Look for Orbit pedestal offset
-  std::map<uint32_t, int>::iterator it = mOrbit.find(orbit);
-  if (it != mOrbit.end()) {
-    auto& orbitdata = mOrbitData[it->second];
-    for (int ich = 0; ich < NChannels; ich++) {
-      auto myped = float(orbitdata.data[ich]) * mModuleConfig->baselineFactor;
-      if (myped >= ADCMin && myped <= ADCMax) {
-        // Pedestal information is present for this channel
-        mOffset[ich] = myped;
-        mSource[ich] = PedOr;
-      }
-    }
-  }
-
-  // Use average "QC" pedestal if orbit pedestals are missing
-  if (mPedParam != nullptr) {
-    for (int ich = 0; ich < NChannels; ich++) {
-      if (mSource[ich] == PedND) {
-        auto myped = mPedParam->getCalib(ich);
-        if (myped >= ADCMin && myped <= ADCMax) {
-          mOffset[ich] = myped;
-          mSource[ich] = PedQC;
-        }
-      }
-    }
-  }
-
-  for (int ich = 0; ich < NChannels; ich++) {
-    if (mSource[ich] == PedND) {
-      mMissingPed[ich]++;
-      if (mVerbosity > DbgMinimal) {
-        LOGF(error, "Missing pedestal for ch %2d %s orbit %u ", ich, ChannelNames[ich], mOffsetOrbit);
-      }
-    }
-#ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
-    LOGF(info, "Pedestal for ch %2d %s orbit %u %s: %f", ich, ChannelNames[ich], mOffsetOrbit, mSource[ich] == PedOr ? "OR" : (mSource[ich] == PedQC ? "QC" : "??"), mOffset[ich]);
-#endif
-  }
-} // updateOffsets
-
-int DigiReco::processTrigger(int itdc, int ibeg, int iend)
+int DigiReco::processTrigger(int itdc, int ibeg, int iend, DigiRecoSignal& sig)
 {
 #ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
   LOG(info) << __func__ << "(itdc=" << itdc << "[" << ChannelNames[TDCSignal[itdc]] << "], " << ibeg << ", " << iend << "): " << mReco[ibeg].ir.orbit << "." << mReco[ibeg].ir.bc << " - " << mReco[iend].ir.orbit << "." << mReco[iend].ir.bc;
@@ -1138,10 +1178,10 @@ int DigiReco::processTrigger(int itdc, int ibeg, int iend)
       break;
     }
   }
-  return interpolate(itdc, ibeg, iend);
+  return interpolate(itdc, ibeg, iend, sig);
 } // processTrigger
 
-int DigiReco::processTriggerExtended(int itdc, int ibeg, int iend)
+int DigiReco::processTriggerExtended(int itdc, int ibeg, int iend, DigiRecoSignal& sig)
 {
   auto isig = TDCSignal[itdc];
 #ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
@@ -1149,13 +1189,13 @@ int DigiReco::processTriggerExtended(int itdc, int ibeg, int iend)
 #endif
   // Extends search zone at the beginning of sequence. Need pedestal information.
   // For simplicity we use information for current bunch/orbit
-  updateOffsets(ibeg);
-  if (mSource[isig] == PedND) {
+  auto& ped = getPedestal(ibeg);
+  if (ped.source[isig] == PedND) {
     // Fall back to normal trigger
     // Message will be produced when computing amplitude (if a hit is found in this bunch)
     // In this framework we have a potential undetected inefficiency, however pedestal
     // problem is a serious problem and will be noticed anyway
-    return processTrigger(itdc, ibeg, iend);
+    return processTrigger(itdc, ibeg, iend, sig);
   }
 
   int nbun = iend - ibeg + 1;
@@ -1191,9 +1231,9 @@ int DigiReco::processTriggerExtended(int itdc, int ibeg, int iend)
         LOG(error) << __func__ << " @ " << __LINE__ << " Missing information for bunch crossing " << mReco[b2].ir.orbit << "." << mReco[b2].ir.bc << " sig = " << isig;
         return __LINE__;
       }
-      diff = mOffset[isig] - mChData[ref_s].data[s2];
+      diff = ped.offset[isig] - mChData[ref_s].data[s2];
 #ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
-      m[0] = mOffset[isig];
+      m[0] = ped.offset[isig];
       s[0] = mChData[ref_s].data[s2];
 #endif
     } else {
@@ -1251,71 +1291,87 @@ int DigiReco::processTriggerExtended(int itdc, int ibeg, int iend)
       break;
     }
   }
-  return interpolate(itdc, ibeg, iend);
+  return interpolate(itdc, ibeg, iend, sig);
 } // processTrigger
 
+int DigiReco::prepareSignal(int isig, int ibeg, int iend, DigiRecoSignal& sig)
+{
+  // Copy of the samples of signal isig, in consecutive bunches from ibeg to iend, for the interpolation
+  constexpr int MaxTimeBin = NTimeBinsPerBC - 1; //< number of samples per BC
+
+  // Set data members for interpolation of the current signal
+  sig.nbun = iend - ibeg + 1;                       // Number of adjacent bunches
+  sig.nsam = sig.nbun * NTimeBinsPerBC;             // Number of acquired samples
+  sig.ntot = sig.nsam * TSN;                        // Total number of points in the interpolated arrays
+  sig.nint = (sig.nbun * NTimeBinsPerBC - 1) * TSN; // Total points in the interpolation region (-1)
+  sig.ilast = sig.ntot - TSNH;                      // Index of last acquired sample
+
+  // At this level there should be no need to check if the channel is connected
+  // since a fatal should have been raised already
+  for (int ibun = ibeg; ibun <= iend; ibun++) {
+    auto ref = mReco[ibun].ref[isig];
+    if (ref == ZDCRefInitVal) {
+      LOG(error) << __func__ << " @ " << __LINE__ << " Missing information for bunch crossing " << mReco[ibun].ir.orbit << "." << mReco[ibun].ir.bc << " sig = " << isig;
+      return __LINE__;
+    }
+  }
+
+  // auto ref_beg = mReco[ibeg].ref[isig];
+  // auto ref_end = mReco[iend].ref[isig];
+  // sig.firstSample = mChData[ref_beg].data[0]; // Original points
+  // sig.lastSample = mChData[ref_end].data[MaxTimeBin]; // Original points
+
+  sig.firstSample = mReco[ibeg].data[isig][0];
+  sig.lastSample = mReco[iend].data[isig][MaxTimeBin];
+
+  // Filtered samples are stored contiguously, with TSL copies of the first (last) sample
+  // before (after) them so that the points near the extremes need no special treatment
+  sig.samples.resize(sig.nsam + 2 * TSL);
+  auto* sam = sig.samples.data();
+  std::fill(sam, sam + TSL, sig.firstSample);
+  for (int ibun = ibeg; ibun <= iend; ibun++) {
+    auto& data = mReco[ibun].data[isig];
+    std::copy(data.begin(), data.end(), sam + TSL + (ibun - ibeg) * NTimeBinsPerBC);
+  }
+  std::fill(sam + TSL + sig.nsam, sam + 2 * TSL + sig.nsam, sig.lastSample);
+  return 0;
+} // prepareSignal
+
 // Interpolation for single point
-O2_ZDC_DIGIRECO_FLT DigiReco::getPoint(int isig, int ibeg, int iend, int i)
+O2_ZDC_DIGIRECO_FLT DigiReco::getPoint(int isig, int i, DigiRecoSignal& sig)
 {
-  constexpr int nsbun = TSN * NTimeBinsPerBC; // Total number of interpolated points per bunch crossing
-  if (i >= mNtot || i < 0) {
-    LOG(error) << "Error addressing isig=" << isig << " i=" << i << " mNtot=" << mNtot;
-    mInError = true;
+  if (i >= sig.ntot || i < 0) {
+    LOG(error) << "Error addressing isig=" << isig << " i=" << i << " ntot=" << sig.ntot;
+    sig.inError = true;
     return std::numeric_limits<float>::infinity();
   }
   // Constant extrapolation at the beginning and at the end of the array
   if (i < TSNH) {
     // Return value of first sample
-    return mFirstSample;
-  } else if (i >= mIlast) {
+    return sig.firstSample;
+  } else if (i >= sig.ilast) {
     // Return value of last sample
-    return mLastSample;
-  } else {
-    // Identification of the point to be assigned
-    int ibun = ibeg + i / nsbun;
-    // Interpolation between acquired points (N.B. from 0 to mNint)
-    i = i - TSNH;
-    int im = i % TSN;
-    if (im == 0) {
-      // This is an acquired point
-      int ip = (i / TSN) % NTimeBinsPerBC;
-      int ib = ibeg + (i / TSN) / NTimeBinsPerBC;
-      if (ib != ibun) {
-        LOG(error) << "ib=" << ib << " ibun=" << ibun;
-        mInError = true;
-        return std::numeric_limits<float>::infinity();
-      }
-      return mReco[ibun].data[isig][ip]; // Filtered point
-      // return mChData[mReco[ibun].ref[isig]].data[ip]; // Original point
-    } else {
-      // Do the actual interpolation
-      O2_ZDC_DIGIRECO_FLT y = 0;
-      int ip = i / TSN;
-      O2_ZDC_DIGIRECO_FLT sum = 0;
-      for (int is = TSN - im, ii = ip - TSL + 1; is < NTS; is += TSN, ii++) {
-        // Default is first point in the array
-        O2_ZDC_DIGIRECO_FLT yy = mFirstSample;
-        if (ii > 0) {
-          if (ii < mNsam) {
-            int ip = ii % NTimeBinsPerBC;
-            int ib = ibeg + ii / NTimeBinsPerBC;
-            yy = mReco[ib].data[isig][ip];
-            // yy = mChData[mReco[ib].ref[isig]].data[ip];
-          } else {
-            // Last acquired point
-            yy = mLastSample;
-          }
-        }
-        sum += mTS[is];
-        y += yy * mTS[is];
-      }
-      y = y / sum;
-      return y;
-    }
-  }
+    return sig.lastSample;
+  }
+  // Interpolation between acquired points (N.B. from 0 to nint)
+  i = i - TSNH;
+  int ip = i / TSN;
+  int im = i % TSN;
+  // Samples from ip - TSL + 1 to ip + TSL
+  const O2_ZDC_DIGIRECO_FLT* yy = &sig.samples[ip + 1];
+  if (im == 0) {
+    // This is an acquired point
+    return yy[TSL - 1]; // Filtered point
+  }
+  // Do the actual interpolation
+  O2_ZDC_DIGIRECO_FLT y = 0;
+  for (int j = 0; j < mNTSW; j++) {
+    y += yy[j] * mTSW[j][im];
+  }
+  return y / mTSWSum[im];
 }
 
-void DigiReco::setPoint(int isig, int ibeg, int iend, int i)
+void DigiReco::setPoints(int isig, int ibeg, int iend, DigiRecoSignal& sig)
 {
   // This function needs to be used only if mFullInterpolation is true otherwise the
   // vectors are not allocated
@@ -1324,28 +1380,40 @@ void DigiReco::setPoint(int isig, int ibeg, int iend, int i)
     return;
   }
   constexpr int nsbun = TSN * NTimeBinsPerBC; // Total number of interpolated points per bunch crossing
-  if (i >= mNtot || i < 0) {
-    LOG(error) << "Error addressing signal isig=" << isig << " i=" << i << " mNtot=" << mNtot;
-    mInError = true;
-    return;
-  }
+  sig.inter.resize(sig.ntot);
+  auto* inter = sig.inter.data();
   // Constant extrapolation at the beginning and at the end of the array
-  if (i < TSNH) {
-    // Assign value of first sample
-    mReco[ibeg].inter[isig][i] = mFirstSample;
-  } else if (i >= mIlast) {
-    // Assign value of last sample
-    int isam = i % nsbun;
-    mReco[iend].inter[isig][isam] = mLastSample;
-  } else {
-    // Identification of the point to be assigned
-    int ibun = ibeg + i / nsbun;
-    int isam = i % nsbun;
-    mReco[ibun].inter[isig][isam] = getPoint(isig, ibeg, iend, i);
+  std::fill(inter, inter + TSNH, sig.firstSample);
+  std::fill(inter + sig.ilast, inter + sig.ntot, sig.lastSample);
+  // Same computation as in getPoint for all the points between two acquired samples.
+  // The inner loops run on contiguous points and can be vectorized, while the terms of
+  // each point are summed in the same order
+  for (int ip = 0; ip < sig.nsam - 1; ip++) {
+    const O2_ZDC_DIGIRECO_FLT* yy = &sig.samples[ip + 1];
+    O2_ZDC_DIGIRECO_FLT* y = inter + TSNH + ip * TSN;
+    for (int im = 0; im < TSN; im++) {
+      y[im] = 0;
+    }
+    for (int j = 0; j < mNTSW; j++) {
+      O2_ZDC_DIGIRECO_FLT yj = yy[j];
+      const O2_ZDC_DIGIRECO_FLT* w = mTSW[j];
+      for (int im = 1; im < TSN; im++) {
+        y[im] += yj * w[im];
+      }
+    }
+    for (int im = 1; im < TSN; im++) {
+      y[im] = y[im] / mTSWSum[im];
+    }
+    // This is an acquired point
+    y[0] = yy[TSL - 1];
+  }
+  for (int ibun = ibeg; ibun <= iend; ibun++) {
+    auto* first = inter + (ibun - ibeg) * nsbun;
+    std::copy(first, first + nsbun, mReco[ibun].inter[isig].begin());
   }
-} // setPoint
+} // setPoints
 
-int DigiReco::fullInterpolation(int isig, int ibeg, int iend)
+int DigiReco::fullInterpolation(int isig, int ibeg, int iend, DigiRecoSignal& sig)
 {
   // Interpolation of signal isig, in consecutive bunches from ibeg to iend
   // This function works for all signals and does not evaluate trigger
@@ -1357,42 +1425,23 @@ int DigiReco::fullInterpolation(int isig, int ibeg, int iend)
   // TODO: get data from preceding time frame in case there are bunches
   // with signal at the beginning of the first orbit of a time frame
 
-  constexpr int MaxTimeBin = NTimeBinsPerBC - 1; //< number of samples per BC
-
-  // Set data members for interpolation of the current channel
-  mNbun = iend - ibeg + 1;                    // Number of adjacent bunches
-  mNsam = mNbun * NTimeBinsPerBC;             // Number of acquired samples
-  mNtot = mNsam * TSN;                        // Total number of points in the interpolated arrays
-  mNint = (mNbun * NTimeBinsPerBC - 1) * TSN; // Total points in the interpolation region (-1)
-  mIlast = mNtot - TSNH;                      // Index of last acquired sample
-
-  // At this level there should be no need to check if the channel is connected
-  // since a fatal should have been raised already
-  for (int ibun = ibeg; ibun <= iend; ibun++) {
-    auto ref = mReco[ibun].ref[isig];
-    if (ref == ZDCRefInitVal) {
-      LOG(error) << __func__ << " @ " << __LINE__ << " Missing information for bunch crossing " << mReco[ibun].ir.orbit << "." << mReco[ibun].ir.bc << " sig = " << isig;
-      return __LINE__;
-    }
+  int rval = prepareSignal(isig, ibeg, iend, sig);
+  if (rval) {
+    return rval;
   }
 
-  mFirstSample = mReco[ibeg].data[isig][0];
-  mLastSample = mReco[iend].data[isig][MaxTimeBin];
-
   // Allocate and fill array of interpolated points
   for (int ibun = ibeg; ibun <= iend; ibun++) {
     mReco[ibun].allocate(isig);
   }
-  for (int i = 0; i < mNtot; i++) {
-    setPoint(isig, ibeg, iend, i);
-  }
-  if (mInError) {
+  setPoints(isig, ibeg, iend, sig);
+  if (sig.inError) {
     return __LINE__;
   }
   return 0;
 }
 
-int DigiReco::interpolate(int itdc, int ibeg, int iend)
+int DigiReco::interpolate(int itdc, int ibeg, int iend, DigiRecoSignal& sig)
 {
   // Interpolation of TDC channel itdc, in consecutive bunches from ibeg to iend
   int isig = TDCSignal[itdc];
@@ -1407,44 +1456,23 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
   constexpr int MaxTimeBin = NTimeBinsPerBC - 1; //< number of samples per BC
   constexpr int nsbun = TSN * NTimeBinsPerBC;    // Total number of interpolated points per bunch crossing
 
-  // Set data members for interpolation of the current TDC
-  mNbun = iend - ibeg + 1;                    // Number of adjacent bunches
-  mNsam = mNbun * NTimeBinsPerBC;             // Number of acquired samples
-  mNtot = mNsam * TSN;                        // Total number of points in the interpolated arrays
-  mNint = (mNbun * NTimeBinsPerBC - 1) * TSN; // Total points in the interpolation region (-1)
-  mIlast = mNtot - TSNH;                      // Index of last acquired sample
-
   constexpr int nsp = 5; // Number of points to be searched
 
-  // At this level there should be no need to check if the channel is connected
-  // since a fatal should have been raised already
-  for (int ibun = ibeg; ibun <= iend; ibun++) {
-    auto ref = mReco[ibun].ref[isig];
-    if (ref == ZDCRefInitVal) {
-      LOG(error) << __func__ << " @ " << __LINE__ << " Missing information for bunch crossing " << mReco[ibun].ir.orbit << "." << mReco[ibun].ir.bc << " sig = " << isig;
-      return __LINE__;
-    }
+  // Set data members for interpolation of the current TDC
+  int rval = prepareSignal(isig, ibeg, iend, sig);
+  if (rval) {
+    return rval;
   }
 
-  // auto ref_beg = mReco[ibeg].ref[isig];
-  // auto ref_end = mReco[iend].ref[isig];
-  // mFirstSample = mChData[ref_beg].data[0]; // Original points
-  // mLastSample = mChData[ref_end].data[MaxTimeBin]; // Original points
-
-  mFirstSample = mReco[ibeg].data[isig][0];
-  mLastSample = mReco[iend].data[isig][MaxTimeBin];
-
   // mFullInterpolation turns on full interpolation for debugging
   // otherwise the interpolation is performed only around actual signal
   if (mFullInterpolation) {
     for (int ibun = ibeg; ibun <= iend; ibun++) {
       mReco[ibun].allocate(isig);
     }
-    for (int i = 0; i < mNtot; i++) {
-      setPoint(isig, ibeg, iend, i);
-    }
+    setPoints(isig, ibeg, iend, sig);
   }
-  if (mInError) {
+  if (sig.inError) {
     return __LINE__;
   }
   // Looking for a local maximum in a search zone
@@ -1457,7 +1485,7 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
   int ip[nsp] = {-1, -1, -1, -1, -1};
   // N.B. Points at the extremes are constant therefore no local maximum
   // can occur in these two regions
-  for (int i = 0; i < mNint; i += mInterpolationStep) {
+  for (int i = 0; i < sig.nint; i += mInterpolationStep) {
     int isam = i + TSNH;
     // Check if trigger is fired for this point
     // For the moment we don't take into account possible extensions of the search zone
@@ -1572,8 +1600,8 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
             sbeg = 0;
             send = sbeg + TSN;
           }
-          if (send > (mNint + TSNH)) {
-            send = mNint + TSNH;
+          if (send > (sig.nint + TSNH)) {
+            send = sig.nint + TSNH;
             sbeg = send - TSN;
           }
           if (sbeg < 0) {
@@ -1581,7 +1609,7 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
           }
           for (int spos = sbeg; spos < send; spos++) {
             // Perform interpolation for the searched point
-            O2_ZDC_DIGIRECO_FLT myval = getPoint(isig, ibeg, iend, spos);
+            O2_ZDC_DIGIRECO_FLT myval = getPoint(isig, spos, sig);
             // Get local minimum of waveform
             if (myval < amp) {
               amp = myval;
@@ -1591,13 +1619,13 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
         }
         // Store identified peak
         int ibun = ibeg + isam_amp / nsbun;
-        updateOffsets(ibun);
+        auto& ped = getPedestal(ibun);
         // At this level offsets are from Orbit or QC therefore
         // the TDC amplitude and time are affected by pile-up from
         // previous collisions. Pile up correction needs to be
         // performed after all signals have been identified
-        if (mSource[isig] != PedND) {
-          amp = mOffset[isig] - amp;
+        if (ped.source[isig] != PedND) {
+          amp = ped.offset[isig] - amp;
         } else {
           LOGF(error, "%u.%-4d Missing pedestal for TDC %d %s ", mBCData[ibun].ir.orbit, mBCData[ibun].ir.bc, itdc, ChannelNames[TDCSignal[itdc]]);
           amp = std::numeric_limits<float>::infinity();
@@ -1617,7 +1645,7 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
         myval = mReco[ib_cur].inter[isig][mysam];
       } else {
         // Perform interpolation for the searched point
-        myval = getPoint(isig, ibeg, iend, isam);
+        myval = getPoint(isig, isam, sig);
       }
       // Get local minimum of waveform
       if (myval < amp) {
@@ -1626,7 +1654,7 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
       }
     }
   } // Loop on interpolated points
-  if (mInError) {
+  if (sig.inError) {
     return __LINE__;
   }
 
@@ -1642,8 +1670,8 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
           sbeg = 0;
           send = sbeg + TSN;
         }
-        if (send > (mNint + TSNH)) {
-          send = mNint + TSNH;
+        if (send > (sig.nint + TSNH)) {
+          send = sig.nint + TSNH;
           sbeg = send - TSN;
         }
         if (sbeg < 0) {
@@ -1651,7 +1679,7 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
         }
         for (int spos = sbeg; spos < send; spos++) {
           // Perform interpolation for the searched point
-          O2_ZDC_DIGIRECO_FLT myval = getPoint(isig, ibeg, iend, spos);
+          O2_ZDC_DIGIRECO_FLT myval = getPoint(isig, spos, sig);
           // Get local minimum of waveform
           if (myval < amp) {
             amp = myval;
@@ -1661,9 +1689,9 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
       }
       // Store identified peak
       int ibun = ibeg + isam_amp / nsbun;
-      updateOffsets(ibun);
-      if (mSource[isig] != PedND) {
-        amp = mOffset[isig] - amp;
+      auto& ped = getPedestal(ibun);
+      if (ped.source[isig] != PedND) {
+        amp = ped.offset[isig] - amp;
       } else {
         LOGF(error, "%u.%-4d Missing pedestal for TDC %d %s ", mBCData[ibun].ir.orbit, mBCData[ibun].ir.bc, itdc, ChannelNames[TDCSignal[itdc]]);
         amp = std::numeric_limits<float>::infinity();
@@ -1672,7 +1700,7 @@ int DigiReco::interpolate(int itdc, int ibeg, int iend)
       assignTDC(ibun, ibeg, iend, itdc, tdc, amp);
     }
   }
-  if (mInError) {
+  if (sig.inError) {
     return __LINE__;
   }
   // TODO: add logic to assign TDC in presence of overflow
@@ -1735,11 +1763,12 @@ void DigiReco::assignTDC(int ibun, int ibeg, int iend, int itdc, int tdc, float
   }
 #endif
   // Assign info about pedestal subtration
-  if (mSource[isig] == PedOr) {
+  auto& ped = getPedestal(ibun);
+  if (ped.source[isig] == PedOr) {
     rec.tdcPedOr[isig] = true;
-  } else if (mSource[isig] == PedQC) {
+  } else if (ped.source[isig] == PedQC) {
     rec.tdcPedQC[isig] = true;
-  } else if (mSource[isig] == PedEv) {
+  } else if (ped.source[isig] == PedEv) {
     // In present implementation this never happens
     rec.tdcPedEv[isig] = true;
   } else {
@@ -1748,7 +1777,7 @@ void DigiReco::assignTDC(int ibun, int ibeg, int iend, int itdc, int tdc, float
 #ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
   LOG(info) << __func__ << " itdc=" << itdc << " " << ChannelNames[isig] << " @ ibun=" << ibun << " " << mReco[ibun].ir.orbit << "." << mReco[ibun].ir.bc << " "
             << " tdc=" << tdc << " -> " << TDCValCorr << " shift=" << tdc_shift[itdc] << " -> TDCVal=" << TDCVal << "=" << TDCVal * o2::zdc::FTDCVal
-            << " mSource[" << isig << "] = " << unsigned(mSource[isig]) << " = " << mOffset[isig]
+            << " source[" << isig << "] = " << unsigned(ped.source[isig]) << " = " << ped.offset[isig]
             << " amp=" << amp << " -> " << TDCAmpCorr << " calib=" << tdc_calib[itdc] << " -> TDCAmp=" << TDCAmp << "=" << myamp
             << (ibun == ibeg ? " B" : "") << (ibun == iend ? " E" : "");
 #endif
@@ -1763,7 +1792,6 @@ void DigiReco::findSignals(int ibeg, int iend)
 #endif
   // Identify TDC signals
   for (int ibun = ibeg; ibun <= iend; ibun++) {
-    updateOffsets(ibun); // Get orbit pedestals or run pedestals as a fallback
     auto& rec = mReco[ibun];
     for (int itdc = 0; itdc < NTDCChannels; itdc++) {
 #ifdef ALICEO2_ZDC_DIGI_RECO_DEBUG
@@ -1892,6 +1920,10 @@ void DigiReco::correctTDCPile()
   // TODO: Perform actual pile-up correction for TDCs.. this is still work in progress..
   // For the moment this function has pile-up detection
 
+  // TDC channels are independent
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
   for (int itdc = 0; itdc < NTDCChannels; itdc++) {
     // Queue is empty at first event of the time frame
     // TODO: collect information from previous time frame
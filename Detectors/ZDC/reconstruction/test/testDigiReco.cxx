@@ -0,0 +1,545 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testDigiReco.cxx
+/// \brief Regression test of the ZDC reconstruction: the filtered samples and the interpolated
+/// waveforms are compared with the scalar reference formulas, the reconstructed events with
+/// the default configuration are compared with the frozen copy of the original DigiReco, and
+/// they must not depend on the number of threads
+
+#define BOOST_TEST_MODULE Test ZDC DigiReco
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <TMath.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <random>
+#include <vector>
+#include "ZDCReconstruction/DigiReco.h"
+#include "DigiRecoReference.h"
+
+namespace o2
+{
+namespace zdc
+{
+
+// Readout configuration of CreateModuleConfig.C
+ModuleConfig createModuleConfig()
+{
+  ModuleConfig conf;
+  conf.nBunchAverage = 2;
+  int bshift = std::ceil(std::log2(double(NTimeBinsPerBC) * double(conf.nBunchAverage) * double(ADCRange))) - 16;
+  conf.baselineFactor = float(0x1 << bshift) / float(conf.nBunchAverage) / float(NTimeBinsPerBC);
+  const int8_t ids[NModules][NChPerModule] = {{IdZNAC, IdZNASum, IdZNA1, IdZNA2}, {IdZNAC, IdZNASum, IdZNA3, IdZNA4},
+                                              {IdZNCC, IdZNCSum, IdZNC1, IdZNC2}, {IdZNCC, IdZNCSum, IdZNC3, IdZNC4},
+                                              {IdZPAC, IdZEM1, IdZPA1, IdZPA2}, {IdZPAC, IdZPASum, IdZPA3, IdZPA4},
+                                              {IdZPCC, IdZEM2, IdZPC1, IdZPC2}, {IdZPCC, IdZPCSum, IdZPC3, IdZPC4}};
+  for (int im = 0; im < NModules; im++) {
+    auto& module = conf.modules[im];
+    module.id = im;
+    bool even = (im % 2) == 0;
+    bool zem = (im == 4 || im == 6);
+    module.setChannel(0, ids[im][0], 2 * im, even, true, -5, 6, 4, 12);
+    module.setChannel(1, ids[im][1], 2 * im, !even || zem, zem, -5, 6, 4, 12);
+    module.setChannel(2, ids[im][2], 2 * im + 1, true, false, -5, 6, 4, 12);
+    module.setChannel(3, ids[im][3], 2 * im + 1, true, false, -5, 6, 4, 12);
+  }
+  return conf;
+}
+
+// Reconstruction configuration of CreateRecoConfigZDC.C
+RecoConfigZDC createRecoConfig()
+{
+  RecoConfigZDC conf;
+  for (int itdc = 0; itdc < NTDCChannels; itdc++) {
+    conf.setSearch(itdc, 250);
+  }
+  for (int ich = 0; ich < NChannels; ich++) {
+    conf.setIntegration(ich, 6, 8, -12, -8);
+    conf.setPedThreshold(ich, ADCRange, ADCRange);
+  }
+  return conf;
+}
+
+struct TestData {
+  std::vector<OrbitData> orbitData;
+  std::vector<BCData> bcData;
+  std::vector<ChannelData> chData;
+};
+
+// Sequences of consecutive bunch crossings with negative pulses on top of the baseline and noise.
+// One orbit has no pedestal information
+TestData createData(const ModuleConfig& conf, int norb)
+{
+  TestData data;
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> seqLength(1, 12), gap(2, 40), hasPulse(0, 3);
+  std::uniform_real_distribution<float> amplitude(50, 1000), position(2, 9);
+  std::normal_distribution<float> noise(0, 2);
+  const float baseline = 100;
+  for (int iorb = 0; iorb < norb; iorb++) {
+    uint32_t orbit = 1000 + iorb;
+    if (iorb != 1) {
+      std::array<int16_t, NChannels> ped;
+      std::array<uint16_t, NChannels> scaler;
+      ped.fill(int16_t(std::nearbyint(baseline / conf.baselineFactor)));
+      scaler.fill(0);
+      data.orbitData.emplace_back(InteractionRecord{0, orbit}, ped, scaler);
+    }
+    // The last sequence of the orbit ends with bunch 3500
+    int bc = 10;
+    while (bc < 3500) {
+      int len = std::min(seqLength(gen), 3501 - bc);
+      if (bc + len >= 3490) {
+        len = 3501 - bc;
+      }
+      for (int ibc = bc; ibc < bc + len; ibc++) {
+        uint32_t channels = 0, triggers = 0;
+        int first = data.chData.size();
+        for (int im = 0; im < NModules; im++) {
+          for (int ic = 0; ic < NChPerModule; ic++) {
+            if (!conf.modules[im].readChannel[ic]) {
+              continue;
+            }
+            std::array<float, NTimeBinsPerBC> samples;
+            for (auto& s : samples) {
+              s = baseline + noise(gen);
+            }
+            if (hasPulse(gen) == 0) {
+              float amp = amplitude(gen), pos = position(gen);
+              for (int is = 0; is < NTimeBinsPerBC; is++) {
+                float x = (is - pos) / 1.5;
+                samples[is] -= amp * std::exp(-0.5 * x * x);
+              }
+              if (conf.modules[im].trigChannel[ic]) {
+                triggers |= 0x1 << (NChPerModule * im + ic);
+              }
+            }
+            channels |= 0x1 << (NChPerModule * im + ic);
+            data.chData.emplace_back(conf.modules[im].channelID[ic], samples);
+          }
+        }
+        data.bcData.emplace_back(first, data.chData.size() - first, InteractionRecord{uint16_t(ibc), orbit}, channels, triggers, 0);
+      }
+      bc += len + gap(gen);
+    }
+  }
+  return data;
+}
+
+// Scalar low pass filter, as it was implemented originally
+int16_t referenceFilter(const TestData& data, const std::vector<RecEventAux>& reco, int ibc, int isig, int is)
+{
+  constexpr int MaxTimeBin = NTimeBinsPerBC - 1;
+  auto ref_c = reco[ibc].ref[isig];
+  uint32_t ref_p = ZDCRefInitVal, ref_n = ZDCRefInitVal;
+  int64_t bcd_p = -1, bcd_n = -1;
+  if (ibc > 0) {
+    ref_p = reco[ibc - 1].ref[isig];
+    bcd_p = reco[ibc].ir.differenceInBC(reco[ibc - 1].ir);
+  }
+  if (ibc < int(reco.size()) - 1) {
+    ref_n = reco[ibc + 1].ref[isig];
+    bcd_n = reco[ibc + 1].ir.differenceInBC(reco[ibc].ir);
+  }
+  const auto& ch = data.chData;
+  int32_t sum = ch[ref_c].data[is];
+  if (is == 0) {
+    sum += ch[ref_c].data[1];
+    sum += (ref_p != ZDCRefInitVal && bcd_p == 1) ? ch[ref_p].data[MaxTimeBin] : ch[ref_c].data[0];
+  } else if (is == MaxTimeBin) {
+    sum += ch[ref_c].data[MaxTimeBin - 1];
+    sum += (ref_n != ZDCRefInitVal && bcd_n == 1) ? ch[ref_n].data[0] : ch[ref_c].data[MaxTimeBin];
+  } else {
+    sum += ch[ref_c].data[is - 1];
+    sum += ch[ref_c].data[is + 1];
+  }
+  bool isNegative = sum < 0;
+  if (isNegative) {
+    sum = -sum;
+  }
+  auto mod = sum % 3;
+  sum = sum / 3;
+  if (mod == 2) {
+    sum++;
+  }
+  return isNegative ? -sum : sum;
+}
+
+// Tapered sinc function of DigiReco::prepareInterpolation
+void prepareReferenceInterpolation(O2_ZDC_DIGIRECO_FLT* ts, O2_ZDC_DIGIRECO_FLT alpha)
+{
+  O2_ZDC_DIGIRECO_FLT beta = TMath::Pi() * alpha;
+  O2_ZDC_DIGIRECO_FLT norm = 1. / TMath::BesselI0(beta);
+  constexpr int n = TSL * TSN;
+  for (int tsi = 0; tsi <= n; tsi++) {
+    O2_ZDC_DIGIRECO_FLT arg1 = TMath::Pi() * O2_ZDC_DIGIRECO_FLT(tsi) / O2_ZDC_DIGIRECO_FLT(TSN);
+    O2_ZDC_DIGIRECO_FLT fs = 1;
+    if (arg1 != 0) {
+      fs = TMath::Sin(arg1) / arg1;
+    }
+    O2_ZDC_DIGIRECO_FLT arg2 = O2_ZDC_DIGIRECO_FLT(tsi) / O2_ZDC_DIGIRECO_FLT(n);
+    O2_ZDC_DIGIRECO_FLT fg = norm * TMath::BesselI0(beta * TMath::Sqrt(1. - arg2 * arg2));
+    ts[n + tsi] = fs * fg;
+    ts[n - tsi] = ts[n + tsi];
+  }
+}
+
+// Scalar interpolation of point i of signal isig in bunches ibeg-iend, as it was implemented originally
+O2_ZDC_DIGIRECO_FLT referencePoint(const std::vector<RecEventAux>& reco, const O2_ZDC_DIGIRECO_FLT* ts, int isig, int ibeg, int iend, int i)
+{
+  constexpr int MaxTimeBin = NTimeBinsPerBC - 1;
+  constexpr int nsbun = TSN * NTimeBinsPerBC;
+  int nsam = (iend - ibeg + 1) * NTimeBinsPerBC;
+  int ilast = nsam * TSN - TSNH;
+  O2_ZDC_DIGIRECO_FLT firstSample = reco[ibeg].data[isig][0];
+  O2_ZDC_DIGIRECO_FLT lastSample = reco[iend].data[isig][MaxTimeBin];
+  if (i < TSNH) {
+    return firstSample;
+  } else if (i >= ilast) {
+    return lastSample;
+  }
+  int ibun = ibeg + i / nsbun;
+  i = i - TSNH;
+  int im = i % TSN;
+  if (im == 0) {
+    return reco[ibun].data[isig][(i / TSN) % NTimeBinsPerBC];
+  }
+  O2_ZDC_DIGIRECO_FLT y = 0;
+  int ip = i / TSN;
+  O2_ZDC_DIGIRECO_FLT sum = 0;
+  for (int is = TSN - im, ii = ip - TSL + 1; is < NTS; is += TSN, ii++) {
+    O2_ZDC_DIGIRECO_FLT yy = firstSample;
+    if (ii > 0) {
+      if (ii < nsam) {
+        yy = reco[ibeg + ii / NTimeBinsPerBC].data[isig][ii % NTimeBinsPerBC];
+      } else {
+        yy = lastSample;
+      }
+    }
+    sum += ts[is];
+    y += yy * ts[is];
+  }
+  return y / sum;
+}
+
+template <typename T>
+bool sameBits(const T& a, const T& b)
+{
+  return a.size() == b.size() && (a.size() == 0 || std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0);
+}
+
+// Bitwise comparison, or relative comparison if a tolerance is given
+template <typename T>
+bool sameValues(const T& a, const T& b, float tolerance)
+{
+  if (tolerance == 0) {
+    return sameBits(a, b);
+  }
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (std::abs(a[i] - b[i]) > tolerance * std::max(1.f, std::abs(float(b[i])))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sameEnergies(const std::map<uint8_t, float>& a, const std::map<uint8_t, float>& b, float tolerance)
+{
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ia++, ib++) {
+    if (ia->first != ib->first || std::abs(ia->second - ib->second) > tolerance * std::max(1.f, std::abs(ib->second))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sameEvent(const RecEventAux& a, const RecEventAux& b, float tolerance = 0)
+{
+  bool same = a.ir == b.ir && a.channels == b.channels && a.triggers == b.triggers && a.ezdcDecoded == b.ezdcDecoded;
+  same = same && (tolerance == 0 ? a.ezdc == b.ezdc : sameEnergies(a.ezdc, b.ezdc, tolerance));
+  for (int itdc = 0; itdc < NTDCChannels; itdc++) {
+    same = same && a.ntdc[itdc] == b.ntdc[itdc] && a.fired[itdc] == b.fired[itdc] && a.pattern[itdc] == b.pattern[itdc];
+    same = same && sameValues(a.TDCVal[itdc], b.TDCVal[itdc], tolerance) && sameValues(a.TDCAmp[itdc], b.TDCAmp[itdc], tolerance);
+  }
+  for (int ich = 0; ich < NChannels; ich++) {
+    same = same && a.chfired[ich] == b.chfired[ich] && a.data[ich] == b.data[ich] && sameValues(a.inter[ich], b.inter[ich], tolerance);
+  }
+  using Flags = std::array<bool, NChannels> RecEventAux::*;
+  for (Flags flags : std::initializer_list<Flags>{&RecEventAux::err, &RecEventAux::isBeg, &RecEventAux::isEnd, &RecEventAux::genericE,
+                                                  &RecEventAux::tdcPedEv, &RecEventAux::tdcPedOr, &RecEventAux::tdcPedQC,
+                                                  &RecEventAux::tdcPedMissing, &RecEventAux::adcPedEv, &RecEventAux::adcPedOr,
+                                                  &RecEventAux::adcPedQC, &RecEventAux::adcPedMissing, &RecEventAux::offPed,
+                                                  &RecEventAux::pilePed, &RecEventAux::pileTM, &RecEventAux::adcMissingwTDC,
+                                                  &RecEventAux::tdcPileEvC, &RecEventAux::tdcPileEvE, &RecEventAux::tdcPileM1C,
+                                                  &RecEventAux::tdcPileM1E, &RecEventAux::tdcPileM2C, &RecEventAux::tdcPileM2E,
+                                                  &RecEventAux::tdcPileM3C, &RecEventAux::tdcPileM3E, &RecEventAux::tdcSigE}) {
+    same = same && a.*flags == b.*flags;
+  }
+  return same;
+}
+
+// Calibration objects with values away from the identity, so that the TDC and energy
+// corrections change the result. The pile-up corrections of one bunch are not assigned
+struct TestCalibration {
+  ModuleConfig moduleConfig = createModuleConfig();
+  RecoConfigZDC recoConfig = createRecoConfig();
+  ZDCTDCParam tdcParam;
+  ZDCTDCCorr tdcCorr;
+  ZDCEnergyParam energyParam;
+  ZDCTowerParam towerParam;
+
+  TestCalibration()
+  {
+    std::mt19937 gen(4321);
+    std::uniform_real_distribution<float> unit(-1, 1);
+    for (int itdc = 0; itdc < NTDCChannels; itdc++) {
+      tdcParam.setShift(itdc, 0.2 * unit(gen));
+      tdcParam.setFactor(itdc, 1 + 0.05 * unit(gen));
+      // Signal corrections at the beginning, in the middle and at the end of the sequences
+      tdcCorr.mTSMidC[itdc][0] = 20 * unit(gen);
+      tdcCorr.mAFMidC[itdc][0] = 1 + 0.05 * unit(gen);
+      tdcCorr.mTSBegC[itdc] = {float(TSN * 4), 20 * unit(gen), 0.01f * unit(gen), 1e-5f * unit(gen)};
+      tdcCorr.mAFBegC[itdc] = {float(TSN * 4), 1 + 0.05f * unit(gen), 1e-4f * unit(gen), 1e-7f * unit(gen)};
+      tdcCorr.mTSEndC[itdc] = {float(TSN * 8), 20 * unit(gen), 0.01f * unit(gen), 1e-5f * unit(gen)};
+      tdcCorr.mAFEndC[itdc] = {float(TSN * 8), 1 + 0.05f * unit(gen), 1e-4f * unit(gen), 1e-7f * unit(gen)};
+      // Pile-up corrections
+      for (int ibun = 0; ibun < NBCAn; ibun++) {
+        if (itdc == 0 && ibun == 0) {
+          continue;
+        }
+        for (int ibukb = 0; ibukb < NBucket; ibukb++) {
+          for (int ibuks = 0; ibuks < NBucket; ibuks++) {
+            tdcCorr.mAmpCorr[itdc][ibun][ibukb][ibuks] = {2 * unit(gen), 1 + 0.02f * unit(gen), 0.01f * unit(gen)};
+            tdcCorr.mTDCCorr[itdc][ibun][ibukb][ibuks] = {5 * unit(gen), 5 * unit(gen), 0};
+          }
+        }
+      }
+    }
+    for (auto ich : ChEnergyCalib) {
+      energyParam.setEnergyCalib(ich, 1 + 0.5 * unit(gen));
+    }
+    for (auto ich : ChTowerCalib) {
+      towerParam.setTowerCalib(ich, 1 + 0.5 * unit(gen));
+    }
+  }
+
+  // Default reconstruction configuration: low pass filter, interpolation of single points
+  // and TDC signal and pile-up corrections
+  template <typename Reco>
+  void configure(Reco& reco) const
+  {
+    reco.setModuleConfig(&moduleConfig);
+    reco.setRecoConfigZDC(&recoConfig);
+    reco.setTDCParam(&tdcParam);
+    reco.setTDCCorr(&tdcCorr);
+    reco.setEnergyParam(&energyParam);
+    reco.setTowerParam(&towerParam);
+    reco.init();
+  }
+};
+
+BOOST_AUTO_TEST_CASE(DigiReco_regression)
+{
+  auto moduleConfig = createModuleConfig();
+  auto recoConfig = createRecoConfig();
+  ZDCTDCParam tdcParam;
+  for (int itdc = 0; itdc < NTDCChannels; itdc++) {
+    tdcParam.setShift(itdc, 0);
+    tdcParam.setFactor(itdc, 1);
+  }
+  auto data = createData(moduleConfig, 3);
+
+  // The same object is used for all the tests since the reconstruction parameters are
+  // assigned only once
+  DigiReco reco;
+  reco.setModuleConfig(&moduleConfig);
+  reco.setRecoConfigZDC(&recoConfig);
+  reco.setTDCParam(&tdcParam);
+  reco.setLowPassFilter(true);
+  reco.setFullInterpolation(true);
+  reco.setCorrSignal(false);
+  reco.setCorrBackground(false);
+  reco.init();
+
+  reco.setNThreads(1);
+  BOOST_REQUIRE_EQUAL(reco.process(data.orbitData, data.bcData, data.chData), 0);
+  BOOST_CHECK(!reco.inError());
+  auto ref = reco.getReco();
+  BOOST_REQUIRE_EQUAL(ref.size(), data.bcData.size());
+
+  // Low pass filter on TDC signals, other signals are unchanged
+  int nbad = 0;
+  for (int ibc = 0; ibc < int(ref.size()); ibc++) {
+    for (int isig = 0; isig < NChannels; isig++) {
+      if (ref[ibc].ref[isig] == ZDCRefInitVal) {
+        continue;
+      }
+      bool isTDC = TDCSignal[SignalTDC[isig]] == isig;
+      for (int is = 0; is < NTimeBinsPerBC; is++) {
+        int16_t expected = isTDC ? referenceFilter(data, ref, ibc, isig, is) : data.chData[ref[ibc].ref[isig]].data[is];
+        nbad += ref[ibc].data[isig][is] != expected;
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(nbad, 0);
+
+  // Interpolated waveforms in sequences of consecutive bunch crossings
+  std::vector<O2_ZDC_DIGIRECO_FLT> ts(NTS);
+  prepareReferenceInterpolation(ts.data(), reco.getAlpha());
+  constexpr int nsbun = TSN * NTimeBinsPerBC;
+#ifdef __FP_FAST_FMAF
+  // Multiply-add contraction may differ between the scalar and the vectorized loops
+  constexpr O2_ZDC_DIGIRECO_FLT tolerance = 1e-5;
+#else
+  constexpr O2_ZDC_DIGIRECO_FLT tolerance = 0;
+#endif
+  int nchecked = 0;
+  nbad = 0;
+  for (int ibeg = 0, iend = 0; ibeg < int(ref.size()); ibeg = iend + 1) {
+    for (iend = ibeg; iend + 1 < int(ref.size()) && ref[iend + 1].ir.differenceInBC(ref[iend].ir) == 1;) {
+      iend++;
+    }
+    if (iend == ibeg) {
+      continue;
+    }
+    for (int isig = 0; isig < NChannels; isig++) {
+      if (ref[ibeg].ref[isig] == ZDCRefInitVal) {
+        continue;
+      }
+      for (int i = 0; i < (iend - ibeg + 1) * nsbun; i++) {
+        auto& inter = ref[ibeg + i / nsbun].inter[isig];
+        BOOST_REQUIRE_EQUAL(inter.size(), nsbun);
+        auto expected = referencePoint(ref, ts.data(), isig, ibeg, iend, i);
+        nbad += std::abs(inter[i % nsbun] - expected) > tolerance * std::max(O2_ZDC_DIGIRECO_FLT(1), std::abs(expected));
+        nchecked++;
+      }
+    }
+  }
+  BOOST_CHECK_GT(nchecked, 0);
+  BOOST_CHECK_EQUAL(nbad, 0);
+
+  // Sequences processed in parallel give the same result
+  reco.setNThreads(4);
+  BOOST_REQUIRE_EQUAL(reco.process(data.orbitData, data.bcData, data.chData), 0);
+  BOOST_CHECK(!reco.inError());
+  auto& rec = reco.getReco();
+  BOOST_REQUIRE_EQUAL(rec.size(), ref.size());
+  nbad = 0;
+  for (int ibc = 0; ibc < int(ref.size()); ibc++) {
+    nbad += !sameEvent(ref[ibc], rec[ibc]);
+  }
+  BOOST_CHECK_EQUAL(nbad, 0);
+}
+
+BOOST_AUTO_TEST_CASE(DigiReco_default_reference)
+{
+  TestCalibration calib;
+  auto data = createData(calib.moduleConfig, 3);
+
+  reference::DigiReco original;
+  calib.configure(original);
+  BOOST_REQUIRE(!original.getFullInterpolation());
+  BOOST_REQUIRE(original.getCorrSignal());
+  BOOST_REQUIRE(original.getCorrBackground());
+  BOOST_REQUIRE_EQUAL(original.process(data.orbitData, data.bcData, data.chData), 0);
+  BOOST_CHECK(!original.inError());
+  auto ref = original.getReco();
+  BOOST_REQUIRE_EQUAL(ref.size(), data.bcData.size());
+
+  // Make sure that the corrections and the energies are exercised
+  int ntdc = 0, nsigcorr = 0, npilecorr = 0, nenergy = 0;
+  for (const auto& rec : ref) {
+    for (int itdc = 0; itdc < NTDCChannels; itdc++) {
+      ntdc += rec.TDCVal[itdc].size();
+      auto isig = TDCSignal[itdc];
+      nsigcorr += rec.TDCVal[itdc].size() > 0 && !rec.tdcSigE[isig];
+      npilecorr += rec.tdcPileM1C[isig] || rec.tdcPileM2C[isig] || rec.tdcPileM3C[isig];
+    }
+    nenergy += rec.ezdc.size();
+  }
+  BOOST_CHECK_GT(ntdc, 0);
+  BOOST_CHECK_GT(nsigcorr, 0);
+  BOOST_CHECK_GT(npilecorr, 0);
+  BOOST_CHECK_GT(nenergy, 0);
+
+#ifdef __FP_FAST_FMAF
+  // Multiply-add contraction may differ between the original and the rearranged interpolation
+  constexpr float tolerance = 1e-5;
+#else
+  constexpr float tolerance = 0;
+#endif
+  for (int nthreads : {1, 4}) {
+    DigiReco reco;
+    calib.configure(reco);
+    reco.setNThreads(nthreads);
+    BOOST_REQUIRE_EQUAL(reco.process(data.orbitData, data.bcData, data.chData), 0);
+    BOOST_CHECK(!reco.inError());
+    auto& rec = reco.getReco();
+    BOOST_REQUIRE_EQUAL(rec.size(), ref.size());
+    int nbad = 0;
+    for (int ibc = 0; ibc < int(ref.size()); ibc++) {
+      nbad += !sameEvent(ref[ibc], rec[ibc], tolerance);
+    }
+    BOOST_CHECK_EQUAL(nbad, 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DigiReco_missing_pedestal)
+{
+  // Without run pedestals, the orbit without pedestal information is counted once per channel
+  // for each call of process. The original DigiReco counted it every time the pedestals were
+  // looked up for a different orbit than the previous lookup, at least once
+  TestCalibration calib;
+  auto data = createData(calib.moduleConfig, 3);
+
+  reference::DigiReco original;
+  calib.configure(original);
+  BOOST_REQUIRE_EQUAL(original.process(data.orbitData, data.bcData, data.chData), 0);
+
+  DigiReco reco;
+  calib.configure(reco);
+  reco.setNThreads(4);
+  for (uint32_t ncalls = 1; ncalls <= 2; ncalls++) {
+    BOOST_REQUIRE_EQUAL(reco.process(data.orbitData, data.bcData, data.chData), 0);
+    for (int ich = 0; ich < NChannels; ich++) {
+      BOOST_CHECK_EQUAL(reco.getMissingPed()[ich], ncalls);
+      if (ncalls == 1) {
+        BOOST_CHECK_GE(original.getMissingPed()[ich], reco.getMissingPed()[ich]);
+      }
+    }
+  }
+
+  // Pedestals are flagged as missing only in the orbit without pedestal information
+  int nmissing = 0;
+  for (const auto& rec : reco.getReco()) {
+    for (int ich = 0; ich < NChannels; ich++) {
+      if (rec.tdcPedMissing[ich] || rec.adcPedMissing[ich]) {
+        BOOST_CHECK_EQUAL(rec.ir.orbit, 1001u);
+        nmissing++;
+      }
+    }
+  }
+  BOOST_CHECK_GT(nmissing, 0);
+}
+
+} // namespace zdc
+} // namespace o2
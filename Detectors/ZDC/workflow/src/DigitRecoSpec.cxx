@@ -74,6 +74,7 @@ void DigitRecoSpec::init(o2::framework::InitContext& ic)
   if (mRecoFraction < 1) {
     LOG(warning) << "Target fraction for reconstructed TFs = " << mRecoFraction;
   }
+  mWorker.setNThreads(ic.options().get<int>("nthreads"));
 }
 
 void DigitRecoSpec::updateTimeDependentParams(ProcessingContext& pc)
@@ -321,7 +322,8 @@ framework::DataProcessorSpec getDigitRecoSpec(const int verbosity = 0, const boo
     outputs,
     AlgorithmSpec{adaptFromTask<DigitRecoSpec>(verbosity, enableDebugOut, enableZDCTDCCorr, enableZDCEnergyParam, enableZDCTowerParam, enableBaselineParam)},
     o2::framework::Options{{"max-wave", o2::framework::VariantType::Int, 0, {"Maximum number of waveforms per TF in output"}},
-                           {"tf-fraction", o2::framework::VariantType::Double, 1.0, {"Fraction of reconstructed TFs"}}}};
+                           {"tf-fraction", o2::framework::VariantType::Double, 1.0, {"Fraction of reconstructed TFs"}},
+                           {"nthreads", o2::framework::VariantType::Int, 1, {"Number of threads for the reconstruction of independent sequences of bunch crossings"}}}};
 }
 
 } // namespace zdc
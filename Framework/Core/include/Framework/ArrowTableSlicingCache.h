@@ -0,0 +1,68 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
+#define O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
+
+#include "Framework/Kernels.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// Per-timeframe cache of the grouping of tables by an index column.
+/// The first process function asking for the slicing of a table by
+/// a given index column computes it, the following ones reuse the
+/// offsets, including the Filtered<> and SmallGroups<> views of the same
+/// table. A table is identified by the values buffer of its index column,
+/// which is shared by all the views of the table within a timeframe.
+struct ArrowTableSlicingCache {
+  struct SortedGroups {
+    std::vector<uint64_t> offsets;
+    std::vector<int> sizes;
+  };
+
+  /// offsets and sizes of the groups of a table sorted by the index column key
+  SortedGroups const& getSortedGroups(char const* key,
+                                      char const* target,
+                                      std::shared_ptr<arrow::Table> const& input,
+                                      int32_t fullSize);
+
+  /// rows of each group of a table not sorted by the index column key
+  std::shared_ptr<ListVector const> getUnsortedGroups(char const* key,
+                                                      char const* target,
+                                                      std::shared_ptr<arrow::Table> const& input,
+                                                      int32_t fullSize);
+
+  /// invalidate the cache, to be called at each new timeframe
+  void reset();
+
+  /// number of slicings actually computed and of requests served since the last reset
+  size_t getComputed() const { return mComputed; }
+  size_t getRequested() const { return mRequested; }
+
+ private:
+  using CacheKey = std::tuple<std::string, void const*, int64_t, int32_t>;
+  static CacheKey makeKey(char const* key, std::shared_ptr<arrow::Table> const& input, int32_t fullSize);
+
+  std::map<CacheKey, SortedGroups> mSorted;
+  std::map<CacheKey, std::shared_ptr<ListVector const>> mUnsorted;
+  size_t mComputed = 0;
+  size_t mRequested = 0;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
@@ -81,6 +81,7 @@ struct CommonServices {
 
 struct CommonAnalysisServices {
   static ServiceSpec databasePDGSpec();
+  static ServiceSpec slicingCacheSpec();
 
   template <typename T>
   static void addAnalysisService(std::vector<ServiceSpec>& specs)
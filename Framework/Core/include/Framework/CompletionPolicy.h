@@ -65,6 +65,7 @@ struct CompletionPolicy {
   using Callback = std::function<CompletionOp(InputSpan const&)>;
   using CallbackFull = std::function<CompletionOp(InputSpan const&, std::vector<InputSpec> const&)>;
   using CallbackConfigureRelayer = std::function<void(DataRelayer&)>;
+  using CallbackCount = std::function<CompletionOp(size_t present, size_t total)>;
 
   /// Constructor
   CompletionPolicy()
@@ -87,6 +88,10 @@ struct CompletionPolicy {
   /// A callback which allows you to configure the behavior of the data relayer associated
   /// to the matching device.
   CallbackConfigureRelayer configureRelayer = nullptr;
+  /// Optional shortcut for policies which only depend on how many of the inputs
+  /// are present. When set, the relayer uses it instead of creating an InputSpan
+  /// for callback / callbackFull, so it must give the same answer as they do.
+  CallbackCount callbackCount = nullptr;
 
   /// Helper to create the default configuration.
   static std::vector<CompletionPolicy> createDefaultPolicies();
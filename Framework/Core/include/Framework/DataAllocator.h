@@ -338,6 +338,19 @@ class DataAllocator
   void snapshot(const Output& spec, const char* payload, size_t payloadSize,
                 o2::header::SerializationMethod serializationMethod = o2::header::gSerializationMethodNone);
 
+  /// Send the payload of an existing message, e.g. one of the inputs, to the
+  /// given output. When the message and the output share the transport, the
+  /// new message refers to the same buffer (e.g. the same shared memory), otherwise
+  /// the payload is copied.
+  /// @return true if the payload was passed by reference, false if copied
+  bool forward(const Output& spec, fair::mq::Message const& payload,
+               o2::header::SerializationMethod serializationMethod = o2::header::gSerializationMethodNone);
+
+  /// The message to send the payload of @a payload through @a transport, referring
+  /// to the same buffer if the transports match, holding a copy otherwise.
+  /// @a byReference tells which of the two was done.
+  static fair::mq::MessagePtr forwardedPayload(fair::mq::TransportFactory& transport, fair::mq::Message const& payload, bool& byReference);
+
   /// make an object of type T and route to output specified by OutputRef
   /// The object is owned by the framework, returned reference can be used to fill the object.
   ///
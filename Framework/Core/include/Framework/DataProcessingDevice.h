@@ -31,6 +31,8 @@
 #include <fairmq/Device.h>
 #include <fairmq/Parts.h>
 
+#include <deque>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <uv.h>
@@ -68,6 +70,8 @@ struct DeviceContext {
   int exitTransitionTimeout = 0;
 };
 
+struct ProcessingStream;
+
 struct DataProcessorContext {
   // These are specific of a given context and therefore
   // not shared by threads.
@@ -89,6 +93,11 @@ struct DataProcessorContext {
   AlgorithmSpec::ProcessCallback* statefulProcess = nullptr;
   AlgorithmSpec::ProcessCallback* statelessProcess = nullptr;
   AlgorithmSpec::ErrorCallback* error = nullptr;
+  /// The streams which run the processing callback concurrently
+  /// for different timeslices. Empty when processing on the main thread.
+  std::vector<std::unique_ptr<ProcessingStream>>* streams = nullptr;
+  /// The streams processing a timeslice, in the order they were dispatched.
+  std::deque<ProcessingStream*>* streamsInFlight = nullptr;
 
   /// Wether or not the associated DataProcessor can forward things early
   bool canForwardEarly = true;
@@ -123,6 +132,7 @@ class DataProcessingDevice : public fair::mq::Device
 {
  public:
   DataProcessingDevice(RunningDeviceRef ref, ServiceRegistry&, ProcessingPolicies& policies);
+  ~DataProcessingDevice() override;
   void Init() final;
   void InitTask() final;
   void PreRun() final;
@@ -136,6 +146,10 @@ class DataProcessingDevice : public fair::mq::Device
   static void doPrepare(DataProcessorContext& context);
   static void handleData(DataProcessorContext& context, InputChannelInfo&);
   static bool tryDispatchComputation(DataProcessorContext& context, std::vector<DataRelayer::RecordAction>& completed);
+  /// Complete, in dispatching order, the streams which are done processing,
+  /// waiting for them until at most @a maxInFlight are still in flight.
+  /// Returns true if any stream was completed.
+  static bool completeStreams(DataProcessorContext& context, size_t maxInFlight = std::numeric_limits<size_t>::max());
   std::vector<DataProcessorContext> mDataProcessorContexes;
 
  protected:
@@ -143,6 +157,9 @@ class DataProcessingDevice : public fair::mq::Device
   void fillContext(DataProcessorContext& context, DeviceContext& deviceContext);
 
  private:
+  /// Start / stop the threads of the processing streams
+  void startStreams(int nStreams);
+  void stopStreams();
   /// Initialise the socket pollers / timers
   void initPollers();
   void startPollers();
@@ -166,6 +183,9 @@ class DataProcessingDevice : public fair::mq::Device
   std::vector<ExpirationHandler> mExpirationHandlers;
   /// Completed actions
   std::vector<DataRelayer::RecordAction> mCompleted;
+  /// Streams processing timeslices concurrently, see ProcessingStream
+  std::vector<std::unique_ptr<ProcessingStream>> mProcessingStreams;
+  std::deque<ProcessingStream*> mStreamsInFlight;
 
   uint64_t mLastSlowMetricSentTimestamp = 0;         /// The timestamp of the last time we sent slow metrics
   uint64_t mLastMetricFlushedTimestamp = 0;          /// The timestamp of the last time we actually flushed metrics
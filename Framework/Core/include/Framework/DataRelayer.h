@@ -189,6 +189,12 @@ class DataRelayer
   std::vector<data_matcher::DataDescriptorMatcher> mInputMatchers;
   std::vector<data_matcher::VariableContext> mVariableContextes;
   std::vector<CacheEntryStatus> mCachedStateMetrics;
+  /// How many inputs have a header in the cache, for each slot. This
+  /// allows policies which provide a CompletionPolicy::callbackCount
+  /// to take a decision without looking at the cache.
+  std::vector<size_t> mPresentInputs;
+  /// Scratch space for the dirty slots to be checked by getReadyToProcess
+  std::vector<TimesliceSlot> mDirtySlots;
   std::vector<PruneOp> mPruneOps;
   size_t mMaxLanes;
 
@@ -16,6 +16,7 @@
 #include "Framework/DeviceState.h"
 
 #include <cstddef>
+#include <memory>
 #include <string>
 #include <vector>
 // For pid_t
@@ -26,6 +27,8 @@
 namespace o2::framework
 {
 
+class DeviceMetricsRing;
+
 struct DeviceInfo {
   /// The pid of the device associated to this device
   pid_t pid;
@@ -89,6 +92,11 @@ struct DeviceInfo {
   size_t lastSignal;
   /// An incremental number for the state of the device
   int providedState = 0;
+  /// Ring buffer in shared memory through which the device sends its
+  /// numeric metrics in binary form, if any.
+  std::shared_ptr<DeviceMetricsRing> metricsRing;
+  /// Index in the DeviceMetricsInfo of the metrics registered in the ring.
+  std::vector<size_t> metricsRingIndices;
 };
 
 } // namespace o2::framework
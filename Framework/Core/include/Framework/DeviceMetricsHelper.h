@@ -25,6 +25,7 @@
 namespace o2::framework
 {
 struct DriverInfo;
+class DeviceMetricsRing;
 
 struct DeviceMetricsHelper {
   /// Type of the callback which can be provided to be invoked every time a new
@@ -42,6 +43,24 @@ struct DeviceMetricsHelper {
   static bool processMetric(ParsedMetricMatch& results,
                             DeviceMetricsInfo& info,
                             NewMetricCallback newMetricCallback = nullptr);
+
+  /// @return the index of the metric matched by @a results, which is created
+  /// (invoking @a newMetricCallback) if not yet present in @a info.
+  static size_t findOrCreateMetric(ParsedMetricMatch& results,
+                                   DeviceMetricsInfo& info,
+                                   NewMetricCallback newMetricCallback = nullptr);
+
+  /// Stores the value of a parsed metric for the metric at @a metricIndex
+  static bool storeMetric(ParsedMetricMatch const& results, size_t metricIndex, DeviceMetricsInfo& info);
+
+  /// Processes all the binary metrics pending in the shared memory ring of a device.
+  ///
+  /// @ringIndices maps the ids of the metrics in the ring to their index in @a info
+  /// @return true if any metric was processed
+  static bool processMetricsRing(DeviceMetricsRing& ring,
+                                 std::vector<size_t>& ringIndices,
+                                 DeviceMetricsInfo& info,
+                                 NewMetricCallback newMetricCallback = nullptr);
   /// @return the index in metrics for the information of given metric
   static size_t metricIdxByName(const std::string& name,
                                 const DeviceMetricsInfo& info);
@@ -0,0 +1,133 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_DEVICEMETRICSRING_H_
+#define O2_FRAMEWORK_DEVICEMETRICSRING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+namespace o2::framework
+{
+
+/// Binary form of a numeric metric sent by a device to the driver.
+/// Each metric name is given an id by the device and sent only once,
+/// in the Register record carrying also its first value. The following
+/// values are sent in Value records, which refer to the metric by id.
+struct MetricRecord {
+  enum Kind : uint8_t {
+    Padding = 0,
+    Register = 1,
+    Value = 2
+  };
+  /// size of the record, including the name which follows a Register record
+  uint16_t size;
+  Kind kind;
+  /// one of MetricType::Int, MetricType::Float, MetricType::Uint64
+  uint8_t type;
+  uint32_t id;
+  uint64_t timestamp;
+  union {
+    int intValue;
+    float floatValue;
+    uint64_t uint64Value;
+  };
+};
+static_assert(sizeof(MetricRecord) == 24, "MetricRecord is part of the device / driver protocol");
+
+/// Single producer, single consumer lock-free ring buffer in shared
+/// memory, through which a device sends its numeric metrics to the
+/// driver as MetricRecords rather than as "[METRIC] ..." text lines.
+/// The device creates the ring, the driver attaches to it and drains it
+/// directly in the DeviceMetricsInfo of the device. When the ring is full
+/// the device falls back to the text protocol.
+class DeviceMetricsRing
+{
+ public:
+  static constexpr size_t DefaultCapacity = 1 << 20;
+
+  /// Create the ring of the device with the given pid. Capacity is rounded
+  /// up to a power of two. nullptr if the shared memory cannot be allocated.
+  static std::unique_ptr<DeviceMetricsRing> create(pid_t pid, size_t capacity = DefaultCapacity);
+  /// Attach to the ring of the device with the given pid, nullptr if not
+  /// created (yet).
+  static std::unique_ptr<DeviceMetricsRing> attach(pid_t pid);
+  /// @return the name of the shared memory segment for the given pid
+  static std::string segmentName(pid_t pid);
+
+  ~DeviceMetricsRing();
+
+  /// Append a record, followed by name for Register records.
+  /// @return false if there is no space left in the ring.
+  bool push(MetricRecord record, std::string_view name = {});
+
+  /// Invoke callback(MetricRecord const&, std::string_view name) for all
+  /// the records which were pushed so far and release their space.
+  /// @return the number of records consumed.
+  template <typename F>
+  size_t consume(F&& callback);
+
+  size_t capacity() const { return mCapacity; }
+
+ private:
+  struct Control {
+    std::atomic<uint64_t> magic;
+    uint64_t capacity;
+    // total number of bytes written and read, kept on separate cache lines
+    alignas(64) std::atomic<uint64_t> head;
+    alignas(64) std::atomic<uint64_t> tail;
+  };
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "the ring is shared between processes");
+
+  DeviceMetricsRing(void* mapping, size_t mappingSize, std::string name, bool owner);
+
+  Control* mControl;
+  char* mData;
+  size_t mCapacity;
+  void* mMapping;
+  size_t mMappingSize;
+  std::string mName;
+  bool mOwner;
+};
+
+template <typename F>
+size_t DeviceMetricsRing::consume(F&& callback)
+{
+  uint64_t tail = mControl->tail.load(std::memory_order_relaxed);
+  uint64_t head = mControl->head.load(std::memory_order_acquire);
+  size_t count = 0;
+  while (tail != head) {
+    auto const* record = reinterpret_cast<MetricRecord const*>(mData + (tail & (mCapacity - 1)));
+    if (record->size == 0 || record->size > head - tail) {
+      // corrupted, drop everything pending
+      tail = head;
+      break;
+    }
+    if (record->kind == MetricRecord::Register) {
+      callback(*record, std::string_view(reinterpret_cast<char const*>(record + 1)));
+      ++count;
+    } else if (record->kind == MetricRecord::Value) {
+      callback(*record, std::string_view{});
+      ++count;
+    }
+    tail += record->size;
+  }
+  mControl->tail.store(tail, std::memory_order_release);
+  return count;
+}
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_DEVICEMETRICSRING_H_
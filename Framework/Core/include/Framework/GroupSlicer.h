@@ -14,8 +14,10 @@
 
 #include "Framework/Pack.h"
 #include "Framework/Kernels.h"
+#include "Framework/ArrowTableSlicingCache.h"
 
 #include <arrow/util/key_value_metadata.h>
+#include <memory>
 #include <type_traits>
 #include <string>
 
@@ -25,9 +27,9 @@ namespace o2::framework
 template <typename G, typename... A>
 struct GroupSlicer {
   using grouping_t = std::decay_t<G>;
-  GroupSlicer(G& gt, std::tuple<A...>& at)
+  GroupSlicer(G& gt, std::tuple<A...>& at, ArrowTableSlicingCache* cache = nullptr)
     : max{gt.size()},
-      mBegin{GroupSlicerIterator(gt, at)}
+      mBegin{GroupSlicerIterator(gt, at, cache)}
   {
   }
 
@@ -86,15 +88,30 @@ struct GroupSlicer {
             return;
           }
           // use presorted splitting approach
-          auto result = o2::framework::sliceByColumn(mIndexColumnName.c_str(),
-                                                     name.c_str(),
-                                                     table.asArrowTable(),
-                                                     static_cast<int32_t>(mGt->tableSize()),
-                                                     &groups[index],
-                                                     &offsets[index],
-                                                     &sizes[index]);
-          if (result.ok() == false) {
-            throw runtime_error("Cannot split collection");
+          if (mCache != nullptr) {
+            // reuse the offsets computed by another process function in this timeframe
+            auto const& cached = mCache->getSortedGroups(mIndexColumnName.c_str(),
+                                                         name.c_str(),
+                                                         table.asArrowTable(),
+                                                         static_cast<int32_t>(mGt->tableSize()));
+            offsets[index] = cached.offsets;
+            sizes[index] = cached.sizes;
+            auto input = table.asArrowTable();
+            groups[index].reserve(offsets[index].size());
+            for (auto i = 0u; i < offsets[index].size(); ++i) {
+              groups[index].emplace_back(arrow::Datum{input->Slice((offsets[index])[i], (sizes[index])[i])});
+            }
+          } else {
+            auto result = o2::framework::sliceByColumn(mIndexColumnName.c_str(),
+                                                       name.c_str(),
+                                                       table.asArrowTable(),
+                                                       static_cast<int32_t>(mGt->tableSize()),
+                                                       &groups[index],
+                                                       &offsets[index],
+                                                       &sizes[index]);
+            if (result.ok() == false) {
+              throw runtime_error("Cannot split collection");
+            }
           }
           if (groups[index].size() > mGt->tableSize()) {
             throw runtime_error_f("Splitting collection %s resulted in a larger group number (%d) than there is rows in the grouping table (%d).", name.c_str(), groups[index].size(), mGt->tableSize());
@@ -104,11 +121,20 @@ struct GroupSlicer {
             return;
           }
           // use generic splitting approach
-          o2::framework::sliceByColumnGeneric(mIndexColumnName.c_str(),
-                                              name.c_str(),
-                                              table.asArrowTable(),
-                                              static_cast<int32_t>(mGt->tableSize()),
-                                              &filterGroups[index]);
+          if (mCache != nullptr) {
+            filterGroups[index] = mCache->getUnsortedGroups(mIndexColumnName.c_str(),
+                                                            name.c_str(),
+                                                            table.asArrowTable(),
+                                                            static_cast<int32_t>(mGt->tableSize()));
+          } else {
+            auto groupsList = std::make_shared<ListVector>();
+            o2::framework::sliceByColumnGeneric(mIndexColumnName.c_str(),
+                                                name.c_str(),
+                                                table.asArrowTable(),
+                                                static_cast<int32_t>(mGt->tableSize()),
+                                                groupsList.get());
+            filterGroups[index] = std::move(groupsList);
+          }
         }
       }
     }
@@ -124,10 +150,11 @@ struct GroupSlicer {
       }
     }
 
-    GroupSlicerIterator(G& gt, std::tuple<A...>& at)
+    GroupSlicerIterator(G& gt, std::tuple<A...>& at, ArrowTableSlicingCache* cache = nullptr)
       : mIndexColumnName{std::string("fIndex") + getLabelFromType<G>()},
         mGt{&gt},
         mAt{&at},
+        mCache{cache},
         mGroupingElement{gt.begin()},
         position{0}
     {
@@ -275,16 +302,17 @@ struct GroupSlicer {
           if constexpr (soa::is_soa_filtered_v<std::decay_t<A1>>) {
             // intersect selections
             o2::soa::SelectionVector s;
+            bool hasGroups = filterGroups[index] != nullptr && !filterGroups[index]->empty();
             if (selections[index]->empty()) {
-              if (!filterGroups[index].empty()) {
-                std::copy((filterGroups[index])[pos].begin(), (filterGroups[index])[pos].end(), std::back_inserter(s));
+              if (hasGroups) {
+                std::copy((*filterGroups[index])[pos].begin(), (*filterGroups[index])[pos].end(), std::back_inserter(s));
               }
             } else {
-              if (!filterGroups[index].empty()) {
+              if (hasGroups) {
                 if constexpr (std::decay_t<A1>::applyFilters) {
-                  std::set_intersection((filterGroups[index])[pos].begin(), (filterGroups[index])[pos].end(), selections[index]->begin(), selections[index]->end(), std::back_inserter(s));
+                  std::set_intersection((*filterGroups[index])[pos].begin(), (*filterGroups[index])[pos].end(), selections[index]->begin(), selections[index]->end(), std::back_inserter(s));
                 } else {
-                  std::copy((filterGroups[index])[pos].begin(), (filterGroups[index])[pos].end(), std::back_inserter(s));
+                  std::copy((*filterGroups[index])[pos].begin(), (*filterGroups[index])[pos].end(), std::back_inserter(s));
                 }
               }
             }
@@ -304,11 +332,12 @@ struct GroupSlicer {
     std::string mIndexColumnName;
     G const* mGt;
     std::tuple<A...>* mAt;
+    ArrowTableSlicingCache* mCache = nullptr;
     typename grouping_t::iterator mGroupingElement;
     uint64_t position = 0;
     gsl::span<int64_t const> groupSelection;
     std::array<std::vector<arrow::Datum>, sizeof...(A)> groups;
-    std::array<ListVector, sizeof...(A)> filterGroups;
+    std::array<std::shared_ptr<ListVector const>, sizeof...(A)> filterGroups;
     std::array<std::vector<uint64_t>, sizeof...(A)> offsets;
     std::array<std::vector<int>, sizeof...(A)> sizes;
     std::array<gsl::span<int64_t const> const*, sizeof...(A)> selections;
@@ -195,6 +195,11 @@ class InputRecord
   [[nodiscard]] DataRef getFirstValid(bool throwOnFailure = false) const;
 
   [[nodiscard]] size_t getNofParts(int pos) const;
+
+  /// The message holding the payload of a given input, nullptr if not
+  /// available. Meant to pass a payload on without copying it, see
+  /// DataAllocator::forward.
+  [[nodiscard]] fair::mq::Message const* getPayloadMessage(int pos, int part = 0) const;
   /// Get the object of specified type T for the binding R.
   /// If R is a string like object, we look up by name the InputSpec and
   /// return the data associated to the given label.
@@ -14,6 +14,8 @@
 #include "Framework/DataRef.h"
 #include <functional>
 
+#include <fairmq/FwdDecls.h>
+
 extern template class std::function<o2::framework::DataRef(size_t)>;
 extern template class std::function<o2::framework::DataRef(size_t, size_t)>;
 
@@ -48,6 +50,24 @@ class InputSpan
   /// @a size is the number of elements in the span.
   InputSpan(std::function<DataRef(size_t, size_t)> getter, std::function<size_t(size_t)> nofPartsGetter, size_t size);
 
+  /// @a getter is the mapping between an element of the span referred by
+  /// index and part and the message holding its payload, for those who
+  /// need to pass the payload on without copying it.
+  void setPayloadMessageGetter(std::function<fair::mq::Message const*(size_t, size_t)> getter)
+  {
+    mPayloadMessageGetter = std::move(getter);
+  }
+
+  /// The message holding the payload of the @a i-th element, nullptr if
+  /// not available.
+  [[nodiscard]] fair::mq::Message const* payloadMessage(size_t i, size_t partidx = 0) const
+  {
+    if (i >= mSize || !mPayloadMessageGetter) {
+      return nullptr;
+    }
+    return mPayloadMessageGetter(i, partidx);
+  }
+
   /// @a i-th element of the InputSpan
   [[nodiscard]] DataRef get(size_t i, size_t partidx = 0) const
   {
@@ -236,6 +256,7 @@ class InputSpan
  private:
   std::function<DataRef(size_t, size_t)> mGetter;
   std::function<size_t(size_t)> mNofPartsGetter;
+  std::function<fair::mq::Message const*(size_t, size_t)> mPayloadMessageGetter;
   size_t mSize;
 };
 
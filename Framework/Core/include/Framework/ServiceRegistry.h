@@ -180,12 +180,15 @@ struct ServiceRegistry {
   // only one thread writes in a given i + id location
   // as guaranteed by the atomic, mServicesKey[i + id] will
   // either be 0 or the final value.
+  // Different threads can start probing from the same location, so
+  // the thread which registered the service must match as well.
   // This method should NEVER register a new service, event when requested.
   int getPos(uint32_t typeHash, uint64_t threadId) const
   {
     auto threadHashId = (typeHash ^ threadId) & MAX_SERVICES_MASK;
     for (uint8_t i = 0; i < MAX_DISTANCE; ++i) {
-      if (mServicesKey[i + threadHashId].load() == typeHash) {
+      if (mServicesKey[i + threadHashId].load() == typeHash &&
+          mServicesMeta[i + threadHashId].threadId == threadId) {
         return i + threadHashId;
       }
     }
@@ -87,6 +87,10 @@ class TimesliceIndex
   [[nodiscard]] inline bool isValid(TimesliceSlot const& slot) const;
   [[nodiscard]] inline bool isDirty(TimesliceSlot const& slot) const;
   inline void markAsDirty(TimesliceSlot slot, bool value);
+  /// Move the slots which were marked as dirty since the last call
+  /// into @a slots, ordered by decreasing slot index. The slots stay
+  /// dirty until they are explicitly marked as clean.
+  inline void takeDirtySlots(std::vector<TimesliceSlot>& slots);
   inline void markAsInvalid(TimesliceSlot slot);
   /// Mark all the cachelines as invalid, e.g. due to an out of band event
   inline void rescan();
@@ -145,6 +149,10 @@ class TimesliceIndex
   /// This keeps track whether or not something was relayed
   /// since last time we called getReadyToProcess()
   std::vector<bool> mDirty;
+  /// The slots which became dirty since last time we called
+  /// takeDirtySlots(), so that we do not need to scan all of them.
+  /// It might contain duplicates or slots which got cleaned in the meanwhile.
+  std::vector<TimesliceSlot> mDirtySlots;
 
   /// This is the oldest possible timeslice for any given channel
   /// The cardinality of this vector is the number of input channels
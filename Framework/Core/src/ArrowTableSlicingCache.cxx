@@ -0,0 +1,77 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ArrowTableSlicingCache.h"
+#include "Framework/RuntimeError.h"
+#include <arrow/array/array_primitive.h>
+#include <arrow/datum.h>
+
+namespace o2::framework
+{
+ArrowTableSlicingCache::CacheKey ArrowTableSlicingCache::makeKey(char const* key, std::shared_ptr<arrow::Table> const& input, int32_t fullSize)
+{
+  auto column = input->GetColumnByName(key);
+  if (column == nullptr) {
+    throw runtime_error_f("Cannot find index column %s", key);
+  }
+  void const* values = nullptr;
+  if (column->num_chunks() > 0) {
+    values = static_cast<arrow::NumericArray<arrow::Int32Type>>(column->chunk(0)->data()).raw_values();
+  }
+  return {key, values, input->num_rows(), fullSize};
+}
+
+ArrowTableSlicingCache::SortedGroups const& ArrowTableSlicingCache::getSortedGroups(char const* key,
+                                                                                   char const* target,
+                                                                                   std::shared_ptr<arrow::Table> const& input,
+                                                                                   int32_t fullSize)
+{
+  ++mRequested;
+  auto cacheKey = makeKey(key, input, fullSize);
+  auto it = mSorted.find(cacheKey);
+  if (it == mSorted.end()) {
+    ++mComputed;
+    SortedGroups groups;
+    std::vector<arrow::Datum> slices;
+    auto status = sliceByColumn(key, target, input, fullSize, &slices, &groups.offsets, &groups.sizes);
+    if (status.ok() == false) {
+      throw runtime_error_f("Cannot split %s by %s", target, key);
+    }
+    it = mSorted.emplace(cacheKey, std::move(groups)).first;
+  }
+  return it->second;
+}
+
+std::shared_ptr<ListVector const> ArrowTableSlicingCache::getUnsortedGroups(char const* key,
+                                                                            char const* target,
+                                                                            std::shared_ptr<arrow::Table> const& input,
+                                                                            int32_t fullSize)
+{
+  ++mRequested;
+  auto cacheKey = makeKey(key, input, fullSize);
+  auto it = mUnsorted.find(cacheKey);
+  if (it == mUnsorted.end()) {
+    ++mComputed;
+    auto groups = std::make_shared<ListVector>();
+    sliceByColumnGeneric(key, target, input, fullSize, groups.get());
+    it = mUnsorted.emplace(cacheKey, std::move(groups)).first;
+  }
+  return it->second;
+}
+
+void ArrowTableSlicingCache::reset()
+{
+  mSorted.clear();
+  mUnsorted.clear();
+  mComputed = 0;
+  mRequested = 0;
+}
+} // namespace o2::framework
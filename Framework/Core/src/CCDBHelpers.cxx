@@ -174,6 +174,20 @@ auto populateCacheWith(std::shared_ptr<CCDBFetcherHelper> const& helper,
                        DataTakingContext& dtc,
                        DataAllocator& allocator) -> void
 {
+  // The objects of all routes are requested at once, so that the CCDB queries are processed concurrently,
+  // then the results are adopted in the order of the routes.
+  struct RouteFetch {
+    Output output;
+    o2::pmr::vector<char> v;
+    std::map<std::string, std::string> headers{};
+    std::string path{};
+    std::string etag{};
+    bool fetched = false;
+  };
+  std::vector<RouteFetch> fetches;
+  fetches.reserve(helper->routes.size()); // requests refer to the elements
+  std::unordered_map<o2::ccdb::CcdbApi const*, std::vector<o2::ccdb::CcdbApi::RequestContext>> requests;
+
   std::string ccdbMetadataPrefix = "ccdb-metadata-";
   bool checkValidityGlo = timingInfo.timeslice % helper->queryDownScaleRate == 0;
   for (auto& route : helper->routes) {
@@ -181,11 +195,11 @@ auto populateCacheWith(std::shared_ptr<CCDBFetcherHelper> const& helper,
 
     auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
     Output output{concrete.origin, concrete.description, concrete.subSpec, route.matcher.lifetime};
-    auto&& v = allocator.makeVector<char>(output);
+    auto v = allocator.makeVector<char>(output);
+    auto& fetch = fetches.emplace_back(RouteFetch{std::move(output), std::move(v)});
     std::map<std::string, std::string> metadata;
-    std::map<std::string, std::string> headers;
-    std::string path = "";
-    std::string etag = "";
+    auto& path = fetch.path;
+    auto& etag = fetch.etag;
     bool checkValidity = checkValidityGlo;
     for (auto& meta : route.matcher.metadata) {
       if (meta.name == "ccdb-path") {
@@ -212,7 +226,18 @@ auto populateCacheWith(std::shared_ptr<CCDBFetcherHelper> const& helper,
     const auto& api = helper->getAPI(path);
     if (checkValidity && (!api.isSnapshotMode() || etag.empty())) { // in the snapshot mode the object needs to be fetched only once
       LOGP(detail, "Loading {} for timestamp {}", path, timestamp);
-      api.loadFileToMemory(v, path, metadata, timestamp, &headers, etag, helper->createdNotAfter, helper->createdNotBefore);
+      requests[&api].push_back({fetch.v, path, std::move(metadata), timestamp, fetch.headers, etag, helper->createdNotAfter, helper->createdNotBefore});
+      fetch.fetched = true;
+    }
+  }
+
+  for (auto& [api, apiRequests] : requests) {
+    api->vectoredLoadFileToMemory(apiRequests);
+  }
+
+  for (auto& fetch : fetches) {
+    auto& [output, v, headers, path, etag, fetched] = fetch;
+    if (fetched) {
       if ((headers.count("Error") != 0) || (etag.empty() && v.empty())) {
         LOGP(fatal, "Unable to find object {}/{}", path, timestamp);
         // FIXME: I should send a dummy message.
@@ -9,6 +9,7 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include "Framework/CommonServices.h"
+#include "Framework/ArrowTableSlicingCache.h"
 #include "Framework/AsyncQueue.h"
 #include "Framework/ParallelContext.h"
 #include "Framework/ControlService.h"
@@ -970,5 +971,17 @@ o2::framework::ServiceSpec CommonAnalysisServices::databasePDGSpec()
     .exit = [](ServiceRegistry&, void* service) { reinterpret_cast<TDatabasePDG*>(service)->Delete(); },
     .kind = ServiceKind::Serial};
 }
+
+o2::framework::ServiceSpec CommonAnalysisServices::slicingCacheSpec()
+{
+  return ServiceSpec{
+    .name = "slicing-cache",
+    .init = CommonServices::simpleServiceInit<ArrowTableSlicingCache, ArrowTableSlicingCache>(),
+    .configure = CommonServices::noConfiguration(),
+    .preProcessing = [](ProcessingContext&, void* service) {
+      // the groupings refer to the tables of the previous dataframe
+      reinterpret_cast<ArrowTableSlicingCache*>(service)->reset(); },
+    .kind = ServiceKind::Serial};
+}
 } // namespace o2::framework
 #pragma GCC diagnostic pop
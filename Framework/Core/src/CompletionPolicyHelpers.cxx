@@ -78,27 +78,33 @@ CompletionPolicy CompletionPolicyHelpers::defineByName(std::string const& name,
   auto callback = [op](InputSpan const&) -> CompletionPolicy::CompletionOp {
     return op;
   };
+  auto withCount = [op](CompletionPolicy policy) -> CompletionPolicy {
+    policy.callbackCount = [op](size_t, size_t) -> CompletionPolicy::CompletionOp {
+      return op;
+    };
+    return policy;
+  };
   switch (op) {
     case CompletionPolicy::CompletionOp::Consume:
-      return CompletionPolicy{"always-consume", matcher, callback};
+      return withCount(CompletionPolicy{"always-consume", matcher, callback});
       break;
     case CompletionPolicy::CompletionOp::ConsumeExisting:
-      return CompletionPolicy{"consume-existing", matcher, callback};
+      return withCount(CompletionPolicy{"consume-existing", matcher, callback});
       break;
     case CompletionPolicy::CompletionOp::Process:
-      return CompletionPolicy{"always-process", matcher, callback};
+      return withCount(CompletionPolicy{"always-process", matcher, callback});
       break;
     case CompletionPolicy::CompletionOp::Wait:
-      return CompletionPolicy{"always-wait", matcher, callback};
+      return withCount(CompletionPolicy{"always-wait", matcher, callback});
       break;
     case CompletionPolicy::CompletionOp::Discard:
-      return CompletionPolicy{"always-discard", matcher, callback};
+      return withCount(CompletionPolicy{"always-discard", matcher, callback});
       break;
     case CompletionPolicy::CompletionOp::ConsumeAndRescan:
-      return CompletionPolicy{"always-rescan", matcher, callback};
+      return withCount(CompletionPolicy{"always-rescan", matcher, callback});
       break;
     case CompletionPolicy::CompletionOp::Retry:
-      return CompletionPolicy{"retry", matcher, callback};
+      return withCount(CompletionPolicy{"retry", matcher, callback});
       break;
   }
   O2_BUILTIN_UNREACHABLE();
@@ -114,7 +120,11 @@ CompletionPolicy CompletionPolicyHelpers::consumeWhenAll(const char* name, Compl
     }
     return CompletionPolicy::CompletionOp::Consume;
   };
-  return CompletionPolicy{name, matcher, callback};
+  CompletionPolicy policy{name, matcher, callback};
+  policy.callbackCount = [](size_t present, size_t total) -> CompletionPolicy::CompletionOp {
+    return present == total ? CompletionPolicy::CompletionOp::Consume : CompletionPolicy::CompletionOp::Wait;
+  };
+  return policy;
 }
 
 CompletionPolicy CompletionPolicyHelpers::consumeWhenAllOrdered(const char* name, CompletionPolicy::Matcher matcher)
@@ -206,7 +216,11 @@ CompletionPolicy CompletionPolicyHelpers::consumeWhenAny(const char* name, Compl
     }
     return CompletionPolicy::CompletionOp::Wait;
   };
-  return CompletionPolicy{name, matcher, callback};
+  CompletionPolicy policy{name, matcher, callback};
+  policy.callbackCount = [](size_t present, size_t) -> CompletionPolicy::CompletionOp {
+    return present != 0 ? CompletionPolicy::CompletionOp::Consume : CompletionPolicy::CompletionOp::Wait;
+  };
+  return policy;
 }
 
 CompletionPolicy CompletionPolicyHelpers::consumeWhenAny(std::string matchName)
@@ -233,7 +247,16 @@ CompletionPolicy CompletionPolicyHelpers::processWhenAny(const char* name, Compl
     }
     return CompletionPolicy::CompletionOp::Process;
   };
-  return CompletionPolicy{name, matcher, callback};
+  CompletionPolicy policy{name, matcher, callback};
+  policy.callbackCount = [](size_t present, size_t total) -> CompletionPolicy::CompletionOp {
+    if (present == total) {
+      return CompletionPolicy::CompletionOp::Consume;
+    } else if (present == 0) {
+      return CompletionPolicy::CompletionOp::Wait;
+    }
+    return CompletionPolicy::CompletionOp::Process;
+  };
+  return policy;
 }
 
 } // namespace o2::framework
@@ -11,9 +11,13 @@
 
 #include "DPLMonitoringBackend.h"
 #include "Framework/DriverClient.h"
+#include "Framework/DeviceMetricsInfo.h"
+#include "Framework/DeviceMetricsRing.h"
 #include "Framework/ServiceRegistry.h"
 #include <fmt/format.h>
+#include <cstdlib>
 #include <sstream>
+#include <unistd.h>
 
 namespace o2::framework
 {
@@ -29,8 +33,13 @@ overloaded(Ts...) -> overloaded<Ts...>;
 DPLMonitoringBackend::DPLMonitoringBackend(ServiceRegistry& registry)
   : mRegistry{registry}
 {
+  if (getenv("DPL_SHM_METRICS")) {
+    mRing = DeviceMetricsRing::create(getpid());
+  }
 }
 
+DPLMonitoringBackend::~DPLMonitoringBackend() = default;
+
 void DPLMonitoringBackend::addGlobalTag(std::string_view name, std::string_view value)
 {
   // FIXME: tags are ignored by DPL in any case...
@@ -51,8 +60,49 @@ inline unsigned long convertTimestamp(const std::chrono::time_point<std::chrono:
     .count();
 }
 
+bool DPLMonitoringBackend::sendBinary(o2::monitoring::Metric const& metric)
+{
+  if (metric.getValuesSize() != 1) {
+    return false;
+  }
+  MetricRecord record{};
+  auto const& value = metric.getValues()[0].second;
+  if (auto const* v = std::get_if<int>(&value)) {
+    record.type = (uint8_t)MetricType::Int;
+    record.intValue = *v;
+  } else if (auto const* v = std::get_if<double>(&value)) {
+    record.type = (uint8_t)MetricType::Float;
+    record.floatValue = *v;
+  } else if (auto const* v = std::get_if<uint64_t>(&value)) {
+    record.type = (uint8_t)MetricType::Uint64;
+    record.uint64Value = *v;
+  } else {
+    return false;
+  }
+  record.timestamp = convertTimestamp(metric.getTimestamp());
+
+  std::lock_guard<std::mutex> lock(mRingMutex);
+  auto id = mRingIds.find(metric.getName());
+  if (id != mRingIds.end()) {
+    record.kind = MetricRecord::Value;
+    record.id = id->second;
+    return mRing->push(record);
+  }
+  record.kind = MetricRecord::Register;
+  record.id = mRingIds.size();
+  if (mRing->push(record, metric.getName()) == false) {
+    return false;
+  }
+  mRingIds.emplace(metric.getName(), record.id);
+  return true;
+}
+
 void DPLMonitoringBackend::send(o2::monitoring::Metric const& metric)
 {
+  // text is the fallback for what cannot go in the ring
+  if (mRing && sendBinary(metric)) {
+    return;
+  }
   std::array<char, 4096> buffer;
   auto mStream = fmt::format_to(buffer.begin(), "[METRIC] {}", metric.getName());
   for (auto& value : metric.getValues()) {
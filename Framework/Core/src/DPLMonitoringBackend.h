@@ -12,12 +12,16 @@
 #define O2_FRAMEWORK_DPLMONITORINGBACKEND_H_
 
 #include "Monitoring/Backend.h"
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace o2::framework
 {
 
 struct ServiceRegistry;
+class DeviceMetricsRing;
 
 /// \brief Prints metrics to standard output via std::cout
 class DPLMonitoringBackend final : public o2::monitoring::Backend
@@ -27,7 +31,7 @@ class DPLMonitoringBackend final : public o2::monitoring::Backend
   DPLMonitoringBackend(ServiceRegistry& registry);
 
   /// Default destructor
-  ~DPLMonitoringBackend() override = default;
+  ~DPLMonitoringBackend() override;
 
   /// Prints metric
   /// \param metric           reference to metric object
@@ -43,9 +47,16 @@ class DPLMonitoringBackend final : public o2::monitoring::Backend
   void addGlobalTag(std::string_view name, std::string_view value) override;
 
  private:
+  /// Sends a numeric metric via the shared memory ring
+  /// \return false if the metric has to be sent as text
+  bool sendBinary(const o2::monitoring::Metric& metric);
+
   std::string mTagString;    ///< Global tagset (common for each metric)
   const std::string mPrefix; ///< Metric prefix
   ServiceRegistry& mRegistry;
+  std::unique_ptr<DeviceMetricsRing> mRing; ///< Binary transport to the driver, if enabled
+  std::unordered_map<std::string, uint32_t> mRingIds; ///< Ids of the metrics registered in the ring
+  std::mutex mRingMutex;                              ///< The ring has a single producer
 };
 
 } // namespace o2::framework
@@ -275,6 +275,36 @@ void DataAllocator::snapshot(const Output& spec, const char* payload, size_t pay
   addPartToContext(std::move(payloadMessage), spec, serializationMethod);
 }
 
+bool DataAllocator::forward(const Output& spec, fair::mq::Message const& payload,
+                            o2::header::SerializationMethod serializationMethod)
+{
+  auto& proxy = mRegistry->get<FairMQDeviceProxy>();
+  auto& timingInfo = mRegistry->get<TimingInfo>();
+
+  RouteIndex routeIndex = matchDataHeader(spec, timingInfo.timeslice);
+  bool byReference = false;
+  auto payloadMessage = forwardedPayload(*proxy.getOutputTransport(routeIndex), payload, byReference);
+
+  addPartToContext(std::move(payloadMessage), spec, serializationMethod);
+  return byReference;
+}
+
+fair::mq::MessagePtr DataAllocator::forwardedPayload(fair::mq::TransportFactory& transport, fair::mq::Message const& payload, bool& byReference)
+{
+  fair::mq::MessagePtr payloadMessage;
+  byReference = transport.GetType() == payload.GetType();
+  if (byReference) {
+    payloadMessage = transport.CreateMessage();
+    payloadMessage->Copy(payload);
+  } else {
+    payloadMessage = transport.CreateMessage(payload.GetSize(), fair::mq::Alignment{64});
+    if (payload.GetSize() > 0) {
+      memcpy(payloadMessage->GetData(), payload.GetData(), payload.GetSize());
+    }
+  }
+  return payloadMessage;
+}
+
 Output DataAllocator::getOutputByBind(OutputRef&& ref)
 {
   if (ref.label.empty()) {
@@ -14,11 +14,13 @@
 #endif
 #include "Framework/AsyncQueue.h"
 #include "Framework/DataProcessingDevice.h"
+#include "Framework/ArrowContext.h"
 #include "Framework/ChannelMatching.h"
 #include "Framework/ControlService.h"
 #include "Framework/ComputingQuotaEvaluator.h"
 #include "Framework/DataProcessingHeader.h"
 #include "Framework/DataProcessor.h"
+#include "Framework/DataSender.h"
 #include "Framework/DataSpecUtils.h"
 #include "Framework/DeviceState.h"
 #include "Framework/DispatchPolicy.h"
@@ -34,8 +36,12 @@
 #include "Framework/TMessageSerializer.h"
 #include "Framework/InputRecord.h"
 #include "Framework/InputSpan.h"
+#include "Framework/MessageContext.h"
+#include "Framework/ProcessingContext.h"
+#include "Framework/RawBufferContext.h"
 #include "Framework/Signpost.h"
 #include "Framework/SourceInfoHeader.h"
+#include "Framework/StringContext.h"
 #include "Framework/Logger.h"
 #include "Framework/DriverClient.h"
 #include "Framework/Monitoring.h"
@@ -63,9 +69,12 @@
 #include <TClonesArray.h>
 
 #include <algorithm>
+#include <condition_variable>
 #include <vector>
 #include <numeric>
 #include <memory>
+#include <optional>
+#include <thread>
 #include <unordered_map>
 #include <uv.h>
 #include <execinfo.h>
@@ -108,6 +117,111 @@ void on_communication_requested(uv_async_t* s)
   state->loopReason |= DeviceState::METRICS_MUST_FLUSH;
 }
 
+/// Maximum number of streams which can process timeslices concurrently.
+/// Each stream books its own contexts, plus an alias for every service
+/// the user code looks up, in the fixed size ServiceRegistry.
+constexpr int MAX_PROCESSING_STREAMS = 4;
+
+/// A thread running the processing callback for one timeslice at the time.
+/// The stream has its own TimingInfo and output contexts, registered as
+/// Stream services for its thread, so that the DataAllocator used by the
+/// processing never touches the ones of the main thread. Everything else
+/// (relaying, forwarding, sending the outputs) is done by the main thread
+/// when the timeslice is dispatched to the stream and when it completes.
+struct ProcessingStream {
+  ProcessingStream(FairMQDeviceProxy& proxy, DataAllocator const& deviceAllocator)
+    : messageContext{proxy},
+      stringContext{proxy},
+      rawBufferContext{proxy},
+      arrowContext{proxy},
+      allocator{deviceAllocator}
+  {
+  }
+
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable condition;
+  /// Protected by the mutex
+  bool hasWork = false;
+  bool done = false;
+  bool quit = false;
+  /// Whether a timeslice was dispatched to the stream and not yet
+  /// completed. Only used by the main thread.
+  bool busy = false;
+
+  TimingInfo timingInfo;
+  MessageContext messageContext;
+  StringContext stringContext;
+  RawBufferContext rawBufferContext;
+  ArrowContext arrowContext;
+  DataAllocator allocator;
+
+  /// The timeslice being processed
+  DataRelayer::RecordAction action;
+  std::vector<MessageSet> inputs;
+  std::unique_ptr<InputSpan> span;
+  std::unique_ptr<InputRecord> record;
+  std::unique_ptr<ProcessingContext> processContext;
+  uint64_t tStart = 0;
+  /// The error thrown by the processing, handled on the main thread.
+  std::optional<RuntimeErrorRef> error;
+};
+
+// The loop of a processing stream. It waits for a timeslice to be
+// dispatched, runs the user callbacks on it and wakes up the main
+// thread, which will then complete it.
+void runProcessingStream(ProcessingStream& stream, DataProcessorContext& context)
+{
+  auto& registry = *context.registry;
+  static bool noCatch = getenv("O2_NO_CATCHALL_EXCEPTIONS") && strcmp(getenv("O2_NO_CATCHALL_EXCEPTIONS"), "0");
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(stream.mutex);
+      stream.condition.wait(lock, [&stream]() { return stream.hasWork || stream.quit; });
+      if (stream.quit) {
+        return;
+      }
+    }
+    auto& action = stream.action;
+    auto& processContext = *stream.processContext;
+    auto runNoCatch = [&]() {
+      registry.get<CallbackService>()(CallbackService::Id::PreProcessing, registry, (int)action.op);
+      if (*context.statefulProcess) {
+        ZoneScopedN("statefull process");
+        (*context.statefulProcess)(processContext);
+      } else {
+        ZoneScopedN("stateless process");
+        (*context.statelessProcess)(processContext);
+      }
+      // Notify the sink we just consumed some timeframe data
+      if (context.isSink) {
+        stream.allocator.make<int>(OutputRef{"dpl-summary", compile_time_hash(context.deviceContext->spec->name.c_str())}, 1);
+      }
+      registry.get<CallbackService>()(CallbackService::Id::PostProcessing, registry, (int)action.op);
+    };
+
+    if (noCatch) {
+      runNoCatch();
+    } else {
+      try {
+        runNoCatch();
+      } catch (std::exception& ex) {
+        stream.error = runtime_error(ex.what());
+      } catch (o2::framework::RuntimeErrorRef e) {
+        stream.error = e;
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(stream.mutex);
+      stream.hasWork = false;
+      stream.done = true;
+    }
+    stream.condition.notify_all();
+    uv_async_send(context.deviceContext->state->awakeMainThread);
+  }
+}
+
 DataProcessingDevice::DataProcessingDevice(RunningDeviceRef ref, ServiceRegistry& registry, ProcessingPolicies& policies)
   : mSpec{registry.get<RunningWorkflowInfo const>().devices[ref.index]},
     mState{registry.get<DeviceState>()},
@@ -194,9 +308,53 @@ DataProcessingDevice::DataProcessingDevice(RunningDeviceRef ref, ServiceRegistry
   });
 }
 
+DataProcessingDevice::~DataProcessingDevice()
+{
+  stopStreams();
+}
+
+void DataProcessingDevice::startStreams(int nStreams)
+{
+  LOGP(info, "Starting {} processing streams. The processing callback must be reentrant.", nStreams);
+  auto& context = mDataProcessorContexes.at(0);
+  auto& proxy = mServiceRegistry.get<FairMQDeviceProxy>();
+  std::hash<std::thread::id> hasher;
+  for (int si = 0; si < nStreams; ++si) {
+    auto& stream = mProcessingStreams.emplace_back(std::make_unique<ProcessingStream>(proxy, mAllocator));
+    stream->thread = std::thread(runProcessingStream, std::ref(*stream), std::ref(context));
+    // The thread only looks up its services once some work is dispatched
+    // to it, so we can safely register them from here.
+    auto tid = hasher(stream->thread.get_id());
+    mServiceRegistry.registerService(TypeIdHelpers::uniqueId<TimingInfo>(), &stream->timingInfo, ServiceKind::Stream, tid, "timing-info");
+    mServiceRegistry.registerService(TypeIdHelpers::uniqueId<MessageContext>(), &stream->messageContext, ServiceKind::Stream, tid, "message-backend");
+    mServiceRegistry.registerService(TypeIdHelpers::uniqueId<StringContext>(), &stream->stringContext, ServiceKind::Stream, tid, "string-backend");
+    mServiceRegistry.registerService(TypeIdHelpers::uniqueId<RawBufferContext>(), &stream->rawBufferContext, ServiceKind::Stream, tid, "raw-backend");
+    mServiceRegistry.registerService(TypeIdHelpers::uniqueId<ArrowContext>(), &stream->arrowContext, ServiceKind::Stream, tid, "arrow-backend");
+  }
+}
+
+void DataProcessingDevice::stopStreams()
+{
+  for (auto& stream : mProcessingStreams) {
+    {
+      std::lock_guard<std::mutex> lock(stream->mutex);
+      stream->quit = true;
+    }
+    stream->condition.notify_all();
+  }
+  for (auto& stream : mProcessingStreams) {
+    if (stream->thread.joinable()) {
+      stream->thread.join();
+    }
+  }
+  mStreamsInFlight.clear();
+  mProcessingStreams.clear();
+}
+
 // Callback to execute the processing. Notice how the data is
-// is a vector of DataProcessorContext so that we can index the correct
-// one with the thread id. For the moment we simply use the first one.
+// the TaskStreamInfo of the task, which points to the
+// DataProcessorContext associated to it. The user processing
+// itself can then be offloaded to the ProcessingStreams.
 void run_callback(uv_work_t* handle)
 {
   ZoneScopedN("run_callback");
@@ -846,6 +1004,18 @@ void DataProcessingDevice::InitTask()
   mDataProcessorContexes.resize(1);
   this->fillContext(mDataProcessorContexes.at(0), mDeviceContext);
 
+  // The user processing can run concurrently for more timeslices
+  // in separate streams. The threads are created only once, because
+  // their services stay registered for the lifetime of the device.
+  int nStreams = std::stoi(fConfig->GetValue<std::string>("streams"));
+  if (nStreams < 1 || nStreams > MAX_PROCESSING_STREAMS) {
+    LOGP(warning, "Requested {} streams, clamping to [1, {}]", nStreams, MAX_PROCESSING_STREAMS);
+    nStreams = std::clamp(nStreams, 1, MAX_PROCESSING_STREAMS);
+  }
+  if (nStreams > 1 && mProcessingStreams.empty()) {
+    this->startStreams(nStreams);
+  }
+
   /// We now run an event loop also in InitTask. This is needed to:
   /// * Make sure region registration callbacks are invoked
   /// on the main thread.
@@ -896,6 +1066,8 @@ void DataProcessingDevice::fillContext(DataProcessorContext& context, DeviceCont
   context.statefulProcess = &mStatefulProcess;
   context.statelessProcess = &mStatelessProcess;
   context.error = &mError;
+  context.streams = &mProcessingStreams;
+  context.streamsInFlight = &mStreamsInFlight;
   context.deviceContext = &deviceContext;
   /// Callback for the error handling
   context.errorHandling = &mErrorHandling;
@@ -1082,6 +1254,7 @@ void DataProcessingDevice::Run()
         continue;
       }
       streamRef.index = ti;
+      break;
     }
     using o2::monitoring::Metric;
     using o2::monitoring::Monitoring;
@@ -1112,7 +1285,7 @@ void DataProcessingDevice::Run()
         stream.running = true;
         stream.context = &mDataProcessorContexes.at(0);
 #ifdef DPL_ENABLE_THREADING
-        stream.task.data = &handle;
+        stream.task.data = &stream;
         uv_queue_work(mState.loop, &stream.task, run_callback, run_completion);
 #else
         run_callback(&handle);
@@ -1127,6 +1300,10 @@ void DataProcessingDevice::Run()
     }
     FrameMark;
   }
+  /// Send the outputs of the timeslices still being processed.
+  if (mDataProcessorContexes.empty() == false) {
+    completeStreams(mDataProcessorContexes.at(0), 0);
+  }
   /// Cleanup messages which are still pending on exit.
   for (size_t ci = 0; ci < mDeviceContext.spec->inputChannels.size(); ++ci) {
     auto& info = mDeviceContext.state->inputChannelInfos[ci];
@@ -1328,6 +1505,7 @@ void DataProcessingDevice::doRun(DataProcessorContext& context)
     while (DataProcessingDevice::tryDispatchComputation(context, *context.completed) && hasOnlyGenerated == false) {
       context.relayer->processDanglingInputs(*context.expirationHandlers, *context.registry, false);
     }
+    completeStreams(context, 0);
     EndOfStreamContext eosContext{*context.registry, *context.allocator};
 
     context.registry->preEOSCallbacks(eosContext);
@@ -1689,8 +1867,107 @@ void update_maximum(std::atomic<T>& maximum_value, T const& value) noexcept
          !maximum_value.compare_exchange_weak(prev_value, value)) {
   }
 }
+
+void preUpdateStats(DataProcessingStats& stats, DataRelayer::RecordAction const& action, InputRecord const& record)
+{
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t ai = 0; ai != record.size(); ai++) {
+    auto cacheId = action.slot.index * record.size() + ai;
+    auto state = record.isValid(ai) ? 2 : 0;
+    update_maximum(stats.statesSize, cacheId + 1);
+    assert(cacheId < DataProcessingStats::MAX_RELAYER_STATES);
+    stats.relayerState[cacheId].store(state);
+  }
+}
+
+void postUpdateStats(DataProcessingStats& stats, DataRelayer::RecordAction const& action, InputRecord const& record, uint64_t tStart)
+{
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t ai = 0; ai != record.size(); ai++) {
+    auto cacheId = action.slot.index * record.size() + ai;
+    auto state = record.isValid(ai) ? 3 : 0;
+    update_maximum(stats.statesSize, cacheId + 1);
+    assert(cacheId < DataProcessingStats::MAX_RELAYER_STATES);
+    stats.relayerState[cacheId].store(state);
+  }
+  uint64_t tEnd = uv_hrtime();
+  stats.lastElapsedTimeMs = tEnd - tStart;
+  stats.lastProcessedSize = calculateTotalInputRecordSize(record);
+  stats.totalProcessedSize += stats.lastProcessedSize;
+  stats.lastLatency = calculateInputRecordLatency(record, tStart);
+}
 } // namespace
 
+bool DataProcessingDevice::completeStreams(DataProcessorContext& context, size_t maxInFlight)
+{
+  if (context.streamsInFlight == nullptr) {
+    return false;
+  }
+  auto& inFlight = *context.streamsInFlight;
+  auto& registry = *context.registry;
+  bool hasForwards = context.deviceContext->spec->forwards.empty() == false;
+  bool completedSome = false;
+  while (inFlight.empty() == false) {
+    auto& stream = *inFlight.front();
+    {
+      std::unique_lock<std::mutex> lock(stream.mutex);
+      if (stream.done == false && inFlight.size() <= maxInFlight) {
+        break;
+      }
+      stream.condition.wait(lock, [&stream]() { return stream.done; });
+      stream.done = false;
+    }
+    inFlight.pop_front();
+    completedSome = true;
+    ZoneScopedN("DataProcessingDevice::completeStream");
+    auto& action = stream.action;
+    auto& record = *stream.record;
+    auto& processContext = *stream.processContext;
+    // Whatever the main thread creates from now on belongs
+    // to the timeslice of the stream.
+    *context.timingInfo = stream.timingInfo;
+    if (stream.error.has_value()) {
+      ZoneScopedN("error handling");
+      (*context.errorHandling)(*stream.error, record);
+    } else {
+      ZoneScopedN("service post processing");
+      auto& sender = registry.get<DataSender>();
+      DataProcessor::doSend(sender, stream.messageContext, registry);
+      DataProcessor::doSend(sender, stream.stringContext, registry);
+      DataProcessor::doSend(sender, stream.rawBufferContext, registry);
+      // Arrow tables are finalised and accounted for by the
+      // context of the device, when it gets sent below.
+      auto& arrowContext = registry.get<ArrowContext>();
+      for (auto& message : stream.arrowContext) {
+        arrowContext.addBuffer(std::move(message.header), std::move(message.buffer), std::move(message.finalize), message.routeIndex);
+      }
+      registry.postProcessingCallbacks(processContext);
+    }
+    stream.messageContext.clear();
+    stream.stringContext.clear();
+    stream.rawBufferContext.clear();
+    stream.arrowContext.clear();
+
+    postUpdateStats(registry.get<DataProcessingStats>(), action, record, stream.tStart);
+    registry.postDispatchingCallbacks(processContext);
+    registry.get<CallbackService>()(CallbackService::Id::DataConsumed, registry);
+    if ((context.canForwardEarly == false) && hasForwards) {
+      LOGP(debug, "Late forwarding");
+      auto& timesliceIndex = registry.get<TimesliceIndex>();
+      forwardInputs(registry, action.slot, stream.inputs, timesliceIndex.getOldestPossibleOutput(), false, true);
+    }
+    registry.postForwardingCallbacks(processContext);
+
+    stream.processContext.reset();
+    stream.record.reset();
+    stream.span.reset();
+    stream.inputs.clear();
+    stream.error.reset();
+    stream.busy = false;
+  }
+  return completedSome;
+}
+
 bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context, std::vector<DataRelayer::RecordAction>& completed)
 {
   ZoneScopedN("DataProcessingDevice::tryDispatchComputation");
@@ -1728,15 +2005,14 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
   };
 
   //
-  auto getInputSpan = [&relayer = context.relayer,
-                       &currentSetOfInputs](TimesliceSlot slot, bool consume = true) {
+  auto getInputSpan = [&relayer = context.relayer](std::vector<MessageSet>& inputs, TimesliceSlot slot, bool consume = true) {
     if (consume) {
-      currentSetOfInputs = relayer->consumeAllInputsForTimeslice(slot);
+      inputs = relayer->consumeAllInputsForTimeslice(slot);
     } else {
-      currentSetOfInputs = relayer->consumeExistingInputsForTimeslice(slot);
+      inputs = relayer->consumeExistingInputsForTimeslice(slot);
     }
-    auto getter = [&currentSetOfInputs](size_t i, size_t partindex) -> DataRef {
-      if (currentSetOfInputs[i].getNumberOfPairs() > partindex) {
+    auto getter = [&inputs](size_t i, size_t partindex) -> DataRef {
+      if (inputs[i].getNumberOfPairs() > partindex) {
         const char* headerptr = nullptr;
         const char* payloadptr = nullptr;
         size_t payloadSize = 0;
@@ -1745,8 +2021,8 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
         //   sequence is the header message
         // - each part has one or more payload messages
         // - InputRecord provides all payloads as header-payload pairs
-        auto const& headerMsg = currentSetOfInputs[i].associatedHeader(partindex);
-        auto const& payloadMsg = currentSetOfInputs[i].associatedPayload(partindex);
+        auto const& headerMsg = inputs[i].associatedHeader(partindex);
+        auto const& payloadMsg = inputs[i].associatedPayload(partindex);
         headerptr = static_cast<char const*>(headerMsg->GetData());
         payloadptr = payloadMsg ? static_cast<char const*>(payloadMsg->GetData()) : nullptr;
         payloadSize = payloadMsg ? payloadMsg->GetSize() : 0;
@@ -1754,10 +2030,18 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
       }
       return DataRef{};
     };
-    auto nofPartsGetter = [&currentSetOfInputs](size_t i) -> size_t {
-      return currentSetOfInputs[i].getNumberOfPairs();
+    auto nofPartsGetter = [&inputs](size_t i) -> size_t {
+      return inputs[i].getNumberOfPairs();
     };
-    return InputSpan{getter, nofPartsGetter, currentSetOfInputs.size()};
+    auto payloadMessageGetter = [&inputs](size_t i, size_t partindex) -> fair::mq::Message const* {
+      if (inputs[i].getNumberOfPairs() > partindex) {
+        return inputs[i].associatedPayload(partindex).get();
+      }
+      return nullptr;
+    };
+    InputSpan span{getter, nofPartsGetter, inputs.size()};
+    span.setPayloadMessageGetter(payloadMessageGetter);
+    return span;
   };
 
   auto markInputsAsDone = [&relayer = context.relayer](TimesliceSlot slot) -> void {
@@ -1831,37 +2115,16 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     control.notifyStreamingState(state->streaming);
   };
 
+  // Send what the processing streams are done with, so that
+  // their outputs leave the device as soon as possible.
+  bool completedStreams = completeStreams(context);
+
   if (canDispatchSomeComputation() == false) {
     LOGP(debug, "No computations available for dispatching.");
-    return false;
+    return completedStreams;
   }
 
-  auto postUpdateStats = [&stats = context.registry->get<DataProcessingStats>()](DataRelayer::RecordAction const& action, InputRecord const& record, uint64_t tStart) {
-    std::atomic_thread_fence(std::memory_order_release);
-    for (size_t ai = 0; ai != record.size(); ai++) {
-      auto cacheId = action.slot.index * record.size() + ai;
-      auto state = record.isValid(ai) ? 3 : 0;
-      update_maximum(stats.statesSize, cacheId + 1);
-      assert(cacheId < DataProcessingStats::MAX_RELAYER_STATES);
-      stats.relayerState[cacheId].store(state);
-    }
-    uint64_t tEnd = uv_hrtime();
-    stats.lastElapsedTimeMs = tEnd - tStart;
-    stats.lastProcessedSize = calculateTotalInputRecordSize(record);
-    stats.totalProcessedSize += stats.lastProcessedSize;
-    stats.lastLatency = calculateInputRecordLatency(record, tStart);
-  };
-
-  auto preUpdateStats = [&stats = context.registry->get<DataProcessingStats>()](DataRelayer::RecordAction const& action, InputRecord const& record, uint64_t) {
-    std::atomic_thread_fence(std::memory_order_release);
-    for (size_t ai = 0; ai != record.size(); ai++) {
-      auto cacheId = action.slot.index * record.size() + ai;
-      auto state = record.isValid(ai) ? 2 : 0;
-      update_maximum(stats.statesSize, cacheId + 1);
-      assert(cacheId < DataProcessingStats::MAX_RELAYER_STATES);
-      stats.relayerState[cacheId].store(state);
-    }
-  };
+  auto& stats = context.registry->get<DataProcessingStats>();
 
   // This is the main dispatching loop
   LOGP(debug, "Processing actions:");
@@ -1881,10 +2144,57 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
         break;
     }
 
+    // Timeslices to be consumed are processed by the streams, when
+    // there are any. Only the user callbacks run on the stream, the
+    // rest happens here and in completeStreams, on the main thread.
+    bool useStream = context.streams != nullptr && context.streams->empty() == false &&
+                     action.op == CompletionPolicy::CompletionOp::Consume &&
+                     context.deviceContext->state->quitRequested == false &&
+                     (*context.statefulProcess || *context.statelessProcess);
+    if (useStream) {
+      // We cannot skip the action if all the streams are busy,
+      // because it would not be offered again. Wait for the oldest.
+      completeStreams(context, context.streams->size() - 1);
+      auto freeStream = std::find_if(context.streams->begin(), context.streams->end(), [](auto const& stream) { return stream->busy == false; });
+      assert(freeStream != context.streams->end());
+      auto& stream = **freeStream;
+
+      prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot});
+      stream.timingInfo = *context.timingInfo;
+      stream.action = action;
+      stream.span = std::make_unique<InputSpan>(getInputSpan(stream.inputs, action.slot, true));
+      stream.record = std::make_unique<InputRecord>(context.deviceContext->spec->inputs, *stream.span, *context.registry);
+      stream.processContext = std::make_unique<ProcessingContext>(*stream.record, *context.registry, stream.allocator);
+      {
+        ZoneScopedN("service pre processing");
+        context.registry->preProcessingCallbacks(*stream.processContext);
+      }
+      if (context.canForwardEarly && context.deviceContext->spec->forwards.empty() == false) {
+        LOGP(debug, "  - Early forwarding");
+        auto& timesliceIndex = context.registry->get<TimesliceIndex>();
+        forwardInputs(*context.registry, action.slot, stream.inputs, timesliceIndex.getOldestPossibleOutput(), true, true);
+      }
+      markInputsAsDone(action.slot);
+      stream.tStart = uv_hrtime();
+      preUpdateStats(stats, action, *stream.record);
+
+      stream.busy = true;
+      {
+        std::lock_guard<std::mutex> lock(stream.mutex);
+        stream.hasWork = true;
+      }
+      stream.condition.notify_all();
+      context.streamsInFlight->push_back(&stream);
+      continue;
+    }
+    // Anything else is processed here, once the streams are done,
+    // so that the outputs still leave in the dispatching order.
+    completeStreams(context, 0);
+
     prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot});
     bool shouldConsume = action.op == CompletionPolicy::CompletionOp::Consume ||
                          action.op == CompletionPolicy::CompletionOp::Discard;
-    InputSpan span = getInputSpan(action.slot, shouldConsume);
+    InputSpan span = getInputSpan(currentSetOfInputs, action.slot, shouldConsume);
     InputRecord record{context.deviceContext->spec->inputs,
                        span,
                        *context.registry};
@@ -1917,7 +2227,7 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     markInputsAsDone(action.slot);
 
     uint64_t tStart = uv_hrtime();
-    preUpdateStats(action, record, tStart);
+    preUpdateStats(stats, action, record);
 
     static bool noCatch = getenv("O2_NO_CATCHALL_EXCEPTIONS") && strcmp(getenv("O2_NO_CATCHALL_EXCEPTIONS"), "0");
 
@@ -1979,7 +2289,7 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
       context.deviceContext->state->severityStack.pop_back();
     }
 
-    postUpdateStats(action, record, tStart);
+    postUpdateStats(stats, action, record, tStart);
     // We forward inputs only when we consume them. If we simply Process them,
     // we keep them for next message arriving.
     if (action.op == CompletionPolicy::CompletionOp::Consume) {
@@ -2002,6 +2312,7 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
   }
   // We now broadcast the end of stream if it was requested
   if (context.deviceContext->state->streaming == StreamingState::EndOfStreaming) {
+    completeStreams(context, 0);
     LOGP(detail, "Broadcasting end of stream");
     for (auto& channel : context.deviceContext->spec->outputChannels) {
       DataProcessingHelpers::sendEndOfStream(*context.deviceContext->device, channel);
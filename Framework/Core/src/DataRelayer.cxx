@@ -214,6 +214,8 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
       PartRef newRef;
       expirator.handler(services, newRef, variables);
       part.reset(std::move(newRef));
+      // We only get here if the part had no header.
+      mPresentInputs[ti]++;
       activity.expiredSlots++;
 
       mTimesliceIndex.markAsDirty(slot, true);
@@ -322,6 +324,7 @@ void DataRelayer::pruneCache(TimesliceSlot slot, OnDropCallback onDrop)
   auto pruneCache = [&onDrop,
                      &cache = mCache,
                      &cachedStateMetrics = mCachedStateMetrics,
+                     &presentInputs = mPresentInputs,
                      numInputTypes = mDistinctRoutesIndex.size(),
                      &index = mTimesliceIndex,
                      &metrics = mMetrics](TimesliceSlot slot) {
@@ -353,6 +356,7 @@ void DataRelayer::pruneCache(TimesliceSlot slot, OnDropCallback onDrop)
       cache[ai].clear();
       cachedStateMetrics[ai] = CacheEntryStatus::EMPTY;
     }
+    presentInputs[slot.index] = 0;
   };
 
   pruneCache(slot);
@@ -412,6 +416,7 @@ DataRelayer::RelayChoice
 
   // Actually save the header / payload in the slot
   auto saveInSlot = [&cachedStateMetrics = mCachedStateMetrics,
+                     &presentInputs = mPresentInputs,
                      &messages,
                      &nMessages,
                      &nPayloads,
@@ -421,6 +426,7 @@ DataRelayer::RelayChoice
     auto cacheIdx = numInputTypes * slot.index + input;
     MessageSet& target = cache[cacheIdx];
     cachedStateMetrics[cacheIdx] = CacheEntryStatus::PENDING;
+    bool wasPresent = target.size() > 0 && target.header(0) != nullptr;
     // TODO: make sure that multiple parts can only be added within the same call of
     // DataRelayer::relay
     assert(nPayloads > 0);
@@ -429,6 +435,9 @@ DataRelayer::RelayChoice
       target.add([&messages, &mi](size_t i) -> fair::mq::MessagePtr& { return messages[mi + i]; }, nPayloads + 1);
       mi += nPayloads;
     }
+    if (wasPresent == false && target.size() > 0 && target.header(0) != nullptr) {
+      presentInputs[slot.index]++;
+    }
   };
 
   auto updateStatistics = [&stats = mStats](TimesliceIndex::ActionTaken action) {
@@ -633,6 +642,11 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   //
   // Notice that the only time numInputTypes is 0 is when we are a dummy
   // device created as a source for timers / conditions.
+  //
+  // We only check the cachelines which have been updated by an incoming
+  // message, rather than scanning all of them. They come ordered by
+  // decreasing slot index.
+  mTimesliceIndex.takeDirtySlots(mDirtySlots);
   if (numInputTypes == 0) {
     LOGP(debug, "numInputTypes == 0, returning.");
     return;
@@ -644,40 +658,39 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   int countProcess = 0;
   int countDiscard = 0;
   int countWait = 0;
-  int notDirty = 0;
-
-  for (int li = cacheLines - 1; li >= 0; --li) {
-    TimesliceSlot slot{(size_t)li};
-    // We only check the cachelines which have been updated by an incoming
-    // message.
-    if (mTimesliceIndex.isDirty(slot) == false) {
-      notDirty++;
-      continue;
-    }
-    auto partial = getPartialRecord(li);
-    // TODO: get the data ref from message model
-    auto getter = [&partial](size_t idx, size_t part) {
-      if (partial[idx].size() > 0 && partial[idx].header(part).get()) {
-        auto header = partial[idx].header(part).get();
-        auto payload = partial[idx].payload(part).get();
-        return DataRef{nullptr,
-                       reinterpret_cast<const char*>(header->GetData()),
-                       reinterpret_cast<char const*>(payload ? payload->GetData() : nullptr),
-                       payload ? payload->GetSize() : 0};
-      }
-      return DataRef{};
-    };
-    auto nPartsGetter = [&partial](size_t idx) {
-      return partial[idx].size();
-    };
-    InputSpan span{getter, nPartsGetter, static_cast<size_t>(partial.size())};
+  int notDirty = cacheLines - mDirtySlots.size();
+
+  for (auto slot : mDirtySlots) {
+    auto li = slot.index;
     CompletionPolicy::CompletionOp action;
-    if (mCompletionPolicy.callback) {
-      action = mCompletionPolicy.callback(span);
-    } else if (mCompletionPolicy.callbackFull) {
-      action = mCompletionPolicy.callbackFull(span, mInputs);
+    if (mCompletionPolicy.callbackCount) {
+      // Fast path: the policy only cares about how many inputs are there.
+      action = mCompletionPolicy.callbackCount(mPresentInputs[li], numInputTypes);
     } else {
-      throw std::runtime_error("No completion policy found");
+      auto partial = getPartialRecord(li);
+      // TODO: get the data ref from message model
+      auto getter = [&partial](size_t idx, size_t part) {
+        if (partial[idx].size() > 0 && partial[idx].header(part).get()) {
+          auto header = partial[idx].header(part).get();
+          auto payload = partial[idx].payload(part).get();
+          return DataRef{nullptr,
+                         reinterpret_cast<const char*>(header->GetData()),
+                         reinterpret_cast<char const*>(payload ? payload->GetData() : nullptr),
+                         payload ? payload->GetSize() : 0};
+        }
+        return DataRef{};
+      };
+      auto nPartsGetter = [&partial](size_t idx) {
+        return partial[idx].size();
+      };
+      InputSpan span{getter, nPartsGetter, static_cast<size_t>(partial.size())};
+      if (mCompletionPolicy.callback) {
+        action = mCompletionPolicy.callback(span);
+      } else if (mCompletionPolicy.callbackFull) {
+        action = mCompletionPolicy.callbackFull(span, mInputs);
+      } else {
+        throw std::runtime_error("No completion policy found");
+      }
     }
     auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
     auto timeslice = std::get_if<uint64_t>(&variables.get(0));
@@ -780,11 +793,12 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice
   // timeslice, so I can simply do that. I keep the assertion there because in principle
   // we should have dispatched the timeslice already!
   // FIXME: what happens when we have enough timeslices to hit the invalid one?
-  auto invalidateCacheFor = [&numInputTypes, &index, &cache](TimesliceSlot s) {
+  auto invalidateCacheFor = [&numInputTypes, &index, &cache, &presentInputs = mPresentInputs](TimesliceSlot s) {
     for (size_t ai = s.index * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
       assert(std::accumulate(cache[ai].messages.begin(), cache[ai].messages.end(), true, [](bool result, auto const& element) { return result && element.get() == nullptr; }));
       cache[ai].clear();
     }
+    presentInputs[s.index] = 0;
     index.markAsInvalid(s);
   };
 
@@ -849,6 +863,7 @@ void DataRelayer::clear()
   for (auto& cache : mCache) {
     cache.clear();
   }
+  std::fill(mPresentInputs.begin(), mPresentInputs.end(), 0);
   for (size_t s = 0; s < mTimesliceIndex.size(); ++s) {
     mTimesliceIndex.markAsInvalid(TimesliceSlot{s});
   }
@@ -882,6 +897,7 @@ void DataRelayer::publishMetrics()
   // maybe misleading to have the allocation in a function primarily for
   // metrics publishing, do better in setPipelineLength?
   mCache.resize(numInputTypes * mTimesliceIndex.size());
+  mPresentInputs.resize(mTimesliceIndex.size(), 0);
   mMetrics.send({(int)numInputTypes, "data_relayer/h", Verbosity::Debug});
   mMetrics.send({(int)mTimesliceIndex.size(), "data_relayer/w", Verbosity::Debug});
   sMetricsNames.resize(mCache.size());
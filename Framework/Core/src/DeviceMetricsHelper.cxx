@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 
 #include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsRing.h"
 #include "Framework/DriverInfo.h"
 #include "Framework/RuntimeError.h"
 #include "Framework/Logger.h"
@@ -401,25 +402,26 @@ bool DeviceMetricsHelper::processMetric(ParsedMetricMatch& match,
                                         DeviceMetricsHelper::NewMetricCallback newMetricsCallback)
 {
   // get the type
-  size_t metricIndex = -1;
-
-  StringMetric stringValue;
   switch (match.type) {
     case MetricType::Float:
     case MetricType::Int:
     case MetricType::Uint64:
     case MetricType::Enum:
+    case MetricType::String:
       break;
-    case MetricType::String: {
-      auto lastChar = std::min(match.endStringValue - match.beginStringValue, StringMetric::MAX_SIZE - 1);
-      memcpy(stringValue.data, match.beginStringValue, lastChar);
-      stringValue.data[lastChar] = '\0';
-    } break;
     default:
       return false;
       break;
   };
+  size_t metricIndex = findOrCreateMetric(match, info, newMetricsCallback);
+  return storeMetric(match, metricIndex, info);
+}
 
+size_t DeviceMetricsHelper::findOrCreateMetric(ParsedMetricMatch& match,
+                                               DeviceMetricsInfo& info,
+                                               DeviceMetricsHelper::NewMetricCallback newMetricsCallback)
+{
+  size_t metricIndex = -1;
   // Find the prefix for the metric
   auto key = std::string_view(match.beginKey, match.endKey - match.beginKey);
 
@@ -485,9 +487,21 @@ bool DeviceMetricsHelper::processMetric(ParsedMetricMatch& match,
     metricIndex = mi->index;
   }
   assert(metricIndex != -1);
-  // We are now guaranteed our metric is present at metricIndex.
+  return metricIndex;
+}
+
+bool DeviceMetricsHelper::storeMetric(ParsedMetricMatch const& match, size_t metricIndex, DeviceMetricsInfo& info)
+{
   MetricInfo& metricInfo = info.metrics[metricIndex];
 
+  StringMetric stringValue;
+  stringValue.data[0] = '\0';
+  if (match.type == MetricType::String) {
+    auto lastChar = std::min(match.endStringValue - match.beginStringValue, StringMetric::MAX_SIZE - 1);
+    memcpy(stringValue.data, match.beginStringValue, lastChar);
+    stringValue.data[lastChar] = '\0';
+  }
+
   //  auto mod = info.timestamps[metricIndex].size();
   auto sizeOfCollection = 0;
   switch (metricInfo.type) {
@@ -539,6 +553,53 @@ bool DeviceMetricsHelper::processMetric(ParsedMetricMatch& match,
   return true;
 }
 
+bool DeviceMetricsHelper::processMetricsRing(DeviceMetricsRing& ring,
+                                             std::vector<size_t>& ringIndices,
+                                             DeviceMetricsInfo& info,
+                                             NewMetricCallback newMetricsCallback)
+{
+  ParsedMetricMatch match;
+  match.beginStringValue = nullptr;
+  match.endStringValue = nullptr;
+  auto consumed = ring.consume([&](MetricRecord const& record, std::string_view name) {
+    match.type = static_cast<MetricType>(record.type);
+    match.timestamp = record.timestamp;
+    // as in parseMetric, floatValue always holds the value for min, max and average
+    switch (match.type) {
+      case MetricType::Int:
+        match.intValue = record.intValue;
+        match.floatValue = record.intValue;
+        break;
+      case MetricType::Float:
+        match.floatValue = record.floatValue;
+        match.intValue = record.floatValue;
+        break;
+      case MetricType::Uint64:
+        match.uint64Value = record.uint64Value;
+        match.floatValue = record.uint64Value;
+        match.intValue = record.uint64Value;
+        break;
+      default:
+        return;
+    }
+    if (record.kind == MetricRecord::Register) {
+      match.beginKey = name.data();
+      match.endKey = name.data() + name.size();
+      if (ringIndices.size() <= record.id) {
+        ringIndices.resize(record.id + 1, -1);
+      }
+      ringIndices[record.id] = findOrCreateMetric(match, info, newMetricsCallback);
+    } else if (record.id >= ringIndices.size() || ringIndices[record.id] == (size_t)-1) {
+      return;
+    }
+    // the type is the one of the first value, as for the text metrics
+    if (info.metrics[ringIndices[record.id]].type == match.type) {
+      storeMetric(match, ringIndices[record.id], info);
+    }
+  });
+  return consumed != 0;
+}
+
 size_t DeviceMetricsHelper::metricIdxByName(const std::string& name, const DeviceMetricsInfo& info)
 {
   size_t i = 0;
@@ -0,0 +1,151 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/DeviceMetricsRing.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace o2::framework
+{
+
+namespace
+{
+constexpr uint64_t RingMagic = 0x44504c4d45545231; // "DPLMETR1"
+}
+
+std::string DeviceMetricsRing::segmentName(pid_t pid)
+{
+  return fmt::format("/dpl_metrics_{}", pid);
+}
+
+DeviceMetricsRing::DeviceMetricsRing(void* mapping, size_t mappingSize, std::string name, bool owner)
+  : mControl{reinterpret_cast<Control*>(mapping)},
+    mData{reinterpret_cast<char*>(mapping) + sizeof(Control)},
+    mCapacity{mControl->capacity},
+    mMapping{mapping},
+    mMappingSize{mappingSize},
+    mName{std::move(name)},
+    mOwner{owner}
+{
+}
+
+DeviceMetricsRing::~DeviceMetricsRing()
+{
+  munmap(mMapping, mMappingSize);
+  if (mOwner) {
+    // the driver removes the name as soon as it attaches, this is for the case it never did.
+    shm_unlink(mName.c_str());
+  }
+}
+
+std::unique_ptr<DeviceMetricsRing> DeviceMetricsRing::create(pid_t pid, size_t capacity)
+{
+  size_t roundedCapacity = sizeof(MetricRecord);
+  while (roundedCapacity < capacity) {
+    roundedCapacity <<= 1;
+  }
+  roundedCapacity = std::max(roundedCapacity, (size_t)1 << 16); // a record must always fit
+  auto name = segmentName(pid);
+  // a leftover from a previous process with the same pid
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  size_t mappingSize = sizeof(Control) + roundedCapacity;
+  void* mapping = MAP_FAILED;
+  if (ftruncate(fd, mappingSize) == 0) {
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  auto* control = new (mapping) Control{};
+  control->capacity = roundedCapacity;
+  control->head.store(0, std::memory_order_relaxed);
+  control->tail.store(0, std::memory_order_relaxed);
+  // the driver does not use the ring before it is initialised
+  control->magic.store(RingMagic, std::memory_order_release);
+  return std::unique_ptr<DeviceMetricsRing>(new DeviceMetricsRing(mapping, mappingSize, name, true));
+}
+
+std::unique_ptr<DeviceMetricsRing> DeviceMetricsRing::attach(pid_t pid)
+{
+  auto name = segmentName(pid);
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  void* mapping = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && (size_t)st.st_size > sizeof(Control)) {
+    mapping = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+  auto* control = reinterpret_cast<Control*>(mapping);
+  if (control->magic.load(std::memory_order_acquire) != RingMagic || control->capacity + sizeof(Control) != (size_t)st.st_size) {
+    // not initialised yet
+    munmap(mapping, st.st_size);
+    return nullptr;
+  }
+  // the mappings stay valid, nothing is left behind if the device dies
+  shm_unlink(name.c_str());
+  return std::unique_ptr<DeviceMetricsRing>(new DeviceMetricsRing(mapping, st.st_size, name, false));
+}
+
+bool DeviceMetricsRing::push(MetricRecord record, std::string_view name)
+{
+  size_t size = sizeof(MetricRecord);
+  if (record.kind == MetricRecord::Register) {
+    size += name.size() + 1;
+  }
+  size = (size + alignof(MetricRecord) - 1) & ~(alignof(MetricRecord) - 1);
+  if (size > UINT16_MAX) {
+    return false;
+  }
+  uint64_t head = mControl->head.load(std::memory_order_relaxed);
+  uint64_t tail = mControl->tail.load(std::memory_order_acquire);
+  size_t offset = head & (mCapacity - 1);
+  // records are contiguous, skip the end of the buffer if too short
+  size_t padding = mCapacity - offset < size ? mCapacity - offset : 0;
+  if (head + padding + size - tail > mCapacity) {
+    return false;
+  }
+  if (padding) {
+    auto* pad = reinterpret_cast<MetricRecord*>(mData + offset);
+    pad->size = padding;
+    pad->kind = MetricRecord::Padding;
+    offset = 0;
+  }
+  record.size = size;
+  auto* dest = mData + offset;
+  memcpy(dest, &record, sizeof(MetricRecord));
+  if (record.kind == MetricRecord::Register) {
+    memcpy(dest + sizeof(MetricRecord), name.data(), name.size());
+    dest[sizeof(MetricRecord) + name.size()] = '\0';
+  }
+  mControl->head.store(head + padding + size, std::memory_order_release);
+  return true;
+}
+
+} // namespace o2::framework
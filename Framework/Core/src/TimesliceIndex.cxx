@@ -25,6 +25,12 @@ void TimesliceIndex::resize(size_t s)
   mVariables.resize(s);
   mPublishedVariables.resize(s);
   mDirty.resize(s, false);
+  mDirtySlots.clear();
+  for (size_t i = 0; i < mDirty.size(); ++i) {
+    if (mDirty[i]) {
+      mDirtySlots.push_back(TimesliceSlot{i});
+    }
+  }
 }
 
 void TimesliceIndex::associate(TimesliceId timestamp, TimesliceSlot slot)
@@ -32,7 +38,7 @@ void TimesliceIndex::associate(TimesliceId timestamp, TimesliceSlot slot)
   assert(mVariables.size() > slot.index);
   mVariables[slot.index].put({0, static_cast<uint64_t>(timestamp.value)});
   mVariables[slot.index].commit();
-  mDirty[slot.index] = true;
+  markAsDirty(slot, true);
 }
 
 TimesliceSlot TimesliceIndex::findOldestSlot(TimesliceId timestamp) const
@@ -26,6 +26,7 @@
 #include "Framework/DeviceInfo.h"
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsRing.h"
 #include "Framework/DeviceConfigInfo.h"
 #include "Framework/DeviceSpec.h"
 #include "Framework/DeviceState.h"
@@ -867,6 +868,7 @@ LogProcessingState processChildrenOutput(DriverInfo& driverInfo,
   const std::string delimiter("\n");
   bool hasNewMetric = false;
   LogProcessingState result;
+  static bool const useMetricsRing = getenv("DPL_SHM_METRICS") != nullptr;
 
   for (size_t di = 0, de = infos.size(); di < de; ++di) {
     DeviceInfo& info = infos[di];
@@ -875,16 +877,16 @@ LogProcessingState processChildrenOutput(DriverInfo& driverInfo,
     assert(specs.size() == infos.size());
     DeviceSpec const& spec = specs[di];
 
-    if (info.unprinted.empty()) {
-      continue;
+    // Binary metrics sent via shared memory. A device which only reports
+    // metrics through the ring might never write anything on its stdout, so we
+    // keep looking for the ring at each iteration until it has been created.
+    if (useMetricsRing && info.metricsRing == nullptr && info.active) {
+      info.metricsRing = DeviceMetricsRing::attach(info.pid);
     }
 
-    O2_SIGNPOST_START(DriverStatus::ID, DriverStatus::BYTES_PROCESSED, info.pid, 0, 0);
-
-    std::string_view s = info.unprinted;
-    size_t pos = 0;
-    info.history.resize(info.historySize);
-    info.historyLevel.resize(info.historySize);
+    if (info.unprinted.empty() && info.metricsRing == nullptr) {
+      continue;
+    }
 
     auto updateMetricsViews =
       Metric2DViewIndex::getUpdater({&info.dataRelayerViewIndex,
@@ -897,6 +899,21 @@ LogProcessingState processChildrenOutput(DriverInfo& driverInfo,
       hasNewMetric = true;
     };
 
+    if (info.metricsRing && DeviceMetricsHelper::processMetricsRing(*info.metricsRing, info.metricsRingIndices, metrics, newMetricCallback)) {
+      result.didProcessMetric = true;
+    }
+
+    if (info.unprinted.empty()) {
+      continue;
+    }
+
+    O2_SIGNPOST_START(DriverStatus::ID, DriverStatus::BYTES_PROCESSED, info.pid, 0, 0);
+
+    std::string_view s = info.unprinted;
+    size_t pos = 0;
+    info.history.resize(info.historySize);
+    info.historyLevel.resize(info.historySize);
+
     while ((pos = s.find(delimiter)) != std::string::npos) {
       std::string token{s.substr(0, pos)};
       auto logLevel = LogParsingHelpers::parseTokenLevel(token);
@@ -1077,6 +1094,7 @@ int doChild(int argc, char** argv, ServiceRegistry& serviceRegistry,
       ("expected-region-callbacks", bpo::value<std::string>()->default_value("0"), "how many region callbacks we are expecting")                                                           //
       ("exit-transition-timeout", bpo::value<std::string>()->default_value(defaultExitTransitionTimeout), "how many second to wait before switching from RUN to READY")                    //
       ("timeframes-rate-limit", bpo::value<std::string>()->default_value("0"), "how many timeframe can be in fly at the same moment (0 disables)")                                         //
+      ("streams", bpo::value<std::string>()->default_value("1"), "how many timeframes the device processes concurrently, each on its own thread (the processing must be reentrant)") //
       ("configuration,cfg", bpo::value<std::string>()->default_value("command-line"), "configuration backend")                                                                             //
       ("infologger-mode", bpo::value<std::string>()->default_value(defaultInfologgerMode), "O2_INFOLOGGER_MODE override");
     r.fConfig.AddToCmdLineOptions(optsDesc, true);
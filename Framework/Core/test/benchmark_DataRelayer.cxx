@@ -344,4 +344,86 @@ static void BM_RelayMultiplePayloads(benchmark::State& state)
 
 BENCHMARK(BM_RelayMultiplePayloads)->Arg(10)->Arg(100)->Arg(1000);
 
+/// Relay one message per input for a given timeslice, checking for completion
+/// after each message, like the device does. This shows how the completion
+/// check scales with the pipeline length (state.range(0)) and the number of
+/// inputs (state.range(1)).
+static void relayManyInputs(benchmark::State& state, CompletionPolicy const& policy)
+{
+  Monitoring metrics;
+  const size_t pipelineLength = state.range(0);
+  const size_t nInputs = state.range(1);
+
+  std::vector<InputRoute> inputs;
+  for (size_t i = 0; i < nInputs; ++i) {
+    inputs.emplace_back(InputRoute{InputSpec{"input" + std::to_string(i), "TST", "A", static_cast<DataHeader::SubSpecificationType>(i)}, i, "Fake", 0});
+  }
+
+  std::vector<InputChannelInfo> infos{1};
+  TimesliceIndex index{1, infos};
+
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(pipelineLength);
+
+  DataHeader dh;
+  dh.dataDescription = "A";
+  dh.dataOrigin = "TST";
+
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  std::vector<std::vector<fair::mq::MessagePtr>> inflightMessages(nInputs);
+  for (size_t i = 0; i < nInputs; ++i) {
+    dh.subSpecification = i;
+    Stack stack{dh, DataProcessingHeader{0, 1}};
+    inflightMessages[i].emplace_back(transport->CreateMessage(stack.size()));
+    inflightMessages[i].emplace_back(transport->CreateMessage(100));
+  }
+
+  size_t timeslice = 0;
+  std::vector<RecordAction> ready;
+  for (auto _ : state) {
+    for (size_t i = 0; i < nInputs; ++i) {
+      dh.subSpecification = i;
+      Stack stack{dh, DataProcessingHeader{timeslice, 1}};
+      memcpy(inflightMessages[i][0]->GetData(), stack.data(), stack.size());
+      relayer.relay(inflightMessages[i][0]->GetData(), inflightMessages[i].data(), inflightMessages[i].size());
+      ready.clear();
+      relayer.getReadyToProcess(ready);
+    }
+    assert(ready.size() == 1);
+    assert(ready[0].op == CompletionPolicy::CompletionOp::Consume);
+    auto result = relayer.consumeAllInputsForTimeslice(ready[0].slot);
+    for (size_t i = 0; i < nInputs; ++i) {
+      inflightMessages[i] = std::move(result[i].messages);
+    }
+    timeslice++;
+  }
+  state.SetItemsProcessed(state.iterations() * nInputs);
+}
+
+static void BM_RelayManyInputsCount(benchmark::State& state)
+{
+  relayManyInputs(state, CompletionPolicyHelpers::consumeWhenAll());
+}
+
+// Same as above, but forcing the policy to look at the InputSpan,
+// as custom policies do.
+static void BM_RelayManyInputsSpan(benchmark::State& state)
+{
+  auto policy = CompletionPolicyHelpers::consumeWhenAll();
+  policy.callbackCount = nullptr;
+  relayManyInputs(state, policy);
+}
+
+static void manyInputsArguments(benchmark::internal::Benchmark* b)
+{
+  for (int pipelineLength : {4, 64, 256}) {
+    for (int nInputs : {1, 16, 128}) {
+      b->Args({pipelineLength, nInputs});
+    }
+  }
+}
+
+BENCHMARK(BM_RelayManyInputsCount)->Apply(manyInputsArguments);
+BENCHMARK(BM_RelayManyInputsSpan)->Apply(manyInputsArguments);
+
 BENCHMARK_MAIN();
@@ -10,9 +10,11 @@
 // or submit itself to any jurisdiction.
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsRing.h"
 
 #include <benchmark/benchmark.h>
 #include <regex>
+#include <unistd.h>
 
 // This is the fastest we could ever get.
 static void BM_MemcmpBaseline(benchmark::State& state)
@@ -92,6 +94,7 @@ static void BM_ProcessIntMetric(benchmark::State& state)
     }
   }
   state.SetBytesProcessed(state.iterations() * metrics.size() * metric.size());
+  state.SetItemsProcessed(state.iterations() * metrics.size());
 }
 
 BENCHMARK(BM_ProcessIntMetric);
@@ -164,4 +167,32 @@ static void BM_ProcessMismatchedMetric(benchmark::State& state)
 
 BENCHMARK(BM_ProcessMismatchedMetric);
 
+// Same as BM_ProcessIntMetric, but going through the shared memory ring
+static void BM_ProcessIntMetricRing(benchmark::State& state)
+{
+  using namespace o2::framework;
+  DeviceMetricsInfo info;
+  std::vector<size_t> ringIndices;
+  auto device = DeviceMetricsRing::create(getpid());
+  auto driver = DeviceMetricsRing::attach(getpid());
+
+  MetricRecord record{};
+  record.kind = MetricRecord::Register;
+  record.type = (uint8_t)MetricType::Int;
+  record.id = 0;
+  record.timestamp = 1789372894;
+  record.intValue = 12;
+  device->push(record, "bkey");
+  record.kind = MetricRecord::Value;
+  for (auto _ : state) {
+    for (auto i = 0; i < 1000; ++i) {
+      device->push(record);
+    }
+    DeviceMetricsHelper::processMetricsRing(*driver, ringIndices, info);
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+BENCHMARK(BM_ProcessIntMetricRing);
+
 BENCHMARK_MAIN();
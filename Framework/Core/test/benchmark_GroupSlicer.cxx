@@ -0,0 +1,118 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/AnalysisTask.h"
+#include "Framework/TableBuilder.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+using namespace o2::framework;
+using namespace o2::soa;
+
+namespace o2::aod
+{
+namespace test
+{
+DECLARE_SOA_COLUMN(PosZ, posZ, float);
+} // namespace test
+DECLARE_SOA_TABLE(BmEvents, "AOD", "BMEVTS",
+                  o2::soa::Index<>,
+                  test::PosZ);
+
+namespace test
+{
+DECLARE_SOA_INDEX_COLUMN(BmEvent, bmEvent);
+DECLARE_SOA_COLUMN(Pt, pt, float);
+} // namespace test
+DECLARE_SOA_TABLE(BmTracks, "AOD", "BMTRKS",
+                  test::BmEventId,
+                  test::Pt);
+} // namespace o2::aod
+
+// number of tracks per event
+constexpr int tracksPerEvent = 20;
+
+static void fillTables(int nEvents, std::shared_ptr<arrow::Table>& events, std::shared_ptr<arrow::Table>& tracks)
+{
+  std::default_random_engine e1(1234567891);
+  std::uniform_real_distribution<float> uniform_dist(0, 1);
+  std::poisson_distribution<int> poisson_dist(tracksPerEvent);
+
+  TableBuilder builderE;
+  auto evtsWriter = builderE.cursor<o2::aod::BmEvents>();
+  TableBuilder builderT;
+  auto trksWriter = builderT.cursor<o2::aod::BmTracks>();
+  for (auto i = 0; i < nEvents; ++i) {
+    evtsWriter(0, uniform_dist(e1));
+    auto n = poisson_dist(e1);
+    for (auto j = 0; j < n; ++j) {
+      trksWriter(0, i, uniform_dist(e1));
+    }
+  }
+  events = builderE.finalize();
+  tracks = builderT.finalize();
+}
+
+/// A train of state.range(1) tasks grouping the same tracks by event in each
+/// timeframe, half of them using a filtered view of the tracks. Without the
+/// cache each task slices the tracks on its own.
+template <bool useCache>
+static void BM_GroupSlicerTrain(benchmark::State& state)
+{
+  std::shared_ptr<arrow::Table> eventsTable;
+  std::shared_ptr<arrow::Table> tracksTable;
+  fillTables(state.range(0), eventsTable, tracksTable);
+
+  o2::aod::BmEvents events{eventsTable};
+  o2::aod::BmTracks tracks{tracksTable};
+  SelectionVector selection;
+  for (auto& track : tracks) {
+    if (track.pt() > 0.5f) {
+      selection.push_back(track.globalIndex());
+    }
+  }
+  Filtered<o2::aod::BmTracks> filteredTracks{{tracksTable}, SelectionVector{selection}};
+  auto associated = std::make_tuple(tracks);
+  auto filteredAssociated = std::make_tuple(filteredTracks);
+
+  ArrowTableSlicingCache cache;
+  ArrowTableSlicingCache* cachePtr = useCache ? &cache : nullptr;
+  int64_t count = 0;
+
+  for (auto _ : state) {
+    count = 0;
+    // new timeframe
+    cache.reset();
+    for (auto task = 0; task < state.range(1); ++task) {
+      if (task % 2 == 0) {
+        GroupSlicer slicer(events, associated, cachePtr);
+        for (auto& slice : slicer) {
+          count += std::get<o2::aod::BmTracks>(slice.associatedTables()).size();
+        }
+      } else {
+        GroupSlicer slicer(events, filteredAssociated, cachePtr);
+        for (auto& slice : slicer) {
+          count += std::get<Filtered<o2::aod::BmTracks>>(slice.associatedTables()).size();
+        }
+      }
+    }
+    benchmark::DoNotOptimize(count);
+  }
+  state.counters["Tracks"] = count;
+  state.counters["Slicings"] = useCache ? cache.getComputed() : state.range(1);
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_TEMPLATE(BM_GroupSlicerTrain, false)->RangeMultiplier(4)->Ranges({{1 << 8, 1 << 14}, {1, 16}});
+BENCHMARK_TEMPLATE(BM_GroupSlicerTrain, true)->RangeMultiplier(4)->Ranges({{1 << 8, 1 << 14}, {1, 16}});
+
+BENCHMARK_MAIN();
@@ -14,10 +14,12 @@
 
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsRing.h"
 #include <boost/test/unit_test.hpp>
 #include <iostream>
 #include <regex>
 #include <string_view>
+#include <unistd.h>
 
 BOOST_AUTO_TEST_CASE(TestIndexedMetrics)
 {
@@ -518,3 +520,71 @@ BOOST_AUTO_TEST_CASE(TestHelpers)
   BOOST_CHECK_EQUAL(metric2, 0);
   BOOST_CHECK_EQUAL(metric3, 1);
 }
+
+BOOST_AUTO_TEST_CASE(TestMetricsRing)
+{
+  using namespace o2::framework;
+  DeviceMetricsInfo info;
+  std::vector<size_t> ringIndices;
+  BOOST_CHECK(DeviceMetricsRing::attach(getpid()) == nullptr);
+  auto device = DeviceMetricsRing::create(getpid(), 1);
+  BOOST_REQUIRE(device != nullptr);
+  auto driver = DeviceMetricsRing::attach(getpid());
+  BOOST_REQUIRE(driver != nullptr);
+  BOOST_CHECK_EQUAL(device->capacity(), 1 << 16);
+
+  // a metric also known from the text protocol
+  ParsedMetricMatch match;
+  std::string metricString = "[METRIC] akey,2 0.5 1000 hostname=test.cern.ch";
+  BOOST_REQUIRE(DeviceMetricsHelper::parseMetric(metricString, match));
+  BOOST_REQUIRE(DeviceMetricsHelper::processMetric(match, info));
+
+  MetricRecord record{};
+  record.kind = MetricRecord::Register;
+  record.type = (uint8_t)MetricType::Int;
+  record.id = 0;
+  record.timestamp = 1001;
+  record.intValue = 12;
+  BOOST_REQUIRE(device->push(record, "bkey/with_prefix"));
+  record.id = 1;
+  record.type = (uint8_t)MetricType::Float;
+  record.floatValue = 1.5;
+  BOOST_REQUIRE(device->push(record, "akey"));
+  record.kind = MetricRecord::Value;
+  record.id = 0;
+  record.type = (uint8_t)MetricType::Int;
+  record.intValue = 13;
+  record.timestamp = 1002;
+  BOOST_REQUIRE(device->push(record));
+
+  BOOST_CHECK(DeviceMetricsHelper::processMetricsRing(*driver, ringIndices, info));
+  BOOST_REQUIRE_EQUAL(info.metrics.size(), 2);
+  BOOST_REQUIRE_EQUAL(ringIndices.size(), 2);
+  BOOST_CHECK_EQUAL(ringIndices[1], 0);
+  BOOST_CHECK_EQUAL(ringIndices[0], 1);
+  BOOST_CHECK_EQUAL(info.floatMetrics[0][1], 1.5);
+  BOOST_CHECK_EQUAL(info.intMetrics[0][0], 12);
+  BOOST_CHECK_EQUAL(info.intMetrics[0][1], 13);
+  BOOST_CHECK_EQUAL(info.intTimestamps[0][1], 1002);
+  BOOST_CHECK_EQUAL(info.metrics[1].filledMetrics, 2);
+  BOOST_CHECK_EQUAL(info.max[1], 13);
+  BOOST_CHECK(DeviceMetricsHelper::processMetricsRing(*driver, ringIndices, info) == false);
+
+  // fill the ring until the device has to fall back to text,
+  // then check that records wrapping around the end are not lost
+  int pushed = 0;
+  record.timestamp = 2000;
+  while (device->push(record)) {
+    record.intValue = ++pushed;
+  }
+  BOOST_CHECK_EQUAL(pushed, (int)((1 << 16) / sizeof(MetricRecord)));
+  DeviceMetricsHelper::processMetricsRing(*driver, ringIndices, info);
+  for (int i = 0; i < 10; ++i) {
+    record.intValue = pushed + i;
+    BOOST_REQUIRE(device->push(record));
+  }
+  DeviceMetricsHelper::processMetricsRing(*driver, ringIndices, info);
+  BOOST_CHECK_EQUAL(info.metrics[1].filledMetrics, 2 + pushed + 10);
+  auto last = (info.metrics[1].pos + 1023) % 1024;
+  BOOST_CHECK_EQUAL(info.intMetrics[0][last], pushed + 9);
+}
@@ -0,0 +1,97 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test Framework ForwardedPayload
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "Framework/DataAllocator.h"
+#include <fairmq/ProgOptions.h>
+#include <fairmq/Tools.h>
+#include <fairmq/TransportFactory.h>
+#include <cstring>
+#include <string>
+#include <utility>
+
+using namespace o2::framework;
+
+namespace
+{
+
+fair::mq::MessagePtr createPayload(fair::mq::TransportFactory& transport, size_t size)
+{
+  auto message = transport.CreateMessage(size);
+  auto* data = static_cast<unsigned char*>(message->GetData());
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = (i * 7 + 3) & 0xff;
+  }
+  return message;
+}
+
+void checkSamePayload(fair::mq::Message const& forwarded, fair::mq::Message const& payload)
+{
+  BOOST_REQUIRE_EQUAL(forwarded.GetSize(), payload.GetSize());
+  if (payload.GetSize() > 0) {
+    BOOST_CHECK(std::memcmp(forwarded.GetData(), payload.GetData(), payload.GetSize()) == 0);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ForwardedPayload)
+{
+  size_t session{fair::mq::tools::UuidHash()};
+  fair::mq::ProgOptions config;
+  config.SetProperty<std::string>("session", std::to_string(session));
+
+  auto factoryZMQ = fair::mq::TransportFactory::CreateTransportFactory("zeromq", "", &config);
+  auto factorySHM = fair::mq::TransportFactory::CreateTransportFactory("shmem", "", &config);
+  BOOST_REQUIRE(factoryZMQ != nullptr);
+  BOOST_REQUIRE(factorySHM != nullptr);
+
+  for (size_t size : {0, 1000, 100000}) {
+    // same transport: the forwarded message refers to the buffer of the input
+    for (auto* transport : {factoryZMQ.get(), factorySHM.get()}) {
+      auto payload = createPayload(*transport, size);
+      bool byReference = false;
+      auto forwarded = DataAllocator::forwardedPayload(*transport, *payload, byReference);
+      BOOST_REQUIRE(forwarded != nullptr);
+      BOOST_CHECK(byReference);
+      BOOST_CHECK(forwarded->GetType() == transport->GetType());
+      checkSamePayload(*forwarded, *payload);
+      if (size > 0) {
+        BOOST_CHECK_EQUAL(forwarded->GetData(), payload->GetData());
+      }
+      // the forwarded message must stay valid once the input is gone
+      auto reference = createPayload(*factoryZMQ, size);
+      payload.reset();
+      checkSamePayload(*forwarded, *reference);
+    }
+
+    // different transports: the payload is copied
+    for (auto [from, to] : {std::pair{factoryZMQ.get(), factorySHM.get()}, std::pair{factorySHM.get(), factoryZMQ.get()}}) {
+      auto payload = createPayload(*from, size);
+      bool byReference = true;
+      auto forwarded = DataAllocator::forwardedPayload(*to, *payload, byReference);
+      BOOST_REQUIRE(forwarded != nullptr);
+      BOOST_CHECK(!byReference);
+      BOOST_CHECK(forwarded->GetType() == to->GetType());
+      checkSamePayload(*forwarded, *payload);
+      if (size > 0) {
+        BOOST_CHECK(forwarded->GetData() != payload->GetData());
+        // the copy does not follow the changes of the input
+        static_cast<unsigned char*>(payload->GetData())[0] ^= 0xff;
+        BOOST_CHECK(std::memcmp(forwarded->GetData(), payload->GetData(), size) != 0);
+      }
+    }
+  }
+}
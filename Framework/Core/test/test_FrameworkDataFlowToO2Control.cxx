@@ -209,6 +209,8 @@ command:
     - "'false'"
     - "--stacktrace-on-signal"
     - "'simple'"
+    - "--streams"
+    - "'1'"
     - "--timeframes-rate-limit"
     - "'0'"
 )EXPECTED",
@@ -290,6 +292,8 @@ command:
     - "'false'"
     - "--stacktrace-on-signal"
     - "'simple'"
+    - "--streams"
+    - "'1'"
     - "--timeframes-rate-limit"
     - "'0'"
 )EXPECTED",
@@ -371,6 +375,8 @@ command:
     - "'false'"
     - "--stacktrace-on-signal"
     - "'simple'"
+    - "--streams"
+    - "'1'"
     - "--timeframes-rate-limit"
     - "'0'"
 )EXPECTED",
@@ -451,6 +457,8 @@ command:
     - "'false'"
     - "--stacktrace-on-signal"
     - "'simple'"
+    - "--streams"
+    - "'1'"
     - "--timeframes-rate-limit"
     - "'0'"
     - "--a-param"
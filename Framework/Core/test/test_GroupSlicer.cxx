@@ -581,3 +581,76 @@ BOOST_AUTO_TEST_CASE(ArrowDirectSlicing)
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE(GroupSlicerSharedCache)
+{
+  TableBuilder builderE;
+  auto evtsWriter = builderE.cursor<aod::Events>();
+  for (auto i = 0; i < 20; ++i) {
+    evtsWriter(0, i, 0.5f * i, 2.f * i, 3.f * i);
+  }
+  auto evtTable = builderE.finalize();
+
+  TableBuilder builderT;
+  auto trksWriter = builderT.cursor<aod::TrksX>();
+  for (auto i = 0; i < 20; ++i) {
+    if (i == 3 || i == 10) {
+      continue;
+    }
+    for (auto j = 0.f; j < 5; j += 0.5f) {
+      trksWriter(0, i, 0.5f * j);
+    }
+  }
+  auto trkTable = builderT.finalize();
+
+  aod::Events e{evtTable};
+  aod::TrksX t{trkTable};
+  soa::SelectionVector sel(t.size() / 2);
+  std::generate(sel.begin(), sel.end(), [n = -2]() mutable { return n += 2; });
+  soa::Filtered<aod::TrksX> ft{{trkTable}, soa::SelectionVector{sel}};
+  soa::SmallGroups<aod::TrksX> st{{trkTable}, soa::SelectionVector{sel}};
+  BOOST_CHECK_EQUAL(ft.size(), 5 * 18);
+
+  ArrowTableSlicingCache cache;
+  auto check = [](auto& slicer, auto expectedSize) {
+    unsigned int count = 0;
+    for (auto& slice : slicer) {
+      auto as = slice.associatedTables();
+      auto trks = std::get<0>(as);
+      BOOST_CHECK_EQUAL(trks.size(), (count == 3 || count == 10) ? 0 : expectedSize);
+      for (auto& trk : trks) {
+        BOOST_CHECK_EQUAL(trk.eventId(), count);
+      }
+      ++count;
+    }
+    BOOST_CHECK_EQUAL(count, 20);
+  };
+
+  // the first grouping of the table computes the offsets
+  auto tt = std::make_tuple(t);
+  o2::framework::GroupSlicer g(e, tt, &cache);
+  check(g, 10);
+  BOOST_CHECK_EQUAL(cache.getComputed(), 1);
+
+  // the filtered view of the same table reuses them
+  auto tft = std::make_tuple(ft);
+  o2::framework::GroupSlicer gf(e, tft, &cache);
+  check(gf, 5);
+  BOOST_CHECK_EQUAL(cache.getComputed(), 1);
+  BOOST_CHECK_EQUAL(cache.getRequested(), 2);
+
+  // generic groupings are computed once as well
+  auto tst = std::make_tuple(st);
+  o2::framework::GroupSlicer gs(e, tst, &cache);
+  check(gs, 5);
+  o2::framework::GroupSlicer gs2(e, tst, &cache);
+  check(gs2, 5);
+  BOOST_CHECK_EQUAL(cache.getComputed(), 2);
+  BOOST_CHECK_EQUAL(cache.getRequested(), 4);
+
+  // a new dataframe invalidates the cache
+  cache.reset();
+  o2::framework::GroupSlicer gn(e, tt, &cache);
+  check(gn, 10);
+  BOOST_CHECK_EQUAL(cache.getComputed(), 1);
+}
@@ -0,0 +1,149 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+// The processor runs with --streams 3 (see CMakeLists.txt), so that several
+// timeslices are processed at the same time on different threads. Each stream
+// must use its own TimingInfo and MessageContext, and the outputs must still
+// leave the processor in the order of the timeslices, even if the later
+// timeslices are done first.
+
+#include "Framework/CallbackService.h"
+#include "Framework/ControlService.h"
+#include "Framework/DataProcessingHeader.h"
+#include "Framework/DataRefUtils.h"
+#include "Framework/EndOfStreamContext.h"
+#include "Framework/MessageContext.h"
+#include "Framework/RawDeviceService.h"
+#include "Framework/TimingInfo.h"
+#include <fairmq/Device.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "Framework/runDataProcessing.h"
+
+#define ASSERT_ERROR(condition)                                   \
+  if ((condition) == false) {                                     \
+    LOG(fatal) << R"(Test condition ")" #condition R"(" failed)"; \
+  }
+
+using namespace o2::framework;
+
+namespace
+{
+constexpr int NTimeslices = 60;
+constexpr int NStreams = 3;
+
+struct StreamOutput {
+  int count;
+  size_t timeslice;
+};
+
+/// What the processing threads saw, checked at the end of stream
+struct StreamsCheck {
+  std::mutex mutex;
+  std::map<std::thread::id, std::pair<TimingInfo*, MessageContext*>> services;
+  std::atomic<int> inFlight{0};
+  std::atomic<int> maxInFlight{0};
+  std::atomic<int> processed{0};
+};
+} // namespace
+
+WorkflowSpec defineDataProcessing(ConfigContext const&)
+{
+  return WorkflowSpec{
+    {"producer",
+     Inputs{},
+     {OutputSpec{{"a"}, "TST", "A"}},
+     AlgorithmSpec{adaptStateful([]() { return adaptStateless(
+                                          [](DataAllocator& outputs, ControlService& control) {
+                                            static int count = 0;
+                                            outputs.make<int>(OutputRef{"a"}) = count++;
+                                            if (count == NTimeslices) {
+                                              control.endOfStream();
+                                              control.readyToQuit(QuitRequest::Me);
+                                            }
+                                          }); })}},
+    {"processor",
+     {InputSpec{"x", "TST", "A", Lifetime::Timeframe}},
+     {OutputSpec{{"b"}, "TST", "B"}},
+     AlgorithmSpec{adaptStateful([](CallbackService& callbacks, RawDeviceService& device) {
+       ASSERT_ERROR(std::stoi(device.device()->GetConfig()->GetValue<std::string>("streams")) == NStreams);
+       auto check = std::make_shared<StreamsCheck>();
+       callbacks.set(CallbackService::Id::EndOfStream, [check](EndOfStreamContext& ctx) {
+         // the end of stream is handled by the main thread, once all the streams are done
+         ASSERT_ERROR(check->processed == NTimeslices);
+         ASSERT_ERROR(check->inFlight == 0);
+         ASSERT_ERROR(check->maxInFlight > 1);
+         std::lock_guard<std::mutex> lock(check->mutex);
+         ASSERT_ERROR(check->services.size() > 1);
+         ASSERT_ERROR(check->services.size() <= NStreams);
+         ASSERT_ERROR(check->services.count(std::this_thread::get_id()) == 0);
+         std::set<TimingInfo*> timingInfos{&ctx.services().get<TimingInfo>()};
+         std::set<MessageContext*> messageContexts{&ctx.services().get<MessageContext>()};
+         for (auto& [thread, services] : check->services) {
+           ASSERT_ERROR(timingInfos.insert(services.first).second);
+           ASSERT_ERROR(messageContexts.insert(services.second).second);
+         }
+       });
+       return adaptStateless([check](ProcessingContext& pc) {
+         int inFlight = ++check->inFlight;
+         int maxInFlight = check->maxInFlight;
+         while (inFlight > maxInFlight && check->maxInFlight.compare_exchange_weak(maxInFlight, inFlight) == false) {
+         }
+         auto& timingInfo = pc.services().get<TimingInfo>();
+         auto& messageContext = pc.services().get<MessageContext>();
+         {
+           std::lock_guard<std::mutex> lock(check->mutex);
+           auto [it, isNew] = check->services.try_emplace(std::this_thread::get_id(), &timingInfo, &messageContext);
+           ASSERT_ERROR(it->second.first == &timingInfo);
+           ASSERT_ERROR(it->second.second == &messageContext);
+         }
+         auto ref = pc.inputs().get("x");
+         auto const* dph = DataRefUtils::getHeader<DataProcessingHeader*>(ref);
+         ASSERT_ERROR(timingInfo.timeslice == dph->startTime);
+         int count = pc.inputs().get<int>("x");
+         // the first timeslice of each group of streams takes the longest,
+         // so that the following ones are done before it
+         std::this_thread::sleep_for(std::chrono::milliseconds(count % NStreams == 0 ? 20 : 1));
+         // the timeslice must not have changed under our feet
+         ASSERT_ERROR(pc.services().get<TimingInfo>().timeslice == dph->startTime);
+         pc.outputs().make<StreamOutput>(OutputRef{"b"}) = StreamOutput{count, timingInfo.timeslice};
+         ++check->processed;
+         --check->inFlight;
+       });
+     })}},
+    {"consumer",
+     {InputSpec{"y", "TST", "B", Lifetime::Timeframe}},
+     {},
+     AlgorithmSpec{adaptStateful([](CallbackService& callbacks) {
+       auto expected = std::make_shared<int>(0);
+       callbacks.set(CallbackService::Id::EndOfStream, [expected](EndOfStreamContext&) {
+         ASSERT_ERROR(*expected == NTimeslices);
+       });
+       return adaptStateless([expected](InputRecord& inputs) {
+         auto ref = inputs.get("y");
+         auto const* dph = DataRefUtils::getHeader<DataProcessingHeader*>(ref);
+         auto const& output = inputs.get<StreamOutput>("y");
+         if (output.count != *expected) {
+           LOGP(fatal, "Outputs out of order. Expected: {}, Found {}.", *expected, output.count);
+         }
+         // the output was created with the timing of the timeslice of its stream
+         ASSERT_ERROR(output.timeslice == dph->startTime);
+         (*expected)++;
+       });
+     })}}};
+}
@@ -162,6 +162,25 @@ BOOST_AUTO_TEST_CASE(TestStreamServices)
   BOOST_CHECK_EQUAL(tt2->threadId, 2);
 }
 
+BOOST_AUTO_TEST_CASE(TestStreamServicesSameSlot)
+{
+  using namespace o2::framework;
+  ServiceRegistry registry;
+
+  /// Thread ids which differ by MAX_SERVICES start looking
+  /// for the service at the same position in the registry.
+  uint64_t otherThread = ServiceRegistry::MAX_SERVICES;
+  DummyService t0{0};
+  DummyService tOther{(int)otherThread};
+  registry.registerService(TypeIdHelpers::uniqueId<DummyService>(), &t0, ServiceKind::Stream, 0);
+  registry.registerService(TypeIdHelpers::uniqueId<DummyService>(), &tOther, ServiceKind::Stream, otherThread);
+
+  auto tt0 = reinterpret_cast<DummyService*>(registry.get(TypeIdHelpers::uniqueId<DummyService>(), 0, ServiceKind::Stream));
+  auto ttOther = reinterpret_cast<DummyService*>(registry.get(TypeIdHelpers::uniqueId<DummyService>(), otherThread, ServiceKind::Stream));
+  BOOST_CHECK_EQUAL(tt0->threadId, 0);
+  BOOST_CHECK_EQUAL(ttOther->threadId, (int)otherThread);
+}
+
 BOOST_AUTO_TEST_CASE(TestServiceRegistryCtor)
 {
   using namespace o2::framework;
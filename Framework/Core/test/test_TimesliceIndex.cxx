@@ -164,3 +164,33 @@ BOOST_AUTO_TEST_CASE(TestOldestPossibleTimeslice)
   index.updateOldestPossibleOutput();
   BOOST_CHECK_EQUAL(index.getOldestPossibleOutput().timeslice.value, 10);
 }
+
+BOOST_AUTO_TEST_CASE(TestDirtySlots)
+{
+  using namespace o2::framework;
+  std::vector<InputChannelInfo> infos{1};
+  TimesliceIndex index{1, infos};
+  index.resize(4);
+  std::vector<TimesliceSlot> dirty;
+
+  index.takeDirtySlots(dirty);
+  BOOST_CHECK(dirty.empty());
+
+  index.markAsDirty({1}, true);
+  index.markAsDirty({3}, true);
+  index.markAsDirty({1}, true);
+  index.markAsDirty({2}, true);
+  index.markAsDirty({2}, false);
+  index.takeDirtySlots(dirty);
+  BOOST_REQUIRE_EQUAL(dirty.size(), 2);
+  BOOST_CHECK_EQUAL(dirty[0].index, 3);
+  BOOST_CHECK_EQUAL(dirty[1].index, 1);
+  // Taking them does not change their state.
+  BOOST_CHECK(index.isDirty({3}));
+  index.takeDirtySlots(dirty);
+  BOOST_CHECK(dirty.empty());
+
+  index.rescan();
+  index.takeDirtySlots(dirty);
+  BOOST_CHECK_EQUAL(dirty.size(), 4);
+}
@@ -86,6 +86,10 @@ class DataSamplingPolicy
   std::string getFairMQOutputChannelName() const;
   uint32_t getTotalAcceptedMessages() const;
   uint32_t getTotalEvaluatedMessages() const;
+  /// \brief Accounts the payload bytes sent by this policy, either passed by reference or copied.
+  void registerSentBytes(uint64_t bytes, bool byReference);
+  uint64_t getTotalForwardedBytes() const;
+  uint64_t getTotalCopiedBytes() const;
 
   static header::DataOrigin createPolicyDataOrigin();
   static header::DataDescription createPolicyDataDescription(std::string policyName, size_t id);
@@ -99,6 +103,8 @@ class DataSamplingPolicy
   // stats
   uint32_t mTotalAcceptedMessages = 0;
   uint32_t mTotalEvaluatedMessages = 0;
+  uint64_t mTotalForwardedBytes = 0;
+  uint64_t mTotalCopiedBytes = 0;
 };
 
 } // namespace o2::utilities
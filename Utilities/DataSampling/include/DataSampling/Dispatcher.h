@@ -67,7 +67,10 @@ class Dispatcher : public framework::Task
   DataSamplingHeader prepareDataSamplingHeader(const DataSamplingPolicy& policy);
   header::Stack extractAdditionalHeaders(const char* inputHeaderStack) const;
   void reportStats(monitoring::Monitoring& monitoring) const;
-  void send(framework::DataAllocator& dataAllocator, const framework::DataRef& inputData, const framework::Output& output) const;
+  /// Sends the payload of inputData, by reference if inputPayload is available and the transport allows it.
+  /// \return true if the payload was passed by reference
+  bool send(framework::DataAllocator& dataAllocator, const framework::DataRef& inputData, const fair::mq::Message* inputPayload,
+            const framework::Output& output) const;
 
   std::string mName;
   DataSamplingHeader::DeviceIDType mDeviceID = "invalid";
@@ -166,6 +166,21 @@ uint32_t DataSamplingPolicy::getTotalEvaluatedMessages() const
   return mTotalEvaluatedMessages;
 }
 
+void DataSamplingPolicy::registerSentBytes(uint64_t bytes, bool byReference)
+{
+  (byReference ? mTotalForwardedBytes : mTotalCopiedBytes) += bytes;
+}
+
+uint64_t DataSamplingPolicy::getTotalForwardedBytes() const
+{
+  return mTotalForwardedBytes;
+}
+
+uint64_t DataSamplingPolicy::getTotalCopiedBytes() const
+{
+  return mTotalCopiedBytes;
+}
+
 header::DataOrigin DataSamplingPolicy::createPolicyDataOrigin()
 {
   return header::DataOrigin("DS");
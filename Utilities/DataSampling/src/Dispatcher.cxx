@@ -27,6 +27,8 @@
 #include "Framework/DataProcessingHelpers.h"
 #include "Framework/DataRelayer.h"
 
+#include <fairmq/Message.h>
+
 #include <Configuration/ConfigurationInterface.h>
 #include <Configuration/ConfigurationFactory.h>
 
@@ -100,7 +102,8 @@ void Dispatcher::run(ProcessingContext& ctx)
       if (auto route = policy->match(inputMatcher); route != nullptr && policy->decide(firstPart)) {
         auto routeAsConcreteDataType = DataSpecUtils::asConcreteDataTypeMatcher(*route);
         auto dsheader = prepareDataSamplingHeader(*policy);
-        for (const auto& part : inputIt) {
+        for (size_t partIndex = 0; partIndex < inputIt.size(); ++partIndex) {
+          const DataRef& part = inputIt.getByPos(partIndex);
           if (part.header != nullptr) {
             // We copy every header which is not DataHeader or DataProcessingHeader,
             // so that custom data-dependent headers are passed forward,
@@ -116,7 +119,10 @@ void Dispatcher::run(ProcessingContext& ctx)
               partInputHeader->subSpecification,
               part.spec->lifetime,
               std::move(headerStack)};
-            send(ctx.outputs(), part, output);
+            // only the header stack is new, the payload is passed by reference whenever possible
+            const auto* inputPayload = ctx.inputs().getPayloadMessage(inputIt.position(), partIndex);
+            bool byReference = send(ctx.outputs(), part, inputPayload, output);
+            policy->registerSentBytes(DataRefUtils::getPayloadSize(part), byReference);
           }
         }
       }
@@ -144,6 +150,11 @@ void Dispatcher::reportStats(Monitoring& monitoring) const
 
   monitoring.send(Metric{dispatcherTotalEvaluatedMessages, "Dispatcher_messages_evaluated"}.addTag(tags::Key::Subsystem, tags::Value::DataSampling));
   monitoring.send(Metric{dispatcherTotalAcceptedMessages, "Dispatcher_messages_passed"}.addTag(tags::Key::Subsystem, tags::Value::DataSampling));
+
+  for (const auto& policy : mPolicies) {
+    monitoring.send(Metric{policy->getTotalForwardedBytes(), "Dispatcher_" + policy->getName() + "_bytes_forwarded"}.addTag(tags::Key::Subsystem, tags::Value::DataSampling));
+    monitoring.send(Metric{policy->getTotalCopiedBytes(), "Dispatcher_" + policy->getName() + "_bytes_copied"}.addTag(tags::Key::Subsystem, tags::Value::DataSampling));
+  }
 }
 
 DataSamplingHeader Dispatcher::prepareDataSamplingHeader(const DataSamplingPolicy& policy)
@@ -172,10 +183,15 @@ header::Stack Dispatcher::extractAdditionalHeaders(const char* inputHeaderStack)
   return headerStack;
 }
 
-void Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, const Output& output) const
+bool Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, const fair::mq::Message* inputPayload,
+                      const Output& output) const
 {
   const auto* inputHeader = DataRefUtils::getHeader<header::DataHeader*>(inputData);
+  if (inputPayload != nullptr && inputPayload->GetData() == inputData.payload) {
+    return dataAllocator.forward(output, *inputPayload, inputHeader->payloadSerializationMethod);
+  }
   dataAllocator.snapshot(output, inputData.payload, DataRefUtils::getPayloadSize(inputData), inputHeader->payloadSerializationMethod);
+  return false;
 }
 
 void Dispatcher::registerPolicy(std::unique_ptr<DataSamplingPolicy>&& policy)
@@ -132,6 +132,19 @@ BOOST_AUTO_TEST_CASE(DataSamplingPolicyFromMethods)
   BOOST_CHECK((policy.prepareOutput(ConcreteDataMatcher{"TST", "CHLEB", 33})) == (Output{"AA", "BBBB", 33}));
 }
 
+BOOST_AUTO_TEST_CASE(DataSamplingPolicySentBytes)
+{
+  DataSamplingPolicy policy("my_policy");
+  BOOST_CHECK_EQUAL(policy.getTotalForwardedBytes(), 0);
+  BOOST_CHECK_EQUAL(policy.getTotalCopiedBytes(), 0);
+
+  policy.registerSentBytes(100, true);
+  policy.registerSentBytes(20, false);
+  policy.registerSentBytes(3, true);
+  BOOST_CHECK_EQUAL(policy.getTotalForwardedBytes(), 103);
+  BOOST_CHECK_EQUAL(policy.getTotalCopiedBytes(), 20);
+}
+
 BOOST_AUTO_TEST_CASE(DataSamplingPolicyStaticMethods)
 {
   BOOST_CHECK(DataSamplingPolicy::createPolicyDataOrigin() == DataOrigin("DS"));
@@ -0,0 +1,121 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_ransInterleaved.cxx
+/// @brief  single core encoding/decoding throughput for different numbers of interleaved rANS states
+
+#include <vector>
+#include <random>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "rANS/rans.h"
+
+template <typename source_T>
+class SourceMessage
+{
+ public:
+  SourceMessage(size_t messageSize)
+  {
+    std::mt19937 mt(0); // same seed we want always the same distrubution of random numbers;
+    // a narrow distribution resembling typical CTF columns, with a few escaped outliers
+    std::normal_distribution<double> dist(0., 64.);
+    mSourceMessage.reserve(messageSize);
+    for (size_t i = 0; i < messageSize; ++i) {
+      mSourceMessage.push_back(static_cast<source_T>(dist(mt)));
+    }
+    auto frequencyTable = o2::rans::makeFrequencyTableFromSamples(std::begin(mSourceMessage), std::end(mSourceMessage));
+    mRenormedFrequencyTable = o2::rans::renorm(std::move(frequencyTable), 20);
+  }
+
+  const auto& get() const { return mSourceMessage; };
+  const auto& getFrequencyTable() const { return mRenormedFrequencyTable; };
+
+ private:
+  std::vector<source_T> mSourceMessage{};
+  o2::rans::RenormedFrequencyTable mRenormedFrequencyTable{};
+};
+
+using source_t = int16_t;
+inline const SourceMessage<source_t> sourceMessage{1 << 24};
+
+// generous upper bound for the encoded size of the message, in stream_T words
+template <typename stream_T>
+size_t getEncodeBufferSize(size_t messageSize)
+{
+  return 2 * messageSize * sizeof(source_t) / sizeof(stream_T) + 1024;
+}
+
+template <typename encoder_T, size_t nStreams_V>
+static void BM_Encode(benchmark::State& state)
+{
+  const auto& message = sourceMessage.get();
+  const encoder_T encoder{sourceMessage.getFrequencyTable()};
+  std::vector<typename encoder_T::stream_t> encodeBuffer(getEncodeBufferSize<typename encoder_T::stream_t>(message.size()));
+  std::vector<source_t> literals;
+  literals.reserve(message.size());
+
+  for (auto _ : state) {
+    literals.clear();
+    benchmark::DoNotOptimize(encoder.template process<nStreams_V>(message.begin(), message.end(), encodeBuffer.begin(), literals));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * message.size());
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * message.size() * sizeof(source_t));
+}
+
+template <typename encoder_T, typename decoder_T, size_t nStreams_V>
+static void BM_Decode(benchmark::State& state)
+{
+  const auto& message = sourceMessage.get();
+  const encoder_T encoder{sourceMessage.getFrequencyTable()};
+  const decoder_T decoder{sourceMessage.getFrequencyTable()};
+  std::vector<typename encoder_T::stream_t> encodeBuffer(getEncodeBufferSize<typename encoder_T::stream_t>(message.size()));
+  std::vector<source_t> literals;
+  const auto encodedEnd = encoder.template process<nStreams_V>(message.begin(), message.end(), encodeBuffer.begin(), literals);
+  std::vector<source_t> decodeBuffer(message.size());
+
+  for (auto _ : state) {
+    std::vector<source_t> literalsCopy = literals;
+    decoder.template process<nStreams_V>(encodedEnd, decodeBuffer.begin(), message.size(), literalsCopy);
+    benchmark::ClobberMemory();
+  }
+
+  if (decodeBuffer != message) {
+    state.SkipWithError("decoded message does not match the source");
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * message.size());
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * message.size() * sizeof(source_t));
+}
+
+using encoder64_t = o2::rans::LiteralEncoder64<source_t>;
+using decoder64_t = o2::rans::LiteralDecoder64<source_t>;
+using encoder32_t = o2::rans::LiteralEncoder32<source_t>;
+using decoder32_t = o2::rans::LiteralDecoder32<source_t>;
+
+BENCHMARK_TEMPLATE(BM_Encode, encoder64_t, 2);
+BENCHMARK_TEMPLATE(BM_Encode, encoder64_t, 4);
+BENCHMARK_TEMPLATE(BM_Encode, encoder64_t, 8);
+BENCHMARK_TEMPLATE(BM_Encode, encoder64_t, 16);
+BENCHMARK_TEMPLATE(BM_Encode, encoder32_t, 2);
+BENCHMARK_TEMPLATE(BM_Encode, encoder32_t, 8);
+BENCHMARK_TEMPLATE(BM_Encode, encoder32_t, 16);
+
+BENCHMARK_TEMPLATE(BM_Decode, encoder64_t, decoder64_t, 2);
+BENCHMARK_TEMPLATE(BM_Decode, encoder64_t, decoder64_t, 4);
+BENCHMARK_TEMPLATE(BM_Decode, encoder64_t, decoder64_t, 8);
+BENCHMARK_TEMPLATE(BM_Decode, encoder64_t, decoder64_t, 16);
+BENCHMARK_TEMPLATE(BM_Decode, encoder32_t, decoder32_t, 2);
+BENCHMARK_TEMPLATE(BM_Decode, encoder32_t, decoder32_t, 8);
+BENCHMARK_TEMPLATE(BM_Decode, encoder32_t, decoder32_t, 16);
+
+BENCHMARK_MAIN();
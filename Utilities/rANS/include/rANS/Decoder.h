@@ -25,7 +25,8 @@
 
 #include <fairlogger/Logger.h>
 
-#include "rANS/internal/Decoder.h"
+#include "rANS/definitions.h"
+#include "rANS/internal/InterleavedDecoder.h"
 #include "rANS/internal/DecoderBase.h"
 
 namespace o2
@@ -39,15 +40,17 @@ class Decoder : public internal::DecoderBase<coder_T, stream_T, source_T>
  public:
   using internal::DecoderBase<coder_T, stream_T, source_T>::DecoderBase;
 
-  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  // nStreams_V: number of interleaved rANS states, has to match the one used by the encoder
+  template <size_t nStreams_V = DefaultNStreams, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength) const;
 
  private:
-  using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::ransDecoder_t;
+  template <size_t nStreams_V>
+  using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::template interleavedDecoder_t<nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
-template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
 void Decoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength) const
 {
   using namespace internal;
@@ -66,26 +69,25 @@ void Decoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT
   // make Iter point to the last last element
   --inputIter;
 
-  ransDecoder_t rans0{this->mSymbolTable.getPrecision()};
-  ransDecoder_t rans1{this->mSymbolTable.getPrecision()};
-
-  inputIter = rans0.init(inputIter);
-  inputIter = rans1.init(inputIter);
-
-  for (size_t i = 0; i < (messageLength & ~1); i += 2) {
-    const int64_t s0 = this->mReverseLUT[rans0.get()];
-    const int64_t s1 = this->mReverseLUT[rans1.get()];
-    *it++ = s0;
-    *it++ = s1;
-    inputIter = rans0.advanceSymbol(inputIter, this->mSymbolTable[s0]);
-    inputIter = rans1.advanceSymbol(inputIter, this->mSymbolTable[s1]);
+  ransDecoder_t<nStreams_V> rans{this->mSymbolTable.getPrecision()};
+  inputIter = rans.init(inputIter);
+
+  const size_t nTrailingSymbols = messageLength % nStreams_V;
+  typename ransDecoder_t<nStreams_V>::symbols_t decoderSymbols;
+  for (size_t i = 0; i < messageLength - nTrailingSymbols; i += nStreams_V) {
+    for (size_t j = 0; j < nStreams_V; ++j) {
+      const int64_t s = this->mReverseLUT[rans.get(j)];
+      *it++ = s;
+      decoderSymbols[j] = &this->mSymbolTable[s];
+    }
+    inputIter = rans.advanceSymbols(inputIter, decoderSymbols);
   }
 
-  // last byte, if message length was odd
-  if (messageLength & 1) {
-    const int64_t s0 = this->mReverseLUT[rans0.get()];
-    *it = s0;
-    inputIter = rans0.advanceSymbol(inputIter, this->mSymbolTable[s0]);
+  // trailing symbols not filling all states
+  for (size_t j = 0; j < nTrailingSymbols; ++j) {
+    const int64_t s = this->mReverseLUT[rans.get(j)];
+    *it++ = s;
+    inputIter = rans.advanceSymbol(inputIter, this->mSymbolTable[s], j);
   }
   t.stop();
   LOG(debug1) << "Decoder::" << __func__ << " { DecodedSymbols: " << messageLength << ","
@@ -30,7 +30,8 @@
 #include "rANS/internal/DecoderSymbol.h"
 #include "rANS/internal/ReverseSymbolLookupTable.h"
 #include "rANS/internal/SymbolTable.h"
-#include "rANS/internal/Decoder.h"
+#include "rANS/definitions.h"
+#include "rANS/internal/InterleavedDecoder.h"
 #include "rANS/internal/DecoderBase.h"
 
 namespace o2
@@ -44,15 +45,17 @@ class LiteralDecoder : public internal::DecoderBase<coder_T, stream_T, source_T>
  public:
   using internal::DecoderBase<coder_T, stream_T, source_T>::DecoderBase;
 
-  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  // nStreams_V: number of interleaved rANS states, has to match the one used by the encoder
+  template <size_t nStreams_V = DefaultNStreams, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const;
 
  private:
-  using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::ransDecoder_t;
+  template <size_t nStreams_V>
+  using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::template interleavedDecoder_t<nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
-template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
 void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const
 {
   using namespace internal;
@@ -73,8 +76,8 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
   stream_IT inputIter = inputEnd;
   source_IT it = outputBegin;
 
-  auto decode = [&, this](ransDecoder_t& decoder) {
-    const auto cumul = decoder.get();
+  // returns the decoded source symbol and the symbol to advance the rANS state with
+  auto decode = [&, this](uint32_t cumul) {
     const auto streamSymbol = (this->mReverseLUT)[cumul];
     source_T symbol = streamSymbol;
     if (this->mSymbolTable.isEscapeSymbol(streamSymbol)) {
@@ -86,25 +89,29 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
     arrayLogger << symbol;
 #endif
 
-    return std::make_tuple(symbol, decoder.advanceSymbol(inputIter, (this->mSymbolTable)[streamSymbol]));
+    return std::make_tuple(symbol, &(this->mSymbolTable)[streamSymbol]);
   };
 
   // make Iter point to the last last element
   --inputIter;
 
-  ransDecoder_t rans0{this->mSymbolTable.getPrecision()};
-  ransDecoder_t rans1{this->mSymbolTable.getPrecision()};
-  inputIter = rans0.init(inputIter);
-  inputIter = rans1.init(inputIter);
+  ransDecoder_t<nStreams_V> rans{this->mSymbolTable.getPrecision()};
+  inputIter = rans.init(inputIter);
 
-  for (size_t i = 0; i < (messageLength & ~1); i += 2) {
-    std::tie(*it++, inputIter) = decode(rans0);
-    std::tie(*it++, inputIter) = decode(rans1);
+  const size_t nTrailingSymbols = messageLength % nStreams_V;
+  typename ransDecoder_t<nStreams_V>::symbols_t decoderSymbols;
+  for (size_t i = 0; i < messageLength - nTrailingSymbols; i += nStreams_V) {
+    for (size_t j = 0; j < nStreams_V; ++j) {
+      std::tie(*it++, decoderSymbols[j]) = decode(rans.get(j));
+    }
+    inputIter = rans.advanceSymbols(inputIter, decoderSymbols);
   }
 
-  // last byte, if message length was odd
-  if (messageLength & 1) {
-    std::tie(*it++, inputIter) = decode(rans0);
+  // trailing symbols not filling all states
+  for (size_t j = 0; j < nTrailingSymbols; ++j) {
+    const DecoderSymbol* decoderSymbol{};
+    std::tie(*it++, decoderSymbol) = decode(rans.get(j));
+    inputIter = rans.advanceSymbol(inputIter, *decoderSymbol, j);
   }
   t.stop();
 
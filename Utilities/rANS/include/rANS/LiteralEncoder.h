@@ -24,6 +24,7 @@
 #include <fairlogger/Logger.h>
 #include <stdexcept>
 
+#include "rANS/definitions.h"
 #include "rANS/internal/EncoderBase.h"
 #include "rANS/internal/EncoderSymbol.h"
 #include "rANS/internal/helper.h"
@@ -42,15 +43,17 @@ class LiteralEncoder : public internal::EncoderBase<coder_T, stream_T, source_T>
   // inherit constructors;
   using internal::EncoderBase<coder_T, stream_T, source_T>::EncoderBase;
 
-  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
+  // nStreams_V: number of interleaved rANS states, the decoder has to use the same number
+  template <size_t nStreams_V = DefaultNStreams, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
   stream_IT process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const;
 
  private:
-  using ransCoder_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::ransCoder_t;
+  template <size_t nStreams_V>
+  using ransCoder_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::template interleavedCoder_t<nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
-template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
 stream_IT LiteralEncoder<coder_T, stream_T, source_T>::process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const
 {
   using namespace internal;
@@ -68,17 +71,15 @@ stream_IT LiteralEncoder<coder_T, stream_T, source_T>::process(source_IT inputBe
     return outputBegin;
   }
 
-  ransCoder_t rans0{this->mSymbolTable.getPrecision()};
-  ransCoder_t rans1{this->mSymbolTable.getPrecision()};
+  ransCoder_t<nStreams_V> rans{this->mSymbolTable.getPrecision()};
 
   stream_IT outputIter = outputBegin;
   source_IT inputIT = inputEnd;
 
   const auto inputBufferSize = std::distance(inputBegin, inputEnd);
 
-  auto encode = [&, this](source_IT symbolIter, stream_IT outputIter, ransCoder_t& coder) {
+  auto lookupSymbol = [&, this](source_IT symbolIter) -> const auto& {
     const source_T symbol = *symbolIter;
-    const auto& encoderSymbol = (this->mSymbolTable)[symbol];
     if (this->mSymbolTable.isEscapeSymbol(symbol)) {
       literals.push_back(symbol);
     }
@@ -87,20 +88,22 @@ stream_IT LiteralEncoder<coder_T, stream_T, source_T>::process(source_IT inputBe
     arrayLogger << symbol;
 #endif
 
-    return coder.putSymbol(outputIter, encoderSymbol);
+    return (this->mSymbolTable)[symbol];
   };
 
-  // odd number of bytes?
-  if (inputBufferSize & 1) {
-    outputIter = encode(--inputIT, outputIter, rans0);
+  // trailing symbols not filling all states
+  for (size_t i = inputBufferSize % nStreams_V; i-- > 0;) {
+    outputIter = rans.putSymbol(outputIter, lookupSymbol(--inputIT), i);
   }
 
+  typename ransCoder_t<nStreams_V>::symbols_t encoderSymbols;
   while (inputIT != inputBegin) { // NB: working in reverse!
-    outputIter = encode(--inputIT, outputIter, rans1);
-    outputIter = encode(--inputIT, outputIter, rans0);
+    for (size_t i = nStreams_V; i-- > 0;) {
+      encoderSymbols[i] = &lookupSymbol(--inputIT);
+    }
+    outputIter = rans.putSymbols(outputIter, encoderSymbols);
   }
-  outputIter = rans1.flush(outputIter);
-  outputIter = rans0.flush(outputIter);
+  outputIter = rans.flush(outputIter);
   // first iterator past the range so that sizes, distances and iterators work correctly.
   ++outputIter;
 
@@ -17,6 +17,7 @@
 #ifndef INCLUDE_RANS_DEFINITIONS_H_
 #define INCLUDE_RANS_DEFINITIONS_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -30,6 +31,10 @@ using histogram_t = std::vector<count_t>;
 
 inline constexpr uint8_t MinRenormThreshold = 10;
 inline constexpr uint8_t MaxRenormThreshold = 20;
+
+// number of interleaved rANS states used by the Encoder/Decoder front-ends unless requested otherwise.
+// Streams produced with a different number of states can only be decoded with the same number of states.
+inline constexpr size_t DefaultNStreams = 2;
 } // namespace rans
 } // namespace o2
 
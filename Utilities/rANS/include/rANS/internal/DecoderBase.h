@@ -29,6 +29,7 @@
 #include "rANS/internal/ReverseSymbolLookupTable.h"
 #include "rANS/internal/SymbolTable.h"
 #include "rANS/internal/Decoder.h"
+#include "rANS/internal/InterleavedDecoder.h"
 #include "rANS/internal/helper.h"
 
 namespace o2
@@ -46,6 +47,8 @@ class DecoderBase
   using decoderSymbolTable_t = internal::SymbolTable<internal::DecoderSymbol>;
   using reverseSymbolLookupTable_t = internal::ReverseSymbolLookupTable;
   using ransDecoder_t = Decoder<coder_T, stream_T>;
+  template <size_t nStreams_V>
+  using interleavedDecoder_t = InterleavedDecoder<coder_T, stream_T, nStreams_V>;
 
  public:
   using coder_t = coder_T;
@@ -26,6 +26,7 @@
 
 #include "rANS/definitions.h"
 #include "rANS/internal/Encoder.h"
+#include "rANS/internal/InterleavedEncoder.h"
 #include "rANS/internal/EncoderSymbol.h"
 #include "rANS/internal/helper.h"
 #include "rANS/internal/SymbolTable.h"
@@ -44,6 +45,8 @@ class EncoderBase
  protected:
   using encoderSymbolTable_t = typename internal::SymbolTable<internal::EncoderSymbol<coder_T>>;
   using ransCoder_t = typename internal::Encoder<coder_T, stream_T>;
+  template <size_t nStreams_V>
+  using interleavedCoder_t = typename internal::InterleavedEncoder<coder_T, stream_T, nStreams_V>;
 
  public:
   using coder_t = coder_T;
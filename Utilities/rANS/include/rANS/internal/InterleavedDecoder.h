@@ -0,0 +1,165 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedDecoder.h
+/// @brief  rANS decoder with nStreams_V independent states reading from a single input stream
+
+#ifndef RANS_INTERNAL_INTERLEAVEDDECODER_H
+#define RANS_INTERNAL_INTERLEAVEDDECODER_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+
+#include "rANS/internal/DecoderSymbol.h"
+#include "rANS/internal/SIMDKernels.h"
+#include "rANS/internal/helper.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+
+// Counterpart of InterleavedEncoder, see there for the layout of the stream.
+template <typename state_T, typename stream_T, size_t nStreams_V>
+class InterleavedDecoder
+{
+  static_assert((sizeof(state_T) == sizeof(uint32_t) && sizeof(stream_T) == sizeof(uint8_t)) ||
+                  (sizeof(state_T) == sizeof(uint64_t) && sizeof(stream_T) == sizeof(uint32_t)),
+                "Coder can either be 32Bit with 8 Bit stream type or 64 Bit Type with 32 Bit stream type");
+  static_assert(nStreams_V > 0, "need at least one rANS state");
+
+ public:
+  using symbols_t = std::array<const DecoderSymbol*, nStreams_V>;
+
+  explicit InterleavedDecoder(size_t symbolTablePrecission) noexcept;
+
+  static constexpr size_t getNStreams() noexcept { return nStreams_V; };
+
+  // Initializes all states, first state first.
+  template <typename stream_IT>
+  stream_IT init(stream_IT inputIter);
+
+  // Returns the current cumulative frequency of state `stream` (map it to a symbol yourself!)
+  uint32_t get(size_t stream) const;
+
+  // Advances all states, symbols[i] is the symbol decoded from state i.
+  template <typename stream_IT>
+  stream_IT advanceSymbols(stream_IT inputIter, const symbols_t& symbols);
+
+  // Advances state `stream` only, used for the trailing symbols of a message.
+  template <typename stream_IT>
+  stream_IT advanceSymbol(stream_IT inputIter, const DecoderSymbol& symbol, size_t stream);
+
+ private:
+  std::array<state_T, nStreams_V> mStates{};
+  size_t mSymbolTablePrecission{};
+
+  template <typename stream_IT>
+  std::tuple<state_T, stream_IT> renorm(state_T state, stream_IT inputIter);
+
+  inline static constexpr state_T LOWER_BOUND = needs64Bit<state_T>() ? (1u << 31) : (1u << 23); // lower bound of our normalization interval
+
+  inline static constexpr state_T STREAM_BITS = sizeof(stream_T) * 8;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+InterleavedDecoder<state_T, stream_T, nStreams_V>::InterleavedDecoder(size_t symbolTablePrecission) noexcept : mSymbolTablePrecission{symbolTablePrecission} {};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::init(stream_IT inputIter)
+{
+  stream_IT streamPosition = inputIter;
+  for (auto& state : mStates) {
+    state = 0;
+    if constexpr (needs64Bit<state_T>()) {
+      state |= static_cast<state_T>(*streamPosition--) << 0;
+      state |= static_cast<state_T>(*streamPosition--) << 32;
+    } else {
+      state |= static_cast<state_T>(*streamPosition--) << 0;
+      state |= static_cast<state_T>(*streamPosition--) << 8;
+      state |= static_cast<state_T>(*streamPosition--) << 16;
+      state |= static_cast<state_T>(*streamPosition--) << 24;
+    }
+  }
+  return streamPosition;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+inline uint32_t InterleavedDecoder<state_T, stream_T, nStreams_V>::get(size_t stream) const
+{
+  return mStates[stream] & ((pow2(mSymbolTablePrecission)) - 1);
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbols(stream_IT inputIter, const symbols_t& symbols)
+{
+  static_assert(std::is_same<typename std::iterator_traits<stream_IT>::value_type, stream_T>::value);
+
+  std::array<state_T, nStreams_V> frequency;
+  std::array<state_T, nStreams_V> cumulative;
+  for (size_t i = 0; i < nStreams_V; ++i) {
+    frequency[i] = symbols[i]->getFrequency();
+    cumulative[i] = symbols[i]->getCumulative();
+  }
+
+  simd::decodeStates<state_T, nStreams_V>(mStates.data(), frequency.data(), cumulative.data(), mSymbolTablePrecission);
+
+  // renormalization reads from the shared stream and has to follow the state order.
+  for (size_t i = 0; i < nStreams_V; ++i) {
+    std::tie(mStates[i], inputIter) = renorm(mStates[i], inputIter);
+  }
+  return inputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbol(stream_IT inputIter, const DecoderSymbol& symbol, size_t stream)
+{
+  static_assert(std::is_same<typename std::iterator_traits<stream_IT>::value_type, stream_T>::value);
+  assert(stream < nStreams_V);
+
+  const state_T state = simd::decodeState<state_T>(mStates[stream], symbol.getFrequency(), symbol.getCumulative(), mSymbolTablePrecission);
+  std::tie(mStates[stream], inputIter) = renorm(state, inputIter);
+  return inputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline std::tuple<state_T, stream_IT> InterleavedDecoder<state_T, stream_T, nStreams_V>::renorm(state_T state, stream_IT inputIter)
+{
+  if (state < LOWER_BOUND) {
+    if constexpr (needs64Bit<state_T>()) {
+      state = (state << STREAM_BITS) | *inputIter;
+      --inputIter;
+      assert(state >= LOWER_BOUND);
+    } else {
+      do {
+        state = (state << STREAM_BITS) | *inputIter;
+        --inputIter;
+      } while (state < LOWER_BOUND);
+    }
+  }
+  return std::make_tuple(state, inputIter);
+}
+
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDDECODER_H */
@@ -0,0 +1,195 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedEncoder.h
+/// @brief  rANS encoder with nStreams_V independent states sharing a single output stream
+
+#ifndef RANS_INTERNAL_INTERLEAVEDENCODER_H
+#define RANS_INTERNAL_INTERLEAVEDENCODER_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+#include <tuple>
+#include <utility>
+
+#include "rANS/internal/EncoderSymbol.h"
+#include "rANS/internal/SIMDKernels.h"
+#include "rANS/internal/helper.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+
+// Symbol i of a message is coded by state i % nStreams_V, the trailing (size % nStreams_V) symbols by states 0, 1, ...
+// Renormalization output of the states is interleaved in reverse state order, so that the decoder can consume it
+// in forward order. For nStreams_V = 2 the produced stream is identical to the one of the two-state Encoder.
+template <typename state_T, typename stream_T, size_t nStreams_V>
+class InterleavedEncoder
+{
+  static_assert((sizeof(state_T) == sizeof(uint32_t) && sizeof(stream_T) == sizeof(uint8_t)) ||
+                  (sizeof(state_T) == sizeof(uint64_t) && sizeof(stream_T) == sizeof(uint32_t)),
+                "Coder can either be 32Bit with 8 Bit stream type or 64 Bit Type with 32 Bit stream type");
+  static_assert(nStreams_V > 0, "need at least one rANS state");
+
+ public:
+  using symbols_t = std::array<const EncoderSymbol<state_T>*, nStreams_V>;
+
+  explicit InterleavedEncoder(size_t symbolTablePrecission) noexcept;
+
+  static constexpr size_t getNStreams() noexcept { return nStreams_V; };
+
+  // Flushes all states, last state first.
+  template <typename stream_IT>
+  stream_IT flush(stream_IT outputIter);
+
+  // Encodes one symbol per state, symbols[i] is encoded into state i.
+  template <typename stream_IT>
+  stream_IT putSymbols(stream_IT outputIter, const symbols_t& symbols);
+
+  // Encodes a single symbol into state `stream`, used for the trailing symbols of a message.
+  template <typename stream_IT>
+  stream_IT putSymbol(stream_IT outputIter, const EncoderSymbol<state_T>& symbol, size_t stream);
+
+ private:
+  std::array<state_T, nStreams_V> mStates{};
+  size_t mSymbolTablePrecission{};
+
+  template <typename stream_IT, size_t... Is>
+  stream_IT putSymbols(stream_IT outputIter, const symbols_t& symbols, std::index_sequence<Is...>);
+
+  template <typename stream_IT>
+  std::tuple<state_T, stream_IT> renorm(state_T state, stream_IT outputIter, uint32_t frequency);
+
+  inline static constexpr state_T LOWER_BOUND = needs64Bit<state_T>() ? (1u << 31) : (1u << 23); // lower bound of our normalization interval
+
+  inline static constexpr state_T STREAM_BITS = sizeof(stream_T) * 8;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+InterleavedEncoder<state_T, stream_T, nStreams_V>::InterleavedEncoder(size_t symbolTablePrecission) noexcept : mSymbolTablePrecission(symbolTablePrecission)
+{
+  mStates.fill(LOWER_BOUND);
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::flush(stream_IT outputIter)
+{
+  stream_IT streamPosition = outputIter;
+  for (size_t i = nStreams_V; i-- > 0;) {
+    const state_T state = mStates[i];
+    if constexpr (needs64Bit<state_T>()) {
+      *(++streamPosition) = static_cast<stream_T>(state >> 32);
+      *(++streamPosition) = static_cast<stream_T>(state >> 0);
+    } else {
+      *(++streamPosition) = static_cast<stream_T>(state >> 24);
+      *(++streamPosition) = static_cast<stream_T>(state >> 16);
+      *(++streamPosition) = static_cast<stream_T>(state >> 8);
+      *(++streamPosition) = static_cast<stream_T>(state >> 0);
+    }
+    mStates[i] = 0;
+  }
+  return streamPosition;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbols(stream_IT outputIter, const symbols_t& symbols)
+{
+  if constexpr (!simd::isEncodeVectorized<state_T, nStreams_V>()) {
+    // the states are updated one after the other, profiting from their independent dependency chains.
+    return putSymbols(outputIter, symbols, std::make_index_sequence<nStreams_V>{});
+  } else {
+    std::array<state_T, nStreams_V> reciprocal;
+    std::array<state_T, nStreams_V> shift;
+    std::array<state_T, nStreams_V> bias;
+    std::array<state_T, nStreams_V> complement;
+
+    // renormalization is serial as all states write into the same stream, the state update is not.
+    for (size_t i = nStreams_V; i-- > 0;) {
+      const auto& symbol = *symbols[i];
+      assert(symbol.getFrequency() != 0); // can't encode symbol with freq=0
+      std::tie(mStates[i], outputIter) = renorm(mStates[i], outputIter, symbol.getFrequency());
+      reciprocal[i] = symbol.getReciprocalFrequency();
+      shift[i] = symbol.getReciprocalShift();
+      bias[i] = symbol.getBias();
+      complement[i] = symbol.getFrequencyComplement();
+    }
+
+    simd::encodeStates<state_T, nStreams_V>(mStates.data(), reciprocal.data(), shift.data(), bias.data(), complement.data());
+    return outputIter;
+  }
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT, size_t... Is>
+inline stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbols(stream_IT outputIter, const symbols_t& symbols, std::index_sequence<Is...>)
+{
+  // unrolled at compile time, last state first
+  ((outputIter = putSymbol(outputIter, *symbols[nStreams_V - 1 - Is], nStreams_V - 1 - Is)), ...);
+  return outputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbol(stream_IT outputIter, const EncoderSymbol<state_T>& symbol, size_t stream)
+{
+  assert(symbol.getFrequency() != 0); // can't encode symbol with freq=0
+  assert(stream < nStreams_V);
+
+  state_T state{};
+  std::tie(state, outputIter) = renorm(mStates[stream], outputIter, symbol.getFrequency());
+  mStates[stream] = simd::encodeState<state_T>(state, symbol.getReciprocalFrequency(), symbol.getReciprocalShift(), symbol.getBias(), symbol.getFrequencyComplement());
+  return outputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline std::tuple<state_T, stream_IT> InterleavedEncoder<state_T, stream_T, nStreams_V>::renorm(state_T state, stream_IT outputIter, uint32_t frequency)
+{
+  state_T maxState = ((LOWER_BOUND >> mSymbolTablePrecission) << STREAM_BITS) * frequency; // this turns into a shift.
+  if constexpr (needs64Bit<state_T>() && std::is_same_v<typename std::iterator_traits<stream_IT>::iterator_category, std::random_access_iterator_tag>) {
+    // renormalization is not predictable: always store the lower bits, only advance if they are really streamed out.
+    // The spurious store is overwritten either by the next renormalization or the final flush.
+    const bool streamOut = state >= maxState;
+    outputIter[1] = static_cast<stream_T>(state);
+    outputIter += streamOut;
+    state = streamOut ? state >> STREAM_BITS : state;
+    assert(state < maxState);
+  } else if (state >= maxState) {
+    if constexpr (needs64Bit<state_T>()) {
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state);
+      state >>= STREAM_BITS;
+      assert(state < maxState);
+    } else {
+      do {
+        ++outputIter;
+        //stream out 8 Bits
+        *outputIter = static_cast<stream_T>(state & 0xff);
+        state >>= STREAM_BITS;
+      } while (state >= maxState);
+    }
+  }
+  return std::make_tuple(state, outputIter);
+};
+
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDENCODER_H */
@@ -0,0 +1,204 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   SIMDKernels.h
+/// @brief  state update kernels shared by the interleaved rANS encoder and decoder
+
+#ifndef RANS_INTERNAL_SIMDKERNELS_H
+#define RANS_INTERNAL_SIMDKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#include "rANS/internal/helper.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+namespace simd
+{
+
+// All kernels operate on nStreams_V independent states. Symbol parameters are passed as arrays of state_T
+// so that each lane can be loaded with a single vector load. Lanes not covered by a vector width available
+// at compile time are processed by the scalar fallback, which is bit-identical to internal::Encoder/Decoder.
+
+#if defined(__AVX2__)
+// high 32 bits of the 64 bit product of each of the 8 unsigned 32 bit lanes
+inline __m256i mulhi_epu32(__m256i a, __m256i b) noexcept
+{
+  const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+  const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+  return _mm256_blend_epi32(even, odd, 0b10101010);
+}
+#endif
+
+#if defined(__SSE4_1__)
+// low 64 bits of the product of 64 bit lanes a with 32 bit lanes b (upper half of b ignored)
+inline __m128i mullo_epu64x32(__m128i a, __m128i b) noexcept
+{
+  const __m128i lo = _mm_mul_epu32(a, b);
+  const __m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+  return _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+}
+#endif
+
+#if defined(__AVX2__)
+inline __m256i mullo_epu64x32(__m256i a, __m256i b) noexcept
+{
+  const __m256i lo = _mm256_mul_epu32(a, b);
+  const __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+  return _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+}
+#endif
+
+/// Encoder state update x' = x + bias + (mulhi(x, rcp) >> shift) * cmplFreq of a single state.
+template <typename state_T>
+inline state_T encodeState(state_T state, state_T reciprocal, state_T shift, state_T bias, state_T complement) noexcept
+{
+  __extension__ using uint128_t = unsigned __int128;
+  state_T quotient = 0;
+  if constexpr (needs64Bit<state_T>()) {
+    quotient = static_cast<state_T>((static_cast<uint128_t>(state) * reciprocal) >> 64);
+  } else {
+    quotient = static_cast<state_T>((static_cast<uint64_t>(state) * reciprocal) >> 32);
+  }
+  quotient = quotient >> shift;
+  return state + bias + quotient * complement;
+}
+
+/// Decoder state update x' = freq * (x >> precision) + (x & mask) - cumul of a single state.
+template <typename state_T>
+inline state_T decodeState(state_T state, state_T frequency, state_T cumulative, size_t symbolTablePrecision) noexcept
+{
+  const state_T mask = pow2(symbolTablePrecision) - 1;
+  return frequency * (state >> symbolTablePrecision) + (state & mask) - cumulative;
+}
+
+// number of leading lanes processed by vectors of vectorWidthBytes_V bytes, the remaining ones are processed one by one
+template <typename state_T, size_t nStreams_V, size_t vectorWidthBytes_V>
+inline constexpr size_t nVectorizedStreams() noexcept
+{
+  constexpr size_t nLanes = vectorWidthBytes_V / sizeof(state_T);
+  return nStreams_V - nStreams_V % nLanes;
+}
+
+/// true if encodeStates processes any of the lanes with vector instructions available at compile time.
+/// 64 bit states would need an emulated 64x64->128 bit multiplication, which is slower than the scalar one.
+template <typename state_T, size_t nStreams_V>
+inline constexpr bool isEncodeVectorized() noexcept
+{
+#if defined(__AVX2__)
+  return !needs64Bit<state_T>() && nVectorizedStreams<state_T, nStreams_V, sizeof(__m256i)>() > 0;
+#else
+  return false;
+#endif
+}
+
+/// Encoder state update x' = x + bias + (mulhi(x, rcp) >> shift) * cmplFreq for all lanes.
+/// States have to be renormalized before calling this.
+template <typename state_T, size_t nStreams_V>
+inline void encodeStates(state_T* __restrict__ states, const state_T* __restrict__ reciprocal, const state_T* __restrict__ shift,
+                         const state_T* __restrict__ bias, const state_T* __restrict__ complement) noexcept
+{
+#if defined(__AVX2__)
+  constexpr size_t nVectorized = isEncodeVectorized<state_T, nStreams_V>() ? nVectorizedStreams<state_T, nStreams_V, sizeof(__m256i)>() : 0;
+  for (size_t i = 0; i < nVectorized; i += sizeof(__m256i) / sizeof(state_T)) {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + i));
+    const __m256i quotient = _mm256_srlv_epi32(mulhi_epu32(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reciprocal + i))),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(shift + i)));
+    const __m256i scaled = _mm256_mullo_epi32(quotient, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(complement + i)));
+    const __m256i newState = _mm256_add_epi32(_mm256_add_epi32(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bias + i))), scaled);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(states + i), newState);
+  }
+#else
+  constexpr size_t nVectorized = 0;
+#endif
+
+  for (size_t i = nVectorized; i < nStreams_V; ++i) {
+    states[i] = encodeState<state_T>(states[i], reciprocal[i], shift[i], bias[i], complement[i]);
+  }
+}
+
+/// Decoder state update x' = freq * (x >> precision) + (x & mask) - cumul for all lanes.
+/// States have to be renormalized after calling this.
+template <typename state_T, size_t nStreams_V>
+inline void decodeStates(state_T* __restrict__ states, const state_T* __restrict__ frequency, const state_T* __restrict__ cumulative,
+                         size_t symbolTablePrecision) noexcept
+{
+  [[maybe_unused]] const state_T mask = pow2(symbolTablePrecision) - 1;
+
+#if defined(__AVX2__)
+  constexpr size_t nVectorizedAVX = nVectorizedStreams<state_T, nStreams_V, sizeof(__m256i)>();
+  {
+    const __m128i precision = _mm_cvtsi64_si128(symbolTablePrecision);
+    const __m256i maskV = needs64Bit<state_T>() ? _mm256_set1_epi64x(mask) : _mm256_set1_epi32(mask);
+    for (size_t i = 0; i < nVectorizedAVX; i += sizeof(__m256i) / sizeof(state_T)) {
+      const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + i));
+      const __m256i frequencyV = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(frequency + i));
+      const __m256i cumulativeV = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cumulative + i));
+      __m256i newState{};
+      if constexpr (needs64Bit<state_T>()) {
+        // the frequency is bounded by 2^precision and fits into 32 bits
+        const __m256i scaled = mullo_epu64x32(_mm256_srl_epi64(x, precision), frequencyV);
+        newState = _mm256_sub_epi64(_mm256_add_epi64(scaled, _mm256_and_si256(x, maskV)), cumulativeV);
+      } else {
+        const __m256i scaled = _mm256_mullo_epi32(_mm256_srl_epi32(x, precision), frequencyV);
+        newState = _mm256_sub_epi32(_mm256_add_epi32(scaled, _mm256_and_si256(x, maskV)), cumulativeV);
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(states + i), newState);
+    }
+  }
+#else
+  constexpr size_t nVectorizedAVX = 0;
+#endif
+
+#if defined(__SSE4_1__)
+  constexpr size_t nVectorized = nVectorizedStreams<state_T, nStreams_V, sizeof(__m128i)>();
+  {
+    const __m128i precision = _mm_cvtsi64_si128(symbolTablePrecision);
+    const __m128i maskV = needs64Bit<state_T>() ? _mm_set1_epi64x(mask) : _mm_set1_epi32(mask);
+    for (size_t i = nVectorizedAVX; i < nVectorized; i += sizeof(__m128i) / sizeof(state_T)) {
+      const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(states + i));
+      const __m128i frequencyV = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frequency + i));
+      const __m128i cumulativeV = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cumulative + i));
+      __m128i newState{};
+      if constexpr (needs64Bit<state_T>()) {
+        const __m128i scaled = mullo_epu64x32(_mm_srl_epi64(x, precision), frequencyV);
+        newState = _mm_sub_epi64(_mm_add_epi64(scaled, _mm_and_si128(x, maskV)), cumulativeV);
+      } else {
+        const __m128i scaled = _mm_mullo_epi32(_mm_srl_epi32(x, precision), frequencyV);
+        newState = _mm_sub_epi32(_mm_add_epi32(scaled, _mm_and_si128(x, maskV)), cumulativeV);
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(states + i), newState);
+    }
+  }
+#else
+  constexpr size_t nVectorized = nVectorizedAVX;
+#endif
+
+  for (size_t i = nVectorized; i < nStreams_V; ++i) {
+    states[i] = decodeState<state_T>(states[i], frequency[i], cumulative[i], symbolTablePrecision);
+  }
+}
+
+} // namespace simd
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_SIMDKERNELS_H */
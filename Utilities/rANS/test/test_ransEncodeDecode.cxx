@@ -147,6 +147,33 @@ struct EncodeDecodeLiteral : public EncodeDecodeBase<o2::rans::LiteralEncoder, o
   std::vector<typename Params<coder_T>::source_t> literals;
 };
 
+template <typename coder_T, size_t nStreams_V, class dictString_T, class testString_T>
+struct EncodeDecodeInterleaved : public EncodeDecodeBase<o2::rans::Encoder, o2::rans::Decoder, coder_T, dictString_T, testString_T> {
+  void encode() override
+  {
+    BOOST_CHECK_NO_THROW(this->encoder.template process<nStreams_V>(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer)));
+  };
+  void decode() override
+  {
+    BOOST_CHECK_NO_THROW(this->decoder.template process<nStreams_V>(this->encodeBuffer.end(), std::back_inserter(this->decodeBuffer), this->source.data.size()));
+  };
+};
+
+template <typename coder_T, size_t nStreams_V, class dictString_T, class testString_T>
+struct EncodeDecodeLiteralInterleaved : public EncodeDecodeBase<o2::rans::LiteralEncoder, o2::rans::LiteralDecoder, coder_T, dictString_T, testString_T> {
+  void encode() override
+  {
+    BOOST_CHECK_NO_THROW(this->encoder.template process<nStreams_V>(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer), literals));
+  };
+  void decode() override
+  {
+    BOOST_CHECK_NO_THROW(this->decoder.template process<nStreams_V>(this->encodeBuffer.end(), std::back_inserter(this->decodeBuffer), this->source.data.size(), literals));
+    BOOST_CHECK(literals.empty());
+  };
+
+  std::vector<typename Params<coder_T>::source_t> literals;
+};
+
 template <typename coder_T, class dictString_T, class testString_T>
 struct EncodeDecodeDedup : public EncodeDecodeBase<o2::rans::DedupEncoder, o2::rans::DedupDecoder, coder_T, dictString_T, testString_T> {
   void encode() override
@@ -185,4 +212,140 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecode, testCase_T, testCase_t)
   testCase.encode();
   testCase.decode();
   testCase.check();
-};
\ No newline at end of file
+};
+
+using interleavedTestCase_t = boost::mpl::vector<EncodeDecodeInterleaved<uint32_t, 1, FullTestString, FullTestString>,
+                                      EncodeDecodeInterleaved<uint64_t, 1, FullTestString, FullTestString>,
+                                      EncodeDecodeInterleaved<uint32_t, 4, EmptyTestString, EmptyTestString>,
+                                      EncodeDecodeInterleaved<uint64_t, 4, EmptyTestString, EmptyTestString>,
+                                      EncodeDecodeInterleaved<uint32_t, 4, FullTestString, FullTestString>,
+                                      EncodeDecodeInterleaved<uint64_t, 4, FullTestString, FullTestString>,
+                                      EncodeDecodeInterleaved<uint32_t, 8, FullTestString, FullTestString>,
+                                      EncodeDecodeInterleaved<uint64_t, 8, FullTestString, FullTestString>,
+                                      EncodeDecodeInterleaved<uint32_t, 16, FullTestString, FullTestString>,
+                                      EncodeDecodeInterleaved<uint64_t, 16, FullTestString, FullTestString>,
+                                      EncodeDecodeLiteralInterleaved<uint32_t, 8, FullTestString, FullTestString>,
+                                      EncodeDecodeLiteralInterleaved<uint64_t, 8, FullTestString, FullTestString>,
+                                      EncodeDecodeLiteralInterleaved<uint32_t, 16, EmptyTestString, FullTestString>,
+                                      EncodeDecodeLiteralInterleaved<uint64_t, 16, EmptyTestString, FullTestString>>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecodeInterleaved, testCase_T, interleavedTestCase_t)
+{
+  testCase_T testCase;
+  testCase.encode();
+  testCase.decode();
+  testCase.check();
+};
+
+// the default two-state front-ends must keep producing the stream format of two interleaved single-state coders
+using coder_t = boost::mpl::vector<uint32_t, uint64_t>;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_legacyStreamFormat, coder_T, coder_t)
+{
+  using params_t = Params<coder_T>;
+  using stream_t = typename params_t::stream_t;
+  using source_t = typename params_t::source_t;
+
+  FullTestString source;
+  const std::string& s = source.data;
+  o2::rans::RenormedFrequencyTable frequencyTable = o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(std::begin(s), std::end(s)), params_t::symbolTablePrecision);
+  const o2::rans::Encoder<coder_T, stream_t, source_t> encoder{frequencyTable};
+  const o2::rans::internal::SymbolTable<o2::rans::internal::EncoderSymbol<coder_T>> symbolTable{frequencyTable};
+
+  for (size_t messageLength : {s.size() - 1, s.size()}) {
+    std::vector<stream_t> encodeBuffer;
+    encoder.process(s.begin(), s.begin() + messageLength, std::back_inserter(encodeBuffer));
+
+    std::vector<stream_t> referenceBuffer;
+    auto outputIter = std::back_inserter(referenceBuffer);
+    o2::rans::internal::Encoder<coder_T, stream_t> rans0{params_t::symbolTablePrecision};
+    o2::rans::internal::Encoder<coder_T, stream_t> rans1{params_t::symbolTablePrecision};
+    auto inputIter = s.begin() + messageLength;
+    if (messageLength & 1) {
+      outputIter = rans0.putSymbol(outputIter, symbolTable[*(--inputIter)]);
+    }
+    while (inputIter != s.begin()) {
+      outputIter = rans1.putSymbol(outputIter, symbolTable[*(--inputIter)]);
+      outputIter = rans0.putSymbol(outputIter, symbolTable[*(--inputIter)]);
+    }
+    outputIter = rans1.flush(outputIter);
+    outputIter = rans0.flush(outputIter);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(encodeBuffer.begin(), encodeBuffer.end(), referenceBuffer.begin(), referenceBuffer.end());
+  }
+}
+
+template <typename coder_T, size_t nStreams_V>
+struct PreallocatedBuffer {
+  using coder_t = coder_T;
+  static constexpr size_t nStreams = nStreams_V;
+};
+
+using preallocatedTestCase_t = boost::mpl::vector<PreallocatedBuffer<uint32_t, 1>,
+                                                  PreallocatedBuffer<uint64_t, 1>,
+                                                  PreallocatedBuffer<uint32_t, 2>,
+                                                  PreallocatedBuffer<uint64_t, 2>,
+                                                  PreallocatedBuffer<uint32_t, 8>,
+                                                  PreallocatedBuffer<uint64_t, 8>>;
+
+// Through random access iterators the 64 bit states are renormalized without branching: the lower bits are always
+// stored one past the current position, which only advances if they are streamed out. Encoding into a preallocated
+// buffer through a vector iterator or a raw pointer must give the stream written through a back_inserter,
+// without writing past its end.
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_preallocatedBuffer, testCase_T, preallocatedTestCase_t)
+{
+  using params_t = Params<typename testCase_T::coder_t>;
+  using coder_t = typename params_t::coder_t;
+  using stream_t = typename params_t::stream_t;
+  using source_t = typename params_t::source_t;
+  constexpr size_t nStreams = testCase_T::nStreams;
+  constexpr stream_t guard = static_cast<stream_t>(0xa5a5a5a5);
+
+  FullTestString source;
+  const std::string& s = source.data;
+  o2::rans::RenormedFrequencyTable frequencyTable = o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(std::begin(s), std::end(s)), params_t::symbolTablePrecision);
+  const o2::rans::Encoder<coder_t, stream_t, source_t> encoder{frequencyTable};
+  const o2::rans::Decoder<coder_t, stream_t, source_t> decoder{frequencyTable};
+
+  for (size_t messageLength : {size_t(1), nStreams + 1, s.size() - 1, s.size()}) {
+    std::vector<stream_t> reference;
+    encoder.template process<nStreams>(s.begin(), s.begin() + messageLength, std::back_inserter(reference));
+
+    if constexpr (o2::rans::internal::needs64Bit<coder_t>()) {
+      // a renormalization streams out a single word, the flush two words per state
+      BOOST_REQUIRE(reference.size() >= 2 * nStreams);
+      const size_t nStreamedOut = reference.size() - 2 * nStreams;
+      if (messageLength == s.size()) {
+        BOOST_CHECK(nStreamedOut > 0);             // renormalizations streaming out
+        BOOST_CHECK(nStreamedOut < messageLength); // renormalizations keeping the state
+      }
+    }
+
+    // the encoder writes from one past the output iterator and returns one past the last written word,
+    // the buffers are {unused, stream, guard}
+    std::vector<stream_t> vecBuffer(reference.size() + 2, guard);
+    const auto vecEnd = encoder.template process<nStreams>(s.begin(), s.begin() + messageLength, vecBuffer.begin());
+    BOOST_CHECK(vecEnd == vecBuffer.end() - 1);
+    BOOST_CHECK_EQUAL_COLLECTIONS(vecBuffer.begin() + 1, vecEnd, reference.begin(), reference.end());
+    BOOST_CHECK(vecBuffer.front() == guard);
+    BOOST_CHECK(vecBuffer.back() == guard);
+
+    std::vector<stream_t> ptrBuffer(reference.size() + 2, guard);
+    stream_t* const ptrEnd = encoder.template process<nStreams>(s.data(), s.data() + messageLength, ptrBuffer.data());
+    BOOST_CHECK(ptrEnd == ptrBuffer.data() + ptrBuffer.size() - 1);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ptrBuffer.data() + 1, ptrEnd, reference.begin(), reference.end());
+    BOOST_CHECK(ptrBuffer.front() == guard);
+    BOOST_CHECK(ptrBuffer.back() == guard);
+
+    // decode into preallocated buffers, the last element must stay untouched
+    std::vector<source_t> decodeBuffer(messageLength + 1, 0);
+    decoder.template process<nStreams>(vecEnd, decodeBuffer.begin(), messageLength);
+    BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end() - 1, s.begin(), s.begin() + messageLength);
+    BOOST_CHECK_EQUAL(decodeBuffer.back(), 0);
+
+    std::fill(decodeBuffer.begin(), decodeBuffer.end(), 0);
+    decoder.template process<nStreams>(static_cast<const stream_t*>(ptrEnd), decodeBuffer.data(), messageLength);
+    BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end() - 1, s.begin(), s.begin() + messageLength);
+    BOOST_CHECK_EQUAL(decodeBuffer.back(), 0);
+  }
+}
@@ -193,6 +193,13 @@ if [ "$doreco" == "1" ]; then
   taskwrapper itstpcMatch.log o2-tpcits-match-workflow --use-ft0 $gloOpt
   echo "Return status of itstpcMatch: $?"
 
+  echo "Running ITS-TPC matching flow on 4 threads"
+  #the matches and the refitted tracks must not depend on the number of threads
+  taskwrapper itstpcMatchMT.log o2-tpcits-match-workflow --use-ft0 $gloOpt --nthreads 4 --itstpc-track-writer \"--outfile o2match_itstpc_nthreads.root\"
+  echo "Return status of itstpcMatch on 4 threads: $?"
+  taskwrapper itstpcMatchCompare.log root -b -q -l $O2_ROOT/share/macro/compareTPCITSMatches.C
+  echo "Return status of itstpcMatch comparison: $?"
+
   echo "Running TRD matching to ITS-TPC and TPC"
   #needs results of o2-tpc-reco-workflow, o2-tpcits-match-workflow and o2-trd-tracklet-transformer
   taskwrapper trdTrkltTransf.log o2-trd-tracklet-transformer $gloOpt
@@ -216,6 +223,18 @@ if [ "$doreco" == "1" ]; then
   taskwrapper tofMatchTracks.log o2-tof-matcher-workflow $gloOpt
   echo "Return status of o2-tof-matcher-workflow: $?"
 
+  echo "Running Track-TOF matching flow on 4 threads"
+  #the matches must not depend on the number of threads, those of all track types are written to tofMatchMT
+  mkdir -p tofMatchMT
+  tofWritersMT=""
+  for writer in TOFMatchedWriter_TPC TOFMatchedWriter_ITSTPC TOFMatchedWriter_TPCTRD TOFMatchedWriter_ITSTPCTRD; do
+    tofWritersMT+=" --${writer} \"--output-dir tofMatchMT\""
+  done
+  taskwrapper tofMatchTracksMT.log o2-tof-matcher-workflow $gloOpt --nthreads 4 $tofWritersMT
+  echo "Return status of o2-tof-matcher-workflow on 4 threads: $?"
+  taskwrapper tofMatchCompare.log root -b -q -l $O2_ROOT/share/macro/compareTOFMatches.C
+  echo "Return status of TOF matching comparison: $?"
+
   echo "Running TOF matching QA"
   #need results of ITSTPC-TOF matching (+ TOF clusters and ITS-TPC tracks)
   taskwrapper tofmatch_qa.log root -b -q -l $O2_ROOT/share/macro/checkTOFMatching.C
@@ -77,6 +77,7 @@
 #endif
 
 #include <tbb/concurrent_unordered_map.h>
+#include <tbb/task_group.h>
 
 namespace o2
 {
@@ -728,31 +729,40 @@ class O2HitMerger : public fair::mq::Device
         eventheader->putInfo("prims_total", prims);
       };
 
-      reorderAndMergeMCTracks(flusheventID, *mOutTree, nprimaries, subevOrdered, mcheaderhook);
-      remapTrackIdsAndMerge<std::vector<o2::TrackReference>>("TrackRefs", flusheventID, *mOutTree, trackoffsets, nprimaries, subevOrdered, mTrackRefBuffer);
+      // The kinematics and the hits of each detector go to different trees (and files), so that
+      // they are merged and filled concurrently, one task per tree. All tasks are finished before
+      // moving to the next event, which keeps the event order in every output file.
+      tbb::task_group flushTasks;
+      flushTasks.run([&]() {
+        reorderAndMergeMCTracks(flusheventID, *mOutTree, nprimaries, subevOrdered, mcheaderhook);
+        remapTrackIdsAndMerge<std::vector<o2::TrackReference>>("TrackRefs", flusheventID, *mOutTree, trackoffsets, nprimaries, subevOrdered, mTrackRefBuffer);
 
-      // header can be written
-      headerbr->SetAddress(&eventheader);
-      headerbr->Fill();
-      headerbr->ResetAddress();
+        // header can be written
+        headerbr->SetAddress(&eventheader);
+        headerbr->Fill();
+        headerbr->ResetAddress();
+
+        // increase the entry count in the tree
+        mOutTree->SetEntries(mOutTree->GetEntries() + 1);
+        LOG(info) << "outtree has file " << mOutTree->GetDirectory()->GetFile()->GetName();
+      });
 
       // c) do the merge procedure for all hits ... delegate this to detector specific functions
       // since they know about types; number of branches; etc.
       // this will also fix the trackIDs inside the hits
       for (int id = 0; id < mDetectorInstances.size(); ++id) {
-        auto& det = mDetectorInstances[id];
+        auto det = mDetectorInstances[id].get();
         if (det) {
           auto hittree = mDetectorToTTreeMap[id];
-          // det->mergeHitEntries(*tree, *hittree, trackoffsets, nprimaries, subevOrdered);
-          det->mergeHitEntriesAndFlush(flusheventID, *hittree, trackoffsets, nprimaries, subevOrdered);
-          hittree->SetEntries(hittree->GetEntries() + 1);
-          LOG(info) << "flushing tree to file " << hittree->GetDirectory()->GetFile()->GetName();
+          flushTasks.run([&, det, hittree]() {
+            // det->mergeHitEntries(*tree, *hittree, trackoffsets, nprimaries, subevOrdered);
+            det->mergeHitEntriesAndFlush(flusheventID, *hittree, trackoffsets, nprimaries, subevOrdered);
+            hittree->SetEntries(hittree->GetEntries() + 1);
+            LOG(info) << "flushing tree to file " << hittree->GetDirectory()->GetFile()->GetName();
+          });
         }
       }
-
-      // increase the entry count in the tree
-      mOutTree->SetEntries(mOutTree->GetEntries() + 1);
-      LOG(info) << "outtree has file " << mOutTree->GetDirectory()->GetFile()->GetName();
+      flushTasks.wait();
 
       cleanEvent(flusheventID);
       LOG(info) << "Merge/flush for event " << flusheventID << " took " << timer.RealTime();
@@ -761,13 +771,16 @@ class O2HitMerger : public fair::mq::Device
       }
     } // end while
     LOG(info) << "Writing TTrees";
-    mOutFile->Write("", TObject::kOverwrite);
+    tbb::task_group writeTasks;
+    writeTasks.run([this]() { mOutFile->Write("", TObject::kOverwrite); });
     for (int id = 0; id < mDetectorInstances.size(); ++id) {
       auto& det = mDetectorInstances[id];
       if (det) {
-        mDetectorOutFiles[id]->Write("", TObject::kOverwrite);
+        auto outfile = mDetectorOutFiles[id];
+        writeTasks.run([outfile]() { outfile->Write("", TObject::kOverwrite); });
       }
     }
+    writeTasks.wait();
 
     return true;
   }